@@ -27,41 +27,41 @@
 #ifndef X264_AARCH64_DCT_H
 #define X264_AARCH64_DCT_H
 
-void x264_dct4x4dc_neon( int16_t d[16] );
-void x264_idct4x4dc_neon( int16_t d[16] );
+void asm_dct4x4dc_neon( int16_t d[16] );
+void asm_idct4x4dc_neon( int16_t d[16] );
 
-void x264_sub4x4_dct_neon( int16_t dct[16], uint8_t *pix1, uint8_t *pix2 );
-void x264_sub8x8_dct_neon( int16_t dct[4][16], uint8_t *pix1, uint8_t *pix2 );
-void x264_sub16x16_dct_neon( int16_t dct[16][16], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub4x4_dct_neon( int16_t dct[16], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub8x8_dct_neon( int16_t dct[4][16], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub16x16_dct_neon( int16_t dct[16][16], uint8_t *pix1, uint8_t *pix2 );
 
-void x264_add4x4_idct_neon( uint8_t *p_dst, int16_t dct[16] );
-void x264_add8x8_idct_neon( uint8_t *p_dst, int16_t dct[4][16] );
-void x264_add16x16_idct_neon( uint8_t *p_dst, int16_t dct[16][16] );
+void asm_add4x4_idct_neon( uint8_t *p_dst, int16_t dct[16] );
+void asm_add8x8_idct_neon( uint8_t *p_dst, int16_t dct[4][16] );
+void asm_add16x16_idct_neon( uint8_t *p_dst, int16_t dct[16][16] );
 
-void x264_add8x8_idct_dc_neon( uint8_t *p_dst, int16_t dct[4] );
-void x264_add16x16_idct_dc_neon( uint8_t *p_dst, int16_t dct[16] );
-void x264_sub8x8_dct_dc_neon( int16_t dct[4], uint8_t *pix1, uint8_t *pix2 );
-void x264_sub8x16_dct_dc_neon( int16_t dct[8], uint8_t *pix1, uint8_t *pix2 );
+void asm_add8x8_idct_dc_neon( uint8_t *p_dst, int16_t dct[4] );
+void asm_add16x16_idct_dc_neon( uint8_t *p_dst, int16_t dct[16] );
+void asm_sub8x8_dct_dc_neon( int16_t dct[4], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub8x16_dct_dc_neon( int16_t dct[8], uint8_t *pix1, uint8_t *pix2 );
 
-void x264_sub8x8_dct8_neon( int16_t dct[64], uint8_t *pix1, uint8_t *pix2 );
-void x264_sub16x16_dct8_neon( int16_t dct[4][64], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub8x8_dct8_neon( int16_t dct[64], uint8_t *pix1, uint8_t *pix2 );
+void asm_sub16x16_dct8_neon( int16_t dct[4][64], uint8_t *pix1, uint8_t *pix2 );
 
-void x264_add8x8_idct8_neon( uint8_t *p_dst, int16_t dct[64] );
-void x264_add16x16_idct8_neon( uint8_t *p_dst, int16_t dct[4][64] );
+void asm_add8x8_idct8_neon( uint8_t *p_dst, int16_t dct[64] );
+void asm_add16x16_idct8_neon( uint8_t *p_dst, int16_t dct[4][64] );
 
-void x264_zigzag_scan_4x4_frame_neon( int16_t level[16], int16_t dct[16] );
-void x264_zigzag_scan_4x4_field_neon( int16_t level[16], int16_t dct[16] );
-void x264_zigzag_scan_8x8_frame_neon( int16_t level[64], int16_t dct[64] );
-void x264_zigzag_scan_8x8_field_neon( int16_t level[64], int16_t dct[64] );
+void asm_zigzag_scan_4x4_frame_neon( int16_t level[16], int16_t dct[16] );
+void asm_zigzag_scan_4x4_field_neon( int16_t level[16], int16_t dct[16] );
+void asm_zigzag_scan_8x8_frame_neon( int16_t level[64], int16_t dct[64] );
+void asm_zigzag_scan_8x8_field_neon( int16_t level[64], int16_t dct[64] );
 
-int x264_zigzag_sub_4x4_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
-int x264_zigzag_sub_4x4ac_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst, dctcoef *dc );
-int x264_zigzag_sub_4x4_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
-int x264_zigzag_sub_4x4ac_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst, dctcoef *dc );
+int asm_zigzag_sub_4x4_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
+int asm_zigzag_sub_4x4ac_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst, dctcoef *dc );
+int asm_zigzag_sub_4x4_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
+int asm_zigzag_sub_4x4ac_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst, dctcoef *dc );
 
-int x264_zigzag_sub_8x8_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
-int x264_zigzag_sub_8x8_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
+int asm_zigzag_sub_8x8_field_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
+int asm_zigzag_sub_8x8_frame_neon( dctcoef level[16], const pixel *p_src, pixel *p_dst );
 
-void x264_zigzag_interleave_8x8_cavlc_neon( dctcoef *dst, dctcoef *src, uint8_t *nnz );
+void asm_zigzag_interleave_8x8_cavlc_neon( dctcoef *dst, dctcoef *src, uint8_t *nnz );
 
 #endif
@@ -26,6 +26,6 @@
 #ifndef X264_AARCH64_MC_H
 #define X264_AARCH64_MC_H
 
-void x264_mc_init_aarch64( int cpu, x264_mc_functions_t *pf );
+void vbench_mc_init_aarch64( uint64_t cpu, vbench_mc_functions_t *pf );
 
 #endif
@@ -27,33 +27,33 @@
 #ifndef X264_AARCH64_QUANT_H
 #define X264_AARCH64_QUANT_H
 
-int x264_quant_2x2_dc_aarch64( int16_t dct[4], int mf, int bias );
-
-int x264_quant_2x2_dc_neon( int16_t dct[4], int mf, int bias );
-int x264_quant_4x4_dc_neon( int16_t dct[16], int mf, int bias );
-int x264_quant_4x4_neon( int16_t dct[16], uint16_t mf[16], uint16_t bias[16] );
-int x264_quant_4x4x4_neon( int16_t dct[4][16], uint16_t mf[16], uint16_t bias[16] );
-int x264_quant_8x8_neon( int16_t dct[64], uint16_t mf[64], uint16_t bias[64] );
-
-void x264_dequant_4x4_dc_neon( int16_t dct[16], int dequant_mf[6][16], int i_qp );
-void x264_dequant_4x4_neon( int16_t dct[16], int dequant_mf[6][16], int i_qp );
-void x264_dequant_8x8_neon( int16_t dct[64], int dequant_mf[6][64], int i_qp );
-
-int x264_decimate_score15_neon( int16_t * );
-int x264_decimate_score16_neon( int16_t * );
-int x264_decimate_score64_neon( int16_t * );
-
-int x264_coeff_last4_aarch64( int16_t * );
-int x264_coeff_last8_aarch64( int16_t * );
-int x264_coeff_last15_neon( int16_t * );
-int x264_coeff_last16_neon( int16_t * );
-int x264_coeff_last64_neon( int16_t * );
-
-int x264_coeff_level_run4_aarch64( int16_t *, x264_run_level_t * );
-int x264_coeff_level_run8_neon( int16_t *, x264_run_level_t * );
-int x264_coeff_level_run15_neon( int16_t *, x264_run_level_t * );
-int x264_coeff_level_run16_neon( int16_t *, x264_run_level_t * );
-
-void x264_denoise_dct_neon( dctcoef *, uint32_t *, udctcoef *, int );
+int asm_quant_2x2_dc_aarch64( int16_t dct[4], int mf, int bias );
+
+int asm_quant_2x2_dc_neon( int16_t dct[4], int mf, int bias );
+int asm_quant_4x4_dc_neon( int16_t dct[16], int mf, int bias );
+int asm_quant_4x4_neon( int16_t dct[16], uint16_t mf[16], uint16_t bias[16] );
+int asm_quant_4x4x4_neon( int16_t dct[4][16], uint16_t mf[16], uint16_t bias[16] );
+int asm_quant_8x8_neon( int16_t dct[64], uint16_t mf[64], uint16_t bias[64] );
+
+void asm_dequant_4x4_dc_neon( int16_t dct[16], int dequant_mf[6][16], int i_qp );
+void asm_dequant_4x4_neon( int16_t dct[16], int dequant_mf[6][16], int i_qp );
+void asm_dequant_8x8_neon( int16_t dct[64], int dequant_mf[6][64], int i_qp );
+
+int asm_decimate_score15_neon( int16_t * );
+int asm_decimate_score16_neon( int16_t * );
+int asm_decimate_score64_neon( int16_t * );
+
+int asm_coeff_last4_aarch64( int16_t * );
+int asm_coeff_last8_aarch64( int16_t * );
+int asm_coeff_last15_neon( int16_t * );
+int asm_coeff_last16_neon( int16_t * );
+int asm_coeff_last64_neon( int16_t * );
+
+int asm_coeff_level_run4_aarch64( int16_t *, vbench_run_level_t * );
+int asm_coeff_level_run8_neon( int16_t *, vbench_run_level_t * );
+int asm_coeff_level_run15_neon( int16_t *, vbench_run_level_t * );
+int asm_coeff_level_run16_neon( int16_t *, vbench_run_level_t * );
+
+void asm_denoise_dct_neon( dctcoef *, uint32_t *, udctcoef *, int );
 
 #endif
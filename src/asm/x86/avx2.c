@@ -0,0 +1,185 @@
+/*****************************************************************************
+ * avx2.c: AVX2 kernels written with intrinsics
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+/* The AVX2 counterparts of sse2.c, built with -mavx2 (see the Makefile)
+ * and registered under CPU_AVX2.  Bit-exact with the C as well. */
+
+#include <immintrin.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+
+#if HAVE_X86_INTRIN
+
+/****************************************************************************
+ * bitstream: nal_unescape
+ ****************************************************************************/
+
+/* see asm_nal_unescape_sse2 */
+uint8_t *asm_nal_unescape_avx2( uint8_t *dst, uint8_t *src, uint8_t *end )
+{
+    const __m256i pb_3 = _mm256_set1_epi8( 3 );
+    const __m256i zero = _mm256_setzero_si256();
+
+    if( src < end ) *dst++ = *src++;
+    if( src < end ) *dst++ = *src++;
+    while( end - src >= 32 )
+    {
+        __m256i v = _mm256_loadu_si256( (__m256i*)src );
+        __m256i z = _mm256_or_si256( _mm256_loadu_si256( (__m256i*)(src-1) ), _mm256_loadu_si256( (__m256i*)(src-2) ) );
+        _mm256_storeu_si256( (__m256i*)dst, v );
+        uint32_t escape = _mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( v, pb_3 ), _mm256_cmpeq_epi8( z, zero ) ) );
+        if( escape )
+        {
+            int i = x264_ctz( escape );
+            dst += i;
+            src += i+1;
+        }
+        else
+        {
+            dst += 32;
+            src += 32;
+        }
+    }
+    while( src < end )
+    {
+        if( src[0] == 0x03 && !src[-2] && !src[-1] )
+            src++;
+        else
+            *dst++ = *src++;
+    }
+    return dst;
+}
+
+/****************************************************************************
+ * mc: polyphase scaler passes
+ ****************************************************************************/
+
+#if !HIGH_BIT_DEPTH
+
+/* As asm_scale_h_sse2, eight outputs per iteration, up to 7 past i_width.
+ * The windows go in as 0,1,4,5 and 2,3,6,7 so that the in-lane phaddd
+ * leaves the sums in order. */
+void asm_scale_h_avx2( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width )
+{
+    for( int x = 0; x < i_width; x += 8, coef += 8*i_taps )
+    {
+        pixel *s[8];
+        __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+        for( int i = 0; i < 8; i++ )
+            s[i] = src + pos[x+i];
+        for( int j = 0; j < i_taps; j += 4 )
+        {
+            __m256i p0 = _mm256_cvtepu8_epi16( _mm_setr_epi32( M32( s[0]+j ), M32( s[1]+j ), M32( s[4]+j ), M32( s[5]+j ) ) );
+            __m256i p1 = _mm256_cvtepu8_epi16( _mm_setr_epi32( M32( s[2]+j ), M32( s[3]+j ), M32( s[6]+j ), M32( s[7]+j ) ) );
+            __m256i c0 = _mm256_setr_epi64x( M64( coef+0*i_taps+j ), M64( coef+1*i_taps+j ),
+                                             M64( coef+4*i_taps+j ), M64( coef+5*i_taps+j ) );
+            __m256i c1 = _mm256_setr_epi64x( M64( coef+2*i_taps+j ), M64( coef+3*i_taps+j ),
+                                             M64( coef+6*i_taps+j ), M64( coef+7*i_taps+j ) );
+            acc0 = _mm256_add_epi32( acc0, _mm256_madd_epi16( p0, c0 ) );
+            acc1 = _mm256_add_epi32( acc1, _mm256_madd_epi16( p1, c1 ) );
+        }
+        __m256i sum = _mm256_hadd_epi32( acc0, acc1 );
+        sum = _mm256_srai_epi32( _mm256_add_epi32( sum, _mm256_set1_epi32( 128 ) ), 8 );
+        _mm_storeu_si128( (__m128i*)(dst+x), _mm_packs_epi32( _mm256_castsi256_si128( sum ),
+                                                              _mm256_extracti128_si256( sum, 1 ) ) );
+    }
+}
+
+/* As asm_scale_v_sse2, one ymm of 16 pixels per row: the in-lane
+ * unpacks and packs cancel out, so the result comes out in order. */
+void asm_scale_v_avx2( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width )
+{
+    const __m256i round = _mm256_set1_epi32( 1 << 17 );
+
+    for( int x = 0; x < i_width; x += 16 )
+    {
+        __m256i acc0 = round, acc1 = round;
+        for( int j = 0; j < i_taps; j += 2 )
+        {
+            __m256i c = _mm256_set1_epi32( (uint16_t)coef[j] | (uint32_t)coef[j+1] << 16 );
+            __m256i a = _mm256_loadu_si256( (__m256i*)(src[j]+x) );
+            __m256i b = _mm256_loadu_si256( (__m256i*)(src[j+1]+x) );
+            acc0 = _mm256_add_epi32( acc0, _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), c ) );
+            acc1 = _mm256_add_epi32( acc1, _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), c ) );
+        }
+        __m256i sum = _mm256_packs_epi32( _mm256_srai_epi32( acc0, 18 ), _mm256_srai_epi32( acc1, 18 ) );
+        _mm_storeu_si128( (__m128i*)(dst+x), _mm_packus_epi16( _mm256_castsi256_si128( sum ),
+                                                               _mm256_extracti128_si256( sum, 1 ) ) );
+    }
+}
+
+#endif
+
+/****************************************************************************
+ * mc: mbtree_propagate_list
+ ****************************************************************************/
+
+/* The first pass of PROPAGATE_LIST (c_kernels/mc.h): per 8 MBs, their
+ * {mbx, mby}, then idx0/idx1 and idx2/idx3 weight pairs, 48 words.
+ * One MB per dword: x, y and the amount sit in the low word with a zero
+ * high word, so pmaddwd gives the exact 32-bit products the C rounds,
+ * with no room for the 32768 overflow of the pmulhrsw version. */
+void asm_mbtree_propagate_list_internal_avx2( int16_t (*mvs)[2], int16_t *propagate_amount,
+                                              uint16_t *lowres_costs, int16_t *output,
+                                              int bipred_weight, int mb_y, int len )
+{
+    const __m256i pd_31 = _mm256_set1_epi32( 31 );
+    const __m256i pd_32 = _mm256_set1_epi32( 32 );
+    const __m256i pd_3  = _mm256_set1_epi32( 3 );
+    const __m256i round = _mm256_set1_epi32( 512 );
+    const __m256i bipred = _mm256_set1_epi32( bipred_weight );
+    __m256i mbxy = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+
+    mbxy = _mm256_add_epi16( mbxy, _mm256_set1_epi32( mb_y << 16 ) );
+    for( int i = 0; i < len; i += 8, output += 48 )
+    {
+        __m256i mv = _mm256_loadu_si256( (__m256i*)mvs[i] );
+        __m256i amount = _mm256_cvtepu16_epi32( _mm_loadu_si128( (__m128i*)(propagate_amount+i) ) );
+        __m256i lists = _mm256_cvtepu16_epi32( _mm_loadu_si128( (__m128i*)(lowres_costs+i) ) );
+        /* if( lists_used == 3 )
+         *     propagate_amount = (propagate_amount * bipred_weight + 32) >> 6 */
+        __m256i bi = _mm256_cmpeq_epi32( _mm256_srli_epi32( lists, LOWRES_COST_SHIFT ), pd_3 );
+        __m256i biamount = _mm256_srli_epi32( _mm256_add_epi32( _mm256_madd_epi16( amount, bipred ), pd_32 ), 6 );
+        amount = _mm256_blendv_epi8( amount, biamount, bi );
+
+        _mm256_storeu_si256( (__m256i*)output, _mm256_add_epi16( _mm256_srai_epi16( mv, 5 ), mbxy ) );
+        mbxy = _mm256_add_epi16( mbxy, _mm256_set1_epi32( 8 ) );
+
+        __m256i x = _mm256_and_si256( mv, pd_31 );
+        __m256i y = _mm256_and_si256( _mm256_srli_epi32( mv, 16 ), pd_31 );
+        __m256i x1 = _mm256_sub_epi32( pd_32, x );
+        __m256i y1 = _mm256_sub_epi32( pd_32, y );
+        __m256i idx0 = _mm256_madd_epi16( _mm256_mullo_epi16( y1, x1 ), amount );
+        __m256i idx1 = _mm256_madd_epi16( _mm256_mullo_epi16( y1, x ), amount );
+        __m256i idx2 = _mm256_madd_epi16( _mm256_mullo_epi16( y, x1 ), amount );
+        __m256i idx3 = _mm256_madd_epi16( _mm256_mullo_epi16( y, x ), amount );
+        idx0 = _mm256_srli_epi32( _mm256_add_epi32( idx0, round ), 10 );
+        idx1 = _mm256_srli_epi32( _mm256_add_epi32( idx1, round ), 10 );
+        idx2 = _mm256_srli_epi32( _mm256_add_epi32( idx2, round ), 10 );
+        idx3 = _mm256_srli_epi32( _mm256_add_epi32( idx3, round ), 10 );
+        _mm256_storeu_si256( (__m256i*)(output+16), _mm256_or_si256( idx0, _mm256_slli_epi32( idx1, 16 ) ) );
+        _mm256_storeu_si256( (__m256i*)(output+32), _mm256_or_si256( idx2, _mm256_slli_epi32( idx3, 16 ) ) );
+    }
+}
+
+#endif
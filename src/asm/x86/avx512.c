@@ -0,0 +1,448 @@
+/*****************************************************************************
+ * avx512.c: AVX-512 kernels
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+/* The AVX-512 (F, CD, BW, DQ, VL) tier, written with intrinsics since
+ * yasm and x86inc.asm have no EVEX encodings.  Only built with
+ * -mavx512*, see the Makefile; every function here is bit-exact with the
+ * C kernel it replaces. */
+
+#include <immintrin.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/pixel.h"
+#include "asm/x86/dct.h"
+#include "asm/x86/quant.h"
+
+#if HAVE_MMX && ARCH_X86_64 && !HIGH_BIT_DEPTH
+
+/* x - t in the lanes of mask, x + t in the others: one butterfly stage,
+ * t holding each lane's partner */
+#define BUTTERFLY( x, t, mask ) _mm512_mask_sub_epi16( _mm512_add_epi16( x, t ), mask, t, x )
+
+/****************************************************************************
+ * pixel: sad_x4, satd, sa8d
+ ****************************************************************************/
+
+static ALWAYS_INLINE __m128i load_w16( pixel *pix, intptr_t stride )
+{
+    return _mm_loadu_si128( (__m128i*)pix );
+}
+
+/* two rows of 8 */
+static ALWAYS_INLINE __m128i load_w8( pixel *pix, intptr_t stride )
+{
+    return _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)pix ), _mm_loadl_epi64( (__m128i*)(pix+stride) ) );
+}
+
+/* the 128-bit lane i of the source i, 16 pixels of fenc in each */
+#define SAD_X4( w, h )\
+void asm_pixel_sad_x4_##w##x##h##_avx512( pixel *fenc, pixel *pix0, pixel *pix1, pixel *pix2, pixel *pix3,\
+                                          intptr_t i_stride, int *scores )\
+{\
+    __m512i sum = _mm512_setzero_si512();\
+    for( int y = 0; y < h; y += 16/w )\
+    {\
+        __m512i e = _mm512_broadcast_i32x4( load_w##w( fenc+y*FENC_STRIDE, FENC_STRIDE ) );\
+        __m512i r = _mm512_castsi128_si512( load_w##w( pix0+y*i_stride, i_stride ) );\
+        r = _mm512_inserti32x4( r, load_w##w( pix1+y*i_stride, i_stride ), 1 );\
+        r = _mm512_inserti32x4( r, load_w##w( pix2+y*i_stride, i_stride ), 2 );\
+        r = _mm512_inserti32x4( r, load_w##w( pix3+y*i_stride, i_stride ), 3 );\
+        sum = _mm512_add_epi32( sum, _mm512_sad_epu8( r, e ) );\
+    }\
+    sum = _mm512_add_epi32( sum, _mm512_shuffle_epi32( sum, _MM_PERM_BADC ) );\
+    __m256i s = _mm256_permutevar8x32_epi32( _mm512_cvtepi64_epi32( sum ), _mm256_setr_epi32( 0, 2, 4, 6, 0, 2, 4, 6 ) );\
+    _mm_storeu_si128( (__m128i*)scores, _mm256_castsi256_si128( s ) );\
+}
+
+SAD_X4( 16, 16 )
+SAD_X4( 16, 8 )
+SAD_X4( 8, 16 )
+SAD_X4( 8, 8 )
+
+/* 4 rows of 8 pixels widened to words, row i in the 128-bit lane i */
+static ALWAYS_INLINE __m512i load_8x4( pixel *pix, intptr_t stride )
+{
+    __m128i r01 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)pix ), _mm_loadl_epi64( (__m128i*)(pix+stride) ) );
+    __m128i r23 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)(pix+2*stride) ), _mm_loadl_epi64( (__m128i*)(pix+3*stride) ) );
+    return _mm512_cvtepu8_epi16( _mm256_inserti128_si256( _mm256_castsi128_si256( r01 ), r23, 1 ) );
+}
+
+/* 4x4 hadamard of the two blocks side by side in an 8x4: across the word
+ * pairs and dword pairs of a row, then across the rows */
+static ALWAYS_INLINE __m512i hadamard_8x4( __m512i d )
+{
+    d = BUTTERFLY( d, _mm512_rol_epi32( d, 16 ), 0xAAAAAAAA );
+    d = BUTTERFLY( d, _mm512_shuffle_epi32( d, _MM_PERM_CDAB ), 0xCCCCCCCC );
+    d = BUTTERFLY( d, _mm512_shuffle_i32x4( d, d, _MM_SHUFFLE( 2,3,0,1 ) ), 0xFF00FF00 );
+    d = BUTTERFLY( d, _mm512_shuffle_i32x4( d, d, _MM_SHUFFLE( 1,0,3,2 ) ), 0xFFFF0000 );
+    return d;
+}
+
+static ALWAYS_INLINE __m512i sum_abs( __m512i sum, __m512i d )
+{
+    return _mm512_add_epi32( sum, _mm512_madd_epi16( _mm512_abs_epi16( d ), _mm512_set1_epi16( 1 ) ) );
+}
+
+/* every 4x4 sum is even, so halving the total is the sum of the halves */
+#define SATD( w, h )\
+int asm_pixel_satd_##w##x##h##_avx512( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )\
+{\
+    __m512i sum = _mm512_setzero_si512();\
+    for( int y = 0; y < h; y += 4 )\
+        for( int x = 0; x < w; x += 8 )\
+        {\
+            __m512i d = _mm512_sub_epi16( load_8x4( pix1+y*i_pix1+x, i_pix1 ), load_8x4( pix2+y*i_pix2+x, i_pix2 ) );\
+            sum = sum_abs( sum, hadamard_8x4( d ) );\
+        }\
+    return _mm512_reduce_add_epi32( sum ) >> 1;\
+}
+
+SATD( 16, 16 )
+SATD( 16, 8 )
+SATD( 8, 16 )
+SATD( 8, 8 )
+
+/* the unnormalized sum of the 8x8 hadamard: the 4x4 one, the last
+ * horizontal stage across the dword pairs, the last vertical between the
+ * top and bottom halves */
+static ALWAYS_INLINE __m512i sa8d_8x8_sum( __m512i sum, pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    __m512i a = _mm512_sub_epi16( load_8x4( pix1, i_pix1 ), load_8x4( pix2, i_pix2 ) );
+    __m512i b = _mm512_sub_epi16( load_8x4( pix1+4*i_pix1, i_pix1 ), load_8x4( pix2+4*i_pix2, i_pix2 ) );
+    a = hadamard_8x4( a );
+    b = hadamard_8x4( b );
+    a = BUTTERFLY( a, _mm512_shuffle_epi32( a, _MM_PERM_BADC ), 0xF0F0F0F0 );
+    b = BUTTERFLY( b, _mm512_shuffle_epi32( b, _MM_PERM_BADC ), 0xF0F0F0F0 );
+    sum = sum_abs( sum, _mm512_add_epi16( a, b ) );
+    return sum_abs( sum, _mm512_sub_epi16( a, b ) );
+}
+
+int asm_pixel_sa8d_8x8_avx512( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    __m512i sum = sa8d_8x8_sum( _mm512_setzero_si512(), pix1, i_pix1, pix2, i_pix2 );
+    return (_mm512_reduce_add_epi32( sum ) + 2) >> 2;
+}
+
+int asm_pixel_sa8d_16x16_avx512( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    __m512i sum = sa8d_8x8_sum( _mm512_setzero_si512(), pix1, i_pix1, pix2, i_pix2 );
+    sum = sa8d_8x8_sum( sum, pix1+8, i_pix1, pix2+8, i_pix2 );
+    sum = sa8d_8x8_sum( sum, pix1+8*i_pix1, i_pix1, pix2+8*i_pix2, i_pix2 );
+    sum = sa8d_8x8_sum( sum, pix1+8+8*i_pix1, i_pix1, pix2+8+8*i_pix2, i_pix2 );
+    return (_mm512_reduce_add_epi32( sum ) + 2) >> 2;
+}
+
+/****************************************************************************
+ * dct: sub16x16_dct
+ ****************************************************************************/
+
+/* word permutes within each group of 4 lanes, and the transpose of two
+ * 4x4 blocks from an 8x4 (row, block, column) to (block, column, row) */
+static const uint16_t dct_rev[32] =
+    { 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,19,18,17,16,23,22,21,20,27,26,25,24,31,30,29,28 };
+static const uint16_t dct_a[32] =
+    { 0,3,0,3,4,7,4,7,8,11,8,11,12,15,12,15,16,19,16,19,20,23,20,23,24,27,24,27,28,31,28,31 };
+static const uint16_t dct_b[32] =
+    { 1,2,1,2,5,6,5,6,9,10,9,10,13,14,13,14,17,18,17,18,21,22,21,22,25,26,25,26,29,30,29,30 };
+static const uint16_t dct_transpose[32] =
+    { 0,8,16,24,1,9,17,25,2,10,18,26,3,11,19,27,4,12,20,28,5,13,21,29,6,14,22,30,7,15,23,31 };
+
+/* the 1-D transform of sub4x4_dct on each group of 4 lanes:
+ * s03+s12, 2*d03+d12, s03-s12, d03-2*d12 */
+static ALWAYS_INLINE __m512i dct4_epi16( __m512i x )
+{
+    __m512i t = _mm512_permutexvar_epi16( _mm512_loadu_si512( dct_rev ), x );
+    x = BUTTERFLY( x, t, 0xCCCCCCCC );  /* s03, s12, d12, d03 */
+    __m512i a = _mm512_permutexvar_epi16( _mm512_loadu_si512( dct_a ), x );
+    __m512i b = _mm512_permutexvar_epi16( _mm512_loadu_si512( dct_b ), x );
+    a = _mm512_mask_add_epi16( a, 0x22222222, a, a );
+    b = _mm512_mask_add_epi16( b, 0x88888888, b, b );
+    return _mm512_mask_sub_epi16( _mm512_add_epi16( a, b ), 0xCCCCCCCC, a, b );
+}
+
+/* two 4x4 blocks side by side, as dct[0] and dct[1] of sub8x8_dct */
+static ALWAYS_INLINE void sub8x4_dct( int16_t dct[2][16], uint8_t *pix1, uint8_t *pix2 )
+{
+    __m512i d = _mm512_sub_epi16( load_8x4( pix1, FENC_STRIDE ), load_8x4( pix2, FDEC_STRIDE ) );
+    d = dct4_epi16( d );
+    d = _mm512_permutexvar_epi16( _mm512_loadu_si512( dct_transpose ), d );
+    _mm512_storeu_si512( dct, dct4_epi16( d ) );
+}
+
+void asm_sub16x16_dct_avx512( int16_t dct[16][16], uint8_t *pix1, uint8_t *pix2 )
+{
+    for( int i = 0; i < 8; i++ )
+    {
+        int x = 8*((i>>1)&1);
+        int y = 8*(i>>2) + 4*(i&1);
+        sub8x4_dct( &dct[2*i], pix1+x+y*FENC_STRIDE, pix2+x+y*FDEC_STRIDE );
+    }
+}
+
+/****************************************************************************
+ * quant: quant_4x4x4
+ ****************************************************************************/
+
+/* two blocks per register; QUANT_ONE as the other asm, the sum saturated
+ * before the multiply */
+int asm_quant_4x4x4_avx512( dctcoef dct[4][16], udctcoef mf[16], udctcoef bias[16] )
+{
+    __m512i mf2 = _mm512_broadcast_i64x4( _mm256_loadu_si256( (__m256i*)mf ) );
+    __m512i bias2 = _mm512_broadcast_i64x4( _mm256_loadu_si256( (__m256i*)bias ) );
+    __m512i zero = _mm512_setzero_si512();
+    int nza = 0;
+    for( int j = 0; j < 4; j += 2 )
+    {
+        __m512i coef = _mm512_loadu_si512( dct[j] );
+        __m512i q = _mm512_mulhi_epu16( _mm512_adds_epu16( _mm512_abs_epi16( coef ), bias2 ), mf2 );
+        q = _mm512_mask_sub_epi16( q, _mm512_cmple_epi16_mask( coef, zero ), zero, q );
+        _mm512_storeu_si512( dct[j], q );
+        __mmask32 nz = _mm512_test_epi16_mask( q, q );
+        nza |= !!(nz&0xFFFF) << j | !!(nz>>16) << (j+1);
+    }
+    return nza;
+}
+
+/****************************************************************************
+ * mc: hpel_filter, mbtree_propagate_cost
+ ****************************************************************************/
+
+static ALWAYS_INLINE __mmask32 tail_mask32( int n )
+{
+    return n >= 32 ? 0xFFFFFFFF : ((__mmask32)1 << n) - 1;
+}
+
+static ALWAYS_INLINE __m512i loadu8_mask( __mmask32 k, pixel *pix )
+{
+    return _mm512_cvtepu8_epi16( _mm256_maskz_loadu_epi8( k, pix ) );
+}
+
+/* vbench_clip_pixel and store */
+static ALWAYS_INLINE void storeu8_mask( pixel *pix, __mmask32 k, __m512i v )
+{
+    _mm256_mask_storeu_epi8( pix, k, _mm512_cvtusepi16_epi8( _mm512_max_epi16( v, _mm512_setzero_si512() ) ) );
+}
+
+/* TAPFILTER: a+f - 5*(b+e) + 20*(c+d) */
+static ALWAYS_INLINE __m512i tapfilter_epi16( __m512i a, __m512i b, __m512i c, __m512i d, __m512i e, __m512i f )
+{
+    __m512i t = _mm512_sub_epi16( _mm512_add_epi16( a, f ), _mm512_mullo_epi16( _mm512_add_epi16( b, e ), _mm512_set1_epi16( 5 ) ) );
+    return _mm512_add_epi16( t, _mm512_mullo_epi16( _mm512_add_epi16( c, d ), _mm512_set1_epi16( 20 ) ) );
+}
+
+/* the centre filter runs on the vertical one's output, out of the range
+ * of words: (af - 5*be + 20*cd + 512) >> 10 in dwords */
+static ALWAYS_INLINE __m256i tapfilter2_epi32( __m256i af, __m256i be, __m256i cd )
+{
+    __m512i t = _mm512_sub_epi32( _mm512_cvtepi16_epi32( af ), _mm512_mullo_epi32( _mm512_cvtepi16_epi32( be ), _mm512_set1_epi32( 5 ) ) );
+    t = _mm512_add_epi32( t, _mm512_mullo_epi32( _mm512_cvtepi16_epi32( cd ), _mm512_set1_epi32( 20 ) ) );
+    return _mm512_cvtsepi32_epi16( _mm512_srai_epi32( _mm512_add_epi32( t, _mm512_set1_epi32( 512 ) ), 10 ) );
+}
+
+void asm_hpel_filter_avx512( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t *src, intptr_t stride, int width, int height, int16_t *buf )
+{
+    for( int y = 0; y < height; y++ )
+    {
+        for( int x = -2; x < width+3; x += 32 )
+        {
+            __mmask32 k = tail_mask32( width+3-x );
+            pixel *s = src+x;
+            __m512i v = tapfilter_epi16( loadu8_mask( k, s-2*stride ), loadu8_mask( k, s-stride ),
+                                         loadu8_mask( k, s ), loadu8_mask( k, s+stride ),
+                                         loadu8_mask( k, s+2*stride ), loadu8_mask( k, s+3*stride ) );
+            storeu8_mask( dstv+x, k, _mm512_srai_epi16( _mm512_add_epi16( v, _mm512_set1_epi16( 16 ) ), 5 ) );
+            _mm512_mask_storeu_epi16( buf+x+2, k, v );
+        }
+        for( int x = 0; x < width; x += 32 )
+        {
+            __mmask32 k = tail_mask32( width-x );
+            int16_t *b = buf+x;
+            __m512i af = _mm512_add_epi16( _mm512_maskz_loadu_epi16( k, b ), _mm512_maskz_loadu_epi16( k, b+5 ) );
+            __m512i be = _mm512_add_epi16( _mm512_maskz_loadu_epi16( k, b+1 ), _mm512_maskz_loadu_epi16( k, b+4 ) );
+            __m512i cd = _mm512_add_epi16( _mm512_maskz_loadu_epi16( k, b+2 ), _mm512_maskz_loadu_epi16( k, b+3 ) );
+            __m256i lo = tapfilter2_epi32( _mm512_castsi512_si256( af ), _mm512_castsi512_si256( be ), _mm512_castsi512_si256( cd ) );
+            __m256i hi = tapfilter2_epi32( _mm512_extracti64x4_epi64( af, 1 ), _mm512_extracti64x4_epi64( be, 1 ),
+                                           _mm512_extracti64x4_epi64( cd, 1 ) );
+            storeu8_mask( dstc+x, k, _mm512_inserti64x4( _mm512_castsi256_si512( lo ), hi, 1 ) );
+        }
+        for( int x = 0; x < width; x += 32 )
+        {
+            __mmask32 k = tail_mask32( width-x );
+            pixel *s = src+x;
+            __m512i h = tapfilter_epi16( loadu8_mask( k, s-2 ), loadu8_mask( k, s-1 ), loadu8_mask( k, s ),
+                                         loadu8_mask( k, s+1 ), loadu8_mask( k, s+2 ), loadu8_mask( k, s+3 ) );
+            storeu8_mask( dsth+x, k, _mm512_srai_epi16( _mm512_add_epi16( h, _mm512_set1_epi16( 16 ) ), 5 ) );
+        }
+        dsth += stride;
+        dstv += stride;
+        dstc += stride;
+        src += stride;
+    }
+}
+
+/* the C in single precision, propagate_in + intra*fps fused as the
+ * compiler contracts it; the (int) of the NaN of an intra cost of 0
+ * truncated to 16 bits as the store of C */
+void asm_mbtree_propagate_cost_avx512( int16_t *dst, uint16_t *propagate_in, uint16_t *intra_costs,
+                                       uint16_t *inter_costs, uint16_t *inv_qscales, float *fps_factor, int len )
+{
+    __m512 fps = _mm512_set1_ps( *fps_factor );
+    for( int i = 0; i < len; i += 16 )
+    {
+        __mmask16 k = len-i >= 16 ? 0xFFFF : (1 << (len-i)) - 1;
+        __m512i intra = _mm512_cvtepu16_epi32( _mm256_maskz_loadu_epi16( k, intra_costs+i ) );
+        __m512i inter = _mm512_cvtepu16_epi32( _mm256_maskz_loadu_epi16( k, inter_costs+i ) );
+        __m512i qscale = _mm512_cvtepu16_epi32( _mm256_maskz_loadu_epi16( k, inv_qscales+i ) );
+        __m512i in = _mm512_cvtepu16_epi32( _mm256_maskz_loadu_epi16( k, propagate_in+i ) );
+        inter = _mm512_min_epi32( intra, _mm512_and_si512( inter, _mm512_set1_epi32( LOWRES_COST_MASK ) ) );
+        __m512 amount = _mm512_fmadd_ps( _mm512_cvtepi32_ps( _mm512_mullo_epi32( intra, qscale ) ), fps,
+                                         _mm512_cvtepi32_ps( in ) );
+        __m512 num = _mm512_cvtepi32_ps( _mm512_sub_epi32( intra, inter ) );
+        __m512 r = _mm512_div_ps( _mm512_mul_ps( amount, num ), _mm512_cvtepi32_ps( intra ) );
+        __m512i res = _mm512_cvttps_epi32( _mm512_add_ps( r, _mm512_set1_ps( 0.5f ) ) );
+        res = _mm512_min_epi32( res, _mm512_set1_epi32( 32767 ) );
+        _mm256_mask_storeu_epi16( dst+i, k, _mm512_cvtepi32_epi16( res ) );
+    }
+}
+
+/****************************************************************************
+ * deblock: deblock_luma
+ ****************************************************************************/
+
+/* deblock_edge_luma_c on the 16 pixels of an edge, in words */
+static ALWAYS_INLINE void deblock_edge_luma_16( __m256i p2, __m256i *p1, __m256i *p0, __m256i *q0, __m256i *q1, __m256i q2,
+                                                int alpha, int beta, __m256i tc0 )
+{
+    __m256i zero = _mm256_setzero_si256();
+    __m256i one = _mm256_set1_epi16( 1 );
+    __m256i vbeta = _mm256_set1_epi16( beta );
+    __mmask16 m = _mm256_cmplt_epi16_mask( _mm256_abs_epi16( _mm256_sub_epi16( *p0, *q0 ) ), _mm256_set1_epi16( alpha ) )
+                & _mm256_cmplt_epi16_mask( _mm256_abs_epi16( _mm256_sub_epi16( *p1, *p0 ) ), vbeta )
+                & _mm256_cmplt_epi16_mask( _mm256_abs_epi16( _mm256_sub_epi16( *q1, *q0 ) ), vbeta )
+                & _mm256_cmpge_epi16_mask( tc0, zero );
+    __mmask16 mp = m & _mm256_cmplt_epi16_mask( _mm256_abs_epi16( _mm256_sub_epi16( p2, *p0 ) ), vbeta );
+    __mmask16 mq = m & _mm256_cmplt_epi16_mask( _mm256_abs_epi16( _mm256_sub_epi16( q2, *q0 ) ), vbeta );
+    __m256i ntc0 = _mm256_sub_epi16( zero, tc0 );
+    __m256i tc = _mm256_mask_add_epi16( tc0, mp, tc0, one );
+    tc = _mm256_mask_add_epi16( tc, mq, tc, one );
+
+    __m256i delta = _mm256_add_epi16( _mm256_slli_epi16( _mm256_sub_epi16( *q0, *p0 ), 2 ), _mm256_sub_epi16( *p1, *q1 ) );
+    delta = _mm256_srai_epi16( _mm256_add_epi16( delta, _mm256_set1_epi16( 4 ) ), 3 );
+    delta = _mm256_min_epi16( _mm256_max_epi16( delta, _mm256_sub_epi16( zero, tc ) ), tc );
+
+    __m256i avg = _mm256_avg_epu16( *p0, *q0 );
+    __m256i dp = _mm256_sub_epi16( _mm256_srli_epi16( _mm256_add_epi16( p2, avg ), 1 ), *p1 );
+    __m256i dq = _mm256_sub_epi16( _mm256_srli_epi16( _mm256_add_epi16( q2, avg ), 1 ), *q1 );
+    dp = _mm256_min_epi16( _mm256_max_epi16( dp, ntc0 ), tc0 );
+    dq = _mm256_min_epi16( _mm256_max_epi16( dq, ntc0 ), tc0 );
+    *p1 = _mm256_mask_add_epi16( *p1, mp, *p1, dp );
+    *q1 = _mm256_mask_add_epi16( *q1, mq, *q1, dq );
+
+    __m256i pmax = _mm256_set1_epi16( PIXEL_MAX );
+    *p0 = _mm256_mask_mov_epi16( *p0, m, _mm256_min_epi16( _mm256_max_epi16( _mm256_add_epi16( *p0, delta ), zero ), pmax ) );
+    *q0 = _mm256_mask_mov_epi16( *q0, m, _mm256_min_epi16( _mm256_max_epi16( _mm256_sub_epi16( *q0, delta ), zero ), pmax ) );
+}
+
+/* tc0[i] in the lanes 4*i to 4*i+3 */
+static ALWAYS_INLINE __m256i deblock_tc0_16( int8_t *tc0 )
+{
+    __m128i t = _mm_shuffle_epi8( _mm_cvtsi32_si128( M32( tc0 ) ), _mm_set_epi8( 3,3,3,3,2,2,2,2,1,1,1,1,0,0,0,0 ) );
+    return _mm256_cvtepi8_epi16( t );
+}
+
+static ALWAYS_INLINE __m256i load_16x1( pixel *pix )
+{
+    return _mm256_cvtepu8_epi16( _mm_loadu_si128( (__m128i*)pix ) );
+}
+
+static ALWAYS_INLINE void store_16x1( pixel *pix, __m256i v )
+{
+    _mm_storeu_si128( (__m128i*)pix, _mm256_cvtepi16_epi8( v ) );
+}
+
+void asm_deblock_v_luma_avx512( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 )
+{
+    __m256i p1 = load_16x1( pix-2*stride );
+    __m256i p0 = load_16x1( pix-stride );
+    __m256i q0 = load_16x1( pix );
+    __m256i q1 = load_16x1( pix+stride );
+    deblock_edge_luma_16( load_16x1( pix-3*stride ), &p1, &p0, &q0, &q1, load_16x1( pix+2*stride ),
+                          alpha, beta, deblock_tc0_16( tc0 ) );
+    store_16x1( pix-2*stride, p1 );
+    store_16x1( pix-stride, p0 );
+    store_16x1( pix, q0 );
+    store_16x1( pix+stride, q1 );
+}
+
+/* the 8 columns p3..q3 of 16 rows transposed to one register each, back
+ * to rows for the 4 the filter changes */
+void asm_deblock_h_luma_avx512( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 )
+{
+    __m128i r[16], t[8], u[8], w[8], c[8];
+    for( int i = 0; i < 16; i++ )
+        r[i] = _mm_loadl_epi64( (__m128i*)(pix-4+i*stride) );
+    for( int i = 0; i < 8; i++ )
+        t[i] = _mm_unpacklo_epi8( r[2*i], r[2*i+1] );
+    for( int i = 0; i < 4; i++ )
+    {
+        u[2*i]   = _mm_unpacklo_epi16( t[2*i], t[2*i+1] );
+        u[2*i+1] = _mm_unpackhi_epi16( t[2*i], t[2*i+1] );
+    }
+    for( int g = 0; g < 2; g++ )
+    {
+        w[4*g+0] = _mm_unpacklo_epi32( u[4*g],   u[4*g+2] );
+        w[4*g+1] = _mm_unpackhi_epi32( u[4*g],   u[4*g+2] );
+        w[4*g+2] = _mm_unpacklo_epi32( u[4*g+1], u[4*g+3] );
+        w[4*g+3] = _mm_unpackhi_epi32( u[4*g+1], u[4*g+3] );
+    }
+    for( int i = 0; i < 4; i++ )
+    {
+        c[2*i]   = _mm_unpacklo_epi64( w[i], w[4+i] );
+        c[2*i+1] = _mm_unpackhi_epi64( w[i], w[4+i] );
+    }
+
+    __m256i p1 = _mm256_cvtepu8_epi16( c[2] );
+    __m256i p0 = _mm256_cvtepu8_epi16( c[3] );
+    __m256i q0 = _mm256_cvtepu8_epi16( c[4] );
+    __m256i q1 = _mm256_cvtepu8_epi16( c[5] );
+    deblock_edge_luma_16( _mm256_cvtepu8_epi16( c[1] ), &p1, &p0, &q0, &q1, _mm256_cvtepu8_epi16( c[6] ),
+                          alpha, beta, deblock_tc0_16( tc0 ) );
+
+    __m128i a0 = _mm256_cvtepi16_epi8( p1 );
+    __m128i a1 = _mm256_cvtepi16_epi8( p0 );
+    __m128i b0 = _mm256_cvtepi16_epi8( q0 );
+    __m128i b1 = _mm256_cvtepi16_epi8( q1 );
+    __m128i lo = _mm_unpacklo_epi8( a0, a1 );
+    __m128i hi = _mm_unpackhi_epi8( a0, a1 );
+    __m128i lo2 = _mm_unpacklo_epi8( b0, b1 );
+    __m128i hi2 = _mm_unpackhi_epi8( b0, b1 );
+    DECLARE_ALIGNED( uint32_t out[16], 16 );
+    _mm_store_si128( (__m128i*)(out+ 0), _mm_unpacklo_epi16( lo, lo2 ) );
+    _mm_store_si128( (__m128i*)(out+ 4), _mm_unpackhi_epi16( lo, lo2 ) );
+    _mm_store_si128( (__m128i*)(out+ 8), _mm_unpacklo_epi16( hi, hi2 ) );
+    _mm_store_si128( (__m128i*)(out+12), _mm_unpackhi_epi16( hi, hi2 ) );
+    for( int i = 0; i < 16; i++ )
+        M32( pix-2+i*stride ) = out[i];
+}
+
+#endif // HAVE_MMX && ARCH_X86_64 && !HIGH_BIT_DEPTH
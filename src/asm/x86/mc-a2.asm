@@ -2234,11 +2234,8 @@ cglobal mbtree_propagate_list_internal, 4,6,8
     pmullw   m0, m1        ; idx3weight = y*x << 5
     pmullw   m1, m3        ; idx2weight = y*(32-x) << 5
 
-    ; avoid overflow in the input to pmulhrsw
-    psrlw    m3, m2, 15
-    psubw    m2, m3        ; idx0weight -= (idx0weight == 32768)
-
     pmulhrsw m2, m5        ; idx0weight * propagate_amount + 512 >> 10
+    pabsw    m2, m2        ; idx0weight == 32768 wraps to -32768 and yields -propagate_amount
     pmulhrsw m4, m5        ; idx1weight * propagate_amount + 512 >> 10
     pmulhrsw m1, m5        ; idx2weight * propagate_amount + 512 >> 10
     pmulhrsw m0, m5        ; idx3weight * propagate_amount + 512 >> 10
@@ -33,6 +33,7 @@
 #include "common.h"
 #include "bench.h"
 #include "asm/x86/mc.h"
+#include "c_kernels/mc.h"
 
 
 extern const uint8_t vbench_hpel_ref0[16];
@@ -180,6 +181,8 @@ void asm_mbtree_propagate_cost_fma4( int16_t *dst, uint16_t *propagate_in, uint1
                                       uint16_t *inter_costs, uint16_t *inv_qscales, float *fps_factor, int len );
 void asm_mbtree_propagate_cost_avx2( int16_t *dst, uint16_t *propagate_in, uint16_t *intra_costs,
                                       uint16_t *inter_costs, uint16_t *inv_qscales, float *fps_factor, int len );
+void asm_mbtree_propagate_cost_avx512( int16_t *dst, uint16_t *propagate_in, uint16_t *intra_costs,
+                                       uint16_t *inter_costs, uint16_t *inv_qscales, float *fps_factor, int len );
 
 #define MC_CHROMA(cpu)\
 void asm_mc_chroma_##cpu( pixel *dstu, pixel *dstv, intptr_t i_dst, pixel *src, intptr_t i_src,\
@@ -492,6 +495,7 @@ void asm_hpel_filter_sse2 ( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t
 void asm_hpel_filter_ssse3( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t *src, intptr_t stride, int width, int height, int16_t *buf );
 void asm_hpel_filter_avx  ( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t *src, intptr_t stride, int width, int height, int16_t *buf );
 void asm_hpel_filter_avx2 ( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t *src, intptr_t stride, int width, int height, int16_t *buf );
+void asm_hpel_filter_avx512( uint8_t *dsth, uint8_t *dstv, uint8_t *dstc, uint8_t *src, intptr_t stride, int width, int height, int16_t *buf );
 #else
 HPEL(16, sse2, sse2, sse2, sse2)
 HPEL(16, ssse3, ssse3, ssse3, ssse3)
@@ -625,77 +629,40 @@ do\
         :"m"(M32(x))\
     );\
 } while(0)
-#endif
 
-#define PROPAGATE_LIST(cpu)\
-        void asm_mbtree_propagate_list_internal_##cpu( int16_t (*mvs)[2], int16_t *propagate_amount,\
-                uint16_t *lowres_costs, int16_t *output,\
-                int bipred_weight, int mb_y, int len );\
-    \
-    static void asm_mbtree_propagate_list_##cpu( uint16_t *ref_costs, int16_t (*mvs)[2],\
-            int16_t *propagate_amount, uint16_t *lowres_costs,\
-            int bipred_weight, int mb_y, int len, int list, unsigned stride, unsigned width, unsigned height, void *buffer2  )\
+#undef MC_CLIP_ADD_RUN
+#define MC_CLIP_ADD_RUN(s,x)\
+do\
 {\
-    int16_t *current = buffer2;\
-    \
-    asm_mbtree_propagate_list_internal_##cpu( mvs, propagate_amount, lowres_costs,\
-            current, bipred_weight, mb_y, len );\
-    \
-    \
-    for( unsigned i = 0; i < len; current += 32 )\
-    {\
-        int end = MIN( i+8, len );\
-        for( ; i < end; i++, current += 2 )\
-        {\
-            if( !(lowres_costs[i] & (1 << (list+LOWRES_COST_SHIFT))) )\
-            continue;\
-            \
-            unsigned mbx = current[0];\
-            unsigned mby = current[1];\
-            unsigned idx0 = mbx + mby * stride;\
-            unsigned idx2 = idx0 + stride;\
-            \
-            /* Shortcut for the simple/common case of zero MV */\
-            if( !M32( mvs[i] ) )\
-            {\
-                MC_CLIP_ADD( ref_costs[idx0], current[16] );\
-                continue;\
-            }\
-            \
-            if( mbx < width-1 && mby < height-1 )\
-            {\
-                MC_CLIP_ADD2( ref_costs+idx0, current+16 );\
-                MC_CLIP_ADD2( ref_costs+idx2, current+32 );\
-            }\
-            else\
-            {\
-                /* Note: this takes advantage of unsigned representation to\
-                 *                  * catch negative mbx/mby. */\
-                if( mby < height )\
-                {\
-                    if( mbx < width )\
-                    MC_CLIP_ADD( ref_costs[idx0+0], current[16] );\
-                    if( mbx+1 < width )\
-                    MC_CLIP_ADD( ref_costs[idx0+1], current[17] );\
-                }\
-                if( mby+1 < height )\
-                {\
-                    if( mbx < width )\
-                    MC_CLIP_ADD( ref_costs[idx2+0], current[32] );\
-                    if( mbx+1 < width )\
-                    MC_CLIP_ADD( ref_costs[idx2+1], current[33] );\
-                }\
-            }\
-        }\
-    }\
-}
-
-
+    asm("movdqu     %1, %%xmm0     \n"\
+        "movdqu     %2, %%xmm1     \n"\
+        "movdqa %%xmm0, %%xmm2     \n"\
+        "movdqa %%xmm1, %%xmm3     \n"\
+        "pslld     $16, %%xmm2     \n"\
+        "pslld     $16, %%xmm3     \n"\
+        "psrad     $16, %%xmm2     \n"\
+        "psrad     $16, %%xmm3     \n"\
+        "packssdw %%xmm3, %%xmm2   \n" /* idx0weight of MBs 0-7 */\
+        "psrad     $16, %%xmm0     \n"\
+        "psrad     $16, %%xmm1     \n"\
+        "packssdw %%xmm1, %%xmm0   \n" /* idx1weight of MBs 0-7 */\
+        "pslldq     $2, %%xmm0     \n" /* ... moved onto the idx0 of the next MB */\
+        "movdqu     %0, %%xmm1     \n"\
+        "paddsw %%xmm2, %%xmm1     \n"\
+        "paddsw %%xmm0, %%xmm1     \n"\
+        "movdqu %%xmm1, %0         \n"\
+        :"+m"(*(uint16_t (*)[8])(s))\
+        :"m"(*(int16_t (*)[8])(x)), "m"(*(int16_t (*)[8])((x)+8))\
+        :"xmm0", "xmm1", "xmm2", "xmm3"\
+    );\
+    MC_CLIP_ADD( (s)[8], (x)[15] );\
+} while(0)
+#endif
 
-PROPAGATE_LIST(ssse3)
-PROPAGATE_LIST(avx)
+PROPAGATE_LIST(asm, ssse3)
+PROPAGATE_LIST(asm, avx)
 
-void vbench_mc_init_mmx( int cpu, vbench_mc_functions_t *pf )
+void vbench_mc_init_mmx( uint64_t cpu, vbench_mc_functions_t *pf )
 {
     if( !(cpu&CPU_MMX) )
         return;
@@ -984,6 +951,10 @@ void vbench_mc_init_mmx( int cpu, vbench_mc_functions_t *pf )
         pf->integral_init4h = asm_integral_init4h_avx2;
         pf->frame_init_lowres_core = asm_frame_init_lowres_core_avx2;
     }
+#if ARCH_X86_64
+    if( cpu&CPU_AVX512 )
+        pf->hpel_filter = asm_hpel_filter_avx512;
+#endif
 #endif // HIGH_BIT_DEPTH
 
     if( !(cpu&CPU_AVX) )
@@ -1001,4 +972,9 @@ void vbench_mc_init_mmx( int cpu, vbench_mc_functions_t *pf )
     pf->plane_copy_swap = asm_plane_copy_swap_avx2;
     pf->get_ref = get_ref_avx2;
     pf->mbtree_propagate_cost = asm_mbtree_propagate_cost_avx2;
+
+#if ARCH_X86_64 && !HIGH_BIT_DEPTH
+    if( cpu&CPU_AVX512 )
+        pf->mbtree_propagate_cost = asm_mbtree_propagate_cost_avx512;
+#endif
 }
@@ -27,6 +27,6 @@
 #ifndef X264_I386_MC_H
 #define X264_I386_MC_H
 
-void x264_mc_init_mmx( int cpu, vbench_mc_functions_t *pf );
+void x264_mc_init_mmx( uint64_t cpu, vbench_mc_functions_t *pf );
 
 #endif
@@ -348,7 +348,7 @@ static void vbench_predict_8x8c_dc_left( uint8_t *src )
 /****************************************************************************
  * Exported functions:
  ****************************************************************************/
-void vbench_predict_16x16_init_mmx( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_16x16_init_mmx( uint64_t cpu, vbench_predict_t pf[7] )
 {
     if( !(cpu & CPU_MMX2) )
         return;
@@ -410,7 +410,7 @@ void vbench_predict_16x16_init_mmx( int cpu, vbench_predict_t pf[7] )
     }
 }
 
-void vbench_predict_8x8c_init_mmx( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_8x8c_init_mmx( uint64_t cpu, vbench_predict_t pf[7] )
 {
     if( !(cpu & CPU_MMX) )
         return;
@@ -468,7 +468,7 @@ void vbench_predict_8x8c_init_mmx( int cpu, vbench_predict_t pf[7] )
     }
 }
 
-void vbench_predict_8x16c_init_mmx( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_8x16c_init_mmx( uint64_t cpu, vbench_predict_t pf[7] )
 {
     if( !(cpu & CPU_MMX) )
         return;
@@ -519,7 +519,7 @@ void vbench_predict_8x16c_init_mmx( int cpu, vbench_predict_t pf[7] )
     }
 }
 
-void vbench_predict_8x8_init_mmx( int cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_8x8_filter )
+void vbench_predict_8x8_init_mmx( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_8x8_filter )
 {
     if( !(cpu & CPU_MMX2) )
         return;
@@ -603,7 +603,7 @@ void vbench_predict_8x8_init_mmx( int cpu, vbench_predict8x8_t pf[12], vbench_pr
 #endif // HIGH_BIT_DEPTH
 }
 
-void vbench_predict_4x4_init_mmx( int cpu, vbench_predict_t pf[12] )
+void vbench_predict_4x4_init_mmx( uint64_t cpu, vbench_predict_t pf[12] )
 {
     if( !(cpu & CPU_MMX2) )
         return;
@@ -51,6 +51,7 @@ int asm_quant_4x4_avx2( dctcoef dct[16], udctcoef mf[16], udctcoef bias[16] );
 int asm_quant_4x4_dc_avx2( dctcoef dct[16], int mf, int bias );
 int asm_quant_8x8_avx2( dctcoef dct[64], udctcoef mf[64], udctcoef bias[64] );
 int asm_quant_4x4x4_avx2( dctcoef dct[4][16], udctcoef mf[16], udctcoef bias[16] );
+int asm_quant_4x4x4_avx512( dctcoef dct[4][16], udctcoef mf[16], udctcoef bias[16] );
 void asm_dequant_4x4_mmx( int16_t dct[16], int dequant_mf[6][16], int i_qp );
 void asm_dequant_4x4dc_mmx2( int16_t dct[16], int dequant_mf[6][16], int i_qp );
 void asm_dequant_8x8_mmx( int16_t dct[64], int dequant_mf[6][64], int i_qp );
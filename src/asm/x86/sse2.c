@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * sse2.c: SSE2 kernels written with intrinsics
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+/* The SSE2 kernels that need no yasm, so that the generic build of an
+ * x86_64 machine runs them too (HAVE_X86_INTRIN, see the Makefile).
+ * Registered under CPU_SSE2 next to the asm; every function here is
+ * bit-exact with the C kernel it replaces. */
+
+#include <emmintrin.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+
+#if HAVE_X86_INTRIN
+
+/****************************************************************************
+ * bitstream: nal_unescape
+ ****************************************************************************/
+
+/* A whole vector is copied, and only one that holds an escape, 0x03
+ * after two zeros, is looked at again: everything before the escape is
+ * then in place, and the copy goes on from the byte after it.  The
+ * zeros are looked for in src, so the first two bytes are copied on
+ * their own and nothing before src is read. */
+uint8_t *asm_nal_unescape_sse2( uint8_t *dst, uint8_t *src, uint8_t *end )
+{
+    const __m128i pb_3 = _mm_set1_epi8( 3 );
+    const __m128i zero = _mm_setzero_si128();
+
+    if( src < end ) *dst++ = *src++;
+    if( src < end ) *dst++ = *src++;
+    while( end - src >= 16 )
+    {
+        __m128i v = _mm_loadu_si128( (__m128i*)src );
+        __m128i z = _mm_or_si128( _mm_loadu_si128( (__m128i*)(src-1) ), _mm_loadu_si128( (__m128i*)(src-2) ) );
+        _mm_storeu_si128( (__m128i*)dst, v );
+        uint32_t escape = _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( v, pb_3 ), _mm_cmpeq_epi8( z, zero ) ) );
+        if( escape )
+        {
+            int i = x264_ctz( escape );
+            dst += i;
+            src += i+1;
+        }
+        else
+        {
+            dst += 16;
+            src += 16;
+        }
+    }
+    while( src < end )
+    {
+        if( src[0] == 0x03 && !src[-2] && !src[-1] )
+            src++;
+        else
+            *dst++ = *src++;
+    }
+    return dst;
+}
+
+/****************************************************************************
+ * mc: polyphase scaler passes
+ ****************************************************************************/
+
+#if !HIGH_BIT_DEPTH
+
+/* Two outputs share a register, four taps of each: pmaddwd leaves a pair
+ * of partial sums per output that the shuffles below fold together.
+ * Only the i_taps pixels of each window are read, so a window at the
+ * right edge of the source never reads past it.  Outputs are done four
+ * at a time, up to 3 past i_width, on the zero weights scale.h pads. */
+void asm_scale_h_sse2( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width )
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for( int x = 0; x < i_width; x += 4, coef += 4*i_taps )
+    {
+        pixel *s0 = src + pos[x+0], *s1 = src + pos[x+1];
+        pixel *s2 = src + pos[x+2], *s3 = src + pos[x+3];
+        __m128i acc01 = zero, acc23 = zero;
+        for( int j = 0; j < i_taps; j += 4 )
+        {
+            __m128i p01 = _mm_unpacklo_epi8( _mm_unpacklo_epi32( _mm_cvtsi32_si128( M32( s0+j ) ),
+                                                                 _mm_cvtsi32_si128( M32( s1+j ) ) ), zero );
+            __m128i p23 = _mm_unpacklo_epi8( _mm_unpacklo_epi32( _mm_cvtsi32_si128( M32( s2+j ) ),
+                                                                 _mm_cvtsi32_si128( M32( s3+j ) ) ), zero );
+            __m128i c01 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)(coef+0*i_taps+j) ),
+                                              _mm_loadl_epi64( (__m128i*)(coef+1*i_taps+j) ) );
+            __m128i c23 = _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)(coef+2*i_taps+j) ),
+                                              _mm_loadl_epi64( (__m128i*)(coef+3*i_taps+j) ) );
+            acc01 = _mm_add_epi32( acc01, _mm_madd_epi16( p01, c01 ) );
+            acc23 = _mm_add_epi32( acc23, _mm_madd_epi16( p23, c23 ) );
+        }
+        __m128 a = _mm_castsi128_ps( acc01 ), b = _mm_castsi128_ps( acc23 );
+        __m128i sum = _mm_add_epi32( _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE(2,0,2,0) ) ),
+                                     _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE(3,1,3,1) ) ) );
+        sum = _mm_srai_epi32( _mm_add_epi32( sum, _mm_set1_epi32( 128 ) ), 8 );
+        _mm_storel_epi64( (__m128i*)(dst+x), _mm_packs_epi32( sum, sum ) );
+    }
+}
+
+/* Rows are taken two at a time, interleaved so that pmaddwd multiplies
+ * both by their weights at once; 16 pixels per iteration, up to 15 past
+ * i_width.  packs/packus clip exactly as vbench_clip_pixel does. */
+void asm_scale_v_sse2( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width )
+{
+    const __m128i round = _mm_set1_epi32( 1 << 17 );
+
+    for( int x = 0; x < i_width; x += 16 )
+    {
+        __m128i acc0 = round, acc1 = round, acc2 = round, acc3 = round;
+        for( int j = 0; j < i_taps; j += 2 )
+        {
+            __m128i c = _mm_set1_epi32( (uint16_t)coef[j] | (uint32_t)coef[j+1] << 16 );
+            __m128i a0 = _mm_loadu_si128( (__m128i*)(src[j]+x) );
+            __m128i a1 = _mm_loadu_si128( (__m128i*)(src[j]+x+8) );
+            __m128i b0 = _mm_loadu_si128( (__m128i*)(src[j+1]+x) );
+            __m128i b1 = _mm_loadu_si128( (__m128i*)(src[j+1]+x+8) );
+            acc0 = _mm_add_epi32( acc0, _mm_madd_epi16( _mm_unpacklo_epi16( a0, b0 ), c ) );
+            acc1 = _mm_add_epi32( acc1, _mm_madd_epi16( _mm_unpackhi_epi16( a0, b0 ), c ) );
+            acc2 = _mm_add_epi32( acc2, _mm_madd_epi16( _mm_unpacklo_epi16( a1, b1 ), c ) );
+            acc3 = _mm_add_epi32( acc3, _mm_madd_epi16( _mm_unpackhi_epi16( a1, b1 ), c ) );
+        }
+        __m128i lo = _mm_packs_epi32( _mm_srai_epi32( acc0, 18 ), _mm_srai_epi32( acc1, 18 ) );
+        __m128i hi = _mm_packs_epi32( _mm_srai_epi32( acc2, 18 ), _mm_srai_epi32( acc3, 18 ) );
+        _mm_storeu_si128( (__m128i*)(dst+x), _mm_packus_epi16( lo, hi ) );
+    }
+}
+
+#endif
+
+#endif
@@ -46,6 +46,7 @@
 #include <string.h>
 #include "common.h"
 #include "osdep.h"
+#include "c_kernels/ccbuild.h"
 
 /* buf1, buf2: initialised to random data and shouldn't write into them */
 extern uint8_t *buf1, *buf2;
@@ -66,9 +67,11 @@ extern pixel *pbuf3, *pbuf4;
 typedef struct
 {
     void *pointer; // just for detecting duplicates
-    uint32_t cpu;
+    uint64_t cpu;
     uint64_t cycles;
     uint32_t den;
+    uint64_t cold_cycles;
+    uint32_t cold_den;
 } bench_t;
 
 typedef struct
@@ -114,6 +117,58 @@ static int cmp_bench( const void *a, const void *b )
 }
 
 
+/* --cold: before a first-call sample, push out what the harness and the
+ * last kernel left behind.  A sweep over COLD_DATA_SIZE bytes evicts the
+ * data from L1 and L2.  1024 distinct functions, each branching on the
+ * bits of a random seed, evict the code from the L1i and the decoded
+ * icache, and fill the branch target buffer and the direction predictors
+ * with other branches.  There is no instruction to flush the predictors
+ * from user space, so retraining them is the best we can do. */
+int bench_cold = 0;
+static volatile uint32_t cold_sink;
+
+#define COLD_CODE( n )\
+static NOINLINE uint32_t cold_code_##n( uint32_t x )\
+{\
+    for( int i = 0; i < 8; i++ )\
+        if( x & (1 << i) )\
+        {\
+            asm volatile( "" );\
+            x = x * 0x9e3779b1 + (n);\
+        }\
+        else\
+            x = (x >> 3) ^ (x << 5) ^ (n);\
+    return x;\
+}
+#define COLD_PTR( n ) cold_code_##n,
+#define COLD_X16( X, p ) X(p##0) X(p##1) X(p##2) X(p##3) X(p##4) X(p##5) X(p##6) X(p##7)\
+                         X(p##8) X(p##9) X(p##a) X(p##b) X(p##c) X(p##d) X(p##e) X(p##f)
+#define COLD_X256( X, p ) COLD_X16( X, p##0 ) COLD_X16( X, p##1 ) COLD_X16( X, p##2 ) COLD_X16( X, p##3 )\
+                          COLD_X16( X, p##4 ) COLD_X16( X, p##5 ) COLD_X16( X, p##6 ) COLD_X16( X, p##7 )\
+                          COLD_X16( X, p##8 ) COLD_X16( X, p##9 ) COLD_X16( X, p##a ) COLD_X16( X, p##b )\
+                          COLD_X16( X, p##c ) COLD_X16( X, p##d ) COLD_X16( X, p##e ) COLD_X16( X, p##f )
+#define COLD_X1024( X ) COLD_X256( X, 0x0 ) COLD_X256( X, 0x1 ) COLD_X256( X, 0x2 ) COLD_X256( X, 0x3 )
+
+COLD_X1024( COLD_CODE )
+static uint32_t (* const cold_code[1024])( uint32_t ) = { COLD_X1024( COLD_PTR ) };
+
+void bench_cold_flush( void )
+{
+    static uint8_t *data;
+    uint32_t x = rand();
+    if( !data && !(data = malloc( COLD_DATA_SIZE )) )
+    {
+        fprintf( stderr, "malloc failed, no --cold\n" );
+        exit( 1 );
+    }
+    for( int i = 0; i < COLD_DATA_SIZE; i += 64 )
+        data[i] += x;
+    for( int i = 0; i < 1024; i++ )
+        x = cold_code[i]( x );
+    cold_sink = x;
+}
+
+
 #if ARCH_X86 || ARCH_X86_64
 int x264_stack_pagealign( int (*func)(), int align );
 
@@ -136,7 +191,7 @@ intptr_t (*x264_checkasm_call)( intptr_t (*func)(), int *ok, ... ) = x264_checka
 
 
 
-static int check_all_funcs( int cpu_ref, int cpu_new )
+static int check_all_funcs( uint64_t cpu_ref, uint64_t cpu_new )
 {
     return check_pixel( cpu_ref, cpu_new )
          + check_dct( cpu_ref, cpu_new )
@@ -144,13 +199,12 @@ static int check_all_funcs( int cpu_ref, int cpu_new )
          + check_intra( cpu_ref, cpu_new )
          + check_deblock( cpu_ref, cpu_new )
          + check_quant( cpu_ref, cpu_new )
-         + check_cabac( cpu_ref, cpu_new );
-#if 0
-         + check_bitstream( cpu_ref, cpu_new );
-#endif
+         + check_cabac( cpu_ref, cpu_new )
+         + check_bitstream( cpu_ref, cpu_new )
+         + check_metrics( cpu_ref, cpu_new );
 }
 
-static int add_flags( int *cpu_ref, int *cpu_new, int flags, const char *name )
+static int add_flags( uint64_t *cpu_ref, uint64_t *cpu_new, uint64_t flags, const char *name )
 {
     *cpu_ref = *cpu_new;
     *cpu_new |= flags;
@@ -166,9 +220,9 @@ static int add_flags( int *cpu_ref, int *cpu_new, int flags, const char *name )
 static int check_all_flags( void )
 {
     int ret = 0;
-    int cpu0 = 0, cpu1 = 0;
+    uint64_t cpu0 = 0, cpu1 = 0;
     uint32_t cpu_detect_rs = cpu_detect();
-#if HAVE_MMX
+#if HAVE_MMX || HAVE_X86_INTRIN
     if( cpu_detect_rs & VSIMD_CPU_MMX2 )
     {
         ret |= add_flags( &cpu0, &cpu1, VSIMD_CPU_MMX | VSIMD_CPU_MMX2, "MMX" );
@@ -265,6 +319,8 @@ static int check_all_flags( void )
         ret |= add_flags( &cpu0, &cpu1, VSIMD_CPU_BMI1|VSIMD_CPU_BMI2, "BMI2" );
         cpu1 &= ~(VSIMD_CPU_BMI1|VSIMD_CPU_BMI2);
     }
+    if( cpu_detect_rs & VSIMD_CPU_AVX512 )
+        ret |= add_flags( &cpu0, &cpu1, VSIMD_CPU_BMI1|VSIMD_CPU_BMI2|VSIMD_CPU_AVX512, "AVX512" );
 #elif ARCH_PPC
     if( cpu_detect_rs & VSIMD_CPU_ALTIVEC )
     {
@@ -289,10 +345,26 @@ static int check_all_flags( void )
     if( cpu_detect_rs & VSIMD_CPU_MSA )
         ret |= add_flags( &cpu0, &cpu1, VSIMD_CPU_MSA, "MSA" );
 #endif
+#if HAVE_VEXT
+    fprintf( stderr, "VideoBench: vector extensions against C\n" );
+    ret |= check_all_funcs( 0, VSIMD_CPU_VEXT );
+#endif
+    /* the other builds of the C kernels, each against the main C build */
+    for( int i = 1; i <= CCBUILD_MAX; i++ )
+    {
+        const char *name = vbench_ccbuild_name( VSIMD_CPU_CCBUILD( i ) );
+        if( !name || (vbench_ccbuild_cpu( VSIMD_CPU_CCBUILD( i ) ) & ~cpu_detect_rs) )
+            continue;
+        fprintf( stderr, "VideoBench: C built with %s\n", name );
+        ret |= check_all_funcs( 0, VSIMD_CPU_CCBUILD( i ) );
+    }
     return ret;
 }
 
+int bench_align = 0;
+
 int run_benchmarks(int i){
+    bench_align = i;
     /* 32-byte alignment is guaranteed whenever it's useful, 
      * but some functions also vary in speed depending on %64 */
     //return x264_stack_pagealign(check_all_flags, i*32 );
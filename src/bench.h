@@ -53,9 +53,11 @@
 typedef struct
 {
     void *pointer; // just for detecting duplicates
-    uint32_t cpu;
+    uint64_t cpu;
     uint64_t cycles;
     uint32_t den;
+    uint64_t cold_cycles; // --cold: one call after bench_cold_flush() per sample
+    uint32_t cold_den;
 } bench_t;
 
 typedef struct
@@ -86,11 +88,25 @@ typedef struct bs_s
     uint8_t *p;
     uint8_t *p_end;
 
-    uintptr_t cur_bits;
+    uint64_t cur_bits;
     int     i_left;    /* i_count number of available bits */
     int     i_bits_encoded; /* RD only */
 } bs_t;
 
+enum bs_symbol_e
+{
+    BS_SYM_BITS = 0, /* i_size raw bits */
+    BS_SYM_UE   = 1, /* unsigned Exp-Golomb */
+    BS_SYM_SE   = 2, /* signed Exp-Golomb */
+};
+
+typedef struct
+{
+    uint8_t  i_type;
+    uint8_t  i_size; /* BS_SYM_BITS only */
+    uint32_t i_val;
+} vbench_bs_symbol_t;
+
 typedef struct
 {
     int32_t last;
@@ -179,12 +195,17 @@ static const struct { uint8_t w, h; } vbech_pixel_size[12] =
  * overwrite the junk written to the stack so there's no guarantee that it will always
  * detect all functions that assumes zero-extension.
  */
-void checkasm_stack_clobber( uint64_t clobber, ... );
+void asm_checkasm_stack_clobber( uint64_t clobber, ... );
+intptr_t asm_checkasm_call( intptr_t (*func)(), int *ok, ... );
 #define call_a1(func,...) ({ \
     uint64_t r = (rand() & 0xffff) * 0x0001000100010001ULL; \
     asm_checkasm_stack_clobber( r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r,r ); /* max_args+6 */ \
     asm_checkasm_call(( intptr_t(*)())func, &ok, 0, 0, 0, 0, __VA_ARGS__ ); })
-#elif ARCH_X86 || (ARCH_AARCH64 && !defined(__APPLE__)) || ARCH_ARM
+#elif ARCH_AARCH64 && !defined(__APPLE__)
+/* checks the callee-saved x19-x28 and d8-d15, see asm/aarch64/checkasm-aarch64.S */
+intptr_t asm_checkasm_call( intptr_t (*func)(), int *ok, ... );
+#define call_a1(func,...) asm_checkasm_call( (intptr_t(*)())func, &ok, __VA_ARGS__ )
+#elif ARCH_X86 || ARCH_ARM
 #define call_a1(func,...) checkasm_call( (intptr_t(*)())func, &ok, __VA_ARGS__ )
 #else
 #define call_a1 call_c1
@@ -196,11 +217,32 @@ void checkasm_stack_clobber( uint64_t clobber, ... );
 #define call_a1_64 call_a1
 #endif
 
+/* --cold: the first call after bench_cold_flush() has evicted the caches
+ * and retrained the branch predictors, one sample per call_bench, next to
+ * the warm steady state of the loop */
+extern int bench_cold;
+void bench_cold_flush( void );
+#define call_bench_cold(b,call)\
+    if( bench_cold )\
+    {\
+        bench_cold_flush();\
+        uint32_t t = read_time();\
+        call;\
+        t = read_time() - t;\
+        if( !b->cold_den || (uint64_t)t*b->cold_den <= b->cold_cycles*4 )\
+        {\
+            b->cold_cycles += t;\
+            b->cold_den++;\
+        }\
+    }
+
 #define call_bench(func,cpu,...)\
     if( !strncmp(func_name, bench_pattern, bench_pattern_len) )\
     {\
         uint64_t tsum = 0;\
         int tcount = 0;\
+        bench_t *b = get_bench( func_name, cpu );\
+        call_bench_cold(b, func(__VA_ARGS__));\
         call_a1(func, __VA_ARGS__);\
         for( int ti = 0; ti < (cpu?BENCH_RUNS:BENCH_RUNS/4); ti++ )\
         {\
@@ -216,7 +258,33 @@ void checkasm_stack_clobber( uint64_t clobber, ... );
                 tcount++;\
             }\
         }\
+        b->cycles += tsum;\
+        b->den += tcount;   \
+        b->pointer = func;\
+    }
+
+/* call_bench for a driver that runs its kernel itself, n times in a loop:
+ * func( n, ... ) once with n = 4 per sample is the work of the four calls
+ * above, without a call per run */
+#define call_bench_loop(func,cpu,...)\
+    if( !strncmp(func_name, bench_pattern, bench_pattern_len) )\
+    {\
+        uint64_t tsum = 0;\
+        int tcount = 0;\
         bench_t *b = get_bench( func_name, cpu );\
+        call_bench_cold(b, func(1, __VA_ARGS__));\
+        func(1, __VA_ARGS__);\
+        for( int ti = 0; ti < (cpu?BENCH_RUNS:BENCH_RUNS/4); ti++ )\
+        {\
+            uint32_t t = read_time();\
+            func(4, __VA_ARGS__);\
+            t = read_time() - t;\
+            if( (uint64_t)t*tcount <= tsum*4 && ti > 0 )\
+            {\
+                tsum += t;\
+                tcount++;\
+            }\
+        }\
         b->cycles += tsum;\
         b->den += tcount;   \
         b->pointer = func;\
@@ -230,6 +298,62 @@ void checkasm_stack_clobber( uint64_t clobber, ... );
 #define call_c2(func,...) ({ call_bench(func,0,__VA_ARGS__); })
 #define call_a64(func,...) ({ call_a2(func,__VA_ARGS__); call_a1_64(func,__VA_ARGS__); })
 
+/* Throughput benchmarks for kernels that process whole frames or large
+ * payloads, where cycles per call are less meaningful than a rate.
+ * amount is the work done by one call, divided by scale to get unit
+ * (e.g. bytes with scale 1e9 for GB/s).  A scale of 0 reports amount per
+ * read_time() tick instead of per second (e.g. bits/cycle). */
+typedef struct
+{
+    void *pointer; // just for detecting duplicates
+    uint64_t cpu;
+    int64_t usecs;
+    uint64_t cycles;
+    double work;
+} bench_rate_t;
+
+typedef struct
+{
+    char *name;
+    const char *unit;
+    double scale;
+    bench_rate_t vers[MAX_CPUS];
+} bench_rate_func_t;
+
+int64_t mdate( void );
+bench_rate_t *get_bench_rate( const char *name, const char *unit, double scale, uint64_t cpu );
+
+#define call_rate(func,cpu,unit,scale,amount,...) call_rate_key(func,func,cpu,unit,scale,amount,__VA_ARGS__)
+#define call_rate_key(func,key,cpu,unit,scale,amount,...)\
+    if( !strncmp(func_name, bench_pattern, bench_pattern_len) )\
+    {\
+        int64_t t = mdate();\
+        uint32_t tc = read_time();\
+        for( int ti = 0; ti < RATE_RUNS; ti++ )\
+            func(__VA_ARGS__);\
+        tc = read_time() - tc;\
+        t = mdate() - t;\
+        bench_rate_t *r = get_bench_rate( func_name, unit, scale, cpu );\
+        r->usecs += t;\
+        r->cycles += tc;\
+        r->work += (double)(amount) * RATE_RUNS;\
+        r->pointer = key;\
+    }
+
+#define call_c_rate(func,unit,scale,amount,...) ({ call_rate(func,0,unit,scale,amount,__VA_ARGS__); })
+#define call_a_rate(func,unit,scale,amount,...) ({ call_rate(func,cpu_new,unit,scale,amount,__VA_ARGS__); })
+
+/* run_benchmarks() runs every check once per offset of buf1 and pbuf1.  The
+ * rate and whole-frame benchmarks don't use those buffers, so they only
+ * run on the first pass, bench_align == 0. */
+extern int bench_align;
+
+/* Frame-level drivers run the same function over every kernel set, so its
+ * pointer can't tell the versions apart.  They are only called when the
+ * set changed, so their results are never dropped as duplicates. */
+#define call_c_frame(func,unit,scale,amount,...) ({ call_rate_key(func,NULL,0,unit,scale,amount,__VA_ARGS__); })
+#define call_a_frame(func,unit,scale,amount,...) ({ call_rate_key(func,NULL,cpu_new,unit,scale,amount,__VA_ARGS__); })
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -472,6 +596,15 @@ typedef struct vbench_mc_functions_t
 
     void (*frame_init_lowres_core)( pixel *src0, pixel *dst0, pixel *dsth, pixel *dstv, pixel *dstc,
             intptr_t src_stride, intptr_t dst_stride, int width, int height );
+
+    /* polyphase scaler passes, see c_kernels/scale.h.  scale_h filters one
+     * row into Q6 samples and may write up to 7 values past i_width;
+     * scale_v combines i_taps such rows and may write and read up to 15
+     * values past i_width.  i_taps is a multiple of 4 for scale_h and of 2
+     * for scale_v. */
+    void (*scale_h)( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width );
+    void (*scale_v)( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width );
+
     weight_fn_t *weight;
     weight_fn_t *offsetadd;
     weight_fn_t *offsetsub;
@@ -514,6 +647,15 @@ typedef struct
 typedef struct
 {
     uint8_t *(*nal_escape) ( uint8_t *dst, uint8_t *src, uint8_t *end );
+    /* removes emulation prevention bytes; dst must not overlap src */
+    uint8_t *(*nal_unescape) ( uint8_t *dst, uint8_t *src, uint8_t *end );
+    /* batched bit writers, see c_kernels/bs.h */
+    void (*bs_write_symbols)( bs_t *s, vbench_bs_symbol_t *sym, int i_count );
+    void (*bs_write_ue_batch)( bs_t *s, uint32_t *val, int i_count );
+    void (*bs_write_se_batch)( bs_t *s, int32_t *val, int i_count );
+    void (*bs_write_vlc_batch)( bs_t *s, const vlc_t *tab, uint8_t *idx, int i_count );
+    /* CAVLC residual of a nonempty block, see c_kernels/cavlc.h */
+    int (*cavlc_block_residual)( bs_t *s, vbench_quant_function_t *quantf, int ctx_block_cat, dctcoef *l, int nC );
     void (*cabac_block_residual_internal)( dctcoef *l, int b_interlaced,
             intptr_t ctx_block_cat, vbench_cabac_t *cb );
     void (*cabac_block_residual_rd_internal)( dctcoef *l, int b_interlaced,
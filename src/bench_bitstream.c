@@ -48,6 +48,8 @@
 #include "bench.h"
 #include "osdep.h"
 #include "macroblock.h"
+#include "c_kernels/bs.h"
+#include "c_kernels/cavlc.h"
 
 /* buf1, buf2: initialised to random data and shouldn't write into them */
 extern uint8_t *buf1, *buf2;
@@ -61,9 +63,13 @@ extern pixel *pbuf3, *pbuf4;
 
 extern int bench_pattern_len;
 extern const char *bench_pattern;
-char func_name[100];
+extern char func_name[100];
 extern  bench_func_t benchs[MAX_FUNCS];
 
+void vbench_bitstream_init( uint64_t cpu, vbench_bitstream_function_t *pf );
+void vbench_quant_init( int i_cqm_preset, uint64_t cpu, vbench_quant_function_t *pf );
+void vbench_zigzag_init( uint64_t cpu, vbench_zigzag_function_t *pf_progressive, vbench_zigzag_function_t *pf_interlaced );
+
 #define set_func_name(...) snprintf( func_name, sizeof(func_name), __VA_ARGS__ )
 
 
@@ -78,7 +84,7 @@ extern  bench_func_t benchs[MAX_FUNCS];
 
 
 
-static bench_t* get_bench( const char *name, int cpu )
+static bench_t* get_bench( const char *name, uint64_t cpu )
 {
     int i, j;
     for( i = 0; benchs[i].name && strcmp(name, benchs[i].name); i++ )
@@ -114,18 +120,157 @@ static int cmp_bench( const void *a, const void *b )
     }
 }
 
-int check_bitstream( int cpu_ref, int cpu_new )
+/* A slice-like mix: mostly short VLC-sized fields and small Exp-Golomb
+ * values (mb_type, ref_idx, mvd), with the occasional long code if big is set. */
+static void bs_gen_symbol( vbench_bs_symbol_t *sym, int big )
+{
+    int r = rand() & 15;
+    if( r < 6 )
+    {
+        sym->i_type = BS_SYM_BITS;
+        sym->i_size = 1 + (rand() & 15);
+        sym->i_val  = rand() & ((1 << sym->i_size) - 1);
+    }
+    else if( r < 10 )
+    {
+        sym->i_type = BS_SYM_UE;
+        sym->i_val  = big && !(rand() & 31) ? (uint32_t)rand()*4 + (rand()&1) : (rand() & 255) >> (rand() & 7);
+    }
+    else if( r < 14 )
+    {
+        sym->i_type = BS_SYM_SE;
+        sym->i_val  = big && !(rand() & 31) ? (uint32_t)rand()*2 + (rand()&1) : (uint32_t)(((rand() & 63) - 32) >> (rand() & 3));
+    }
+    else
+    {
+        sym->i_type = BS_SYM_BITS;
+        sym->i_size = 1;
+        sym->i_val  = rand() & 1;
+    }
+}
+
+/* Quantized residual in scan order: both the chance of a nonzero coefficient
+ * and its magnitude fall off along the scan, and the density varies from
+ * block to block like it does with QP and texture.  big adds rare levels
+ * that need the level_prefix escapes.  Returns the number of nonzeros. */
+static int cavlc_gen_block( dctcoef *l, int n, int big )
+{
+    int density = 1 + (rand() & 7);
+    int nz = 0;
+    for( int i = 0; i < n; i++ )
+    {
+        l[i] = 0;
+        if( (rand() % (8*n)) < density * (n - i) )
+        {
+            int level = 1;
+            if( rand() & 1 )
+                level += (rand() & 15) >> (rand() & 3);
+            if( big && !(rand() & 15) )
+                level = 1 + (rand() & ((1 << (1 + (rand() & 14))) - 1));
+            l[i] = rand() & 1 ? -level : level;
+            nz++;
+        }
+    }
+    return nz;
+}
+
+typedef int (*vbench_cavlc_block_t)( bs_t *s, vbench_quant_function_t *quantf, int ctx_block_cat, dctcoef *l, int nC );
+/* the coeff_level_run the coders use for a category */
+#define CAVLC_LEVEL_RUN( qf, cat ) ((cat) == DCT_CHROMA_DC ? (void*)(qf).coeff_level_run4 : (void*)(qf).coeff_level_run[cat])
+
+/* Blocks are stored 16 coefficients apart; AC blocks start at index 1 and
+ * the first chroma DC block index is 4 coefficients apart. */
+static void cavlc_write_blocks( vbench_cavlc_block_t coder, bs_t *s, vbench_quant_function_t *quantf,
+                                int ctx_block_cat, dctcoef *l, uint8_t *nnz, uint8_t *nC, int count )
+{
+    int stride = ctx_block_cat == DCT_CHROMA_DC ? 4 : 16;
+    int offset = ctx_block_cat == DCT_LUMA_AC || ctx_block_cat == DCT_CHROMA_AC;
+    for( int i = 0; i < count; i++ )
+    {
+        if( nnz[i] )
+            coder( s, quantf, ctx_block_cat, l + i*stride + offset, nC[i] );
+        else
+            vbench_cavlc_block_residual_empty( s, ctx_block_cat, nC[i] );
+    }
+}
+
+/* Quantized coefficients of a 4x4 or 8x8 block in transform order,
+ * dct[x*n+y] with x the horizontal and y the vertical frequency.  Energy
+ * falls off with frequency, in frame content about as fast in both
+ * directions; the lines of a field MB are twice as far apart, so field
+ * content keeps more of its vertical frequencies, which is what the field
+ * scans are ordered for.  Returns the number of nonzeros. */
+static int residual_gen_block( dctcoef *dct, int n, int b_field )
+{
+    int density = 1 + (rand() & 7);
+    int nz = 0;
+    for( int x = 0; x < n; x++ )
+        for( int y = 0; y < n; y++ )
+        {
+            int f = b_field ? (3*x + y) >> 1 : x + y;
+            dct[x*n+y] = 0;
+            if( (rand() % (16*n)) < density * (2*n - 1 - f) )
+            {
+                int level = 1;
+                if( rand() & 1 )
+                    level += (rand() & 15) >> (rand() & 3);
+                dct[x*n+y] = rand() & 1 ? -level : level;
+                nz++;
+            }
+        }
+    return nz;
+}
+
+/* The luma residual path of a macroblock after quantization: zigzag scan
+ * with the frame or field scan, then CAVLC.  8x8 blocks are scanned whole
+ * and interleaved into the four 4x4 blocks CAVLC codes. */
+static void residual_write_blocks( vbench_zigzag_function_t *zigzag, vbench_cavlc_block_t coder, bs_t *s,
+                                   vbench_quant_function_t *quantf, int b_8x8, dctcoef *dct, uint8_t *nnz,
+                                   uint8_t *nC, int count )
+{
+    ALIGNED_16( dctcoef level[64] );
+    ALIGNED_16( dctcoef level4[4*16] );
+
+    if( b_8x8 )
+        for( int i = 0; i < count; i += 4 )
+        {
+            uint8_t nnz8[16*3] = {0};
+            zigzag->scan_8x8( level, dct + i*16 );
+            zigzag->interleave_8x8_cavlc( level4, level, nnz8 );
+            for( int j = 0; j < 4; j++ )
+            {
+                if( nnz8[(j&1) + (j>>1)*8] )
+                    coder( s, quantf, DCT_LUMA_4x4, level4 + j*16, nC[i+j] );
+                else
+                    vbench_cavlc_block_residual_empty( s, DCT_LUMA_4x4, nC[i+j] );
+            }
+        }
+    else
+        for( int i = 0; i < count; i++ )
+        {
+            if( nnz[i] )
+            {
+                zigzag->scan_4x4( level, dct + i*16 );
+                coder( s, quantf, DCT_LUMA_4x4, level, nC[i] );
+            }
+            else
+                vbench_cavlc_block_residual_empty( s, DCT_LUMA_4x4, nC[i] );
+        }
+}
+
+int check_bitstream( uint64_t cpu_ref, uint64_t cpu_new )
 {
     vbench_bitstream_function_t bs_c;
     vbench_bitstream_function_t bs_ref;
     vbench_bitstream_function_t bs_a;
 
     int ret = 0, ok = 1, used_asm = 0;
+    /* the C-only checks and benchmarks, once per run */
+    static int c_done = 0;
 
     vbench_bitstream_init( 0, &bs_c );
     vbench_bitstream_init( cpu_ref, &bs_ref );
     vbench_bitstream_init( cpu_new, &bs_a );
-#if 0 
     if( bs_a.nal_escape != bs_ref.nal_escape )
     {
         int size = 0x4000;
@@ -160,8 +305,385 @@ int check_bitstream( int cpu_ref, int cpu_new )
         free(output1);
         free(output2);
     }
-    report( "nal escape:" );
-#endif
+    report( "nal escape :" );
+
+    ok = 1; used_asm = 0;
+    if( bs_a.nal_unescape != bs_ref.nal_unescape )
+    {
+        int size = 0x4000;
+        uint8_t *input = malloc(size+100);
+        uint8_t *escaped = malloc(size*2);
+        uint8_t *output1 = malloc(size*2);
+        uint8_t *output2 = malloc(size*2);
+        used_asm = 1;
+        set_func_name( "nal_unescape" );
+        for( int i = 0; i < 200 && ok; i++ )
+        {
+            int test_size = i < 10 ? i+1 : rand() & 0x3fff;
+            for( int j = 0; j < test_size+32; j++ )
+                input[j] = (rand()&((1 << ((i&7)+1)) - 1)) * rand();
+            /* Even iterations unescape a valid escaped payload, which must round-trip;
+             * odd ones feed the raw data, which has stray 0x000003 sequences. */
+            uint8_t *src = input;
+            int src_size = test_size;
+            if( !(i&1) )
+            {
+                src = escaped;
+                src_size = bs_c.nal_escape( escaped, input, input+test_size ) - escaped;
+            }
+            uint8_t *end_c = (uint8_t*)call_c1( bs_c.nal_unescape, output1, src, src+src_size );
+            uint8_t *end_a = (uint8_t*)call_a1( bs_a.nal_unescape, output2, src, src+src_size );
+            int size_c = end_c-output1;
+            int size_a = end_a-output2;
+            if( size_c != size_a || memcmp( output1, output2, size_c ) ||
+                (!(i&1) && (size_c != test_size || memcmp( output1, input, test_size ))) )
+            {
+                fprintf( stderr, "nal_unescape :  [FAILED] %d %d %d\n", size_c, size_a, test_size );
+                ok = 0;
+            }
+        }
+        /* Zeros right before src and an 0x03 at offset 0 or 1: the first two
+         * bytes are copied as they are, whatever is in front of them. */
+        static const uint8_t head[4][4] = { {3,3,3,3}, {0,3,3,0}, {3,0,0,3}, {0,0,3,3} };
+        for( int i = 0; i < 16 && ok; i++ )
+        {
+            uint8_t *src = input + 2;
+            int src_size = (i&3) + 1;
+            input[0] = input[1] = 0;
+            memcpy( src, head[i>>2], 4 );
+            uint8_t *end_c = (uint8_t*)call_c1( bs_c.nal_unescape, output1, src, src+src_size );
+            uint8_t *end_a = (uint8_t*)call_a1( bs_a.nal_unescape, output2, src, src+src_size );
+            int size_c = end_c-output1;
+            int size_a = end_a-output2;
+            if( size_c != size_a || memcmp( output1, output2, size_c ) ||
+                size_c < MIN( src_size, 2 ) || memcmp( output1, src, MIN( src_size, 2 ) ) )
+            {
+                fprintf( stderr, "nal_unescape :  [FAILED] head %d size %d: %d %d\n", i>>2, src_size, size_c, size_a );
+                ok = 0;
+            }
+        }
+        for( int j = 0; j < size+32; j++ )
+            input[j] = (rand()&3) * rand();
+        int escaped_size = bs_c.nal_escape( escaped, input, input+size ) - escaped;
+        call_c2( bs_c.nal_unescape, output1, escaped, escaped+escaped_size );
+        call_a2( bs_a.nal_unescape, output2, escaped, escaped+escaped_size );
+        free(input);
+        free(escaped);
+        free(output1);
+        free(output2);
+    }
+    report( "nal unescape :" );
+
+    /* Throughput on slice-sized payloads, measured per source byte. */
+    if( !bench_align && (!c_done || bs_a.nal_escape != bs_ref.nal_escape || bs_a.nal_unescape != bs_ref.nal_unescape) )
+    {
+        int size = 1<<20;
+        uint8_t *input = malloc(size+32);
+        uint8_t *escaped = malloc(size*3/2+32);
+        uint8_t *output = malloc(size*3/2+32);
+        for( int j = 0; j < size+32; j++ )
+            input[j] = (rand()&3) * rand();
+        int escaped_size = bs_c.nal_escape( escaped, input, input+size ) - escaped;
+        set_func_name( "nal_escape_1M" );
+        if( !c_done )
+            call_c_rate( bs_c.nal_escape, "GB/s", 1e9, size, output, input, input+size );
+        if( bs_a.nal_escape != bs_ref.nal_escape )
+            call_a_rate( bs_a.nal_escape, "GB/s", 1e9, size, output, input, input+size );
+        set_func_name( "nal_unescape_1M" );
+        if( !c_done )
+            call_c_rate( bs_c.nal_unescape, "GB/s", 1e9, escaped_size, output, escaped, escaped+escaped_size );
+        if( bs_a.nal_unescape != bs_ref.nal_unescape )
+            call_a_rate( bs_a.nal_unescape, "GB/s", 1e9, escaped_size, output, escaped, escaped+escaped_size );
+        free(input);
+        free(escaped);
+        free(output);
+    }
+
+    /* C only, against the bit-at-a-time reference */
+    ok = 1; used_asm = 0;
+    if( !bench_align && !c_done )
+    {
+        int n_max = 1<<16;
+        int size = n_max*4*RATE_RUNS + BS_PADDING;
+        vbench_bs_symbol_t *sym = malloc( n_max*sizeof(vbench_bs_symbol_t) );
+        uint32_t *ue = malloc( n_max*sizeof(uint32_t) );
+        int32_t *se = malloc( n_max*sizeof(int32_t) );
+        uint8_t *idx = malloc( n_max );
+        uint8_t *output1 = malloc( size );
+        uint8_t *output2 = malloc( size );
+        vlc_t vlc[256];
+        bs_t bs1, bs2;
+
+        for( int i = 0; i < 256; i++ )
+        {
+            vlc[i].i_size = 1 + (rand() & 15);
+            vlc[i].i_bits = rand() & ((1 << MIN( vlc[i].i_size, 8 )) - 1);
+        }
+
+#define BS_CHECK( name, fast, ref, ... )\
+        {\
+            bs_init( &bs1, output1, size );\
+            vbench_bs_init_ref( &bs2, output2, size );\
+            fast( &bs1, __VA_ARGS__ );\
+            ref( &bs2, __VA_ARGS__ );\
+            int pos1 = bs_pos( &bs1 );\
+            int pos2 = 8*(bs2.p - output2) + 8 - bs2.i_left;\
+            bs_flush( &bs1 );\
+            vbench_bs_flush_ref( &bs2 );\
+            if( pos1 != pos2 || bs1.p - output1 != bs2.p - output2 ||\
+                memcmp( output1, output2, bs2.p - output2 ) )\
+            {\
+                fprintf( stderr, name " :  [FAILED] %d %d\n", (int)(bs1.p - output1), (int)(bs2.p - output2) );\
+                ok = 0;\
+            }\
+        }
+
+        for( int i = 0; i < 100 && ok; i++ )
+        {
+            int n = i < 16 ? i+1 : rand() & 0xfff;
+            for( int j = 0; j < n; j++ )
+            {
+                bs_gen_symbol( &sym[j], 1 );
+                ue[j] = i&1 ? (uint32_t)rand()*2 + (rand()&1) : (rand() & 1023) >> (rand() & 7);
+                se[j] = i&1 ? (int32_t)((uint32_t)rand()*2) : (rand() & 255) - 128;
+                idx[j] = rand();
+            }
+            BS_CHECK( "bs_write_symbols", bs_c.bs_write_symbols, vbench_bs_write_symbols_ref, sym, n );
+            BS_CHECK( "bs_write_ue", bs_c.bs_write_ue_batch, vbench_bs_write_ue_batch_ref, ue, n );
+            BS_CHECK( "bs_write_se", bs_c.bs_write_se_batch, vbench_bs_write_se_batch_ref, se, n );
+            BS_CHECK( "bs_write_vlc", bs_c.bs_write_vlc_batch, vbench_bs_write_vlc_batch_ref, vlc, idx, n );
+        }
+#undef BS_CHECK
+
+        /* Throughput in output Mbit/s; every benchmarked call appends to the
+         * same writer so the output buffer holds RATE_RUNS runs. */
+        for( int j = 0; j < n_max; j++ )
+        {
+            bs_gen_symbol( &sym[j], 0 );
+            ue[j] = (rand() & 255) >> (rand() & 7);
+            se[j] = ((rand() & 63) - 32) >> (rand() & 3);
+            idx[j] = rand();
+        }
+
+#define BS_BENCH( name, fast, ref, ... )\
+        {\
+            vbench_bs_init_ref( &bs2, output2, size );\
+            ref( &bs2, __VA_ARGS__ );\
+            int bits = 8*(bs2.p - output2) + 8 - bs2.i_left;\
+            set_func_name( name );\
+            bs_init( &bs1, output1, size );\
+            call_c_rate( fast, "Mbit/s", 1e6, bits, &bs1, __VA_ARGS__ );\
+            set_func_name( name "_naive" );\
+            vbench_bs_init_ref( &bs2, output2, size );\
+            call_c_rate( ref, "Mbit/s", 1e6, bits, &bs2, __VA_ARGS__ );\
+        }
+
+        BS_BENCH( "bs_write_mix", bs_c.bs_write_symbols, vbench_bs_write_symbols_ref, sym, n_max );
+        BS_BENCH( "bs_write_ue", bs_c.bs_write_ue_batch, vbench_bs_write_ue_batch_ref, ue, n_max );
+        BS_BENCH( "bs_write_se", bs_c.bs_write_se_batch, vbench_bs_write_se_batch_ref, se, n_max );
+        BS_BENCH( "bs_write_vlc", bs_c.bs_write_vlc_batch, vbench_bs_write_vlc_batch_ref, vlc, idx, n_max );
+#undef BS_BENCH
+
+        free(sym);
+        free(ue);
+        free(se);
+        free(idx);
+        free(output1);
+        free(output2);
+    }
+    report( "bs write :" );
+
+    /* every category the C coder and the reference check and time once,
+     * the asm for every cpu step that changes its coeff_level_run */
+    ok = 1; used_asm = 0;
+    if( !bench_align )
+    {
+        static const struct { const char *name; int cat; int n; } cats[] =
+        {
+            { "cavlc_luma_dc",   DCT_LUMA_DC,   16 },
+            { "cavlc_luma_ac",   DCT_LUMA_AC,   15 },
+            { "cavlc_luma_4x4",  DCT_LUMA_4x4,  16 },
+            { "cavlc_luma_8x8",  DCT_LUMA_8x8,  64 },
+            { "cavlc_chroma_dc", DCT_CHROMA_DC,  4 },
+            { "cavlc_chroma_ac", DCT_CHROMA_AC, 15 },
+        };
+        int count = 1024;
+        int size = count*128*RATE_RUNS + BS_PADDING;
+        vbench_quant_function_t qf_c, qf_ref, qf_a;
+        vbench_zigzag_function_t zigzag[2];
+        dctcoef *blocks = memalign( 32, count*16*sizeof(dctcoef) + 64 );
+        ALIGNED_16( dctcoef dct8[64] );
+        uint8_t *nnz = malloc( count );
+        uint8_t *nC = malloc( count );
+        uint8_t *output1 = malloc( size );
+        uint8_t *output2 = malloc( size );
+        bs_t bs1, bs2;
+
+        vbench_quant_init( 0, 0, &qf_c );
+        vbench_quant_init( 0, cpu_ref, &qf_ref );
+        vbench_quant_init( 0, cpu_new, &qf_a );
+        vbench_zigzag_init( 0, &zigzag[0], &zigzag[1] );
+
+        for( int c = 0; c < sizeof(cats)/sizeof(cats[0]); c++ )
+        {
+            int cat = cats[c].cat == DCT_LUMA_8x8 ? DCT_LUMA_4x4 : cats[c].cat;
+            int b_asm = bs_a.cavlc_block_residual != bs_ref.cavlc_block_residual ||
+                        CAVLC_LEVEL_RUN( qf_a, cat ) != CAVLC_LEVEL_RUN( qf_ref, cat );
+            if( !b_asm && c_done )
+                continue;
+            used_asm |= b_asm;
+            vbench_quant_function_t *qf_t = b_asm ? &qf_a : &qf_c;
+            vbench_cavlc_block_t coder_t = b_asm ? bs_a.cavlc_block_residual : bs_c.cavlc_block_residual;
+            for( int pass = 0; pass < 2; pass++ )
+            {
+                /* pass 0 checks with rare large levels, pass 1 benchmarks typical ones */
+                memset( blocks, 0, count*16*sizeof(dctcoef) );
+                for( int i = 0; i < count; )
+                {
+                    if( cats[c].cat == DCT_LUMA_8x8 )
+                    {
+                        uint8_t nnz8[16*3] = {0};
+                        while( !cavlc_gen_block( dct8, 64, !pass ) );
+                        zigzag[0].interleave_8x8_cavlc( blocks + i*16, dct8, nnz8 );
+                        for( int j = 0; j < 4; j++, i++ )
+                        {
+                            nnz[i] = nnz8[(j&1) + (j>>1)*8];
+                            nC[i] = rand() % 17 >> (rand() & 1);
+                        }
+                    }
+                    else
+                    {
+                        int stride = cat == DCT_CHROMA_DC ? 4 : 16;
+                        int offset = cat == DCT_LUMA_AC || cat == DCT_CHROMA_AC;
+                        while( !(nnz[i] = cavlc_gen_block( blocks + i*stride + offset, cats[c].n, !pass )) );
+                        nC[i] = rand() % 17 >> (rand() & 1);
+                        i++;
+                    }
+                }
+
+                bs_init( &bs2, output2, size );
+                cavlc_write_blocks( vbench_cavlc_block_residual_ref, &bs2, &qf_c, cat, blocks, nnz, nC, count );
+                int bits = bs_pos( &bs2 );
+
+                if( !pass )
+                {
+                    bs_init( &bs1, output1, size );
+                    cavlc_write_blocks( coder_t, &bs1, qf_t, cat, blocks, nnz, nC, count );
+                    int bits_a = bs_pos( &bs1 );
+                    bs_flush( &bs1 );
+                    bs_flush( &bs2 );
+                    if( bits != bits_a || memcmp( output1, output2, bs2.p - output2 ) )
+                    {
+                        fprintf( stderr, "%s :  [FAILED]\n", cats[c].name );
+                        ok = 0;
+                    }
+                    continue;
+                }
+
+                set_func_name( "%s", cats[c].name );
+                bs_init( &bs1, output1, size );
+                call_c_frame( cavlc_write_blocks, "bits/cycle", 0, bits, bs_c.cavlc_block_residual, &bs1, &qf_c, cat, blocks, nnz, nC, count );
+                if( b_asm )
+                {
+                    bs_init( &bs1, output1, size );
+                    call_a_frame( cavlc_write_blocks, "bits/cycle", 0, bits, bs_a.cavlc_block_residual, &bs1, &qf_a, cat, blocks, nnz, nC, count );
+                }
+                if( !c_done )
+                {
+                    set_func_name( "%s_ref", cats[c].name );
+                    bs_init( &bs2, output2, size );
+                    call_c_frame( cavlc_write_blocks, "bits/cycle", 0, bits, vbench_cavlc_block_residual_ref, &bs2, &qf_c, cat, blocks, nnz, nC, count );
+                }
+            }
+        }
+
+        free(blocks);
+        free(nnz);
+        free(nC);
+        free(output1);
+        free(output2);
+    }
+    report( "cavlc residual :" );
+
+    /* frame and field MBs through scan and CAVLC, with the field
+     * content a field MB is chosen for */
+    ok = 1; used_asm = 0;
+    if( !bench_align )
+    {
+        int count = 1024;
+        int size = count*128*RATE_RUNS + BS_PADDING;
+        vbench_quant_function_t qf_c, qf_ref, qf_a;
+        vbench_zigzag_function_t zigzag_c[2], zigzag_ref[2], zigzag_a[2];
+        dctcoef *dct = memalign( 32, count*16*sizeof(dctcoef) );
+        uint8_t *nnz = malloc( count );
+        uint8_t *nC = malloc( count );
+        uint8_t *output1 = malloc( size );
+        uint8_t *output2 = malloc( size );
+        bs_t bs1, bs2;
+
+        vbench_quant_init( 0, 0, &qf_c );
+        vbench_quant_init( 0, cpu_ref, &qf_ref );
+        vbench_quant_init( 0, cpu_new, &qf_a );
+        vbench_zigzag_init( 0, &zigzag_c[0], &zigzag_c[1] );
+        vbench_zigzag_init( cpu_ref, &zigzag_ref[0], &zigzag_ref[1] );
+        vbench_zigzag_init( cpu_new, &zigzag_a[0], &zigzag_a[1] );
+        int b_asm = bs_a.cavlc_block_residual != bs_ref.cavlc_block_residual ||
+                    memcmp( qf_a.coeff_level_run, qf_ref.coeff_level_run, sizeof(qf_a.coeff_level_run) ) ||
+                    memcmp( zigzag_a, zigzag_ref, sizeof(zigzag_a) );
+
+        for( int b_8x8 = 0; b_8x8 < 2 && (b_asm || !c_done); b_8x8++ )
+            for( int b_field = 0; b_field < 2; b_field++ )
+            {
+                int n = b_8x8 ? 8 : 4;
+                used_asm |= b_asm;
+                for( int i = 0; i < count; i += n*n/16 )
+                {
+                    while( !(nnz[i] = residual_gen_block( dct + i*16, n, b_field )) );
+                    for( int j = 0; j < n*n/16; j++ )
+                        nC[i+j] = rand() % 17 >> (rand() & 1);
+                }
+
+                bs_init( &bs2, output2, size );
+                residual_write_blocks( &zigzag_c[b_field], vbench_cavlc_block_residual_ref, &bs2, &qf_c,
+                                       b_8x8, dct, nnz, nC, count );
+                int bits = bs_pos( &bs2 );
+                bs_init( &bs1, output1, size );
+                residual_write_blocks( &zigzag_a[b_field], bs_a.cavlc_block_residual, &bs1, &qf_a,
+                                       b_8x8, dct, nnz, nC, count );
+                int bits_a = bs_pos( &bs1 );
+                bs_flush( &bs1 );
+                bs_flush( &bs2 );
+                if( bits != bits_a || memcmp( output1, output2, bs2.p - output2 ) )
+                {
+                    fprintf( stderr, "residual_%dx%d_%s :  [FAILED]\n", n, n, b_field ? "field" : "frame" );
+                    ok = 0;
+                    continue;
+                }
+
+                set_func_name( "residual_%dx%d_%s", n, n, b_field ? "field" : "frame" );
+                if( !c_done )
+                {
+                    bs_init( &bs1, output1, size );
+                    call_c_frame( residual_write_blocks, "bits/cycle", 0, bits, &zigzag_c[b_field], bs_c.cavlc_block_residual,
+                                  &bs1, &qf_c, b_8x8, dct, nnz, nC, count );
+                }
+                if( b_asm )
+                {
+                    bs_init( &bs2, output2, size );
+                    call_a_frame( residual_write_blocks, "bits/cycle", 0, bits, &zigzag_a[b_field], bs_a.cavlc_block_residual,
+                                  &bs2, &qf_a, b_8x8, dct, nnz, nC, count );
+                }
+            }
+
+        free(dct);
+        free(nnz);
+        free(nC);
+        free(output1);
+        free(output2);
+    }
+    report( "residual scan :" );
+    if( !bench_align )
+        c_done = 1;
     return ret;
 }
 
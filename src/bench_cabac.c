@@ -75,7 +75,7 @@ void asm_cabac_encode_ue_bypass( void *cb, int exp_bits, int val )
 }
 
 #if 0
-static bench_t* get_bench( const char *name, int cpu )
+static bench_t* get_bench( const char *name, uint64_t cpu )
 {
     int i, j;
     for( i = 0; benchs[i].name && strcmp(name, benchs[i].name); i++ )
@@ -236,7 +236,7 @@ void x264_cabac_block_residual_rd_c( x264_t *h, x264_cabac_t *cb, int ctx_block_
 #endif
 extern const uint8_t asm_count_cat_m1[14];
 
-int check_cabac( int cpu_ref, int cpu_new )
+int check_cabac( uint64_t cpu_ref, uint64_t cpu_new )
 {
     int ret = 0, ok = 1, used_asm = 0;
     int i_chroma_format_idc = 3;
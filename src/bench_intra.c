@@ -48,6 +48,11 @@
 #include "bench.h"
 #include "macroblock.h"
 #include "c_kernels/predict.h"
+#include "c_kernels/iframe.h"
+
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf );
+void vbench_dct_init( uint64_t cpu, vbench_dct_function_t *dctf );
+void vbench_quant_init( int i_cqm_preset, uint64_t cpu, vbench_quant_function_t *pf );
 
 /* buf1, buf2: initialised to random data and shouldn't write into them */
 extern uint8_t *buf1, *buf2;
@@ -68,7 +73,7 @@ extern pixel *pbuf3, *pbuf4;
 
 extern int bench_pattern_len;
 extern const char *bench_pattern;
-char func_name[100];
+extern char func_name[100];
 extern  bench_func_t benchs[MAX_FUNCS];
 
 static const char *pixel_names[12] = { "16x16", "16x8", "8x16", "8x8", "8x4", "4x8", "4x4", "4x16", "4x2", "2x8", "2x4", "2x2" };
@@ -81,7 +86,7 @@ static const char **intra_predict_8x16c_names = intra_predict_8x8c_names;
 #define set_func_name(...) snprintf( func_name, sizeof(func_name), __VA_ARGS__ )
 
 
-static bench_t* get_bench( const char *name, int cpu )
+static bench_t* get_bench( const char *name, uint64_t cpu )
 {
     int i, j;
     for( i = 0; benchs[i].name && strcmp(name, benchs[i].name); i++ )
@@ -117,7 +122,105 @@ static int cmp_bench( const void *a, const void *b )
     }
 }
 
-int check_intra( int cpu_ref, int cpu_new ){
+/* A 1080p I-frame at a mid qp.  Every MB goes through the 16x16, 8x8, 4x4
+ * and chroma mode decision and is reconstructed before the next, once with
+ * the x3 and x9 kernels where they apply and once predicting and comparing
+ * each mode on its own. */
+#define IFRAME_WIDTH  1920
+#define IFRAME_HEIGHT 1088
+#define IFRAME_QP     26
+
+static int check_iframe( uint64_t cpu_ref, uint64_t cpu_new )
+{
+    static const char *path_names[2] = { "pred", "fast" };
+    vbench_pixel_function_t pixf_c, pixf_ref, pixf_a;
+    vbench_dct_function_t dctf_c, dctf_ref, dctf_a;
+    vbench_quant_function_t qf_c, qf_ref, qf_a;
+    vbench_iframe_func_t f_c, f_ref, f_a;
+    vbench_iframe_result_t res_c, res_a, res_pred;
+    vbench_iframe_t *ifr;
+    static int c_done = 0;
+    int b_bench_c = !c_done;
+    int ret = 0, ok = 1, used_asm = 1;
+
+    vbench_pixel_init( 0, &pixf_c );
+    vbench_pixel_init( cpu_ref, &pixf_ref );
+    vbench_pixel_init( cpu_new, &pixf_a );
+    vbench_dct_init( 0, &dctf_c );
+    vbench_dct_init( cpu_ref, &dctf_ref );
+    vbench_dct_init( cpu_new, &dctf_a );
+    vbench_quant_init( 0, 0, &qf_c );
+    vbench_quant_init( 0, cpu_ref, &qf_ref );
+    vbench_quant_init( 0, cpu_new, &qf_a );
+    vbench_iframe_func_init( 0, &f_c, CHROMA_FORMAT, &pixf_c, &dctf_c, &qf_c );
+    vbench_iframe_func_init( cpu_ref, &f_ref, CHROMA_FORMAT, &pixf_ref, &dctf_ref, &qf_ref );
+    vbench_iframe_func_init( cpu_new, &f_a, CHROMA_FORMAT, &pixf_a, &dctf_a, &qf_a );
+    if( bench_align )
+        return 0;
+    if( !memcmp( &pixf_a, &pixf_ref, sizeof(pixf_a) ) && !memcmp( &dctf_a, &dctf_ref, sizeof(dctf_a) ) &&
+        !memcmp( &qf_a, &qf_ref, sizeof(qf_a) ) &&
+        !memcmp( f_a.predict_16x16, f_ref.predict_16x16, sizeof(f_a) - offsetof( vbench_iframe_func_t, predict_16x16 ) ) )
+        return 0;
+
+    ifr = vbench_iframe_open( IFRAME_WIDTH, IFRAME_HEIGHT, CHROMA_FORMAT, IFRAME_QP );
+    if( !ifr )
+    {
+        fprintf( stderr, "iframe: unable to allocate the frames\n" );
+        return -1;
+    }
+    for( int b_fast = 0; b_fast < 2 && ok; b_fast++ )
+    {
+        int mbs = vbench_iframe_mbs( ifr );
+        int plane = -1, row = -1;
+
+        vbench_iframe_analyse( ifr, &f_c, b_fast, 0, &res_c );
+        vbench_iframe_analyse( ifr, &f_a, b_fast, 1, &res_a );
+        /* the shortcuts must not change a decision */
+        if( b_fast && (res_c.i_cost != res_pred.i_cost || memcmp( res_c.i_mbs, res_pred.i_mbs, sizeof(res_c.i_mbs) )) )
+            ok = 0;
+        if( vbench_iframe_cmp( ifr, &plane, &row ) || res_c.i_cost != res_a.i_cost ||
+            memcmp( res_c.i_mbs, res_a.i_mbs, sizeof(res_c.i_mbs) ) )
+            ok = 0;
+        if( !ok )
+        {
+            fprintf( stderr, "iframe FAILED: %s cost %"PRId64" (%d/%d/%d) vs %"PRId64" (%d/%d/%d), plane %d line %d\n",
+                     path_names[b_fast], res_c.i_cost, res_c.i_mbs[I_4x4], res_c.i_mbs[I_8x8], res_c.i_mbs[I_16x16],
+                     res_a.i_cost, res_a.i_mbs[I_4x4], res_a.i_mbs[I_8x8], res_a.i_mbs[I_16x16], plane, row );
+            break;
+        }
+        res_pred = res_c;
+
+        set_func_name( "iframe_%s_%s", vbench_chroma_names[CHROMA_FORMAT], path_names[b_fast] );
+        if( b_bench_c )
+            call_c_frame( vbench_iframe_analyse, "MB/s", 1, mbs, ifr, &f_c, b_fast, 0, &res_c );
+        call_a_frame( vbench_iframe_analyse, "MB/s", 1, mbs, ifr, &f_a, b_fast, 1, &res_a );
+    }
+
+    /* whether the x3/x9 shortcuts pay off over predicting each mode, on C
+     * (only once) and on this cpu */
+    if( ok && !strncmp( func_name, bench_pattern, bench_pattern_len ) )
+        for( int i = !b_bench_c; i < 2; i++ )
+        {
+            vbench_iframe_result_t *res = i ? &res_a : &res_c;
+            bench_rate_t *r[2];
+            for( int j = 0; j < 2; j++ )
+            {
+                set_func_name( "iframe_%s_%s", vbench_chroma_names[CHROMA_FORMAT], path_names[j] );
+                r[j] = get_bench_rate( func_name, "MB/s", 1, i ? cpu_new : 0 );
+            }
+            if( !r[0]->work || !r[1]->work || !r[1]->usecs )
+                continue;
+            fprintf( stderr, " - iframe fast path%s : x3/x9 %.2fx vs pred+satd, x9 on %d 4x4 and %d 8x8 blocks\n",
+                     i ? "" : " (C)",
+                     (r[0]->usecs / r[0]->work) / (r[1]->usecs / r[1]->work), res->i_x9[0], res->i_x9[1] );
+        }
+    vbench_iframe_close( ifr );
+    c_done = 1;
+    report( "iframe :" );
+    return ret;
+}
+
+int check_intra( uint64_t cpu_ref, uint64_t cpu_new ){
 
     int ret = 0, ok = 1, used_asm = 0;
     ALIGNED_ARRAY_32( pixel, edge,[36] );
@@ -201,10 +304,13 @@ int check_intra( int cpu_ref, int cpu_new ){
 
     for( int i = 0; i < 12; i++ )
         INTRA_TEST(   predict_4x4, i,  4,  4,  4, );
-    for( int i = 0; i < 7; i++ )
-        INTRA_TEST(  predict_8x8c, i,  8,  8, 16, );
-    for( int i = 0; i < 7; i++ )
-        INTRA_TEST( predict_8x16c, i,  8, 16, 16, );
+    /* 4:4:4 chroma is predicted with the luma modes */
+    if( CHROMA_FORMAT == CHROMA_420 )
+        for( int i = 0; i < 7; i++ )
+            INTRA_TEST(  predict_8x8c, i,  8,  8, 16, );
+    if( CHROMA_FORMAT == CHROMA_422 )
+        for( int i = 0; i < 7; i++ )
+            INTRA_TEST( predict_8x16c, i,  8, 16, 16, );
     for( int i = 0; i < 7; i++ )
         INTRA_TEST( predict_16x16, i, 16, 16, 16, );
     for( int i = 0; i < 12; i++ )
@@ -254,14 +360,21 @@ int check_intra( int cpu_ref, int cpu_new ){
     for( int test = 0; test < 100 && ok; test++ )
         for( int i = 0; i < 128 && ok; i++ )
         {
-            EXTREMAL_PLANE(  8,  8 );
-            INTRA_TEST(  predict_8x8c, I_PRED_CHROMA_P,  8,  8, 64, 1 );
-            EXTREMAL_PLANE(  8, 16 );
-            INTRA_TEST( predict_8x16c, I_PRED_CHROMA_P,  8, 16, 64, 1 );
+            if( CHROMA_FORMAT == CHROMA_420 )
+            {
+                EXTREMAL_PLANE(  8,  8 );
+                INTRA_TEST(  predict_8x8c, I_PRED_CHROMA_P,  8,  8, 64, 1 );
+            }
+            if( CHROMA_FORMAT == CHROMA_422 )
+            {
+                EXTREMAL_PLANE(  8, 16 );
+                INTRA_TEST( predict_8x16c, I_PRED_CHROMA_P,  8, 16, 64, 1 );
+            }
             EXTREMAL_PLANE( 16, 16 );
             INTRA_TEST( predict_16x16,  I_PRED_16x16_P, 16, 16, 64, 1 );
         }
     report( "intra pred :" );
+    ret |= check_iframe( cpu_ref, cpu_new );
     return ret;
 }
 
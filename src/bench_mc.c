@@ -43,9 +43,19 @@
 
 
 #include <ctype.h>
+#include <unistd.h>
 #include "osdep.h"
 #include "common.h"
 #include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/scale.h"
+#include "c_kernels/threadpool.h"
+#include "c_kernels/mbtree.h"
+#include "c_kernels/ingest.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/mcframe.h"
+#include "c_kernels/weightp.h"
+#include "c_kernels/esa.h"
 
 
 
@@ -69,7 +79,7 @@ extern pixel *pbuf3, *pbuf4;
 
 extern int bench_pattern_len;
 extern const char *bench_pattern;
-char func_name[100];
+extern char func_name[100];
 extern  bench_func_t benchs[MAX_FUNCS];
 
 static const char *pixel_names[12] = { "16x16", "16x8", "8x16", "8x8", "8x4", "4x8", "4x4", "4x16", "4x2", "2x8", "2x4", "2x2" };
@@ -86,7 +96,7 @@ static const char **intra_predict_8x16c_names = intra_predict_8x8c_names;
 const uint8_t vbench_hpel_ref0[16] = {0,1,1,1,0,1,1,1,2,3,3,3,0,1,1,1};
 const uint8_t vbench_hpel_ref1[16] = {0,0,1,0,2,2,3,2,2,2,3,2,2,2,3,2};
 
-static bench_t* get_bench( const char *name, int cpu )
+static bench_t* get_bench( const char *name, uint64_t cpu )
 {
     int i, j;
     for( i = 0; benchs[i].name && strcmp(name, benchs[i].name); i++ )
@@ -100,13 +110,879 @@ static bench_t* get_bench( const char *name, int cpu )
     benchs[i].vers[j].cpu = cpu;
     return &benchs[i].vers[j];
 }
+/* A typical 720p ABR ladder, ratios 1.5 to 5 and not all integer */
+#define SCALE_SRC_WIDTH  1280
+#define SCALE_SRC_HEIGHT 720
+#define SCALE_LADDER     4
+static const int scale_ladder_dims[SCALE_LADDER][2] = { {854,480}, {640,360}, {426,240}, {256,144} };
+
+typedef struct
+{
+    pixel *src[3];
+    intptr_t i_src[3];
+    pixel *dst[2][SCALE_LADDER][3];
+    intptr_t i_dst[SCALE_LADDER][3];
+    int i_pixels;
+} scale_ladder_t;
+
+static int scale_ladder_init( scale_ladder_t *l )
+{
+    if( l->src[0] )
+        return 0;
+    for( int p = 0; p < 3; p++ )
+    {
+        int w = SCALE_SRC_WIDTH >> !!p;
+        int h = SCALE_SRC_HEIGHT >> !!p;
+        l->i_src[p] = ALIGN( w, 32 );
+        l->src[p] = memalign( 32, l->i_src[p] * h * sizeof(pixel) );
+        if( !l->src[p] )
+            return -1;
+        for( int y = 0; y < h; y++ )
+            for( int x = 0; x < w; x++ )
+                l->src[p][y*l->i_src[p]+x] = ((x*x + 3*y*y) >> 7) + (rand() & 31);
+    }
+    l->i_pixels = 0;
+    for( int o = 0; o < SCALE_LADDER; o++ )
+    {
+        l->i_pixels += scale_ladder_dims[o][0] * scale_ladder_dims[o][1];
+        for( int p = 0; p < 3; p++ )
+        {
+            /* the vertical pass may write 15 pixels past the width */
+            l->i_dst[o][p] = ALIGN( (scale_ladder_dims[o][0] >> !!p) + 16, 32 );
+            for( int i = 0; i < 2; i++ )
+            {
+                l->dst[i][o][p] = memalign( 32, l->i_dst[o][p] * (scale_ladder_dims[o][1] >> !!p) * sizeof(pixel) );
+                if( !l->dst[i][o][p] )
+                    return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* one scaler per rendition, each reading the whole source */
+static void scale_ladder_separate( vbench_scaler_t **s, pixel *src[3], intptr_t i_src[3],
+                                   pixel *dst[][3], intptr_t i_dst[][3] )
+{
+    for( int o = 0; o < SCALE_LADDER; o++ )
+        vbench_scaler_frame( s[o], src, i_src, dst+o, i_dst+o );
+}
+
+/* The C ladder is timed once, the kernel checks and the asm ladder only
+ * run when cpu_new brought a scaler pass of its own (b_asm). */
+static int check_scale( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new, int b_asm )
+{
+    static scale_ladder_t l;
+    static int c_done = 0;
+    ALIGNED_16( int16_t rows[32][112] );
+    int16_t *rowp[32];
+    vbench_scale_filter_t f;
+    vbench_scaler_t *s_c = NULL, *s_a = NULL, *sep_c[SCALE_LADDER] = {0}, *sep_a[SCALE_LADDER] = {0};
+    int ret = 0, ok = 1, used_asm = b_asm;
+
+    if( !b_asm && c_done )
+        return 0;
+
+    set_func_name( "scale_h" );
+    for( int w = 24; w <= 88 && ok && b_asm; w += 13 )
+    {
+        if( vbench_scale_filter_init( &f, 96, w, SCALE_LANCZOS, 4, 14 ) )
+            return -1;
+        memset( pbuf3, 0, 256*sizeof(int16_t) );
+        memset( pbuf4, 0, 256*sizeof(int16_t) );
+        call_c( mc_c->scale_h, (int16_t*)pbuf3, pbuf1, f.pos, f.coef, f.i_taps, w );
+        call_a( mc_a->scale_h, (int16_t*)pbuf4, pbuf1, f.pos, f.coef, f.i_taps, w );
+        if( memcmp( pbuf3, pbuf4, w*sizeof(int16_t) ) )
+        {
+            ok = 0;
+            fprintf( stderr, "scale_h FAILED: 96->%d, %d taps\n", w, f.i_taps );
+        }
+        vbench_scale_filter_free( &f );
+    }
+
+    set_func_name( "scale_v" );
+    for( int i = 0; i < 32; i++ )
+    {
+        rowp[i] = rows[i];
+        for( int x = 0; x < 112; x++ )
+            rows[i][x] = (pbuf1[i*112+x] << 6) + (pbuf2[i*112+x] & 63);
+    }
+    for( int h = 12; h <= 36 && ok && b_asm; h += 6 )
+    {
+        if( vbench_scale_filter_init( &f, 36, h, SCALE_LANCZOS, 2, 12 ) || f.i_taps > 32 )
+            return -1;
+        for( int w = 1; w <= 96; w += w < 16 ? 5 : 27 )
+        {
+            memset( pbuf3, 0, 128 );
+            memset( pbuf4, 0, 128 );
+            call_c1( mc_c->scale_v, pbuf3, rowp, f.coef + (h-1)*f.i_taps, f.i_taps, w );
+            call_a1( mc_a->scale_v, pbuf4, rowp, f.coef + (h-1)*f.i_taps, f.i_taps, w );
+            if( memcmp( pbuf3, pbuf4, w ) )
+            {
+                ok = 0;
+                fprintf( stderr, "scale_v FAILED: %d taps, width %d\n", f.i_taps, w );
+                break;
+            }
+        }
+        call_c2( mc_c->scale_v, pbuf3, rowp, f.coef, f.i_taps, 96 );
+        call_a2( mc_a->scale_v, pbuf4, rowp, f.coef, f.i_taps, 96 );
+        vbench_scale_filter_free( &f );
+    }
+
+    /* the whole ladder must be bit-exact against the C passes */
+    if( scale_ladder_init( &l ) )
+        return -1;
+    s_c = vbench_scaler_open( mc_c, SCALE_SRC_WIDTH, SCALE_SRC_HEIGHT, SCALE_LADDER, scale_ladder_dims, SCALE_BICUBIC );
+    s_a = vbench_scaler_open( mc_a, SCALE_SRC_WIDTH, SCALE_SRC_HEIGHT, SCALE_LADDER, scale_ladder_dims, SCALE_BICUBIC );
+    for( int o = 0; o < SCALE_LADDER; o++ )
+    {
+        sep_c[o] = vbench_scaler_open( mc_c, SCALE_SRC_WIDTH, SCALE_SRC_HEIGHT, 1, scale_ladder_dims+o, SCALE_BICUBIC );
+        sep_a[o] = vbench_scaler_open( mc_a, SCALE_SRC_WIDTH, SCALE_SRC_HEIGHT, 1, scale_ladder_dims+o, SCALE_BICUBIC );
+        if( !sep_c[o] || !sep_a[o] )
+            ok = 0;
+    }
+    if( ok && s_c && s_a )
+    {
+        vbench_scaler_frame( s_c, l.src, l.i_src, l.dst[0], l.i_dst );
+        vbench_scaler_frame( s_a, l.src, l.i_src, l.dst[1], l.i_dst );
+        for( int o = 0; o < SCALE_LADDER && b_asm; o++ )
+            for( int p = 0; p < 3; p++ )
+            {
+                int y = 0, h = scale_ladder_dims[o][1] >> !!p;
+                while( y < h && !memcmp( l.dst[0][o][p] + y*l.i_dst[o][p], l.dst[1][o][p] + y*l.i_dst[o][p],
+                                         (scale_ladder_dims[o][0] >> !!p) * sizeof(pixel) ) )
+                    y++;
+                if( y < h )
+                {
+                    ok = 0;
+                    fprintf( stderr, "scale ladder FAILED: %dx%d plane %d line %d\n",
+                             scale_ladder_dims[o][0], scale_ladder_dims[o][1], p, y );
+                }
+            }
+
+        set_func_name( "scale_ladder" );
+        if( !c_done )
+            call_c_frame( vbench_scaler_frame, "MP/s", 1e6, l.i_pixels, s_c, l.src, l.i_src, l.dst[0], l.i_dst );
+        if( b_asm )
+            call_a_frame( vbench_scaler_frame, "MP/s", 1e6, l.i_pixels, s_a, l.src, l.i_src, l.dst[1], l.i_dst );
+        set_func_name( "scale_ladder_separate" );
+        if( !c_done )
+            call_c_frame( scale_ladder_separate, "MP/s", 1e6, l.i_pixels, sep_c, l.src, l.i_src, l.dst[0], l.i_dst );
+        if( b_asm )
+            call_a_frame( scale_ladder_separate, "MP/s", 1e6, l.i_pixels, sep_a, l.src, l.i_src, l.dst[1], l.i_dst );
+        c_done = 1;
+    }
+    else
+        ok = 0;
+
+    vbench_scaler_close( s_c );
+    vbench_scaler_close( s_a );
+    for( int o = 0; o < SCALE_LADDER; o++ )
+    {
+        vbench_scaler_close( sep_c[o] );
+        vbench_scaler_close( sep_a[o] );
+    }
+    report( "scale :" );
+    return ret;
+}
+
+/* A whole row of a 1080p lowres frame over MV fields of increasing
+ * coherence, the share of MBs following one global motion.  Groups of 8
+ * coherent MBs hit consecutive targets and take the conflict-aware path
+ * of the SIMD scatter, random ones the per-MB path. */
+static int check_propagate_list_coherence( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new )
+{
+    static const int coherence[4] = { 0, 50, 90, 100 };
+    const int width = 120, height = 8, size = width*height, mb_y = 3;
+    uint16_t *ref_costsc = memalign( 32, size * 2 * sizeof(uint16_t) + width * 16 + 2048 );
+    uint16_t *ref_costsa = ref_costsc + size;
+    int16_t (*mvs)[2] = (int16_t(*)[2])(ref_costsa + size);
+    int16_t *propagate_amount = (int16_t*)(mvs + width);
+    uint16_t *lowres_costs = (uint16_t*)(propagate_amount + width);
+    void *scratch_buffer2 = lowres_costs + width;
+    int ok = 1;
+
+    if( !ref_costsc )
+        return 0;
+    for( int c = 0; c < 4; c++ )
+    {
+        int bipred_weight = (rand()%63)+1;
+        for( int j = 0; j < size; j++ )
+            ref_costsc[j] = ref_costsa[j] = rand()&16383;
+        for( int j = 0; j < width; j++ )
+        {
+            int b_coherent = rand()%100 < coherence[c];
+            mvs[j][0] = b_coherent ?  37 : (rand()&255) - 128;
+            mvs[j][1] = b_coherent ? -21 : (rand()&255) - 128;
+            propagate_amount[j] = rand()&32767;
+            lowres_costs[j] = ((rand()&3) ? 1 : 3) << LOWRES_COST_SHIFT;
+        }
+
+        set_func_name( "mbtree_propagate_list_coh%d", coherence[c] );
+        call_c1( mc_c->mbtree_propagate_list, ref_costsc, mvs, propagate_amount, lowres_costs, bipred_weight, mb_y, width, 0, width, width, height, scratch_buffer2 );
+        call_a1( mc_a->mbtree_propagate_list, ref_costsa, mvs, propagate_amount, lowres_costs, bipred_weight, mb_y, width, 0, width, width, height, scratch_buffer2 );
+        for( int j = 0; j < size && ok; j++ )
+            if( ref_costsa[j] != ref_costsc[j] )
+            {
+                ok = 0;
+                fprintf( stderr, "mbtree_propagate_list FAILED: %d%% coherent MVs at %d: %d != %d\n",
+                         coherence[c], j, ref_costsc[j], ref_costsa[j] );
+            }
+        call_c2( mc_c->mbtree_propagate_list, ref_costsc, mvs, propagate_amount, lowres_costs, bipred_weight, mb_y, width, 0, width, width, height, scratch_buffer2 );
+        call_a2( mc_a->mbtree_propagate_list, ref_costsa, mvs, propagate_amount, lowres_costs, bipred_weight, mb_y, width, 0, width, width, height, scratch_buffer2 );
+    }
+    free( ref_costsc );
+    return ok;
+}
+
+/* 1080p in lowres 8x8 MBs with 3 B frames, over the default rc-lookahead
+ * and over a whole default keyint */
+#define MBTREE_MB_WIDTH  120
+#define MBTREE_MB_HEIGHT 68
+#define MBTREE_BFRAMES   3
+static const int mbtree_gop_frames[2] = { 40, 250 };
+
+/* returns 1 + the first frame that differs */
+static int mbtree_gop_cmp( vbench_mbtree_t *a, vbench_mbtree_t *b, int i_frames )
+{
+    for( int i = 0; i < i_frames; i++ )
+    {
+        vbench_mbtree_frame_t *fa = vbench_mbtree_frame( a, i );
+        vbench_mbtree_frame_t *fb = vbench_mbtree_frame( b, i );
+        if( memcmp( fa->propagate_cost, fb->propagate_cost, MBTREE_MB_WIDTH*MBTREE_MB_HEIGHT*sizeof(uint16_t) ) ||
+            memcmp( fa->qp_offset, fb->qp_offset, MBTREE_MB_WIDTH*MBTREE_MB_HEIGHT*sizeof(float) ) )
+            return i+1;
+    }
+    return 0;
+}
+
+/* The C engine is timed once, the asm one only when cpu_new brought
+ * propagate kernels of its own (b_asm). */
+static int check_mbtree_gop( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new, int b_asm )
+{
+    static int c_done = 0;
+    int ret = 0, ok = 1, used_asm = b_asm;
+    int threads = sysconf( _SC_NPROCESSORS_ONLN );
+
+    if( !b_asm && c_done )
+        return 0;
+    threads = MIN( MAX( threads, 2 ), THREADPOOL_MAX_THREADS );
+    for( int g = 0; g < 2 && ok; g++ )
+    {
+        int frames = mbtree_gop_frames[g];
+        vbench_mbtree_t *t_c = vbench_mbtree_open( mc_c, MBTREE_MB_WIDTH, MBTREE_MB_HEIGHT, frames, MBTREE_BFRAMES, 1 );
+        vbench_mbtree_t *t_a = vbench_mbtree_open( mc_a, MBTREE_MB_WIDTH, MBTREE_MB_HEIGHT, frames, MBTREE_BFRAMES, 1 );
+        vbench_mbtree_t *t_t = vbench_mbtree_open( mc_a, MBTREE_MB_WIDTH, MBTREE_MB_HEIGHT, frames, MBTREE_BFRAMES, threads );
+        int diff;
+
+        if( t_c && t_a && t_t )
+        {
+            vbench_mbtree_gen( t_c, 0x2545f491 + g, 60 );
+            vbench_mbtree_gen( t_a, 0x2545f491 + g, 60 );
+            vbench_mbtree_gen( t_t, 0x2545f491 + g, 60 );
+            threads = vbench_mbtree_threads( t_t );
+
+            /* the C and asm kernels round differently, but the threaded
+             * scatter must reproduce the serial one exactly */
+            vbench_mbtree_gop( t_a );
+            vbench_mbtree_gop( t_t );
+            if( (diff = mbtree_gop_cmp( t_a, t_t, frames )) )
+            {
+                ok = 0;
+                fprintf( stderr, "mbtree gop FAILED: %d frames, %d threads differ from serial at frame %d\n",
+                         frames, threads, diff-1 );
+            }
+
+            set_func_name( "mbtree_gop%d", frames );
+            if( !c_done )
+                call_c_frame( vbench_mbtree_gop, "frames/s", 1, frames, t_c );
+            if( b_asm )
+                call_a_frame( vbench_mbtree_gop, "frames/s", 1, frames, t_a );
+            /* without asm of its own, mc_a is still the C on the first step */
+            set_func_name( "mbtree_gop%d_%dt", frames, threads );
+            if( b_asm )
+                call_a_frame( vbench_mbtree_gop, "frames/s", 1, frames, t_t );
+            else
+                call_c_frame( vbench_mbtree_gop, "frames/s", 1, frames, t_t );
+        }
+        else
+        {
+            ok = 0;
+            fprintf( stderr, "mbtree gop: unable to allocate the engine\n" );
+        }
+        vbench_mbtree_close( t_c );
+        vbench_mbtree_close( t_a );
+        vbench_mbtree_close( t_t );
+    }
+    c_done = 1;
+    report( "mbtree gop :" );
+    return ret;
+}
+
+/* Whole 1080p frames, more of them than fit in the last level cache
+ * once source and destination are counted */
+#define INGEST_WIDTH  1920
+#define INGEST_HEIGHT 1080
+#define INGEST_FRAMES 4
+static const char * const ingest_policy_names[2] = { "cached", "stream" };
+
+static int ingest_cmp( vbench_ingest_t *a, vbench_ingest_t *b )
+{
+    for( int i = 0; i < INGEST_FRAMES; i++ )
+        for( int p = 0; p < vbench_ingest_planes( a ); p++ )
+        {
+            intptr_t stride_a, stride_b;
+            int w, h;
+            pixel *pa = vbench_ingest_plane( a, i, p, &stride_a, &w, &h );
+            pixel *pb = vbench_ingest_plane( b, i, p, &stride_b, &w, &h );
+            for( int y = 0; y < h; y++ )
+                if( memcmp( pa + y*stride_a, pb + y*stride_b, w * sizeof(pixel) ) )
+                    return 1;
+        }
+    return 0;
+}
+
+/* The C engine is timed once, the asm one only when cpu_new brought
+ * plane copy kernels of its own (b_asm). */
+static int check_ingest( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new, int b_asm )
+{
+    static int c_done = 0;
+    int ret = 0, ok = 1, used_asm = b_asm;
+    int threads = sysconf( _SC_NPROCESSORS_ONLN );
+    int64_t max_size = vbench_ingest_frame_size( INGEST_BGRA_GBRP, INGEST_WIDTH, INGEST_HEIGHT );
+    uint8_t *src;
+
+    if( !b_asm && c_done )
+        return 0;
+
+    /* the SIMD kernels read a little past the last source row */
+    src = vbench_malloc( INGEST_FRAMES * max_size + 64 );
+    if( !src )
+        return -1;
+    for( int64_t i = 0; i < INGEST_FRAMES * max_size + 64; i++ )
+        src[i] = rand();
+
+    threads = MIN( MAX( threads, 2 ), THREADPOOL_MAX_THREADS );
+    for( int f = 0; f < INGEST_FORMATS && ok; f++ )
+    {
+        vbench_ingest_t *t_c, *t_a, *t_t;
+        int64_t traffic;
+
+        if( !vbench_ingest_frame_size( f, INGEST_WIDTH, INGEST_HEIGHT ) )
+            continue;
+        t_c = vbench_ingest_open( mc_c, f, INGEST_WIDTH, INGEST_HEIGHT, INGEST_FRAMES, 1 );
+        t_a = vbench_ingest_open( mc_a, f, INGEST_WIDTH, INGEST_HEIGHT, INGEST_FRAMES, 1 );
+        t_t = vbench_ingest_open( mc_a, f, INGEST_WIDTH, INGEST_HEIGHT, INGEST_FRAMES, threads );
+        if( t_c && t_a && t_t )
+        {
+            threads = vbench_ingest_threads( t_t );
+            traffic = vbench_ingest_traffic( t_c ) * INGEST_FRAMES;
+
+            /* every kernel set, store policy and band split must give the
+             * same pictures */
+            vbench_ingest_frames( t_c, src, INGEST_FRAMES, INGEST_CACHED );
+            vbench_ingest_frames( t_a, src, INGEST_FRAMES, INGEST_CACHED );
+            vbench_ingest_frames( t_t, src, INGEST_FRAMES, INGEST_STREAM );
+            if( ingest_cmp( t_c, t_a ) || ingest_cmp( t_c, t_t ) )
+            {
+                ok = 0;
+                fprintf( stderr, "ingest %s FAILED\n", vbench_ingest_names[f] );
+            }
+
+            for( int p = INGEST_CACHED; p <= INGEST_STREAM; p++ )
+            {
+                set_func_name( "ingest_%s_%s", vbench_ingest_names[f], ingest_policy_names[p] );
+                if( !c_done )
+                    call_c_frame( vbench_ingest_frames, "GB/s", 1e9, traffic, t_c, src, INGEST_FRAMES, p );
+                if( b_asm )
+                    call_a_frame( vbench_ingest_frames, "GB/s", 1e9, traffic, t_a, src, INGEST_FRAMES, p );
+                /* without asm of its own, mc_a is still the C on the first step */
+                set_func_name( "ingest_%s_%s_%dt", vbench_ingest_names[f], ingest_policy_names[p], threads );
+                if( b_asm )
+                    call_a_frame( vbench_ingest_frames, "GB/s", 1e9, traffic, t_t, src, INGEST_FRAMES, p );
+                else
+                    call_c_frame( vbench_ingest_frames, "GB/s", 1e9, traffic, t_t, src, INGEST_FRAMES, p );
+            }
+        }
+        else
+        {
+            ok = 0;
+            fprintf( stderr, "ingest: unable to allocate the engine\n" );
+        }
+        vbench_ingest_close( t_c );
+        vbench_ingest_close( t_a );
+        vbench_ingest_close( t_t );
+    }
+    vbench_free( src );
+    c_done = 1;
+    report( "ingest :" );
+    return ret;
+}
+
 extern vbench_weight_t vbench_weight_none[3];
-int check_mc( int cpu_ref, int cpu_new )
+
+/* A 1080p reference frame with a 64-pixel border, its three hpel planes
+ * and one 16x16 mc_luma/get_ref per MB over MVs of up to +-40 pixels,
+ * under every page size and placement.  A 16x16 block spans 8 pages of
+ * each plane it reads with 4K pages and usually one with 2M pages, and
+ * the whole set is ~10MB, so the MC passes are mostly TLB bound. */
+#define FRAME_MEM_WIDTH  1920
+#define FRAME_MEM_HEIGHT 1088
+#define FRAME_MEM_PAD    64
+#define FRAME_MEM_MV     40
+#define FRAME_MEM_MBS    ((FRAME_MEM_WIDTH/16) * (FRAME_MEM_HEIGHT/16))
+
+static const vbench_mem_policy_t frame_mem_policies[] =
+{
+    { MEM_PAGES_4K,      MEM_NODE_LOCAL },
+    { MEM_PAGES_THP,     MEM_NODE_LOCAL },
+    { MEM_PAGES_HUGETLB, MEM_NODE_LOCAL },
+    { MEM_PAGES_4K,      MEM_NODE_REMOTE },
+    { MEM_PAGES_THP,     MEM_NODE_REMOTE },
+};
+#define FRAME_MEM_POLICIES (sizeof(frame_mem_policies)/sizeof(*frame_mem_policies))
+
+typedef struct
+{
+    vbench_plane_t ref[4];  /* fullpel, h, v, c */
+    vbench_plane_t pred[2];
+    int16_t (*mv)[2];
+    int16_t *buf;
+} frame_mem_t;
+
+static void frame_mem_free( frame_mem_t *f )
+{
+    for( int i = 0; i < 4; i++ )
+        vbench_plane_free( &f->ref[i] );
+    vbench_plane_free( &f->pred[0] );
+    vbench_plane_free( &f->pred[1] );
+    free( f->mv );
+    free( f->buf );
+}
+
+static int frame_mem_alloc( frame_mem_t *f, const vbench_mem_policy_t *p )
+{
+    memset( f, 0, sizeof(frame_mem_t) );
+    for( int i = 0; i < 4; i++ )
+        if( vbench_plane_alloc( &f->ref[i], FRAME_MEM_WIDTH, FRAME_MEM_HEIGHT, FRAME_MEM_PAD, p ) )
+            goto fail;
+    for( int i = 0; i < 2; i++ )
+        if( vbench_plane_alloc( &f->pred[i], FRAME_MEM_WIDTH, FRAME_MEM_HEIGHT, 0, p ) )
+            goto fail;
+    f->mv = malloc( FRAME_MEM_MBS * sizeof(*f->mv) );
+    f->buf = memalign( 32, (FRAME_MEM_WIDTH + 64) * sizeof(int16_t) );
+    if( !f->mv || !f->buf )
+        goto fail;
+
+    /* first touch from this thread */
+    for( int y = 0; y < FRAME_MEM_HEIGHT; y++ )
+        for( int x = 0; x < FRAME_MEM_WIDTH; x++ )
+            f->ref[0].plane[y*f->ref[0].i_stride+x] = ((x*x + 3*y*y) >> 8) + (rand() & 15);
+    vbench_plane_expand_border( &f->ref[0] );
+    for( int i = 1; i < 4; i++ )
+        memset( f->ref[i].buffer, 0, f->ref[i].i_stride * (FRAME_MEM_HEIGHT + 2*f->ref[i].i_pad) * sizeof(pixel) );
+    for( int i = 0; i < 2; i++ )
+        memset( f->pred[i].buffer, 0, f->pred[i].i_stride * FRAME_MEM_HEIGHT * sizeof(pixel) );
+    for( int i = 0; i < FRAME_MEM_MBS; i++ )
+    {
+        f->mv[i][0] = (rand() % (8*FRAME_MEM_MV+1)) - 4*FRAME_MEM_MV;
+        f->mv[i][1] = (rand() % (8*FRAME_MEM_MV+1)) - 4*FRAME_MEM_MV;
+    }
+    return 0;
+fail:
+    frame_mem_free( f );
+    return -1;
+}
+
+/* hpel planes of the whole frame, with their borders as in an encoder */
+static void frame_mem_hpel( vbench_mc_functions_t *mc, frame_mem_t *f )
+{
+    mc->hpel_filter( f->ref[1].plane, f->ref[2].plane, f->ref[3].plane, f->ref[0].plane,
+                     f->ref[0].i_stride, FRAME_MEM_WIDTH, FRAME_MEM_HEIGHT, f->buf );
+    for( int i = 1; i < 4; i++ )
+        vbench_plane_expand_border( &f->ref[i] );
+}
+
+static void frame_mem_mc_luma( vbench_mc_functions_t *mc, frame_mem_t *f, vbench_plane_t *pred )
+{
+    pixel *src[4] = { f->ref[0].plane, f->ref[1].plane, f->ref[2].plane, f->ref[3].plane };
+    for( int mby = 0, i = 0; mby < FRAME_MEM_HEIGHT/16; mby++ )
+        for( int mbx = 0; mbx < FRAME_MEM_WIDTH/16; mbx++, i++ )
+            mc->mc_luma( pred->plane + 16*(mby*pred->i_stride + mbx), pred->i_stride, src, f->ref[0].i_stride,
+                         64*mbx + f->mv[i][0], 64*mby + f->mv[i][1], 16, 16, vbench_weight_none );
+}
+
+static void frame_mem_get_ref( vbench_mc_functions_t *mc, frame_mem_t *f, vbench_plane_t *pred )
+{
+    pixel *src[4] = { f->ref[0].plane, f->ref[1].plane, f->ref[2].plane, f->ref[3].plane };
+    for( int mby = 0, i = 0; mby < FRAME_MEM_HEIGHT/16; mby++ )
+        for( int mbx = 0; mbx < FRAME_MEM_WIDTH/16; mbx++, i++ )
+        {
+            intptr_t stride = pred->i_stride;
+            mc->get_ref( pred->plane + 16*(mby*pred->i_stride + mbx), &stride, src, f->ref[0].i_stride,
+                         64*mbx + f->mv[i][0], 64*mby + f->mv[i][1], 16, 16, vbench_weight_none );
+        }
+}
+
+/* The C passes are timed once, the asm ones only when cpu_new brought
+ * hpel or luma MC kernels of its own (b_asm). */
+static int check_frame_memory( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new, int b_asm )
+{
+    static int b_noted[FRAME_MEM_POLICIES];
+    static int c_done = 0;
+    int ret = 0, ok = 1, used_asm = b_asm;
+
+    if( !b_asm && c_done )
+        return 0;
+    for( int p = 0; p < FRAME_MEM_POLICIES && ok; p++ )
+    {
+        frame_mem_t f;
+        char name[32];
+        int64_t thp;
+
+        vbench_mem_name( &frame_mem_policies[p], name, sizeof(name) );
+        if( frame_mem_alloc( &f, &frame_mem_policies[p] ) )
+        {
+            if( !b_noted[p]++ )
+                fprintf( stderr, "frame memory: %s not available, skipped\n", name );
+            continue;
+        }
+        thp = vbench_mem_thp_bytes( f.ref[0].buffer );
+        if( frame_mem_policies[p].i_pages == MEM_PAGES_THP && !thp && !b_noted[p]++ )
+            fprintf( stderr, "frame memory: %s got no huge pages, see /sys/kernel/mm/transparent_hugepage\n", name );
+
+        set_func_name( "frame_hpel_%s", name );
+        if( !c_done )
+            call_c_frame( frame_mem_hpel, "frames/s", 1, 1, mc_c, &f );
+        if( b_asm )
+            call_a_frame( frame_mem_hpel, "frames/s", 1, 1, mc_a, &f );
+
+        /* both kernel sets predict from the same C hpel planes */
+        frame_mem_hpel( mc_c, &f );
+        if( b_asm )
+        {
+            frame_mem_mc_luma( mc_c, &f, &f.pred[0] );
+            frame_mem_mc_luma( mc_a, &f, &f.pred[1] );
+            for( int y = 0; y < FRAME_MEM_HEIGHT; y++ )
+                if( memcmp( f.pred[0].plane + y*f.pred[0].i_stride, f.pred[1].plane + y*f.pred[1].i_stride,
+                            FRAME_MEM_WIDTH * sizeof(pixel) ) )
+                {
+                    ok = 0;
+                    fprintf( stderr, "frame mc_luma FAILED: %s line %d\n", name, y );
+                    break;
+                }
+        }
+
+        set_func_name( "frame_mc_luma_%s", name );
+        if( !c_done )
+            call_c_frame( frame_mem_mc_luma, "frames/s", 1, 1, mc_c, &f, &f.pred[0] );
+        if( b_asm )
+            call_a_frame( frame_mem_mc_luma, "frames/s", 1, 1, mc_a, &f, &f.pred[1] );
+        set_func_name( "frame_get_ref_%s", name );
+        if( !c_done )
+            call_c_frame( frame_mem_get_ref, "frames/s", 1, 1, mc_c, &f, &f.pred[0] );
+        if( b_asm )
+            call_a_frame( frame_mem_get_ref, "frames/s", 1, 1, mc_a, &f, &f.pred[1] );
+        frame_mem_free( &f );
+    }
+    c_done = 1;
+    report( "frame memory :" );
+    return ret;
+}
+
+/* B-frame style reconstruction of a whole 1080p frame: every partition
+ * of a synthetic MV field is fetched from two padded references with
+ * their hpel planes, averaged or weighted and copied out, so the numbers
+ * include the cache and TLB misses the per-block benchmarks never see. */
+#define MCFRAME_WIDTH  1920
+#define MCFRAME_HEIGHT 1088
+
+static const struct
+{
+    const char *name;
+    vbench_mcframe_param_t param;
+} mcframe_fields[] =
+{
+    /* coherence, split, bipred, weighted, range, field */
+    { "p16x16_c90",   { 90,  0,  0, 0, 16, 0 } },
+    { "p_mixed_c50",  { 50, 40,  0, 0, 32, 0 } },
+    { "p_weighted",   { 90, 20,  0, 1, 16, 0 } },
+    { "b16x16_c90",   { 90,  0, 60, 0, 16, 0 } },
+    { "b_mixed_c50",  { 50, 40, 50, 0, 32, 0 } },
+    { "b_small_c10",  { 10, 90, 50, 0, 48, 0 } },
+    { "b_weighted",   { 50, 40, 50, 1, 32, 0 } },
+    { "p_field_c50",  { 50, 40,  0, 0, 16, 1 } },
+    { "b_field_c50",  { 50, 40, 50, 0, 16, 1 } },
+};
+
+/* The C reconstruction is timed once, the asm one only when cpu_new
+ * brought MC kernels of its own (b_asm). */
+static int check_mcframe( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, uint64_t cpu_new, int b_asm )
+{
+    static int c_done = 0;
+    vbench_mcframe_t *mf;
+    int ret = 0, ok = 1, used_asm = b_asm;
+
+    if( !b_asm && c_done )
+        return 0;
+    mf = vbench_mcframe_open( mc_c, MCFRAME_WIDTH, MCFRAME_HEIGHT, CHROMA_FORMAT );
+    if( !mf )
+    {
+        fprintf( stderr, "mc frame: unable to allocate the frames\n" );
+        return -1;
+    }
+    for( int i = 0; i < sizeof(mcframe_fields)/sizeof(*mcframe_fields) && ok; i++ )
+    {
+        int mbs = vbench_mcframe_mbs( mf );
+        int plane, row;
+
+        vbench_mcframe_field( mf, &mcframe_fields[i].param );
+        if( b_asm )
+        {
+            vbench_mcframe_predict( mf, mc_c, 0 );
+            vbench_mcframe_predict( mf, mc_a, 1 );
+            if( vbench_mcframe_cmp( mf, &plane, &row ) )
+            {
+                ok = 0;
+                fprintf( stderr, "mc frame FAILED: %s plane %d line %d\n", mcframe_fields[i].name, plane, row );
+                break;
+            }
+        }
+        set_func_name( "mcframe_%s_%s", vbench_chroma_names[CHROMA_FORMAT], mcframe_fields[i].name );
+        if( !c_done )
+            call_c_frame( vbench_mcframe_predict, "MB/s", 1, mbs, mf, mc_c, 0 );
+        if( b_asm )
+            call_a_frame( vbench_mcframe_predict, "MB/s", 1, mbs, mf, mc_a, 1 );
+    }
+    vbench_mcframe_close( mf );
+    c_done = 1;
+    report( "mc frame :" );
+    return ret;
+}
+
+/* A fade, a flash and a still scene at 1080p.  Every frame is analysed,
+ * its weights searched and the weighted reference written, as in the
+ * lookahead of an encoder with weightp on fades. */
+#define WEIGHTP_WIDTH  1920
+#define WEIGHTP_HEIGHT 1088
+
+static const struct
+{
+    const char *name;
+    float f_scale[3];
+    int i_offset[3];
+} weightp_scenes[] =
+{
+    { "fade",   { 0.75, 0.90, 0.90 }, { 12,  6, -6 } },
+    { "flash",  { 1.00, 1.00, 1.00 }, { 24,  0,  0 } },
+    { "static", { 1.00, 1.00, 1.00 }, {  0,  0,  0 } },
+};
+
+/* same reference in both engines, the current frame is the scene applied
+ * to it plus a little noise */
+static void weightp_fill( vbench_weightp_t *wp[2], int i_frame, int i_scene )
+{
+    for( int p = 0; p < (CHROMA_FORMAT ? 3 : 1); p++ )
+    {
+        int w = WEIGHTP_WIDTH >> (p ? CHROMA_H_SHIFT : 0), h = WEIGHTP_HEIGHT >> (p ? CHROMA_V_SHIFT : 0);
+        intptr_t stride[2];
+        pixel *pix[2] = { vbench_weightp_plane( wp[0], i_frame, p, &stride[0] ),
+                          vbench_weightp_plane( wp[1], i_frame, p, &stride[1] ) };
+        for( int y = 0; y < h; y++ )
+            for( int x = 0; x < w; x++ )
+            {
+                int v = 48 + (((x*x + 3*y*y + 7*p*x) >> 10) & 127) + (rand() & 31);
+                if( i_frame == 0 )
+                {
+                    pixel *ref = vbench_weightp_plane( wp[0], 1, p, &stride[0] );
+                    v = ref[y*stride[0]+x] * weightp_scenes[i_scene].f_scale[p] + weightp_scenes[i_scene].i_offset[p] + (rand()%3) - 1;
+                }
+                pix[0][y*stride[0]+x] = pix[1][y*stride[1]+x] = vbench_clip_pixel( v );
+            }
+    }
+}
+
+/* The C pipeline is timed once, the asm one only when cpu_new brought
+ * kernels of its own to the analysis (b_asm). */
+static int check_weightp( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a,
+                          vbench_pixel_function_t *pix_c, vbench_pixel_function_t *pix_a, uint64_t cpu_new, int b_asm )
+{
+    static int c_done = 0;
+    vbench_weightp_t *wp[2];
+    int ret = 0, ok = 1, used_asm = b_asm;
+
+    if( !b_asm && c_done )
+        return 0;
+    wp[0] = vbench_weightp_open( pix_c, mc_c, WEIGHTP_WIDTH, WEIGHTP_HEIGHT, CHROMA_FORMAT );
+    wp[1] = vbench_weightp_open( pix_a, mc_a, WEIGHTP_WIDTH, WEIGHTP_HEIGHT, CHROMA_FORMAT );
+    if( !wp[0] || !wp[1] )
+    {
+        fprintf( stderr, "weightp: unable to allocate the frames\n" );
+        vbench_weightp_close( wp[0] );
+        vbench_weightp_close( wp[1] );
+        return -1;
+    }
+    weightp_fill( wp, 1, 0 );
+    vbench_weightp_analyse( wp[0], 1 );
+    vbench_weightp_analyse( wp[1], 1 );
+    for( int i = 0; i < sizeof(weightp_scenes)/sizeof(*weightp_scenes) && ok; i++ )
+    {
+        vbench_weightp_result_t res[2];
+
+        weightp_fill( wp, 0, i );
+        if( b_asm )
+        {
+            vbench_weightp_frame( wp[0], &res[0] );
+            vbench_weightp_frame( wp[1], &res[1] );
+        }
+        for( int p = 0; p < (CHROMA_FORMAT ? 3 : 1) && ok && b_asm; p++ )
+        {
+            int w = WEIGHTP_WIDTH >> (p ? CHROMA_H_SHIFT : 0), h = WEIGHTP_HEIGHT >> (p ? CHROMA_V_SHIFT : 0);
+            vbench_weight_t *w0 = &res[0].weight[p], *w1 = &res[1].weight[p];
+            intptr_t stride[2];
+            pixel *pix[2] = { vbench_weightp_weighted( wp[0], &res[0], p, &stride[0] ),
+                              vbench_weightp_weighted( wp[1], &res[1], p, &stride[1] ) };
+            if( res[0].b_weighted[p] != res[1].b_weighted[p] || res[0].i_cost[p] != res[1].i_cost[p] ||
+                res[0].i_cost_none[p] != res[1].i_cost_none[p] || res[0].i_ssd[p] != res[1].i_ssd[p] ||
+                w0->i_scale != w1->i_scale || w0->i_denom != w1->i_denom || w0->i_offset != w1->i_offset )
+            {
+                ok = 0;
+                fprintf( stderr, "weightp FAILED: %s plane %d: %d*x/%d%+d cost %d vs %d*x/%d%+d cost %d\n",
+                         weightp_scenes[i].name, p, w0->i_scale, 1 << w0->i_denom, w0->i_offset, res[0].i_cost[p],
+                         w1->i_scale, 1 << w1->i_denom, w1->i_offset, res[1].i_cost[p] );
+                break;
+            }
+            for( int y = 0; y < h; y++ )
+                if( memcmp( pix[0] + y*stride[0], pix[1] + y*stride[1], w * sizeof(pixel) ) )
+                {
+                    ok = 0;
+                    fprintf( stderr, "weightp FAILED: %s plane %d line %d\n", weightp_scenes[i].name, p, y );
+                    break;
+                }
+        }
+
+        set_func_name( "weightp_%s_%s", vbench_chroma_names[CHROMA_FORMAT], weightp_scenes[i].name );
+        if( !c_done )
+            call_c_frame( vbench_weightp_frame, "frames/s", 1, 1, wp[0], &res[0] );
+        if( b_asm )
+            call_a_frame( vbench_weightp_frame, "frames/s", 1, 1, wp[1], &res[1] );
+    }
+    vbench_weightp_close( wp[0] );
+    vbench_weightp_close( wp[1] );
+    c_done = 1;
+    report( "weightp :" );
+    return ret;
+}
+
+/* --me esa and --me tesa on a 1080p frame with a pan and some objects
+ * moving on their own.  The integral plane of the reference is part of
+ * the per-frame work. */
+#define ESA_WIDTH  1920
+#define ESA_HEIGHT 1088
+#define ESA_QP     26
+
+static const struct
+{
+    const char *name;
+    vbench_esa_param_t param;
+} esa_presets[] =
+{
+    { "esa16",  { ESA_ME_ESA,  16 } },
+    { "tesa16", { ESA_ME_TESA, 16 } },
+    { "tesa24", { ESA_ME_TESA, 24 } },
+};
+
+/* The C search is timed once, the asm one only when cpu_new brought
+ * kernels of its own to it (b_asm).  Without them mc_a and pix_a are
+ * still the C on the first step, so the threaded search is timed as C. */
+static int check_esa( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a,
+                      vbench_pixel_function_t *pix_c, vbench_pixel_function_t *pix_a, uint64_t cpu_new, int b_asm )
+{
+    static int c_done = 0;
+    int ret = 0, ok = 1, used_asm = b_asm;
+    int threads = sysconf( _SC_NPROCESSORS_ONLN );
+    vbench_esa_t *t_c, *t_a = NULL, *t_t, *t_s;
+
+    if( !b_asm && c_done )
+        return 0;
+    threads = MIN( MAX( threads, 2 ), THREADPOOL_MAX_THREADS );
+    t_c = vbench_esa_open( pix_c, mc_c, ESA_WIDTH, ESA_HEIGHT, ESA_QP, 1 );
+    if( b_asm )
+        t_a = vbench_esa_open( pix_a, mc_a, ESA_WIDTH, ESA_HEIGHT, ESA_QP, 1 );
+    t_t = vbench_esa_open( pix_a, mc_a, ESA_WIDTH, ESA_HEIGHT, ESA_QP, threads );
+    t_s = b_asm ? t_a : t_c;
+    if( !t_c || !t_s || !t_t )
+    {
+        ok = 0;
+        fprintf( stderr, "esa: unable to allocate the frames\n" );
+    }
+    else
+    {
+        vbench_esa_gen( t_c, 0x5bd1e995, 12, 30 );
+        if( b_asm )
+            vbench_esa_gen( t_a, 0x5bd1e995, 12, 30 );
+        vbench_esa_gen( t_t, 0x5bd1e995, 12, 30 );
+        threads = vbench_esa_threads( t_t );
+    }
+    for( int i = 0; i < sizeof(esa_presets)/sizeof(*esa_presets) && ok; i++ )
+    {
+        const vbench_esa_param_t *param = &esa_presets[i].param;
+        vbench_esa_result_t res[3];
+        int mbs = vbench_esa_mbs( t_c );
+        int mb = -1;
+
+        vbench_esa_frame( t_c, param, &res[0] );
+        if( b_asm )
+            vbench_esa_frame( t_a, param, &res[1] );
+        else
+            res[1] = res[0];
+        vbench_esa_frame( t_t, param, &res[2] );
+        if( b_asm && (vbench_esa_cmp( t_c, t_a, &mb ) || memcmp( &res[0], &res[1], sizeof(vbench_esa_result_t) )) )
+        {
+            ok = 0;
+            fprintf( stderr, "esa FAILED: %s differs at MB %d\n", esa_presets[i].name, mb );
+            break;
+        }
+        if( vbench_esa_cmp( t_s, t_t, &mb ) || memcmp( &res[1], &res[2], sizeof(vbench_esa_result_t) ) )
+        {
+            ok = 0;
+            fprintf( stderr, "esa FAILED: %s with %d threads differs from serial at MB %d\n",
+                     esa_presets[i].name, threads, mb );
+            break;
+        }
+
+        set_func_name( "%s", esa_presets[i].name );
+        if( !c_done )
+            call_c_frame( vbench_esa_frame, "MB/s", 1, mbs, t_c, param, &res[0] );
+        if( b_asm )
+            call_a_frame( vbench_esa_frame, "MB/s", 1, mbs, t_a, param, &res[1] );
+        /* the counts are the same for every kernel set */
+        if( !c_done && !strncmp( func_name, bench_pattern, bench_pattern_len ) && res[1].i_window )
+            fprintf( stderr, " - %-6s : %.1f%% of %"PRId64" positions pruned by ads, %.1f sad %.1f satd per MB\n",
+                     esa_presets[i].name, 100.0 * (res[1].i_window - res[1].i_ads) / res[1].i_window,
+                     res[1].i_window, (double)res[1].i_sad / mbs, (double)res[1].i_satd / mbs );
+        set_func_name( "%s_%dt", esa_presets[i].name, threads );
+        if( b_asm )
+            call_a_frame( vbench_esa_frame, "MB/s", 1, mbs, t_t, param, &res[2] );
+        else
+            call_c_frame( vbench_esa_frame, "MB/s", 1, mbs, t_t, param, &res[2] );
+    }
+    vbench_esa_close( t_c );
+    vbench_esa_close( t_a );
+    vbench_esa_close( t_t );
+    c_done = 1;
+    report( "esa :" );
+    return ret;
+}
+
+int check_mc( uint64_t cpu_ref, uint64_t cpu_new )
 {
     vbench_mc_functions_t mc_c;
     vbench_mc_functions_t mc_ref;
     vbench_mc_functions_t mc_a;
     vbench_pixel_function_t pixf;
+    vbench_pixel_function_t pixf_ref;
+    vbench_pixel_function_t pixf_a;
 
     pixel *src     = &(pbuf1)[2*64+2];
     pixel *src2[4] = { &(pbuf1)[3*64+2], &(pbuf1)[5*64+2],
@@ -120,6 +996,8 @@ int check_mc( int cpu_ref, int cpu_new )
     vbench_mc_init( cpu_ref, &mc_ref, 0 );
     vbench_mc_init( cpu_new, &mc_a, 0 );
     vbench_pixel_init( 0, &pixf );
+    vbench_pixel_init( cpu_ref, &pixf_ref );
+    vbench_pixel_init( cpu_new, &pixf_a );
 
 #define MC_TEST_LUMA( w, h ) \
         if( mc_a.mc_luma != mc_ref.mc_luma && !(w&(w-1)) && h<=16 ) \
@@ -202,13 +1080,28 @@ int check_mc( int cpu_ref, int cpu_new )
         for( int dx = -128; dx < 128; dx++ )
         {
             if( rand()&15 ) continue;
-            MC_TEST_CHROMA( 8, 8 );
-            MC_TEST_CHROMA( 8, 4 );
-            MC_TEST_CHROMA( 4, 8 );
-            MC_TEST_CHROMA( 4, 4 );
-            MC_TEST_CHROMA( 4, 2 );
-            MC_TEST_CHROMA( 2, 4 );
-            MC_TEST_CHROMA( 2, 2 );
+            /* the chroma blocks of each luma partition, 4:4:4 chroma goes
+             * through mc_luma */
+            if( CHROMA_FORMAT == CHROMA_420 )
+            {
+                MC_TEST_CHROMA( 8, 8 );
+                MC_TEST_CHROMA( 8, 4 );
+                MC_TEST_CHROMA( 4, 8 );
+                MC_TEST_CHROMA( 4, 4 );
+                MC_TEST_CHROMA( 4, 2 );
+                MC_TEST_CHROMA( 2, 4 );
+                MC_TEST_CHROMA( 2, 2 );
+            }
+            else if( CHROMA_FORMAT == CHROMA_422 )
+            {
+                MC_TEST_CHROMA( 8, 16 );
+                MC_TEST_CHROMA( 8, 8 );
+                MC_TEST_CHROMA( 4, 16 );
+                MC_TEST_CHROMA( 4, 8 );
+                MC_TEST_CHROMA( 4, 4 );
+                MC_TEST_CHROMA( 2, 8 );
+                MC_TEST_CHROMA( 2, 4 );
+            }
         }
     report( "mc chroma :" );
 #undef MC_TEST_LUMA
@@ -317,7 +1210,9 @@ int check_mc( int cpu_ref, int cpu_new )
     report( "mc offsetsub :" );
 
     ok = 1; used_asm = 0;
-    for( int height = 8; height <= 16; height += 8 )
+    /* one MB of NV12 chroma, 4:4:4 and 4:0:0 have none */
+    int chroma_height = CHROMA_FORMAT == CHROMA_420 || CHROMA_FORMAT == CHROMA_422 ? 16 >> CHROMA_V_SHIFT : 0;
+    for( int height = chroma_height; height && height <= chroma_height; height += 8 )
     {
         if( mc_a.store_interleave_chroma != mc_ref.store_interleave_chroma )
         {
@@ -530,6 +1425,32 @@ int check_mc( int cpu_ref, int cpu_new )
         report( "v210 :" );
     }
 
+    if( !bench_align )
+        ret |= check_ingest( &mc_c, &mc_a, cpu_new, mc_a.plane_copy != mc_ref.plane_copy ||
+                             mc_a.plane_copy_interleave != mc_ref.plane_copy_interleave ||
+                             mc_a.plane_copy_deinterleave != mc_ref.plane_copy_deinterleave ||
+                             mc_a.plane_copy_deinterleave_rgb != mc_ref.plane_copy_deinterleave_rgb ||
+                             mc_a.plane_copy_deinterleave_v210 != mc_ref.plane_copy_deinterleave_v210 );
+
+    if( !bench_align )
+        ret |= check_frame_memory( &mc_c, &mc_a, cpu_new, mc_a.hpel_filter != mc_ref.hpel_filter ||
+                                   mc_a.mc_luma != mc_ref.mc_luma || mc_a.get_ref != mc_ref.get_ref );
+
+    if( !bench_align )
+        ret |= check_mcframe( &mc_c, &mc_a, cpu_new, mc_a.mc_luma != mc_ref.mc_luma || mc_a.get_ref != mc_ref.get_ref ||
+                              mc_a.mc_chroma != mc_ref.mc_chroma || memcmp( mc_a.avg, mc_ref.avg, sizeof(mc_a.avg) ) ||
+                              mc_a.weight != mc_ref.weight || mc_a.weight_cache != mc_ref.weight_cache ||
+                              memcmp( mc_a.copy, mc_ref.copy, sizeof(mc_a.copy) ) );
+
+    if( !bench_align )
+        ret |= check_weightp( &mc_c, &mc_a, &pixf, &pixf_a, cpu_new,
+                              mc_a.weight != mc_ref.weight || mc_a.weight_cache != mc_ref.weight_cache ||
+                              mc_a.frame_init_lowres_core != mc_ref.frame_init_lowres_core ||
+                              memcmp( pixf_a.var, pixf_ref.var, sizeof(pixf_a.var) ) ||
+                              pixf_a.sad[PIXEL_8x8] != pixf_ref.sad[PIXEL_8x8] || pixf_a.asd8 != pixf_ref.asd8 ||
+                              pixf_a.ssd[PIXEL_16x16] != pixf_ref.ssd[PIXEL_16x16] ||
+                              pixf_a.ssd[PIXEL_8x16] != pixf_ref.ssd[PIXEL_8x16] );
+
     if( mc_a.hpel_filter != mc_ref.hpel_filter )
     {
         pixel *srchpel = pbuf1+8+2*64;
@@ -592,6 +1513,9 @@ int check_mc( int cpu_ref, int cpu_new )
         report( "lowres init :" );
     }
 
+    if( !bench_align )
+        ret |= check_scale( &mc_c, &mc_a, cpu_new, mc_a.scale_h != mc_ref.scale_h || mc_a.scale_v != mc_ref.scale_v );
+
 #define INTEGRAL_INIT( name, size, offset, cmp_len, ... )\
     if( mc_a.name != mc_ref.name )\
     {\
@@ -617,6 +1541,15 @@ int check_mc( int cpu_ref, int cpu_new )
     INTEGRAL_INIT( integral_init8v, 9, 0, stride-8, stride );
     report( "integral init :" );
 
+    if( !bench_align )
+        ret |= check_esa( &mc_c, &mc_a, &pixf, &pixf_a, cpu_new,
+                          mc_a.integral_init8h != mc_ref.integral_init8h || mc_a.integral_init8v != mc_ref.integral_init8v ||
+                          pixf_a.ads[PIXEL_16x16] != pixf_ref.ads[PIXEL_16x16] ||
+                          pixf_a.sad[PIXEL_16x16] != pixf_ref.sad[PIXEL_16x16] ||
+                          pixf_a.sad_x3[PIXEL_16x16] != pixf_ref.sad_x3[PIXEL_16x16] ||
+                          pixf_a.sad_x4[PIXEL_8x8] != pixf_ref.sad_x4[PIXEL_8x8] ||
+                          pixf_a.satd[PIXEL_16x16] != pixf_ref.satd[PIXEL_16x16] );
+
     ok = 1; used_asm = 0;
     if( mc_a.mbtree_propagate_cost != mc_ref.mbtree_propagate_cost )
     {
@@ -696,17 +1629,22 @@ int check_mc( int cpu_ref, int cpu_new )
 
             for( int j = 0; j < size && ok; j++ )
             {
-                ok &= abs(ref_costsa[j] - ref_costsc[j]) <= 1;
+                ok &= ref_costsa[j] == ref_costsc[j];
                 if( !ok )
-                    fprintf( stderr, "mbtree_propagate_list FAILED at %d: %d !~= %d\n", j, ref_costsc[j], ref_costsa[j] );
+                    fprintf( stderr, "mbtree_propagate_list FAILED at %d: %d != %d\n", j, ref_costsc[j], ref_costsa[j] );
             }
 
             call_c2( mc_c.mbtree_propagate_list, ref_costsc, mvs, propagate_amount, lowres_costs, bipred_weight, 0, width, list, width, width, height, scratch_buffer2 );
             call_a2( mc_a.mbtree_propagate_list, ref_costsa, mvs, propagate_amount, lowres_costs, bipred_weight, 0, width, list, width, width, height, scratch_buffer2 );
         }
+        ok &= check_propagate_list_coherence( &mc_c, &mc_a, cpu_new );
     }
     report( "mbtree :" );
 
+    if( !bench_align )
+        ret |= check_mbtree_gop( &mc_c, &mc_a, cpu_new, mc_a.mbtree_propagate_cost != mc_ref.mbtree_propagate_cost ||
+                                                        mc_a.mbtree_propagate_list != mc_ref.mbtree_propagate_list );
+
     if( mc_a.memcpy_aligned != mc_ref.memcpy_aligned )
     {
         set_func_name( "memcpy_aligned" );
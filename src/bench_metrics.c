@@ -0,0 +1,171 @@
+/*****************************************************************************
+ * bench_metrics.c: run and measure the frame-level quality metrics
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ * Copyright (C) 2003-2016 x264 project
+ *
+ * Author of Video SIMD-Benchmark: Michail Alvanos <malvanos@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include <unistd.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/pixel.h"
+#include "c_kernels/metrics.h"
+
+extern int bench_pattern_len;
+extern const char *bench_pattern;
+extern char func_name[100];
+
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf );
+
+#define set_func_name(...) snprintf( func_name, sizeof(func_name), __VA_ARGS__ )
+
+#define report( name ) { \
+    if( used_asm ) \
+        fprintf( stderr, " - %-21s [%s]\n", name, ok ? "OK" : "FAILED" ); \
+    if( !ok ) ret = -1; \
+}
+
+#define METRICS_WIDTH  640
+#define METRICS_HEIGHT 360
+
+/* A smooth gradient with texture as the reference and the same picture
+ * with small noise as the distorted one, so SSIM lands in a realistic
+ * range instead of near zero as with two random buffers. */
+static vbench_picture_t metrics_pic[2];
+
+static int metrics_gen_pictures( void )
+{
+    if( metrics_pic[0].buffer )
+        return 0;
+    if( vbench_picture_alloc( &metrics_pic[0], METRICS_WIDTH, METRICS_HEIGHT ) ||
+        vbench_picture_alloc( &metrics_pic[1], METRICS_WIDTH, METRICS_HEIGHT ) )
+        return -1;
+    for( int p = 0; p < 3; p++ )
+    {
+        int w = METRICS_WIDTH >> !!p;
+        int h = METRICS_HEIGHT >> !!p;
+        for( int y = 0; y < h; y++ )
+            for( int x = 0; x < w; x++ )
+            {
+                int v = (x + 2*y) * 200 / (w + 2*h) + 24 + (rand() & 15);
+                int n = (rand() % 9) - 4;
+                metrics_pic[0].plane[p][y*metrics_pic[0].i_stride[p]+x] = v;
+                metrics_pic[1].plane[p][y*metrics_pic[1].i_stride[p]+x] = vbench_clip_pixel( v + n );
+            }
+    }
+    return 0;
+}
+
+/* SSD must match exactly; the per-call path sums SSIM in float, the
+ * engine in float per row and double across rows and bands. */
+static int metrics_cmp( vbench_metrics_result_t *a, vbench_metrics_result_t *b, double eps )
+{
+    return memcmp( a->ssd, b->ssd, sizeof(a->ssd) ) || fabs( a->ssim - b->ssim ) > eps;
+}
+
+int check_metrics( uint64_t cpu_ref, uint64_t cpu_new )
+{
+    vbench_pixel_function_t pixel_c;
+    vbench_pixel_function_t pixel_ref;
+    vbench_pixel_function_t pixel_asm;
+    vbench_metrics_result_t res_c, res_a, res_t;
+    vbench_metrics_t *m_c = NULL, *m_a = NULL, *m_t = NULL;
+    vbench_picture_t *ref = &metrics_pic[0], *dist = &metrics_pic[1];
+    static int c_done = 0;
+    int ret = 0, ok = 1, used_asm = 0, b_asm;
+    int threads = sysconf( _SC_NPROCESSORS_ONLN );
+
+    vbench_pixel_init( 0, &pixel_c );
+    vbench_pixel_init( cpu_ref, &pixel_ref );
+    vbench_pixel_init( cpu_new, &pixel_asm );
+
+    if( bench_align )
+        return 0;
+    b_asm = pixel_asm.ssim_4x4x2_core != pixel_ref.ssim_4x4x2_core ||
+            pixel_asm.ssim_end4 != pixel_ref.ssim_end4 ||
+            memcmp( pixel_asm.ssd, pixel_ref.ssd, sizeof(pixel_asm.ssd) );
+    if( !b_asm && c_done )
+        return 0;
+
+    threads = MIN( MAX( threads, 2 ), METRICS_MAX_THREADS );
+    if( metrics_gen_pictures() ||
+        !(m_c = vbench_metrics_open( &pixel_c, METRICS_WIDTH, METRICS_HEIGHT, 1 )) ||
+        !(m_a = vbench_metrics_open( &pixel_asm, METRICS_WIDTH, METRICS_HEIGHT, 1 )) ||
+        !(m_t = vbench_metrics_open( b_asm ? &pixel_asm : &pixel_c, METRICS_WIDTH, METRICS_HEIGHT, threads )) )
+    {
+        fprintf( stderr, "metrics: unable to allocate the engine\n" );
+        ret = -1;
+        goto end;
+    }
+    threads = vbench_metrics_threads( m_t );
+    used_asm = b_asm;
+
+    /* the engine must match the per-call path with both kernel sets, and
+     * the banded result must not depend on the number of threads */
+    vbench_metrics_frame_ref( &pixel_c, ref, dist, &res_c );
+    vbench_metrics_frame_ref( &pixel_asm, ref, dist, &res_a );
+    if( metrics_cmp( &res_c, &res_a, 1e-5 ) )
+    {
+        ok = 0;
+        fprintf( stderr, "metrics per-call: ssd %"PRIu64",%"PRIu64",%"PRIu64" ssim %.7f != ssd %"PRIu64",%"PRIu64",%"PRIu64" ssim %.7f\n",
+                 res_c.ssd[0], res_c.ssd[1], res_c.ssd[2], res_c.ssim, res_a.ssd[0], res_a.ssd[1], res_a.ssd[2], res_a.ssim );
+    }
+    vbench_metrics_frame( m_c, ref, dist, &res_a );
+    if( metrics_cmp( &res_c, &res_a, 1e-5 ) )
+    {
+        ok = 0;
+        fprintf( stderr, "metrics engine C: ssim %.7f != %.7f\n", res_c.ssim, res_a.ssim );
+    }
+    vbench_metrics_frame( m_a, ref, dist, &res_a );
+    vbench_metrics_frame( m_t, ref, dist, &res_t );
+    if( metrics_cmp( &res_c, &res_a, 1e-5 ) || metrics_cmp( &res_a, &res_t, 1e-9 ) )
+    {
+        ok = 0;
+        fprintf( stderr, "metrics engine: ssim %.7f / %.7f (%d threads) != %.7f\n", res_a.ssim, res_t.ssim, threads, res_c.ssim );
+    }
+
+    set_func_name( "metrics_percall" );
+    if( !c_done )
+        call_c_frame( vbench_metrics_frame_ref, "frames/s", 1, 1, &pixel_c, ref, dist, &res_c );
+    if( b_asm )
+        call_a_frame( vbench_metrics_frame_ref, "frames/s", 1, 1, &pixel_asm, ref, dist, &res_a );
+    set_func_name( "metrics_1t" );
+    if( !c_done )
+        call_c_frame( vbench_metrics_frame, "frames/s", 1, 1, m_c, ref, dist, &res_c );
+    if( b_asm )
+        call_a_frame( vbench_metrics_frame, "frames/s", 1, 1, m_a, ref, dist, &res_a );
+    c_done = 1;
+    /* without ssd or ssim asm of its own, m_t runs the C on the first step */
+    set_func_name( "metrics_%dt", threads );
+    if( b_asm )
+        call_a_frame( vbench_metrics_frame, "frames/s", 1, 1, m_t, ref, dist, &res_t );
+    else
+        call_c_frame( vbench_metrics_frame, "frames/s", 1, 1, m_t, ref, dist, &res_t );
+
+end:
+    vbench_metrics_close( m_c );
+    vbench_metrics_close( m_a );
+    vbench_metrics_close( m_t );
+    report( "metrics :" );
+    return ret;
+}
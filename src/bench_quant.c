@@ -60,7 +60,7 @@ extern pixel *pbuf3, *pbuf4;
 
 extern int bench_pattern_len;
 extern const char *bench_pattern;
-char func_name[100];
+extern char func_name[100];
 extern  bench_func_t benchs[MAX_FUNCS];
 
 #define set_func_name(...) snprintf( func_name, sizeof(func_name), __VA_ARGS__ )
@@ -76,7 +76,7 @@ extern  bench_func_t benchs[MAX_FUNCS];
 
 
 
-static bench_t* get_bench( const char *name, int cpu )
+static bench_t* get_bench( const char *name, uint64_t cpu )
 {
     int i, j;
     for( i = 0; benchs[i].name && strcmp(name, benchs[i].name); i++ )
@@ -114,7 +114,7 @@ static int cmp_bench( const void *a, const void *b )
 
 
 
-int check_quant( int cpu_ref, int cpu_new )
+int check_quant( uint64_t cpu_ref, uint64_t cpu_new )
 {
     vbench_quant_function_t qf_c;
     vbench_quant_function_t qf_ref;
@@ -279,7 +279,9 @@ int check_quant( int cpu_ref, int cpu_new )
         TEST_QUANT( quant_4x4x4, CQM_4IY, 4, 8, 16 );
         TEST_QUANT( quant_4x4x4, CQM_4PY, 4, 8, 16 );
         TEST_QUANT_DC( quant_4x4_dc, **quant4_mf[CQM_4IY] );
-        TEST_QUANT_DC( quant_2x2_dc, **quant4_mf[CQM_4IC] );
+        /* the 2x4 chroma DC of 4:2:2 is quantised as two 2x2 halves */
+        if( CHROMA_FORMAT == CHROMA_420 || CHROMA_FORMAT == CHROMA_422 )
+            TEST_QUANT_DC( quant_2x2_dc, **quant4_mf[CQM_4IC] );
 
 
 #define TEST_DEQUANT( qname, dqname, block, w ) \
@@ -335,7 +337,7 @@ int check_quant( int cpu_ref, int cpu_new )
 
         TEST_DEQUANT_DC( quant_4x4_dc, dequant_4x4_dc, CQM_4IY, 4 );
 
-        if( qf_a.idct_dequant_2x4_dc != qf_ref.idct_dequant_2x4_dc )
+        if( qf_a.idct_dequant_2x4_dc != qf_ref.idct_dequant_2x4_dc && CHROMA_FORMAT == CHROMA_422 )
         {
             set_func_name( "idct_dequant_2x4_dc_%s", i_cqm?"cqm":"flat" );
             used_asms[1] = 1;
@@ -357,7 +359,7 @@ int check_quant( int cpu_ref, int cpu_new )
             }
         }
 
-        if( qf_a.idct_dequant_2x4_dconly != qf_ref.idct_dequant_2x4_dconly )
+        if( qf_a.idct_dequant_2x4_dconly != qf_ref.idct_dequant_2x4_dconly && CHROMA_FORMAT == CHROMA_422 )
         {
             set_func_name( "idct_dequant_2x4_dc_%s", i_cqm?"cqm":"flat" );
             used_asms[1] = 1;
@@ -416,8 +418,10 @@ int check_quant( int cpu_ref, int cpu_new )
             } \
         }
 
-        TEST_OPTIMIZE_CHROMA_DC( optimize_chroma_2x2_dc, 4 );
-        TEST_OPTIMIZE_CHROMA_DC( optimize_chroma_2x4_dc, 8 );
+        if( CHROMA_FORMAT == CHROMA_420 )
+            TEST_OPTIMIZE_CHROMA_DC( optimize_chroma_2x2_dc, 4 );
+        if( CHROMA_FORMAT == CHROMA_422 )
+            TEST_OPTIMIZE_CHROMA_DC( optimize_chroma_2x4_dc, 8 );
 
         //x264_cqm_delete( h );
     }
@@ -29,6 +29,9 @@
 #include "bench.h"
 #include "predict.h"
 #include "macroblock.h"
+#include "bs.h"
+#include "cavlc.h"
+#include "c_kernels/ccbuild.h"
 
 
 
@@ -45,9 +48,148 @@ static uint8_t *vbench_nal_escape_c( uint8_t *dst, uint8_t *src, uint8_t *end )
     return dst;
 }
 
+/* Inverse of nal_escape: drop every 0x03 that follows two zero bytes of src.
+ * dst must not overlap src. */
+static uint8_t *vbench_nal_unescape_c( uint8_t *dst, uint8_t *src, uint8_t *end )
+{
+    if( src < end ) *dst++ = *src++;
+    if( src < end ) *dst++ = *src++;
+    while( src < end )
+    {
+        if( src[0] == 0x03 && !src[-2] && !src[-1] )
+            src++;
+        else
+            *dst++ = *src++;
+    }
+    return dst;
+}
+
+/* The batched writers work on a local copy of the writer state: stores
+ * through s->p could otherwise alias *s and force a reload per symbol. */
+static void vbench_bs_write_symbols_c( bs_t *s, vbench_bs_symbol_t *sym, int i_count )
+{
+    bs_t bs = *s;
+    for( int i = 0; i < i_count; i++ )
+    {
+        if( sym[i].i_type == BS_SYM_UE )
+            bs_write_ue( &bs, sym[i].i_val );
+        else if( sym[i].i_type == BS_SYM_SE )
+            bs_write_se( &bs, (int32_t)sym[i].i_val );
+        else
+            bs_write( &bs, sym[i].i_size, sym[i].i_val );
+    }
+    *s = bs;
+}
+
+static void vbench_bs_write_ue_batch_c( bs_t *s, uint32_t *val, int i_count )
+{
+    bs_t bs = *s;
+    for( int i = 0; i < i_count; i++ )
+        bs_write_ue( &bs, val[i] );
+    *s = bs;
+}
+
+static void vbench_bs_write_se_batch_c( bs_t *s, int32_t *val, int i_count )
+{
+    bs_t bs = *s;
+    for( int i = 0; i < i_count; i++ )
+        bs_write_se( &bs, val[i] );
+    *s = bs;
+}
+
+static void vbench_bs_write_vlc_batch_c( bs_t *s, const vlc_t *tab, uint8_t *idx, int i_count )
+{
+    bs_t bs = *s;
+    for( int i = 0; i < i_count; i++ )
+        bs_write_vlc( &bs, tab[idx[i]] );
+    *s = bs;
+}
+
+/* Reference writers: i_left is the number of free bits in *p. */
+void vbench_bs_init_ref( bs_t *s, void *p_data, int i_data )
+{
+    s->p_start = s->p = p_data;
+    s->p_end   = (uint8_t*)p_data + i_data;
+    s->cur_bits = 0;
+    s->i_left  = 8;
+    s->i_bits_encoded = 0;
+}
+
+void vbench_bs_write_ref( bs_t *s, int i_count, uint64_t i_bits )
+{
+    while( i_count-- > 0 )
+    {
+        if( s->i_left == 8 )
+            *s->p = 0;
+        *s->p |= ((i_bits >> i_count) & 1) << --s->i_left;
+        if( !s->i_left )
+        {
+            s->p++;
+            s->i_left = 8;
+        }
+    }
+}
+
+void vbench_bs_write_ue_ref( bs_t *s, uint32_t val )
+{
+    uint64_t tmp = (uint64_t)val + 1;
+    int k = 0;
+    while( tmp >> (k+1) )
+        k++;
+    vbench_bs_write_ref( s, k, 0 );
+    vbench_bs_write_ref( s, k+1, tmp );
+}
+
+void vbench_bs_write_se_ref( bs_t *s, int val )
+{
+    vbench_bs_write_ue_ref( s, val <= 0 ? -2*(int64_t)val : 2*(int64_t)val - 1 );
+}
+
+void vbench_bs_flush_ref( bs_t *s )
+{
+    if( s->i_left != 8 )
+    {
+        s->p++;
+        s->i_left = 8;
+    }
+}
+
+void vbench_bs_write_symbols_ref( bs_t *s, vbench_bs_symbol_t *sym, int i_count )
+{
+    for( int i = 0; i < i_count; i++ )
+    {
+        if( sym[i].i_type == BS_SYM_UE )
+            vbench_bs_write_ue_ref( s, sym[i].i_val );
+        else if( sym[i].i_type == BS_SYM_SE )
+            vbench_bs_write_se_ref( s, (int32_t)sym[i].i_val );
+        else
+            vbench_bs_write_ref( s, sym[i].i_size, sym[i].i_val );
+    }
+}
+
+void vbench_bs_write_ue_batch_ref( bs_t *s, uint32_t *val, int i_count )
+{
+    for( int i = 0; i < i_count; i++ )
+        vbench_bs_write_ue_ref( s, val[i] );
+}
+
+void vbench_bs_write_se_batch_ref( bs_t *s, int32_t *val, int i_count )
+{
+    for( int i = 0; i < i_count; i++ )
+        vbench_bs_write_se_ref( s, val[i] );
+}
+
+void vbench_bs_write_vlc_batch_ref( bs_t *s, const vlc_t *tab, uint8_t *idx, int i_count )
+{
+    for( int i = 0; i < i_count; i++ )
+        vbench_bs_write_ref( s, tab[idx[i]].i_size, tab[idx[i]].i_bits );
+}
+
 uint8_t *asm_nal_escape_mmx2( uint8_t *dst, uint8_t *src, uint8_t *end );
 uint8_t *asm_nal_escape_sse2( uint8_t *dst, uint8_t *src, uint8_t *end );
 uint8_t *asm_nal_escape_avx2( uint8_t *dst, uint8_t *src, uint8_t *end );
+uint8_t *asm_nal_unescape_sse2( uint8_t *dst, uint8_t *src, uint8_t *end );
+uint8_t *asm_nal_unescape_avx2( uint8_t *dst, uint8_t *src, uint8_t *end );
 void asm_cabac_block_residual_rd_internal_sse2       ( dctcoef *l, int b_interlaced, intptr_t ctx_block_cat, vbench_cabac_t *cb );
 void asm_cabac_block_residual_rd_internal_sse2_lzcnt ( dctcoef *l, int b_interlaced, intptr_t ctx_block_cat, vbench_cabac_t *cb );
 void asm_cabac_block_residual_rd_internal_ssse3      ( dctcoef *l, int b_interlaced, intptr_t ctx_block_cat, vbench_cabac_t *cb );
@@ -115,11 +257,20 @@ void vbench_nal_encode( x264_t *h, uint8_t *dst, x264_nal_t *nal )
 }
 #endif
 
-void vbench_bitstream_init( int cpu, vbench_bitstream_function_t *pf )
+void vbench_bitstream_init( uint64_t cpu, vbench_bitstream_function_t *pf )
 {
+    CCBUILD_INIT( cpu, bitstream_init, 0, pf );
     memset( pf, 0, sizeof(*pf) );
 
     pf->nal_escape = vbench_nal_escape_c;
+    pf->nal_unescape = vbench_nal_unescape_c;
+    pf->bs_write_symbols = vbench_bs_write_symbols_c;
+    pf->bs_write_ue_batch = vbench_bs_write_ue_batch_c;
+    pf->bs_write_se_batch = vbench_bs_write_se_batch_c;
+    pf->bs_write_vlc_batch = vbench_bs_write_vlc_batch_c;
+
+    vbench_cavlc_init();
+    pf->cavlc_block_residual = vbench_cavlc_block_residual_c;
 #if HAVE_MMX
 #if ARCH_X86_64
     pf->cabac_block_residual_internal = asm_cabac_block_residual_internal_sse2;
@@ -162,12 +313,18 @@ void vbench_bitstream_init( int cpu, vbench_bitstream_function_t *pf )
     }
 #endif
 #endif
+#if HAVE_X86_INTRIN
+    if( cpu&CPU_SSE2 )
+        pf->nal_unescape = asm_nal_unescape_sse2;
+    if( cpu&CPU_AVX2 )
+        pf->nal_unescape = asm_nal_unescape_avx2;
+#endif
 #if HAVE_ARMV6
     if( cpu&asm_CPU_NEON )
         pf->nal_escape = asm_nal_escape_neon;
 #endif
 #if ARCH_AARCH64
-    if( cpu&asm_CPU_NEON )
+    if( cpu&CPU_NEON )
         pf->nal_escape = asm_nal_escape_neon;
 #endif
 }
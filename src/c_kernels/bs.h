@@ -0,0 +1,151 @@
+/*****************************************************************************
+ * bs.h: bitstream writer
+ *****************************************************************************
+ * Copyright (C) 2003-2016 x264 project
+ *
+ * Authors: Loren Merritt <lorenm@u.washington.edu>
+ *          Fiona Glaser <fiona@x264.com>
+ *          Laurent Aimar <fenrir@via.ecp.fr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ * This program is also available under a commercial proprietary license.
+ * For more information, contact us at licensing@x264.com.
+ *****************************************************************************/
+
+#ifndef BS_H
+#define BS_H
+
+/* The writer keeps up to 64 bits in cur_bits; the low 64-i_left bits are
+ * pending.  After every write all complete bytes are stored with a single
+ * unaligned 64-bit big-endian store, so the flush has no data-dependent
+ * branch and fewer than 8 bits stay pending between writes.  This is why
+ * a single bs_write can take up to BS_MAX_WRITE bits, and why the output
+ * buffer needs BS_PADDING bytes of slack past p_end. */
+#define BS_MAX_WRITE 56
+#define BS_PADDING 8
+
+static ALWAYS_INLINE uint64_t bs_endian_fix64( uint64_t x )
+{
+#if WORDS_BIGENDIAN
+    return x;
+#else
+    return __builtin_bswap64( x );
+#endif
+}
+
+static inline void bs_init( bs_t *s, void *p_data, int i_data )
+{
+    s->p_start = s->p = p_data;
+    s->p_end   = (uint8_t*)p_data + i_data;
+    s->cur_bits = 0;
+    s->i_left  = 64;
+    s->i_bits_encoded = 0;
+}
+
+static inline int bs_pos( bs_t *s )
+{
+    return 8 * (s->p - s->p_start) + 64 - s->i_left;
+}
+
+/* Store every complete byte of cur_bits.  The partial byte is stored too
+ * but p is not advanced past it, so the next store rewrites it. */
+static ALWAYS_INLINE void bs_store( bs_t *s )
+{
+    uint64_t out = bs_endian_fix64( s->cur_bits << (s->i_left & 63) );
+    memcpy( s->p, &out, 8 );
+    int bytes = (64 - s->i_left) >> 3;
+    s->p += bytes;
+    s->i_left += bytes << 3;
+}
+
+/* i_count <= BS_MAX_WRITE, i_bits must not have bits set above i_count */
+static ALWAYS_INLINE void bs_write( bs_t *s, int i_count, uint64_t i_bits )
+{
+    s->cur_bits = (s->cur_bits << i_count) | i_bits;
+    s->i_left -= i_count;
+    bs_store( s );
+}
+
+static ALWAYS_INLINE void bs_write1( bs_t *s, uint32_t i_bit )
+{
+    bs_write( s, 1, i_bit );
+}
+
+static ALWAYS_INLINE void bs_write_vlc( bs_t *s, vlc_t v )
+{
+    bs_write( s, v.i_size, v.i_bits );
+}
+
+/* Exp-Golomb codes are written as one (2*k+1)-bit value whose leading k
+ * bits are zero, so each code is a single accumulator update. */
+static ALWAYS_INLINE void bs_write_ue( bs_t *s, uint32_t val )
+{
+    uint64_t tmp = (uint64_t)val + 1;
+    int k = 63 - __builtin_clzll( tmp );
+    if( 2*k+1 > BS_MAX_WRITE )
+    {
+        bs_write( s, k, 0 );
+        bs_write( s, k+1, tmp );
+    }
+    else
+        bs_write( s, 2*k+1, tmp );
+}
+
+static ALWAYS_INLINE void bs_write_se( bs_t *s, int val )
+{
+    /* 0 -> 0, 1 -> 1, -1 -> 2, 2 -> 3, ... */
+    uint32_t tmp = val <= 0 ? -2*(int64_t)val : 2*(int64_t)val - 1;
+    bs_write_ue( s, tmp );
+}
+
+static ALWAYS_INLINE void bs_write_te( bs_t *s, int x, int val )
+{
+    if( x == 1 )
+        bs_write1( s, 1^val );
+    else
+        bs_write_ue( s, val );
+}
+
+static inline void bs_rbsp_trailing( bs_t *s )
+{
+    bs_write1( s, 1 );
+    bs_write( s, (s->i_left-56)&7, 0 );
+}
+
+/* Store the pending partial byte, zero-padded; p then points past the end
+ * of the written data. */
+static inline void bs_flush( bs_t *s )
+{
+    int pad = (s->i_left-56)&7;
+    s->cur_bits <<= pad;
+    s->i_left -= pad;
+    bs_store( s );
+}
+
+/* Naive writers, one bit at a time with a byte store per bit.  These are
+ * what the batched writers are checked and benchmarked against. */
+void vbench_bs_init_ref( bs_t *s, void *p_data, int i_data );
+void vbench_bs_write_ref( bs_t *s, int i_count, uint64_t i_bits );
+void vbench_bs_write_ue_ref( bs_t *s, uint32_t val );
+void vbench_bs_write_se_ref( bs_t *s, int val );
+void vbench_bs_flush_ref( bs_t *s );
+
+void vbench_bs_write_symbols_ref( bs_t *s, vbench_bs_symbol_t *sym, int i_count );
+void vbench_bs_write_ue_batch_ref( bs_t *s, uint32_t *val, int i_count );
+void vbench_bs_write_se_batch_ref( bs_t *s, int32_t *val, int i_count );
+void vbench_bs_write_vlc_batch_ref( bs_t *s, const vlc_t *tab, uint8_t *idx, int i_count );
+
+#endif
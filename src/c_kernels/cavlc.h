@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * cavlc.h: cavlc bitstream writing
+ *****************************************************************************
+ * Copyright (C) 2003-2016 x264 project
+ *
+ * Authors: Laurent Aimar <fenrir@via.ecp.fr>
+ *          Loren Merritt <lorenm@u.washington.edu>
+ *          Fiona Glaser <fiona@x264.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ * This program is also available under a commercial proprietary license.
+ * For more information, contact us at licensing@x264.com.
+ *****************************************************************************/
+
+#ifndef CAVLC_H
+#define CAVLC_H
+
+/* Builds the level and run_before tables, must be called before coding. */
+void vbench_cavlc_init( void );
+
+/* Write the residual of one block with at least one nonzero coefficient
+ * and return the number of coefficients.  nC is the predicted number of
+ * nonzero coefficients (0-16), ignored for DCT_CHROMA_DC.  8x8 blocks are
+ * coded as four DCT_LUMA_4x4 blocks after zigzag interleave_8x8_cavlc. */
+int vbench_cavlc_block_residual_c( bs_t *s, vbench_quant_function_t *quantf, int ctx_block_cat, dctcoef *l, int nC );
+int vbench_cavlc_block_residual_ref( bs_t *s, vbench_quant_function_t *quantf, int ctx_block_cat, dctcoef *l, int nC );
+
+/* coeff_token of a block without coefficients */
+int vbench_cavlc_block_residual_empty( bs_t *s, int ctx_block_cat, int nC );
+
+#endif
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * ccbuild.c: C kernels of other compilers in the same binary
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/ccbuild.h"
+
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf );
+void vbench_mc_init( uint64_t cpu, vbench_mc_functions_t *pf, int cpu_independent );
+void vbench_dct_init( uint64_t cpu, vbench_dct_function_t *dctf );
+void vbench_zigzag_init( uint64_t cpu, vbench_zigzag_function_t *pf_progressive, vbench_zigzag_function_t *pf_interlaced );
+void vbench_quant_init( int i_cqm_preset, uint64_t cpu, vbench_quant_function_t *pf );
+void vbench_deblock_init( uint64_t cpu, vbench_deblock_function_t *pf, int b_mbaff );
+void vbench_bitstream_init( uint64_t cpu, vbench_bitstream_function_t *pf );
+void vbench_predict_16x16_init( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x8c_init( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x16c_init( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x8_init( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter );
+void vbench_predict_4x4_init( uint64_t cpu, vbench_predict_t pf[12] );
+
+#ifdef VBENCH_CCBUILD
+
+#ifndef VBENCH_CCBUILD_NAME
+#define CCBUILD_STR2( x ) #x
+#define CCBUILD_STR( x ) CCBUILD_STR2( x )
+#define VBENCH_CCBUILD_NAME "cc" CCBUILD_STR( VBENCH_CCBUILD )
+#endif
+#ifndef VBENCH_CCBUILD_CPU
+#define VBENCH_CCBUILD_CPU 0
+#endif
+
+/* becomes ccn_vbench_ccbuild_self once the symbols are prefixed, with
+ * every pointer into this build */
+const vbench_ccbuild_t vbench_ccbuild_self =
+{
+    VBENCH_CCBUILD_NAME,
+    VBENCH_CCBUILD_CPU,
+    vbench_pixel_init,
+    vbench_mc_init,
+    vbench_dct_init,
+    vbench_zigzag_init,
+    vbench_quant_init,
+    vbench_deblock_init,
+    vbench_bitstream_init,
+    vbench_predict_16x16_init,
+    vbench_predict_8x8c_init,
+    vbench_predict_8x16c_init,
+    vbench_predict_8x8_init,
+    vbench_predict_4x4_init,
+};
+
+#else
+
+/* weak, so an empty slot resolves to NULL */
+extern const vbench_ccbuild_t cc1_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc2_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc3_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc4_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc5_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc6_vbench_ccbuild_self __attribute__((weak));
+extern const vbench_ccbuild_t cc7_vbench_ccbuild_self __attribute__((weak));
+
+const vbench_ccbuild_t *vbench_ccbuild( uint64_t cpu )
+{
+    const vbench_ccbuild_t *builds[CCBUILD_MAX] =
+    {
+        &cc1_vbench_ccbuild_self,
+        &cc2_vbench_ccbuild_self,
+        &cc3_vbench_ccbuild_self,
+        &cc4_vbench_ccbuild_self,
+        &cc5_vbench_ccbuild_self,
+        &cc6_vbench_ccbuild_self,
+        &cc7_vbench_ccbuild_self,
+    };
+    int i = (cpu & VSIMD_CPU_CCBUILD_MASK) >> VSIMD_CPU_CCBUILD_SHIFT;
+    return i >= 1 && i <= CCBUILD_MAX ? builds[i-1] : NULL;
+}
+
+const char *vbench_ccbuild_name( uint64_t cpu )
+{
+    const vbench_ccbuild_t *build = vbench_ccbuild( cpu );
+    return build ? build->name : NULL;
+}
+
+uint64_t vbench_ccbuild_cpu( uint64_t cpu )
+{
+    const vbench_ccbuild_t *build = vbench_ccbuild( cpu );
+    return build ? build->cpu : 0;
+}
+
+#endif
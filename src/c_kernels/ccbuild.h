@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * ccbuild.h: C kernels of other compilers in the same binary
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef CCBUILD_H
+#define CCBUILD_H
+
+/* Slots of the Makefile's CCBUILDn_* variables.  Each filled slot compiles
+ * the kernel sources once more with its own compiler and flags, with
+ * VBENCH_CCBUILD set to n, and prefixes every global symbol of the result
+ * with ccn_ so it links next to the main build.  check_all_flags then runs
+ * every check with the main C build as reference and the slot's C build,
+ * cpu VSIMD_CPU_CCBUILD( n ), in the place of the asm.  Slots 1 to 3 are
+ * for other compilers; 4 to 7 hold the main compiler's code for SSE2,
+ * SSE4.2, AVX2 and AVX-512, to set against the asm of the same level. */
+#define CCBUILD_MAX 7
+
+/* the name of the build selected by the VSIMD_CPU_CCBUILD bits of cpu,
+ * NULL if that slot isn't linked in */
+const char *vbench_ccbuild_name( uint64_t cpu );
+
+/* the VSIMD_CPU_* flags the code of that build was compiled for */
+uint64_t vbench_ccbuild_cpu( uint64_t cpu );
+
+/* the rest needs the kernel types of bench.h, which bench.c goes without */
+#ifdef BENCH_H
+
+/* the entry points of one build, all used with cpu 0 */
+typedef struct
+{
+    const char *name;
+    uint64_t cpu;
+    void (*pixel_init)( uint64_t cpu, vbench_pixel_function_t *pixf );
+    void (*mc_init)( uint64_t cpu, vbench_mc_functions_t *pf, int cpu_independent );
+    void (*dct_init)( uint64_t cpu, vbench_dct_function_t *dctf );
+    void (*zigzag_init)( uint64_t cpu, vbench_zigzag_function_t *pf_progressive, vbench_zigzag_function_t *pf_interlaced );
+    void (*quant_init)( int i_cqm_preset, uint64_t cpu, vbench_quant_function_t *pf );
+    void (*deblock_init)( uint64_t cpu, vbench_deblock_function_t *pf, int b_mbaff );
+    void (*bitstream_init)( uint64_t cpu, vbench_bitstream_function_t *pf );
+    void (*predict_16x16_init)( uint64_t cpu, vbench_predict_t pf[7] );
+    void (*predict_8x8c_init)( uint64_t cpu, vbench_predict_t pf[7] );
+    void (*predict_8x16c_init)( uint64_t cpu, vbench_predict_t pf[7] );
+    void (*predict_8x8_init)( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter );
+    void (*predict_4x4_init)( uint64_t cpu, vbench_predict_t pf[12] );
+} vbench_ccbuild_t;
+
+/* the build selected by the VSIMD_CPU_CCBUILD bits of cpu, or NULL */
+const vbench_ccbuild_t *vbench_ccbuild( uint64_t cpu );
+
+/* First thing in every init of the main build: with a build selected in
+ * cpu, fill the table from that build instead.  The builds themselves
+ * only ever see cpu 0 and leave this out. */
+#ifdef VBENCH_CCBUILD
+#define CCBUILD_INIT( cpu, init, ... )
+#else
+#define CCBUILD_INIT( cpu, init, ... )\
+    if( (cpu) & VSIMD_CPU_CCBUILD_MASK )\
+    {\
+        vbench_ccbuild( cpu )->init( __VA_ARGS__ );\
+        return;\
+    }
+#endif
+
+#endif /* BENCH_H */
+
+#endif
@@ -30,6 +30,8 @@
 #include "common.h"
 #include "bench.h"
 #include "macroblock.h"
+#include "c_kernels/ccbuild.h"
+#include "c_kernels/vext.h"
 
 
 #if HAVE_MMX
@@ -543,8 +545,9 @@ static void add16x16_idct_dc( pixel *p_dst, dctcoef dct[16] )
 /****************************************************************************
  * x264_dct_init:
  ****************************************************************************/
-void vbench_dct_init( int cpu, vbench_dct_function_t *dctf )
+void vbench_dct_init( uint64_t cpu, vbench_dct_function_t *dctf )
 {
+    CCBUILD_INIT( cpu, dct_init, 0, dctf );
     dctf->sub4x4_dct    = sub4x4_dct;
     dctf->add4x4_idct   = add4x4_idct;
 
@@ -715,6 +718,11 @@ void vbench_dct_init( int cpu, vbench_dct_function_t *dctf )
         dctf->sub16x16_dct8    = asm_sub16x16_dct8_avx2;
 #endif
     }
+
+#if ARCH_X86_64
+    if( cpu&CPU_AVX512 )
+        dctf->sub16x16_dct     = asm_sub16x16_dct_avx512;
+#endif
 #endif //HAVE_MMX
 
 #if HAVE_ALTIVEC
@@ -782,6 +790,10 @@ void vbench_dct_init( int cpu, vbench_dct_function_t *dctf )
 #endif
 
 #endif // HIGH_BIT_DEPTH
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+    if( cpu&CPU_VEXT )
+        vbench_dct_init_vext( dctf );
+#endif
 }
 
 
@@ -955,8 +967,9 @@ static void zigzag_interleave_8x8_cavlc( dctcoef *dst, dctcoef *src, uint8_t *nn
     }
 }
 
-void vbench_zigzag_init( int cpu, vbench_zigzag_function_t *pf_progressive, vbench_zigzag_function_t *pf_interlaced )
+void vbench_zigzag_init( uint64_t cpu, vbench_zigzag_function_t *pf_progressive, vbench_zigzag_function_t *pf_interlaced )
 {
+    CCBUILD_INIT( cpu, zigzag_init, 0, pf_progressive, pf_interlaced );
     pf_interlaced->scan_8x8   = zigzag_scan_8x8_field;
     pf_progressive->scan_8x8  = zigzag_scan_8x8_frame;
     pf_interlaced->scan_4x4   = zigzag_scan_4x4_field;
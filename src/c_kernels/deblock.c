@@ -31,6 +31,10 @@
 #include "bench.h"
 #include "predict.h"
 #include "macroblock.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/deblock.h"
+#include "c_kernels/ccbuild.h"
+#include "c_kernels/vext.h"
 
 
 /* Deblocking filter */
@@ -665,6 +669,8 @@ void asm_deblock_v_luma_sse2( pixel *pix, intptr_t stride, int alpha, int beta,
 void asm_deblock_v_luma_avx ( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
 void asm_deblock_h_luma_sse2( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
 void asm_deblock_h_luma_avx ( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
+void asm_deblock_v_luma_avx512( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
+void asm_deblock_h_luma_avx512( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
 void asm_deblock_v_chroma_sse2( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
 void asm_deblock_v_chroma_avx ( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
 void asm_deblock_h_chroma_sse2( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 );
@@ -774,8 +780,9 @@ void asm_deblock_strength_msa( uint8_t nnz[SCAN8_SIZE], int8_t ref[2][SCAN8_LUMA
 #endif
 #endif
 
-void vbench_deblock_init( int cpu, vbench_deblock_function_t *pf, int b_mbaff )
+void vbench_deblock_init( uint64_t cpu, vbench_deblock_function_t *pf, int b_mbaff )
 {
+    CCBUILD_INIT( cpu, deblock_init, 0, pf, b_mbaff );
     pf->deblock_luma[1] = deblock_v_luma_c;
     pf->deblock_luma[0] = deblock_h_luma_c;
     pf->deblock_chroma[1] = deblock_v_chroma_c;
@@ -861,6 +868,13 @@ void vbench_deblock_init( int cpu, vbench_deblock_function_t *pf, int b_mbaff )
         {
             pf->deblock_strength = asm_deblock_strength_avx2;
         }
+#if ARCH_X86_64 && !HIGH_BIT_DEPTH
+        if( cpu&CPU_AVX512 )
+        {
+            pf->deblock_luma[1] = asm_deblock_v_luma_avx512;
+            pf->deblock_luma[0] = asm_deblock_h_luma_avx512;
+        }
+#endif
     }
 #endif
 
@@ -907,8 +921,441 @@ void vbench_deblock_init( int cpu, vbench_deblock_function_t *pf, int b_mbaff )
     }
 #endif
 #endif // !HIGH_BIT_DEPTH
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+    if( cpu&CPU_VEXT )
+        vbench_deblock_init_vext( pf );
+#endif
 
     /* These functions are equivalent, so don't duplicate them. */
     pf->deblock_chroma_422_mbaff = pf->deblock_h_chroma_420;
     pf->deblock_chroma_422_intra_mbaff = pf->deblock_h_chroma_420_intra;
 }
+
+/****************************************************************************
+ * frame deblocking
+ ****************************************************************************/
+
+/* what x264_frame_deblock_row reads of each MB */
+typedef struct
+{
+    ALIGNED_4( uint8_t bs[2][8][4] );
+    uint8_t qp;
+    uint8_t b_intra;
+    uint8_t b_8x8;
+    uint8_t b_inner;    /* split or coded, so the inner edges are filtered */
+    uint8_t b_field;
+} dbframe_mb_t;
+
+/* a picture to deblock: the frame, or one of its fields */
+typedef struct
+{
+    pixel *plane[3];
+    intptr_t i_stride[2];   /* luma, chroma */
+    int i_mb_height;
+    dbframe_mb_t *mb;
+} dbframe_pic_t;
+
+struct vbench_dbframe_t
+{
+    int i_width, i_height;
+    int i_mb_width, i_mb_height;
+    int i_csp;
+    int i_planes;           /* 2 with interleaved chroma */
+    int i_shift_v;
+    int i_mode;
+
+    vbench_plane_t src[3];
+    vbench_plane_t frame[2][3];
+    dbframe_mb_t *mb;
+};
+
+void vbench_dbframe_close( vbench_dbframe_t *t )
+{
+    if( !t )
+        return;
+    for( int p = 0; p < 3; p++ )
+    {
+        vbench_plane_free( &t->src[p] );
+        vbench_plane_free( &t->frame[0][p] );
+        vbench_plane_free( &t->frame[1][p] );
+    }
+    free( t->mb );
+    free( t );
+}
+
+vbench_dbframe_t *vbench_dbframe_open( int i_width, int i_height, int i_csp )
+{
+    vbench_dbframe_t *t;
+
+    if( i_width <= 0 || i_height <= 0 || (i_width&15) || (i_height&31) ||
+        i_csp < CHROMA_400 || i_csp > CHROMA_444 )
+        return NULL;
+    t = calloc( 1, sizeof(vbench_dbframe_t) );
+    if( !t )
+        return NULL;
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_mb_width = i_width / 16;
+    t->i_mb_height = i_height / 16;
+    t->i_csp = i_csp;
+    t->i_planes = i_csp == CHROMA_444 ? 3 : i_csp ? 2 : 1;
+    t->i_shift_v = i_csp == CHROMA_420;
+
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        int h = p ? i_height >> t->i_shift_v : i_height;
+        if( vbench_plane_alloc( &t->src[p], i_width, h, 0, NULL ) ||
+            vbench_plane_alloc( &t->frame[0][p], i_width, h, 0, NULL ) ||
+            vbench_plane_alloc( &t->frame[1][p], i_width, h, 0, NULL ) )
+            goto fail;
+    }
+    t->mb = calloc( t->i_mb_width * t->i_mb_height, sizeof(dbframe_mb_t) );
+    if( !t->mb )
+        goto fail;
+
+    /* smooth texture with a step at every 8x8 block and a little combing
+     * between the fields, so that most edges pass the alpha/beta tests */
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        vbench_plane_t *pl = &t->src[p];
+        for( int y = 0; y < pl->i_height; y++ )
+            for( int x = 0; x < pl->i_width; x++ )
+                pl->plane[y*pl->i_stride+x] = 64 + (((x*x >> 2) + 3*y*y + 37*p*x) >> 10 & 63)
+                                            + (((x>>3)*7 + (y>>3)*13) & 15) + 4*(y&1) + (rand() & 3);
+    }
+    return t;
+fail:
+    vbench_dbframe_close( t );
+    return NULL;
+}
+
+int vbench_dbframe_mbs( vbench_dbframe_t *t )
+{
+    return t->i_mb_width * t->i_mb_height;
+}
+
+void vbench_dbframe_field( vbench_dbframe_t *t, const vbench_dbframe_param_t *param )
+{
+    t->i_mode = param->i_mode;
+    for( int mb_y = 0; mb_y < t->i_mb_height; mb_y++ )
+        for( int mb_x = 0; mb_x < t->i_mb_width; mb_x++ )
+        {
+            dbframe_mb_t *mb = &t->mb[mb_y*t->i_mb_width + mb_x];
+            /* both MBs of an MBAFF pair share the field flag */
+            if( param->i_mode == DBFRAME_MBAFF && (mb_y&1) )
+                mb->b_field = mb[-t->i_mb_width].b_field;
+            else
+                mb->b_field = param->i_mode == DBFRAME_MBAFF && rand()%100 < param->i_field;
+            mb->qp = vbench_clip3( param->i_qp + rand()%7 - 3, 0, QP_MAX_SPEC );
+            mb->b_intra = rand()%100 < param->i_intra;
+            mb->b_inner = mb->b_intra || rand()%100 < param->i_coded;
+            mb->b_8x8 = mb->b_inner && (rand()&1);
+            /* intra edges are strength 3 where they aren't filtered as
+             * intra; inter ones 2 for residual, 1 for a motion edge */
+            for( int dir = 0; dir < 2; dir++ )
+                for( int edge = 0; edge < 8; edge++ )
+                    for( int i = 0; i < 4; i++ )
+                    {
+                        int r = rand()%100;
+                        mb->bs[dir][edge][i] = mb->b_intra ? 3 : r < param->i_coded/2 ? 2 : r < param->i_coded ? 1 : 0;
+                    }
+        }
+}
+
+void vbench_dbframe_reset( vbench_dbframe_t *t, int i_frame )
+{
+    for( int p = 0; p < t->i_planes; p++ )
+        memcpy( t->frame[i_frame][p].buffer, t->src[p].buffer,
+                t->src[p].i_stride * t->src[p].i_height * sizeof(pixel) );
+}
+
+static ALWAYS_INLINE void dbframe_edge( pixel *pix, intptr_t i_stride, uint8_t bS[4], int i_qp,
+                                        int b_chroma, vbench_deblock_inter_t pf_inter )
+{
+    int alpha = alpha_table(i_qp);
+    int beta  = beta_table(i_qp);
+    int8_t tc[4];
+
+    if( !M32(bS) || !alpha || !beta )
+        return;
+
+    tc[0] = tc0_table(i_qp)[bS[0]] + b_chroma;
+    tc[1] = tc0_table(i_qp)[bS[1]] + b_chroma;
+    tc[2] = tc0_table(i_qp)[bS[2]] + b_chroma;
+    tc[3] = tc0_table(i_qp)[bS[3]] + b_chroma;
+
+    pf_inter( pix, i_stride, alpha, beta, tc );
+}
+
+static ALWAYS_INLINE void dbframe_edge_intra( pixel *pix, intptr_t i_stride, uint8_t bS[4], int i_qp,
+                                              int b_chroma, vbench_deblock_intra_t pf_intra )
+{
+    int alpha = alpha_table(i_qp);
+    int beta  = beta_table(i_qp);
+
+    if( !alpha || !beta )
+        return;
+
+    pf_intra( pix, i_stride, alpha, beta );
+}
+
+/* x264_frame_deblock_row with slice-wide offsets of 0, one slice and the
+ * MB state of the picture instead of the encoder's */
+static void dbframe_row( vbench_dbframe_t *t, vbench_deblock_function_t *lf, dbframe_pic_t *pic,
+                         int mb_y, int b_interlaced )
+{
+    const uint8_t *chroma_qp_table = i_chroma_qp_table + 12;
+    int qp_thresh = 15;
+    intptr_t stridey  = pic->i_stride[0];
+    intptr_t strideuv = pic->i_stride[1];
+    int chroma_format = t->i_csp;
+    int chroma444 = chroma_format == CHROMA_444;
+    int chroma_height = 16 >> t->i_shift_v;
+    intptr_t uvdiff = chroma444 ? pic->plane[2] - pic->plane[1] : 1;
+    int mb_width = t->i_mb_width;
+    dbframe_mb_t *mbs = pic->mb;
+
+    for( int mb_x = 0; mb_x < mb_width; mb_x += (~b_interlaced | mb_y)&1, mb_y ^= b_interlaced )
+    {
+        int mb_xy = mb_y*mb_width + mb_x;
+        int mb_interlaced = b_interlaced && mbs[mb_xy].b_field;
+        int top_xy = mb_x + mb_width*(mb_y - (1 << mb_interlaced));
+        int left_xy[2] = { mb_xy - 1, mb_xy - 1 };
+
+        if( b_interlaced )
+        {
+            if( mb_y&1 )
+            {
+                if( mb_x && mbs[mb_xy - 1].b_field != mb_interlaced )
+                    left_xy[0] -= mb_width;
+            }
+            else
+            {
+                if( top_xy >= 0 && mb_interlaced && !mbs[top_xy].b_field )
+                    top_xy += mb_width;
+                if( mb_x && mbs[mb_xy - 1].b_field != mb_interlaced )
+                    left_xy[1] += mb_width;
+            }
+        }
+
+        dbframe_mb_t *mb = &mbs[mb_xy];
+        int transform_8x8 = mb->b_8x8;
+        int intra_cur = mb->b_intra;
+        uint8_t (*bs)[8][4] = mb->bs;
+
+        pixel *pixy = pic->plane[0] + 16*mb_y*stridey + 16*mb_x;
+        pixel *pixuv = chroma_format ? pic->plane[1] + chroma_height*mb_y*strideuv + 16*mb_x : NULL;
+
+        if( mb_y & mb_interlaced )
+        {
+            pixy -= 15*stridey;
+            if( chroma_format )
+                pixuv -= (chroma_height-1)*strideuv;
+        }
+
+        intptr_t stride2y  = stridey << mb_interlaced;
+        intptr_t stride2uv = strideuv << mb_interlaced;
+        int qp = mb->qp;
+        int qpc = chroma_qp_table[qp];
+        int first_edge_only = !mb->b_inner || qp <= qp_thresh;
+
+        #define FILTER( intra, dir, edge, qp, chroma_qp )\
+        do\
+        {\
+            if( !(edge & 1) || !transform_8x8 )\
+            {\
+                dbframe_edge##intra( pixy + 4*edge*(dir?stride2y:1),\
+                                     stride2y, bs[dir][edge], qp, 0,\
+                                     lf->deblock_luma##intra[dir] );\
+                if( chroma_format == CHROMA_444 )\
+                {\
+                    dbframe_edge##intra( pixuv          + 4*edge*(dir?stride2uv:1),\
+                                         stride2uv, bs[dir][edge], chroma_qp, 0,\
+                                         lf->deblock_luma##intra[dir] );\
+                    dbframe_edge##intra( pixuv + uvdiff + 4*edge*(dir?stride2uv:1),\
+                                         stride2uv, bs[dir][edge], chroma_qp, 0,\
+                                         lf->deblock_luma##intra[dir] );\
+                }\
+                else if( chroma_format == CHROMA_420 && !(edge & 1) )\
+                {\
+                    dbframe_edge##intra( pixuv + edge*(dir?2*stride2uv:4),\
+                                         stride2uv, bs[dir][edge], chroma_qp, 1,\
+                                         lf->deblock_chroma##intra[dir] );\
+                }\
+            }\
+            if( chroma_format == CHROMA_422 && (dir || !(edge & 1)) )\
+            {\
+                dbframe_edge##intra( pixuv + edge*(dir?4*stride2uv:4),\
+                                     stride2uv, bs[dir][edge], chroma_qp, 1,\
+                                     lf->deblock_chroma##intra[dir] );\
+            }\
+        } while(0)
+
+        if( mb_x > 0 )
+        {
+            if( b_interlaced && mbs[left_xy[0]].b_field != mb_interlaced )
+            {
+                /* a frame MB next to a field pair or the other way round:
+                 * each half of the edge against its own left MB */
+                int c = chroma444 ? 0 : 1;
+                for( int j = 0; j < 2; j++ )
+                {
+                    dbframe_mb_t *left = &mbs[left_xy[j]];
+                    int luma_qp = (qp + left->qp + 1) >> 1;
+                    int chroma_qp = (qpc + chroma_qp_table[left->qp] + 1) >> 1;
+                    intptr_t offy  = j ? stridey  << (mb_interlaced ? 4 : 0) : 0;
+                    intptr_t offuv = j ? strideuv << (mb_interlaced ? 4 - t->i_shift_v : 0) : 0;
+                    if( intra_cur || left->b_intra )
+                    {
+                        dbframe_edge_intra( pixy + offy, 2*stridey, bs[0][4*j], luma_qp, 0, lf->deblock_luma_intra_mbaff );
+                        if( chroma_format )
+                            dbframe_edge_intra( pixuv + offuv, 2*strideuv, bs[0][4*j], chroma_qp, c, lf->deblock_chroma_intra_mbaff );
+                        if( chroma444 )
+                            dbframe_edge_intra( pixuv + uvdiff + offuv, 2*strideuv, bs[0][4*j], chroma_qp, c, lf->deblock_chroma_intra_mbaff );
+                    }
+                    else
+                    {
+                        dbframe_edge( pixy + offy, 2*stridey, bs[0][4*j], luma_qp, 0, lf->deblock_luma_mbaff );
+                        if( chroma_format )
+                            dbframe_edge( pixuv + offuv, 2*strideuv, bs[0][4*j], chroma_qp, c, lf->deblock_chroma_mbaff );
+                        if( chroma444 )
+                            dbframe_edge( pixuv + uvdiff + offuv, 2*strideuv, bs[0][4*j], chroma_qp, c, lf->deblock_chroma_mbaff );
+                    }
+                }
+            }
+            else
+            {
+                int qpl = mbs[mb_xy-1].qp;
+                int qp_left = (qp + qpl + 1) >> 1;
+                int qpc_left = (qpc + chroma_qp_table[qpl] + 1) >> 1;
+
+                if( intra_cur || mbs[mb_xy-1].b_intra )
+                    FILTER( _intra, 0, 0, qp_left, qpc_left );
+                else
+                    FILTER(       , 0, 0, qp_left, qpc_left );
+            }
+        }
+        if( !first_edge_only )
+        {
+            FILTER( , 0, 1, qp, qpc );
+            FILTER( , 0, 2, qp, qpc );
+            FILTER( , 0, 3, qp, qpc );
+        }
+
+        if( mb_y > mb_interlaced )
+        {
+            if( b_interlaced && !(mb_y&1) && !mb_interlaced && mbs[top_xy].b_field )
+            {
+                /* a frame pair under a field pair: the top edge of the
+                 * even rows against the top field, of the odd rows
+                 * against the bottom one */
+                int mbn_xy = mb_xy - 2*mb_width;
+
+                for( int j = 0; j < 2; j++, mbn_xy += mb_width )
+                {
+                    int qpt = mbs[mbn_xy].qp;
+                    int qp_top = (qp + qpt + 1) >> 1;
+                    int qpc_top = (qpc + chroma_qp_table[qpt] + 1) >> 1;
+                    if( intra_cur || mbs[mbn_xy].b_intra )
+                        M32( bs[1][4*j] ) = 0x03030303;
+
+                    dbframe_edge( pixy + j*stridey, 2*stridey, bs[1][4*j], qp_top, 0, lf->deblock_luma[1] );
+                    if( chroma444 )
+                    {
+                        dbframe_edge( pixuv          + j*strideuv, 2*strideuv, bs[1][4*j], qpc_top, 0, lf->deblock_luma[1] );
+                        dbframe_edge( pixuv + uvdiff + j*strideuv, 2*strideuv, bs[1][4*j], qpc_top, 0, lf->deblock_luma[1] );
+                    }
+                    else if( chroma_format )
+                        dbframe_edge( pixuv          + j*strideuv, 2*strideuv, bs[1][4*j], qpc_top, 1, lf->deblock_chroma[1] );
+                }
+            }
+            else
+            {
+                int qpt = mbs[top_xy].qp;
+                int qp_top = (qp + qpt + 1) >> 1;
+                int qpc_top = (qpc + chroma_qp_table[qpt] + 1) >> 1;
+                int intra_deblock = intra_cur || mbs[top_xy].b_intra;
+
+                if( (!b_interlaced || (!mb_interlaced && !mbs[top_xy].b_field)) && intra_deblock )
+                {
+                    FILTER( _intra, 1, 0, qp_top, qpc_top );
+                }
+                else
+                {
+                    if( intra_deblock )
+                        M32( bs[1][0] ) = 0x03030303;
+                    FILTER(       , 1, 0, qp_top, qpc_top );
+                }
+            }
+        }
+
+        if( !first_edge_only )
+        {
+            FILTER( , 1, 1, qp, qpc );
+            FILTER( , 1, 2, qp, qpc );
+            FILTER( , 1, 3, qp, qpc );
+        }
+
+        #undef FILTER
+    }
+}
+
+void vbench_dbframe_deblock( vbench_dbframe_t *t, vbench_deblock_function_t *db, int i_frame )
+{
+    vbench_deblock_function_t lf = *db;
+    int b_field = t->i_mode == DBFRAME_FIELD;
+    int b_mbaff = t->i_mode == DBFRAME_MBAFF;
+    vbench_plane_t *frame = t->frame[i_frame];
+
+    /* the chroma filters of the format, as an encoder sets them up */
+    if( t->i_csp == CHROMA_444 )
+    {
+        lf.deblock_chroma_mbaff = lf.deblock_luma_mbaff;
+        lf.deblock_chroma_intra_mbaff = lf.deblock_luma_intra_mbaff;
+    }
+    else if( t->i_csp == CHROMA_420 )
+    {
+        lf.deblock_chroma[0] = lf.deblock_h_chroma_420;
+        lf.deblock_chroma_intra[0] = lf.deblock_h_chroma_420_intra;
+        lf.deblock_chroma_mbaff = lf.deblock_chroma_420_mbaff;
+        lf.deblock_chroma_intra_mbaff = lf.deblock_chroma_420_intra_mbaff;
+    }
+    else if( t->i_csp == CHROMA_422 )
+    {
+        lf.deblock_chroma[0] = lf.deblock_h_chroma_422;
+        lf.deblock_chroma_intra[0] = lf.deblock_h_chroma_422_intra;
+        lf.deblock_chroma_mbaff = lf.deblock_chroma_422_mbaff;
+        lf.deblock_chroma_intra_mbaff = lf.deblock_chroma_422_intra_mbaff;
+    }
+
+    /* field pictures are deblocked as pictures of their own lines */
+    for( int i_parity = 0; i_parity <= b_field; i_parity++ )
+    {
+        dbframe_pic_t pic;
+        for( int p = 0; p < 3; p++ )
+            pic.plane[p] = p < t->i_planes ? frame[p].plane + i_parity*frame[p].i_stride : NULL;
+        pic.i_stride[0] = frame[0].i_stride << b_field;
+        pic.i_stride[1] = t->i_planes > 1 ? frame[1].i_stride << b_field : 0;
+        pic.i_mb_height = t->i_mb_height >> b_field;
+        pic.mb = t->mb + i_parity * pic.i_mb_height * t->i_mb_width;
+        for( int mb_y = 0; mb_y < pic.i_mb_height; mb_y += 1 + b_mbaff )
+            dbframe_row( t, &lf, &pic, mb_y, b_mbaff );
+    }
+}
+
+int vbench_dbframe_cmp( vbench_dbframe_t *t, int *i_plane, int *i_row )
+{
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        vbench_plane_t *a = &t->frame[0][p];
+        vbench_plane_t *b = &t->frame[1][p];
+        for( int y = 0; y < a->i_height; y++ )
+            if( memcmp( a->plane + y*a->i_stride, b->plane + y*b->i_stride, a->i_width * sizeof(pixel) ) )
+            {
+                *i_plane = p;
+                *i_row = y;
+                return -1;
+            }
+    }
+    return 0;
+}
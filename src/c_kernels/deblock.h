@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * deblock.h: whole-frame deblocking
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef DEBLOCK_H
+#define DEBLOCK_H
+
+void vbench_deblock_init( uint64_t cpu, vbench_deblock_function_t *pf, int b_mbaff );
+
+/* How the frame is coded: as one progressive picture, as two field
+ * pictures deblocked one after the other, or as MBAFF with a mix of frame
+ * and field MB pairs. */
+enum dbframe_mode_e
+{
+    DBFRAME_PROGRESSIVE = 0,
+    DBFRAME_FIELD       = 1,
+    DBFRAME_MBAFF       = 2,
+};
+
+/* Shape of the synthetic MB state.  i_intra and i_coded are the
+ * percentages of intra MBs and of inter MBs with residual or a split, the
+ * others only get their outer edges filtered.  i_field is the percentage
+ * of field pairs in MBAFF. */
+typedef struct
+{
+    int i_mode;
+    int i_qp;
+    int i_intra;
+    int i_coded;
+    int i_field;
+} vbench_dbframe_param_t;
+
+typedef struct vbench_dbframe_t vbench_dbframe_t;
+
+/* A textured frame of i_width x i_height, i_width a multiple of 16 and
+ * i_height of 32, in chroma format i_csp, and two copies of it to deblock
+ * so the results of two kernel sets can be compared. */
+vbench_dbframe_t *vbench_dbframe_open( int i_width, int i_height, int i_csp );
+void vbench_dbframe_close( vbench_dbframe_t *t );
+int  vbench_dbframe_mbs( vbench_dbframe_t *t );
+
+/* Replace the MB state (QPs, types, transform sizes, field flags and
+ * boundary strengths) with a new one drawn from rand(). */
+void vbench_dbframe_field( vbench_dbframe_t *t, const vbench_dbframe_param_t *param );
+
+/* Restore copy i_frame from the source frame. */
+void vbench_dbframe_reset( vbench_dbframe_t *t, int i_frame );
+
+/* Deblock copy i_frame in place, row by row as x264_frame_deblock_row,
+ * with MBAFF pairs filtered top then bottom. */
+void vbench_dbframe_deblock( vbench_dbframe_t *t, vbench_deblock_function_t *db, int i_frame );
+
+/* Returns 0 if both copies match, else sets the first differing plane
+ * and row and returns -1. */
+int vbench_dbframe_cmp( vbench_dbframe_t *t, int *i_plane, int *i_row );
+
+#endif
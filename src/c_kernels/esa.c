@@ -0,0 +1,499 @@
+/*****************************************************************************
+ * esa.c: exhaustive motion search with successive elimination
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/threadpool.h"
+#include "c_kernels/esa.h"
+
+/* A block may sit this far outside the picture.  The border of the planes
+ * also covers the window rounded up to 4 columns and the ads kernels
+ * reading sums for up to 16 more. */
+#define ESA_MV_BORDER 16
+#define ESA_PAD 64
+
+/* the 8-bit x264 lambda_tab */
+static const uint8_t esa_lambda_tab[52] =
+{
+   1,  1,  1,  1,  1,  1,  1,  1,  /*  0- 7 */
+   1,  1,  1,  1,  1,  1,  1,  1,  /*  8-15 */
+   2,  2,  2,  2,  3,  3,  3,  4,  /* 16-23 */
+   4,  4,  5,  6,  6,  7,  8,  9,  /* 24-31 */
+  10, 11, 13, 14, 16, 18, 20, 23,  /* 32-39 */
+  25, 29, 32, 36, 40, 45, 51, 57,  /* 40-47 */
+  64, 72, 81, 91                   /* 48-51 */
+};
+
+/* the flat block the DCs of the 8x8 quadrants are measured against */
+static DECLARE_ALIGNED( pixel esa_zero[16*FENC_STRIDE], 64 );
+
+typedef struct
+{
+    int16_t mv[2];
+    int sad;
+} esa_mvsad_t;
+
+typedef struct
+{
+    DECLARE_ALIGNED( pixel fenc[16*FENC_STRIDE], 64 );
+    int i_row0, i_row1;
+    int16_t *xs;                /* ads output for one row of the window */
+    esa_mvsad_t *mvsads;        /* TESA candidates */
+    vbench_esa_result_t res;
+} esa_band_t;
+
+struct vbench_esa_t
+{
+    vbench_pixel_function_t *pf;
+    vbench_mc_functions_t *mc;
+    int i_width, i_height;
+    int i_mb_width, i_mb_height, i_mb_count;
+    int i_threads;
+    vbench_plane_t fenc;
+    vbench_plane_t ref;
+    uint16_t *integral_buf;
+    uint16_t *integral;         /* the 8x8 sum whose top-left pixel is ref.plane[i] is integral[i] */
+    uint16_t *cost_mv_buf;
+    uint16_t *cost_mv;          /* lambda * bits of a fullpel mvd, for mvds of +-i_cost_range */
+    int16_t (*mv)[2];
+    int *cost;
+    esa_band_t band[THREADPOOL_MAX_THREADS];
+    vbench_threadpool_t *pool;
+
+    /* the search in progress */
+    const vbench_esa_param_t *param;
+};
+
+vbench_esa_t *vbench_esa_open( vbench_pixel_function_t *pf, vbench_mc_functions_t *mc,
+                               int i_width, int i_height, int i_qp, int i_threads )
+{
+    vbench_esa_t *t;
+    int lambda = esa_lambda_tab[vbench_clip3( i_qp, 0, 51 )];
+    int cost_range;
+    intptr_t stride;
+
+    if( i_width <= 0 || i_height <= 0 || (i_width&15) || (i_height&15) )
+        return NULL;
+    t = memalign( 64, sizeof(vbench_esa_t) );
+    if( !t )
+        return NULL;
+    memset( t, 0, sizeof(vbench_esa_t) );
+    t->pf = pf;
+    t->mc = mc;
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_mb_width = i_width / 16;
+    t->i_mb_height = i_height / 16;
+    t->i_mb_count = t->i_mb_width * t->i_mb_height;
+    t->i_threads = vbench_clip3( i_threads, 1, MIN( t->i_mb_height, THREADPOOL_MAX_THREADS ) );
+
+    if( vbench_plane_alloc( &t->fenc, i_width, i_height, 0, NULL ) ||
+        vbench_plane_alloc( &t->ref, i_width, i_height, ESA_PAD, NULL ) )
+        goto fail;
+    stride = t->ref.i_stride;
+    /* one spare row, the kernels write up to stride-8 from the left border */
+    t->integral_buf = memalign( 64, (t->ref.i_height + 2*t->ref.i_pad + 1) * stride * sizeof(uint16_t) );
+    if( !t->integral_buf )
+        goto fail;
+    t->integral = t->integral_buf + t->ref.i_pad * stride + t->ref.i_pad;
+
+    /* any mvd between two mvs of the frame, and the ads reads past the window */
+    cost_range = MAX( i_width, i_height ) + 2*ESA_MV_BORDER + 2*ESA_RANGE_MAX + 32;
+    t->cost_mv_buf = malloc( (2*cost_range+1) * sizeof(uint16_t) );
+    if( !t->cost_mv_buf )
+        goto fail;
+    t->cost_mv = t->cost_mv_buf + cost_range;
+    for( int i = 0; i <= cost_range; i++ )
+    {
+        /* bits of the qpel mvd, as x264's mvd cost init */
+        float bits = log2f( 4*i+1 ) * 2 + 0.718f + !!i;
+        t->cost_mv[i] = t->cost_mv[-i] = MIN( lambda * bits + .5f, (1<<16)-1 );
+    }
+
+    t->mv = malloc( t->i_mb_count * sizeof(*t->mv) );
+    t->cost = malloc( t->i_mb_count * sizeof(int) );
+    if( !t->mv || !t->cost )
+        goto fail;
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        esa_band_t *b = &t->band[i];
+        b->i_row0 = t->i_mb_height * i / t->i_threads;
+        b->i_row1 = t->i_mb_height * (i+1) / t->i_threads;
+        /* ads may round the width up to 16 */
+        b->xs = memalign( 64, (ALIGN( 2*ESA_RANGE_MAX+4, 16 ) + 16) * sizeof(int16_t) );
+        b->mvsads = malloc( (2*ESA_RANGE_MAX+4) * (2*ESA_RANGE_MAX+1) * sizeof(esa_mvsad_t) );
+        if( !b->xs || !b->mvsads )
+            goto fail;
+    }
+    t->pool = vbench_threadpool_init( t->i_threads );
+    if( !t->pool )
+        goto fail;
+    return t;
+fail:
+    vbench_esa_close( t );
+    return NULL;
+}
+
+void vbench_esa_close( vbench_esa_t *t )
+{
+    if( !t )
+        return;
+    vbench_threadpool_delete( t->pool );
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        free( t->band[i].xs );
+        free( t->band[i].mvsads );
+    }
+    vbench_plane_free( &t->fenc );
+    vbench_plane_free( &t->ref );
+    free( t->integral_buf );
+    free( t->cost_mv_buf );
+    free( t->mv );
+    free( t->cost );
+    free( t );
+}
+
+int vbench_esa_mbs( vbench_esa_t *t )
+{
+    return t->i_mb_count;
+}
+
+int vbench_esa_threads( vbench_esa_t *t )
+{
+    return t->i_threads;
+}
+
+/****************************************************************************
+ * synthetic frames
+ ****************************************************************************/
+
+static uint32_t esa_rand( uint32_t *state )
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+void vbench_esa_gen( vbench_esa_t *t, uint32_t i_seed, int i_motion, int i_local )
+{
+    uint32_t rnd = i_seed | 1;
+    vbench_plane_t *ref = &t->ref, *fenc = &t->fenc;
+    int pan_x = (int)(esa_rand( &rnd ) % 17) - 8;
+    int pan_y = (int)(esa_rand( &rnd ) % 9) - 4;
+
+    i_motion = vbench_clip3( i_motion, 0, ESA_PAD/2 );
+    for( int y = 0; y < t->i_height; y++ )
+        for( int x = 0; x < t->i_width; x++ )
+        {
+            int v = 48 + (((x*x + 3*y*y) >> 12) & 127) + (esa_rand( &rnd ) & 31);
+            ref->plane[y*ref->i_stride+x] = vbench_clip_pixel( v );
+        }
+    vbench_plane_expand_border( ref );
+
+    for( int ry = 0; ry < t->i_height; ry += 64 )
+        for( int rx = 0; rx < t->i_width; rx += 64 )
+        {
+            int mvx = pan_x, mvy = pan_y;
+            if( (int)(esa_rand( &rnd ) % 100) < i_local )
+            {
+                mvx = (int)(esa_rand( &rnd ) % (2*i_motion+1)) - i_motion;
+                mvy = (int)(esa_rand( &rnd ) % (2*i_motion+1)) - i_motion;
+            }
+            for( int y = ry; y < MIN( ry + 64, t->i_height ); y++ )
+                for( int x = rx; x < MIN( rx + 64, t->i_width ); x++ )
+                {
+                    int sx = vbench_clip3( x + mvx, -ESA_PAD/2, t->i_width + ESA_PAD/2 - 1 );
+                    int sy = vbench_clip3( y + mvy, -ESA_PAD/2, t->i_height + ESA_PAD/2 - 1 );
+                    int v = ref->plane[sy*ref->i_stride+sx] + (int)(esa_rand( &rnd ) % 5) - 2;
+                    fenc->plane[y*fenc->i_stride+x] = vbench_clip_pixel( v );
+                }
+        }
+}
+
+/****************************************************************************
+ * search
+ ****************************************************************************/
+
+/* frame->integral of x264's frame_filter without the 4x4 sums: row y+1
+ * accumulates the horizontal 8-sums of rows up to y, and once 8 rows are
+ * in, the row 8 above becomes the 8x8 sums starting there. */
+static void esa_integral( vbench_esa_t *t )
+{
+    intptr_t stride = t->ref.i_stride;
+    int pad = t->ref.i_pad;
+
+    memset( t->integral - pad * stride - pad, 0, stride * sizeof(uint16_t) );
+    for( int y = -pad; y < t->i_height + pad - 9; y++ )
+    {
+        pixel    *pix  = t->ref.plane + y * stride - pad;
+        uint16_t *sum8 = t->integral + (y+1) * stride - pad;
+        t->mc->integral_init8h( sum8, pix, stride );
+        if( y >= 8-pad )
+            t->mc->integral_init8v( sum8 - 8*stride, stride );
+    }
+}
+
+#define ESA_COPY3_IF_LT( x, y, a, b, c, d )\
+if( (y) < (x) )\
+{\
+    (x) = (y);\
+    (a) = (b);\
+    (c) = (d);\
+}
+
+/* The ESA and TESA cases of x264's me_search_ref for a 16x16 partition,
+ * starting from the better of the predictor and the zero mv. */
+static void esa_mb( vbench_esa_t *t, esa_band_t *b, int i_mb, int16_t *mvp )
+{
+    const vbench_esa_param_t *param = t->param;
+    vbench_pixel_function_t *pf = t->pf;
+    intptr_t stride = t->ref.i_stride;
+    int mb_x = i_mb % t->i_mb_width;
+    int mb_y = i_mb / t->i_mb_width;
+    int b_tesa = param->i_me == ESA_ME_TESA;
+    int i_me_range = vbench_clip3( param->i_range, 1, ESA_RANGE_MAX );
+    vbench_pixel_cmp_t fpelcmp = b_tesa ? pf->satd[PIXEL_16x16] : pf->sad[PIXEL_16x16];
+    pixel *p_fenc = b->fenc;
+    pixel *p_fref = t->ref.plane + 16 * (mb_y * stride + mb_x);
+    uint16_t *sums_base = t->integral + 16 * (mb_y * stride + mb_x);
+    int mv_x_min = -16*mb_x - ESA_MV_BORDER;
+    int mv_y_min = -16*mb_y - ESA_MV_BORDER;
+    int mv_x_max = t->i_width  - 16*(mb_x+1) + ESA_MV_BORDER;
+    int mv_y_max = t->i_height - 16*(mb_y+1) + ESA_MV_BORDER;
+    int pmx = mvp ? vbench_clip3( mvp[0], mv_x_min, mv_x_max ) : 0;
+    int pmy = mvp ? vbench_clip3( mvp[1], mv_y_min, mv_y_max ) : 0;
+    uint16_t *p_cost_mvx = t->cost_mv - pmx;
+    uint16_t *p_cost_mvy = t->cost_mv - pmy;
+    int bmx = pmx, bmy = pmy, bcost;
+    int16_t *xs = b->xs;
+    DECLARE_ALIGNED( int enc_dc[4], 16 );
+    DECLARE_ALIGNED( int sads[4], 16 );     /* padded to [4] for asm */
+
+    for( int y = 0; y < 16; y++ )
+        memcpy( p_fenc + y*FENC_STRIDE, t->fenc.plane + (16*mb_y+y) * t->fenc.i_stride + 16*mb_x, 16 * sizeof(pixel) );
+
+    bcost = fpelcmp( p_fenc, FENC_STRIDE, p_fref + bmy*stride + bmx, stride ) + p_cost_mvx[bmx] + p_cost_mvy[bmy];
+    if( bmx || bmy )
+    {
+        int cost = fpelcmp( p_fenc, FENC_STRIDE, p_fref, stride ) + p_cost_mvx[0] + p_cost_mvy[0];
+        ESA_COPY3_IF_LT( bcost, cost, bmx, 0, bmy, 0 );
+    }
+    if( b_tesa )
+        b->res.i_satd += 1 + !!(pmx || pmy);
+    else
+        b->res.i_sad += 1 + !!(pmx || pmy);
+
+    const int min_x = MAX( bmx - i_me_range, mv_x_min );
+    const int min_y = MAX( bmy - i_me_range, mv_y_min );
+    const int max_x = MIN( bmx + i_me_range, mv_x_max );
+    const int max_y = MIN( bmy + i_me_range, mv_y_max );
+    /* SEA is fastest in multiples of 4 */
+    const int width = (max_x - min_x + 3) & ~3;
+    int delta = 8 * stride;
+    int xn;
+
+    pf->sad_x4[PIXEL_8x8]( esa_zero, p_fenc, p_fenc+8, p_fenc+8*FENC_STRIDE, p_fenc+8+8*FENC_STRIDE,
+                           FENC_STRIDE, enc_dc );
+    b->res.i_window += width * (max_y - min_y + 1);
+
+    if( b_tesa )
+    {
+        /* ADS threshold, then SAD threshold, then keep the best few SADs, then SATD */
+        esa_mvsad_t *mvsads = b->mvsads;
+        int nmvsad = 0, limit;
+        int sad_thresh = param->i_sad_thresh ? param->i_sad_thresh : i_me_range <= 16 ? 10 : i_me_range <= 24 ? 11 : 12;
+        int ads_thresh = param->i_ads_thresh ? param->i_ads_thresh : 17;
+        int bsad = pf->sad[PIXEL_16x16]( p_fenc, FENC_STRIDE, p_fref + bmy*stride + bmx, stride )
+                 + p_cost_mvx[bmx] + p_cost_mvy[bmy];
+        b->res.i_sad++;
+        for( int my = min_y; my <= max_y; my++ )
+        {
+            int i;
+            int ycost = p_cost_mvy[my];
+            if( bsad <= ycost )
+                continue;
+            bsad -= ycost;
+            xn = pf->ads[PIXEL_16x16]( enc_dc, sums_base + min_x + my * stride, delta,
+                                       p_cost_mvx + min_x, xs, width, bsad * ads_thresh >> 4 );
+            b->res.i_ads += xn;
+            b->res.i_sad += xn;
+            for( i = 0; i < xn-2; i += 3 )
+            {
+                pixel *ref = p_fref + min_x + my*stride;
+                pf->sad_x3[PIXEL_16x16]( p_fenc, ref+xs[i], ref+xs[i+1], ref+xs[i+2], stride, sads );
+                for( int j = 0; j < 3; j++ )
+                {
+                    int sad = sads[j] + p_cost_mvx[min_x+xs[i+j]];
+                    if( sad < bsad*sad_thresh>>3 )
+                    {
+                        bsad = MIN( bsad, sad );
+                        mvsads[nmvsad].sad = sad + ycost;
+                        mvsads[nmvsad].mv[0] = min_x+xs[i+j];
+                        mvsads[nmvsad].mv[1] = my;
+                        nmvsad++;
+                    }
+                }
+            }
+            for( ; i < xn; i++ )
+            {
+                int mx = min_x+xs[i];
+                int sad = pf->sad[PIXEL_16x16]( p_fenc, FENC_STRIDE, p_fref + mx + my*stride, stride )
+                        + p_cost_mvx[mx];
+                if( sad < bsad*sad_thresh>>3 )
+                {
+                    bsad = MIN( bsad, sad );
+                    mvsads[nmvsad].sad = sad + ycost;
+                    mvsads[nmvsad].mv[0] = mx;
+                    mvsads[nmvsad].mv[1] = my;
+                    nmvsad++;
+                }
+            }
+            bsad += ycost;
+        }
+
+        limit = i_me_range >> 1;
+        sad_thresh = bsad*sad_thresh>>3;
+        while( nmvsad > limit*2 && sad_thresh > bsad )
+        {
+            int i = 0;
+            /* halve the range if the domain is too large... eh, close enough */
+            sad_thresh = (sad_thresh + bsad) >> 1;
+            while( i < nmvsad && mvsads[i].sad <= sad_thresh )
+                i++;
+            for( int j = i; j < nmvsad; j++ )
+            {
+                mvsads[i] = mvsads[j];
+                i += mvsads[j].sad <= sad_thresh;
+            }
+            nmvsad = i;
+        }
+        while( nmvsad > limit )
+        {
+            int bi = 0;
+            for( int i = 1; i < nmvsad; i++ )
+                if( mvsads[i].sad > mvsads[bi].sad )
+                    bi = i;
+            nmvsad--;
+            mvsads[bi] = mvsads[nmvsad];
+        }
+        b->res.i_satd += nmvsad;
+        for( int i = 0; i < nmvsad; i++ )
+        {
+            int mx = mvsads[i].mv[0], my = mvsads[i].mv[1];
+            int cost = fpelcmp( p_fenc, FENC_STRIDE, p_fref + mx + my*stride, stride )
+                     + p_cost_mvx[mx] + p_cost_mvy[my];
+            ESA_COPY3_IF_LT( bcost, cost, bmx, mx, bmy, my );
+        }
+    }
+    else
+    {
+        /* just ADS and SAD */
+        for( int my = min_y; my <= max_y; my++ )
+        {
+            int i;
+            int ycost = p_cost_mvy[my];
+            if( bcost <= ycost )
+                continue;
+            bcost -= ycost;
+            xn = pf->ads[PIXEL_16x16]( enc_dc, sums_base + min_x + my * stride, delta,
+                                       p_cost_mvx + min_x, xs, width, bcost );
+            b->res.i_ads += xn;
+            b->res.i_sad += xn;
+            for( i = 0; i < xn-2; i += 3 )
+            {
+                pixel *ref = p_fref + min_x + my*stride;
+                pf->sad_x3[PIXEL_16x16]( p_fenc, ref+xs[i], ref+xs[i+1], ref+xs[i+2], stride, sads );
+                /* no cost_mvy, it was taken off bcost */
+                for( int j = 0; j < 3; j++ )
+                    ESA_COPY3_IF_LT( bcost, sads[j] + p_cost_mvx[min_x+xs[i+j]], bmx, min_x+xs[i+j], bmy, my );
+            }
+            bcost += ycost;
+            for( ; i < xn; i++ )
+            {
+                int mx = min_x+xs[i];
+                int cost = pf->sad[PIXEL_16x16]( p_fenc, FENC_STRIDE, p_fref + mx + my*stride, stride )
+                         + p_cost_mvx[mx] + ycost;
+                ESA_COPY3_IF_LT( bcost, cost, bmx, mx, bmy, my );
+            }
+        }
+    }
+
+    t->mv[i_mb][0] = bmx;
+    t->mv[i_mb][1] = bmy;
+    t->cost[i_mb] = bcost;
+    b->res.i_cost += bcost;
+}
+
+static void esa_rows( vbench_esa_t *t, esa_band_t *b )
+{
+    memset( &b->res, 0, sizeof(b->res) );
+    for( int y = b->i_row0; y < b->i_row1; y++ )
+        for( int x = 0; x < t->i_mb_width; x++ )
+        {
+            int mb = y * t->i_mb_width + x;
+            esa_mb( t, b, mb, x ? t->mv[mb-1] : NULL );
+        }
+}
+
+static void esa_job( void *arg, int i_thread )
+{
+    vbench_esa_t *t = arg;
+    esa_rows( t, &t->band[i_thread] );
+}
+
+void vbench_esa_frame( vbench_esa_t *t, const vbench_esa_param_t *param, vbench_esa_result_t *res )
+{
+    t->param = param;
+    /* every row of sums depends on the one above it, so this part stays
+     * on one thread */
+    esa_integral( t );
+    if( t->i_threads == 1 )
+        esa_rows( t, &t->band[0] );
+    else
+        vbench_threadpool_run( t->pool, esa_job, t );
+
+    memset( res, 0, sizeof(vbench_esa_result_t) );
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        vbench_esa_result_t *r = &t->band[i].res;
+        res->i_cost   += r->i_cost;
+        res->i_window += r->i_window;
+        res->i_ads    += r->i_ads;
+        res->i_sad    += r->i_sad;
+        res->i_satd   += r->i_satd;
+    }
+}
+
+int vbench_esa_cmp( vbench_esa_t *a, vbench_esa_t *b, int *i_mb )
+{
+    for( int i = 0; i < a->i_mb_count; i++ )
+        if( M32( a->mv[i] ) != M32( b->mv[i] ) || a->cost[i] != b->cost[i] )
+        {
+            *i_mb = i;
+            return -1;
+        }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * esa.h: exhaustive motion search with successive elimination
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef ESA_H
+#define ESA_H
+
+#define ESA_RANGE_MAX 64
+
+/* x264's --me esa and --me tesa */
+enum esa_method_e
+{
+    ESA_ME_ESA  = 0,
+    ESA_ME_TESA = 1,
+};
+
+/* i_sad_thresh and i_ads_thresh only matter to TESA.  Zero picks x264's
+ * values: 10, 11 or 12 eighths of the best SAD by range, and 17
+ * sixteenths for ads. */
+typedef struct
+{
+    int i_me;
+    int i_range;
+    int i_sad_thresh;
+    int i_ads_thresh;
+} vbench_esa_param_t;
+
+typedef struct
+{
+    int64_t i_cost;     /* best costs, SAD for ESA and SATD for TESA, plus lambda * mv bits */
+    int64_t i_window;   /* positions inside the search windows */
+    int64_t i_ads;      /* positions left by the ads prefilter */
+    int64_t i_sad;      /* SADs computed on those */
+    int64_t i_satd;     /* SATDs computed on the TESA shortlist */
+} vbench_esa_result_t;
+
+typedef struct vbench_esa_t vbench_esa_t;
+
+/* A current frame and its reference of i_width x i_height, multiples of
+ * 16, searched with the 16x16 kernels of pf and the integral kernels of
+ * mc, with mv costs at i_qp.  With i_threads > 1 the MB rows are split
+ * into bands, each MB predicting its mv from its left neighbour only, so
+ * the result does not depend on the thread count. */
+vbench_esa_t *vbench_esa_open( vbench_pixel_function_t *pf, vbench_mc_functions_t *mc,
+                               int i_width, int i_height, int i_qp, int i_threads );
+void vbench_esa_close( vbench_esa_t *t );
+int  vbench_esa_mbs( vbench_esa_t *t );
+int  vbench_esa_threads( vbench_esa_t *t );
+
+/* Fill both frames from i_seed: a textured reference, and a current frame
+ * moved from it by a global pan with i_local percent of 64x64 regions
+ * moving on their own by up to i_motion pixels, plus a little noise. */
+void vbench_esa_gen( vbench_esa_t *t, uint32_t i_seed, int i_motion, int i_local );
+
+/* The per-frame work: the 8x8 integral plane of the reference as x264's
+ * frame_filter builds it, then a full search of every MB within i_range
+ * of its predictor, ads over each row of the window and the survivors
+ * checked as x264's me_search_ref does for the method. */
+void vbench_esa_frame( vbench_esa_t *t, const vbench_esa_param_t *param, vbench_esa_result_t *res );
+
+/* Returns 0 if both engines found the same mvs and costs, else sets the
+ * first differing MB and returns -1. */
+int vbench_esa_cmp( vbench_esa_t *a, vbench_esa_t *b, int *i_mb );
+
+#endif
@@ -0,0 +1,681 @@
+/*****************************************************************************
+ * iframe.c: I-frame mode decision
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/predict.h"
+#include "c_kernels/iframe.h"
+
+#define IFRAME_COST_MAX (1<<28)
+
+/* the 8-bit x264 lambda_tab */
+static const uint8_t iframe_lambda_tab[52] =
+{
+   1,  1,  1,  1,  1,  1,  1,  1,  /*  0- 7 */
+   1,  1,  1,  1,  1,  1,  1,  1,  /*  8-15 */
+   2,  2,  2,  2,  3,  3,  3,  4,  /* 16-23 */
+   4,  4,  5,  6,  6,  7,  8,  9,  /* 24-31 */
+  10, 11, 13, 14, 16, 18, 20, 23,  /* 32-39 */
+  25, 29, 32, 36, 40, 45, 51, 57,  /* 40-47 */
+  64, 72, 81, 91                   /* 48-51 */
+};
+
+/* flat 4x4 quant and dequant factors of each qp%6, by coefficient class */
+static const uint16_t iframe_quant4_scale[6][3] =
+{
+    { 13107, 8066, 5243 },
+    { 11916, 7490, 4660 },
+    { 10082, 6554, 4194 },
+    {  9362, 5825, 3647 },
+    {  8192, 5243, 3355 },
+    {  7282, 4559, 2893 },
+};
+static const uint8_t iframe_dequant4_scale[6][3] =
+{
+    { 10, 13, 16 },
+    { 11, 14, 18 },
+    { 13, 16, 20 },
+    { 14, 18, 23 },
+    { 16, 20, 25 },
+    { 18, 23, 29 },
+};
+
+/* bits of the ue() coded 16x16 and chroma modes */
+static const uint8_t iframe_ue_size[4] = { 1, 3, 3, 5 };
+
+/* The modes available with the left (1) and top (2) neighbours, in the
+ * order x264 tries them, -1 terminated.  The 4x4 lists serve 8x8 too.
+ * Only the full lists start with the modes the x3 kernels cover. */
+static const int8_t iframe_modes_16x16[4][5] =
+{
+    { I_PRED_16x16_DC_128, -1 },
+    { I_PRED_16x16_DC_LEFT, I_PRED_16x16_H, -1 },
+    { I_PRED_16x16_DC_TOP, I_PRED_16x16_V, -1 },
+    { I_PRED_16x16_V, I_PRED_16x16_H, I_PRED_16x16_DC, I_PRED_16x16_P, -1 },
+};
+static const int8_t iframe_modes_chroma[4][5] =
+{
+    { I_PRED_CHROMA_DC_128, -1 },
+    { I_PRED_CHROMA_DC_LEFT, I_PRED_CHROMA_H, -1 },
+    { I_PRED_CHROMA_DC_TOP, I_PRED_CHROMA_V, -1 },
+    { I_PRED_CHROMA_DC, I_PRED_CHROMA_H, I_PRED_CHROMA_V, I_PRED_CHROMA_P, -1 },
+};
+static const int8_t iframe_modes_4x4[4][10] =
+{
+    { I_PRED_4x4_DC_128, -1 },
+    { I_PRED_4x4_DC_LEFT, I_PRED_4x4_H, I_PRED_4x4_HU, -1 },
+    { I_PRED_4x4_DC_TOP, I_PRED_4x4_V, I_PRED_4x4_DDL, I_PRED_4x4_VL, -1 },
+    { I_PRED_4x4_V, I_PRED_4x4_H, I_PRED_4x4_DC, I_PRED_4x4_DDL, I_PRED_4x4_DDR,
+      I_PRED_4x4_VR, I_PRED_4x4_HD, I_PRED_4x4_VL, I_PRED_4x4_HU, -1 },
+};
+#define MODES( n ) ((!!((n)&MB_LEFT)) | (!!((n)&MB_TOP))<<1)
+#define ALL_MODES 3
+
+struct vbench_iframe_t
+{
+    DECLARE_ALIGNED( pixel fenc_buf[48*FENC_STRIDE], 64 );
+    DECLARE_ALIGNED( pixel fdec_buf[54*FDEC_STRIDE], 64 );
+    DECLARE_ALIGNED( pixel edge[36], 32 );
+    DECLARE_ALIGNED( dctcoef dct[16], 32 );
+    DECLARE_ALIGNED( uint16_t bitcosts[17], 64 );   /* lambda for the predicted mode at 8, else 4*lambda */
+    DECLARE_ALIGNED( uint16_t satds[16], 16 );
+    DECLARE_ALIGNED( udctcoef quant_mf[2][16], 32 );    /* luma and chroma qp */
+    DECLARE_ALIGNED( udctcoef quant_bias[2][16], 32 );
+    DECLARE_ALIGNED( int dequant_mf[6][16], 32 );
+
+    int i_width, i_height;
+    int i_mb_width, i_mb_height;
+    int i_csp;
+    int i_planes;               /* planes coded like luma, 3 in 4:4:4 */
+    int i_shift_h, i_shift_v;   /* chroma subsampling */
+    int i_qp[2];
+    int i_lambda;
+
+    vbench_plane_t src[3];
+    vbench_plane_t rec[2][3];
+    pixel *p_fenc[3];
+    pixel *p_fdec[3];
+
+    /* modes of the 4x4 blocks of every MB in raster order, fixed to the
+     * nine real ones, DC for I_16x16 MBs as the mode prediction wants */
+    int8_t (*mode4)[16];
+
+    /* the MB being coded */
+    int i_neighbor;
+    int i_mode16;
+    int i_mode_chroma;
+    int8_t mode8[4];
+    int8_t mode4x4[16];         /* by block_idx */
+};
+
+void vbench_iframe_func_init( uint64_t cpu, vbench_iframe_func_t *f, int i_csp, vbench_pixel_function_t *pixf,
+                              vbench_dct_function_t *dctf, vbench_quant_function_t *quantf )
+{
+    f->pixf = pixf;
+    f->dctf = dctf;
+    f->quantf = quantf;
+    vbench_predict_16x16_init( cpu, f->predict_16x16 );
+    if( i_csp == CHROMA_422 )
+        vbench_predict_8x16c_init( cpu, f->predict_chroma );
+    else
+        vbench_predict_8x8c_init( cpu, f->predict_chroma );
+    vbench_predict_8x8_init( cpu, f->predict_8x8, &f->predict_8x8_filter );
+    vbench_predict_4x4_init( cpu, f->predict_4x4 );
+}
+
+void vbench_iframe_close( vbench_iframe_t *t )
+{
+    if( !t )
+        return;
+    for( int p = 0; p < 3; p++ )
+    {
+        vbench_plane_free( &t->src[p] );
+        vbench_plane_free( &t->rec[0][p] );
+        vbench_plane_free( &t->rec[1][p] );
+    }
+    free( t->mode4 );
+    free( t );
+}
+
+vbench_iframe_t *vbench_iframe_open( int i_width, int i_height, int i_csp, int i_qp )
+{
+    vbench_iframe_t *t;
+
+    if( i_width <= 0 || i_height <= 0 || (i_width&15) || (i_height&15) ||
+        i_csp < CHROMA_400 || i_csp > CHROMA_444 )
+        return NULL;
+    t = memalign( 64, sizeof(vbench_iframe_t) );
+    if( !t )
+        return NULL;
+    memset( t, 0, sizeof(vbench_iframe_t) );
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_mb_width = i_width / 16;
+    t->i_mb_height = i_height / 16;
+    t->i_csp = i_csp;
+    t->i_planes = i_csp == CHROMA_444 ? 3 : 1;
+    t->i_shift_h = i_csp == CHROMA_420 || i_csp == CHROMA_422;
+    t->i_shift_v = i_csp == CHROMA_420;
+    t->i_qp[0] = vbench_clip3( i_qp, 0, 51 );
+    t->i_qp[1] = i_chroma_qp_table[t->i_qp[0]+12];
+    t->i_lambda = iframe_lambda_tab[t->i_qp[0]];
+
+    /* flat matrices, intra deadzone as x264's cqm init */
+    for( int c = 0; c < 2; c++ )
+        for( int i = 0; i < 16; i++ )
+        {
+            int q = t->i_qp[c];
+            int j = (i&1) + ((i>>2)&1);
+            int s = q/6 - 1;
+            int mf = s <= 0 ? iframe_quant4_scale[q%6][j] << -s : (iframe_quant4_scale[q%6][j] + (1<<(s-1))) >> s;
+            t->quant_mf[c][i] = mf;
+            t->quant_bias[c][i] = MIN( ((21<<10) + mf/2) / mf, (1<<15) / mf );
+        }
+    for( int q = 0; q < 6; q++ )
+        for( int i = 0; i < 16; i++ )
+            t->dequant_mf[q][i] = iframe_dequant4_scale[q][(i&1) + ((i>>2)&1)] * 16;
+    for( int i = 0; i < 17; i++ )
+        t->bitcosts[i] = t->i_lambda * (i == 8 ? 1 : 4);
+
+    t->p_fenc[0] = t->fenc_buf;
+    t->p_fdec[0] = t->fdec_buf + 2*FDEC_STRIDE;
+    if( i_csp == CHROMA_444 )
+    {
+        t->p_fenc[1] = t->fenc_buf + 16*FENC_STRIDE;
+        t->p_fenc[2] = t->fenc_buf + 32*FENC_STRIDE;
+        t->p_fdec[1] = t->fdec_buf + 20*FDEC_STRIDE;
+        t->p_fdec[2] = t->fdec_buf + 38*FDEC_STRIDE;
+    }
+    else
+    {
+        t->p_fenc[1] = t->fenc_buf + 16*FENC_STRIDE;
+        t->p_fenc[2] = t->fenc_buf + 16*FENC_STRIDE + 8;
+        t->p_fdec[1] = t->fdec_buf + 19*FDEC_STRIDE;
+        t->p_fdec[2] = t->fdec_buf + 19*FDEC_STRIDE + 16;
+    }
+
+    for( int p = 0; p < (i_csp ? 3 : 1); p++ )
+    {
+        int w = p ? i_width >> t->i_shift_h : i_width;
+        int h = p ? i_height >> t->i_shift_v : i_height;
+        if( vbench_plane_alloc( &t->src[p], w, h, 0, NULL ) ||
+            vbench_plane_alloc( &t->rec[0][p], w, h, 0, NULL ) ||
+            vbench_plane_alloc( &t->rec[1][p], w, h, 0, NULL ) )
+            goto fail;
+    }
+    t->mode4 = malloc( t->i_mb_width * t->i_mb_height * sizeof(*t->mode4) );
+    if( !t->mode4 )
+        goto fail;
+
+    /* 64x64 regions of smooth gradients, diagonal stripes, blocky edges
+     * and noise, so that every block size and most modes win somewhere */
+    for( int p = 0; p < (i_csp ? 3 : 1); p++ )
+    {
+        vbench_plane_t *pl = &t->src[p];
+        for( int y = 0; y < pl->i_height; y++ )
+            for( int x = 0; x < pl->i_width; x++ )
+            {
+                int lx = p ? x << t->i_shift_h : x;
+                int ly = p ? y << t->i_shift_v : y;
+                int v;
+                switch( ((lx>>6)*5 + (ly>>6)*3) & 3 )
+                {
+                    case 0:  v = 64 + (((lx + 2*ly) >> 3) & 127) + 8*p; break;
+                    case 1:  v = (lx + ly) & 8 ? 180 : 70; break;
+                    case 2:  v = ((lx>>3) ^ (ly>>2)) & 1 ? 160 + (lx&3)*8 : 90; break;
+                    default: v = 96 + (rand() & 63) + ((ly>>2)&1)*24; break;
+                }
+                pl->plane[y*pl->i_stride+x] = vbench_clip_pixel( v + (rand() & 3) );
+            }
+    }
+    return t;
+fail:
+    vbench_iframe_close( t );
+    return NULL;
+}
+
+int vbench_iframe_mbs( vbench_iframe_t *t )
+{
+    return t->i_mb_width * t->i_mb_height;
+}
+
+/* Neighbours of the w x w (in 4x4 blocks) block at x,y of the MB.  Inside
+ * the MB the top right block is only there if it was coded first. */
+static int iframe_neighbor( int i_mb_neighbor, int x, int y, int w )
+{
+    int n = 0;
+    if( x || (i_mb_neighbor & MB_LEFT) )
+        n |= MB_LEFT;
+    if( y || (i_mb_neighbor & MB_TOP) )
+        n |= MB_TOP;
+    if( x && y ? 1 : x ? i_mb_neighbor & MB_TOP : y ? i_mb_neighbor & MB_LEFT : i_mb_neighbor & MB_TOPLEFT )
+        n |= MB_TOPLEFT;
+    if( x + w < 4 ? (y ? block_idx_xy[x+w][y-1] < block_idx_xy[x][y] : i_mb_neighbor & MB_TOP)
+                  : !y && (i_mb_neighbor & MB_TOPRIGHT) )
+        n |= MB_TOPRIGHT;
+    return n;
+}
+
+/* the most probable mode of the 4x4 block at x,y, DC unless both the
+ * left and top blocks are in the picture */
+static int iframe_pred_mode( vbench_iframe_t *t, int i_mb, int x, int y )
+{
+    int mb_x = i_mb % t->i_mb_width;
+    int mb_y = i_mb / t->i_mb_width;
+    int left = x ? t->mode4[i_mb][y*4+x-1] : mb_x ? t->mode4[i_mb-1][y*4+3] : -1;
+    int top  = y ? t->mode4[i_mb][y*4+x-4] : mb_y ? t->mode4[i_mb-t->i_mb_width][12+x] : -1;
+    if( left < 0 || top < 0 )
+        return I_PRED_4x4_DC;
+    return MIN( left, top );
+}
+
+static void iframe_load( vbench_iframe_t *t, int i_rec, int mb_x, int mb_y )
+{
+    for( int p = 0; p < (t->i_csp ? 3 : 1); p++ )
+    {
+        int b_chroma = p && t->i_planes == 1;
+        int w = b_chroma ? 16 >> t->i_shift_h : 16;
+        int h = b_chroma ? 16 >> t->i_shift_v : 16;
+        vbench_plane_t *src = &t->src[p];
+        vbench_plane_t *rec = &t->rec[i_rec][p];
+        pixel *pix = src->plane + mb_y*h*src->i_stride + mb_x*w;
+        pixel *top = rec->plane + (mb_y*h-1)*rec->i_stride + mb_x*w;
+
+        for( int y = 0; y < h; y++ )
+            memcpy( t->p_fenc[p] + y*FENC_STRIDE, pix + y*src->i_stride, w * sizeof(pixel) );
+        if( t->i_neighbor & MB_TOP )
+        {
+            int i_left = !!(t->i_neighbor & MB_TOPLEFT);
+            int i_right = !b_chroma && (t->i_neighbor & MB_TOPRIGHT) ? 8 : 0;
+            memcpy( t->p_fdec[p] - FDEC_STRIDE - i_left, top - i_left, (i_left + w + i_right) * sizeof(pixel) );
+        }
+        if( t->i_neighbor & MB_LEFT )
+            for( int y = 0; y < h; y++ )
+                t->p_fdec[p][y*FDEC_STRIDE-1] = top[(y+1)*rec->i_stride-1];
+    }
+}
+
+static void iframe_save( vbench_iframe_t *t, int i_rec, int mb_x, int mb_y )
+{
+    for( int p = 0; p < (t->i_csp ? 3 : 1); p++ )
+    {
+        int b_chroma = p && t->i_planes == 1;
+        int w = b_chroma ? 16 >> t->i_shift_h : 16;
+        int h = b_chroma ? 16 >> t->i_shift_v : 16;
+        vbench_plane_t *rec = &t->rec[i_rec][p];
+        pixel *dst = rec->plane + mb_y*h*rec->i_stride + mb_x*w;
+        for( int y = 0; y < h; y++ )
+            memcpy( dst + y*rec->i_stride, t->p_fdec[p] + y*FDEC_STRIDE, w * sizeof(pixel) );
+    }
+}
+
+/* residual of a 4x4 block through the 4x4 transform and quant, added
+ * back to its prediction */
+static ALWAYS_INLINE void iframe_recon4x4( vbench_iframe_t *t, vbench_iframe_func_t *f, pixel *fenc, pixel *fdec, int b_chroma )
+{
+    f->dctf->sub4x4_dct( t->dct, fenc, fdec );
+    if( f->quantf->quant_4x4( t->dct, t->quant_mf[b_chroma], t->quant_bias[b_chroma] ) )
+    {
+        f->quantf->dequant_4x4( t->dct, t->dequant_mf, t->i_qp[b_chroma] );
+        f->dctf->add4x4_idct( fdec, t->dct );
+    }
+}
+
+static void iframe_recon( vbench_iframe_t *t, vbench_iframe_func_t *f, int p, int w, int h )
+{
+    for( int y = 0; y < h; y += 4 )
+        for( int x = 0; x < w; x += 4 )
+            iframe_recon4x4( t, f, t->p_fenc[p] + x + y*FENC_STRIDE, t->p_fdec[p] + x + y*FDEC_STRIDE, p > 0 );
+}
+
+/* a top right the 4x4 block can't see is replaced by its last top pixel */
+static ALWAYS_INLINE void iframe_fill_topright( pixel *fdec, int n )
+{
+    if( (n & MB_TOP) && !(n & MB_TOPRIGHT) )
+        for( int i = 0; i < 4; i++ )
+            fdec[4+i-FDEC_STRIDE] = fdec[3-FDEC_STRIDE];
+}
+
+static int iframe_analyse_16x16( vbench_iframe_t *t, vbench_iframe_func_t *f, int b_fast, vbench_iframe_result_t *res )
+{
+    int i_modes = MODES( t->i_neighbor );
+    const int8_t *modes = iframe_modes_16x16[i_modes];
+    pixel *fenc = t->p_fenc[0];
+    pixel *fdec = t->p_fdec[0];
+    int i_best = IFRAME_COST_MAX;
+    int i = 0;
+
+    if( b_fast && i_modes == ALL_MODES )
+    {
+        int satd[3];
+        f->pixf->intra_satd_x3_16x16( fenc, fdec, satd );
+        for( ; i < 3; i++ )
+        {
+            int i_cost = satd[i] + t->i_lambda * iframe_ue_size[i];
+            if( i_cost < i_best )
+            {
+                i_best = i_cost;
+                t->i_mode16 = i;
+            }
+        }
+        res->i_x3[2]++;
+    }
+    for( ; modes[i] >= 0; i++ )
+    {
+        int i_cost;
+        f->predict_16x16[modes[i]]( fdec );
+        i_cost = f->pixf->satd[PIXEL_16x16]( fenc, FENC_STRIDE, fdec, FDEC_STRIDE )
+               + t->i_lambda * iframe_ue_size[vbench_mb_pred_mode16x16_fix[modes[i]]];
+        if( i_cost < i_best )
+        {
+            i_best = i_cost;
+            t->i_mode16 = modes[i];
+        }
+    }
+    return i_best;
+}
+
+/* Each 8x8 block is decided and reconstructed before the next one is
+ * predicted from it.  Gives up once the cost reaches i_thresh. */
+static int iframe_analyse_8x8( vbench_iframe_t *t, vbench_iframe_func_t *f, int i_mb, int b_fast, int i_thresh,
+                               vbench_iframe_result_t *res )
+{
+    int i_cost = t->i_lambda * 4;
+
+    for( int idx = 0; idx < 4 && i_cost < i_thresh; idx++ )
+    {
+        int x = 2*(idx&1), y = 2*(idx>>1);
+        int n = iframe_neighbor( t->i_neighbor, x, y, 2 );
+        int i_modes = MODES( n );
+        const int8_t *modes = iframe_modes_4x4[i_modes];
+        uint16_t *bitcosts = t->bitcosts + 8 - iframe_pred_mode( t, i_mb, x, y );
+        pixel *fenc = t->p_fenc[0] + 4*x + 4*y*FENC_STRIDE;
+        pixel *fdec = t->p_fdec[0] + 4*x + 4*y*FDEC_STRIDE;
+        int i_best = IFRAME_COST_MAX;
+        int i_mode = 0;
+
+        f->predict_8x8_filter( fdec, t->edge, n, ALL_NEIGHBORS );
+        if( b_fast && i_modes == ALL_MODES && f->pixf->intra_sa8d_x9_8x8 )
+        {
+            int i_ret = f->pixf->intra_sa8d_x9_8x8( fenc, fdec, t->edge, bitcosts, t->satds );
+            i_best = i_ret & 0xffff;
+            i_mode = i_ret >> 16;
+            res->i_x9[1]++;
+        }
+        else
+        {
+            int i = 0;
+            if( b_fast && i_modes == ALL_MODES )
+            {
+                int satd[3];
+                f->pixf->intra_sa8d_x3_8x8( fenc, t->edge, satd );
+                for( ; i < 3; i++ )
+                    if( satd[i] + bitcosts[i] < i_best )
+                    {
+                        i_best = satd[i] + bitcosts[i];
+                        i_mode = i;
+                    }
+                res->i_x3[1]++;
+            }
+            for( ; modes[i] >= 0; i++ )
+            {
+                int i_satd;
+                f->predict_8x8[modes[i]]( fdec, t->edge );
+                i_satd = f->pixf->sa8d[PIXEL_8x8]( fenc, FENC_STRIDE, fdec, FDEC_STRIDE )
+                       + bitcosts[vbench_mb_pred_mode4x4_fix(modes[i])];
+                if( i_satd < i_best )
+                {
+                    i_best = i_satd;
+                    i_mode = modes[i];
+                }
+            }
+        }
+        i_cost += i_best;
+        t->mode8[idx] = i_mode;
+        M16( &t->mode4[i_mb][y*4+x] ) = M16( &t->mode4[i_mb][y*4+x+4] ) = vbench_mb_pred_mode4x4_fix(i_mode) * 0x0101;
+
+        f->predict_8x8[i_mode]( fdec, t->edge );
+        for( int i = 0; i < 4; i++ )
+            iframe_recon4x4( t, f, fenc + 4*(i&1) + 4*(i>>1)*FENC_STRIDE, fdec + 4*(i&1) + 4*(i>>1)*FDEC_STRIDE, 0 );
+    }
+    return i_cost;
+}
+
+static int iframe_analyse_4x4( vbench_iframe_t *t, vbench_iframe_func_t *f, int i_mb, int b_fast, int i_thresh,
+                               vbench_iframe_result_t *res )
+{
+    int i_cost = t->i_lambda * 24;
+
+    for( int idx = 0; idx < 16 && i_cost < i_thresh; idx++ )
+    {
+        int x = block_idx_x[idx], y = block_idx_y[idx];
+        int n = iframe_neighbor( t->i_neighbor, x, y, 1 );
+        int i_modes = MODES( n );
+        const int8_t *modes = iframe_modes_4x4[i_modes];
+        uint16_t *bitcosts = t->bitcosts + 8 - iframe_pred_mode( t, i_mb, x, y );
+        pixel *fenc = t->p_fenc[0] + block_idx_xy_fenc[idx];
+        pixel *fdec = t->p_fdec[0] + block_idx_xy_fdec[idx];
+        int i_best = IFRAME_COST_MAX;
+        int i_mode = 0;
+
+        iframe_fill_topright( fdec, n );
+        if( b_fast && i_modes == ALL_MODES && f->pixf->intra_satd_x9_4x4 )
+        {
+            /* leaves the prediction of the best mode in fdec */
+            int i_ret = f->pixf->intra_satd_x9_4x4( fenc, fdec, bitcosts );
+            i_best = i_ret & 0xffff;
+            i_mode = i_ret >> 16;
+            res->i_x9[0]++;
+        }
+        else
+        {
+            int i = 0;
+            if( b_fast && i_modes == ALL_MODES )
+            {
+                int satd[3];
+                f->pixf->intra_satd_x3_4x4( fenc, fdec, satd );
+                for( ; i < 3; i++ )
+                    if( satd[i] + bitcosts[i] < i_best )
+                    {
+                        i_best = satd[i] + bitcosts[i];
+                        i_mode = i;
+                    }
+                res->i_x3[0]++;
+            }
+            for( ; modes[i] >= 0; i++ )
+            {
+                int i_satd;
+                f->predict_4x4[modes[i]]( fdec );
+                i_satd = f->pixf->satd[PIXEL_4x4]( fenc, FENC_STRIDE, fdec, FDEC_STRIDE )
+                       + bitcosts[vbench_mb_pred_mode4x4_fix(modes[i])];
+                if( i_satd < i_best )
+                {
+                    i_best = i_satd;
+                    i_mode = modes[i];
+                }
+            }
+            f->predict_4x4[i_mode]( fdec );
+        }
+        i_cost += i_best;
+        t->mode4x4[idx] = i_mode;
+        t->mode4[i_mb][y*4+x] = vbench_mb_pred_mode4x4_fix(i_mode);
+        iframe_recon4x4( t, f, fenc, fdec, 0 );
+    }
+    return i_cost;
+}
+
+static int iframe_analyse_chroma( vbench_iframe_t *t, vbench_iframe_func_t *f, int b_fast, vbench_iframe_result_t *res )
+{
+    int i_modes = MODES( t->i_neighbor );
+    const int8_t *modes = iframe_modes_chroma[i_modes];
+    int i_size = t->i_csp == CHROMA_422 ? PIXEL_8x16 : PIXEL_8x8;
+    int i_best = IFRAME_COST_MAX;
+    int i = 0;
+
+    if( b_fast && i_modes == ALL_MODES )
+    {
+        int satdu[3], satdv[3];
+        void (*intra_satd_x3)( pixel *, pixel *, int[3] ) = t->i_csp == CHROMA_422 ? f->pixf->intra_satd_x3_8x16c
+                                                                                   : f->pixf->intra_satd_x3_8x8c;
+        intra_satd_x3( t->p_fenc[1], t->p_fdec[1], satdu );
+        intra_satd_x3( t->p_fenc[2], t->p_fdec[2], satdv );
+        for( ; i < 3; i++ )
+        {
+            int i_cost = satdu[i] + satdv[i] + t->i_lambda * iframe_ue_size[i];
+            if( i_cost < i_best )
+            {
+                i_best = i_cost;
+                t->i_mode_chroma = i;
+            }
+        }
+        res->i_x3[3]++;
+    }
+    for( ; modes[i] >= 0; i++ )
+    {
+        int i_cost = t->i_lambda * iframe_ue_size[vbench_mb_chroma_pred_mode_fix[modes[i]]];
+        for( int p = 1; p < 3; p++ )
+        {
+            f->predict_chroma[modes[i]]( t->p_fdec[p] );
+            i_cost += f->pixf->satd[i_size]( t->p_fenc[p], FENC_STRIDE, t->p_fdec[p], FDEC_STRIDE );
+        }
+        if( i_cost < i_best )
+        {
+            i_best = i_cost;
+            t->i_mode_chroma = modes[i];
+        }
+    }
+    return i_best;
+}
+
+/* predict plane p of the MB with the chosen modes and reconstruct it */
+static void iframe_encode_plane( vbench_iframe_t *t, vbench_iframe_func_t *f, int p, int i_type )
+{
+    pixel *fdec = t->p_fdec[p];
+
+    if( i_type == I_16x16 )
+    {
+        f->predict_16x16[t->i_mode16]( fdec );
+        iframe_recon( t, f, p, 16, 16 );
+    }
+    else if( i_type == I_8x8 )
+        for( int idx = 0; idx < 4; idx++ )
+        {
+            int x = 8*(idx&1), y = 8*(idx>>1);
+            f->predict_8x8_filter( fdec + x + y*FDEC_STRIDE, t->edge, iframe_neighbor( t->i_neighbor, x>>2, y>>2, 2 ), ALL_NEIGHBORS );
+            f->predict_8x8[t->mode8[idx]]( fdec + x + y*FDEC_STRIDE, t->edge );
+            for( int i = 0; i < 4; i++ )
+            {
+                int o = x + 4*(i&1) + (y + 4*(i>>1))*FENC_STRIDE;
+                int od = x + 4*(i&1) + (y + 4*(i>>1))*FDEC_STRIDE;
+                iframe_recon4x4( t, f, t->p_fenc[p] + o, fdec + od, p > 0 );
+            }
+        }
+    else
+        for( int idx = 0; idx < 16; idx++ )
+        {
+            pixel *dst = fdec + block_idx_xy_fdec[idx];
+            iframe_fill_topright( dst, iframe_neighbor( t->i_neighbor, block_idx_x[idx], block_idx_y[idx], 1 ) );
+            f->predict_4x4[t->mode4x4[idx]]( dst );
+            iframe_recon4x4( t, f, t->p_fenc[p] + block_idx_xy_fenc[idx], dst, p > 0 );
+        }
+}
+
+static void iframe_mb( vbench_iframe_t *t, vbench_iframe_func_t *f, int b_fast, int i_rec, int mb_x, int mb_y,
+                       vbench_iframe_result_t *res )
+{
+    int i_mb = mb_y * t->i_mb_width + mb_x;
+    int i_cost[3], i_type = I_16x16;
+
+    t->i_neighbor = (mb_x ? MB_LEFT : 0) | (mb_y ? MB_TOP : 0) | (mb_x && mb_y ? MB_TOPLEFT : 0)
+                  | (mb_y && mb_x < t->i_mb_width-1 ? MB_TOPRIGHT : 0);
+    iframe_load( t, i_rec, mb_x, mb_y );
+
+    i_cost[I_16x16] = iframe_analyse_16x16( t, f, b_fast, res );
+    i_cost[I_8x8] = iframe_analyse_8x8( t, f, i_mb, b_fast, i_cost[I_16x16], res );
+    i_cost[I_4x4] = iframe_analyse_4x4( t, f, i_mb, b_fast, MIN( i_cost[I_16x16], i_cost[I_8x8] ), res );
+    if( i_cost[I_8x8] < i_cost[i_type] )
+        i_type = I_8x8;
+    if( i_cost[I_4x4] < i_cost[i_type] )
+        i_type = I_4x4;
+
+    /* the 4x4 analysis ran last, so only its reconstruction is in fdec */
+    if( i_type == I_16x16 )
+        memset( t->mode4[i_mb], I_PRED_4x4_DC, 16 );
+    else if( i_type == I_8x8 )
+        for( int idx = 0; idx < 4; idx++ )
+        {
+            int o = 8*(idx>>1) + 2*(idx&1);
+            M16( &t->mode4[i_mb][o] ) = M16( &t->mode4[i_mb][o+4] ) = vbench_mb_pred_mode4x4_fix(t->mode8[idx]) * 0x0101;
+        }
+    if( i_type != I_4x4 )
+        iframe_encode_plane( t, f, 0, i_type );
+
+    /* 4:4:4 chroma reuses the luma modes */
+    if( t->i_planes == 3 )
+    {
+        iframe_encode_plane( t, f, 1, i_type );
+        iframe_encode_plane( t, f, 2, i_type );
+    }
+    else if( t->i_csp )
+    {
+        int h = 16 >> t->i_shift_v;
+        i_cost[i_type] += iframe_analyse_chroma( t, f, b_fast, res );
+        for( int p = 1; p < 3; p++ )
+        {
+            f->predict_chroma[t->i_mode_chroma]( t->p_fdec[p] );
+            iframe_recon( t, f, p, 8, h );
+        }
+    }
+    iframe_save( t, i_rec, mb_x, mb_y );
+
+    res->i_mbs[i_type]++;
+    res->i_cost += i_cost[i_type];
+}
+
+void vbench_iframe_analyse( vbench_iframe_t *t, vbench_iframe_func_t *f, int b_fast, int i_rec,
+                            vbench_iframe_result_t *res )
+{
+    memset( res, 0, sizeof(vbench_iframe_result_t) );
+    for( int mb_y = 0; mb_y < t->i_mb_height; mb_y++ )
+        for( int mb_x = 0; mb_x < t->i_mb_width; mb_x++ )
+            iframe_mb( t, f, b_fast, i_rec, mb_x, mb_y, res );
+}
+
+int vbench_iframe_cmp( vbench_iframe_t *t, int *i_plane, int *i_row )
+{
+    for( int p = 0; p < (t->i_csp ? 3 : 1); p++ )
+    {
+        vbench_plane_t *a = &t->rec[0][p];
+        vbench_plane_t *b = &t->rec[1][p];
+        for( int y = 0; y < a->i_height; y++ )
+            if( memcmp( a->plane + y*a->i_stride, b->plane + y*b->i_stride, a->i_width * sizeof(pixel) ) )
+            {
+                *i_plane = p;
+                *i_row = y;
+                return -1;
+            }
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * iframe.h: I-frame mode decision
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef IFRAME_H
+#define IFRAME_H
+
+/* The kernels an I-frame analysis runs: the caller's pixel, dct and quant
+ * functions and the intra predictors of the same cpu. */
+typedef struct
+{
+    vbench_pixel_function_t *pixf;
+    vbench_dct_function_t *dctf;
+    vbench_quant_function_t *quantf;
+    vbench_predict_t      predict_16x16[4+3];
+    vbench_predict_t      predict_chroma[4+3];
+    vbench_predict8x8_t   predict_8x8[9+3];
+    vbench_predict_t      predict_4x4[9+3];
+    vbench_predict_8x8_filter_t predict_8x8_filter;
+} vbench_iframe_func_t;
+
+/* chroma prediction is 8x8c or 8x16c as i_csp asks */
+void vbench_iframe_func_init( uint64_t cpu, vbench_iframe_func_t *f, int i_csp, vbench_pixel_function_t *pixf,
+                              vbench_dct_function_t *dctf, vbench_quant_function_t *quantf );
+
+typedef struct
+{
+    int i_mbs[3];       /* I_4x4, I_8x8 and I_16x16 MBs chosen */
+    int64_t i_cost;     /* SATD plus lambda * bits of the chosen modes */
+    int i_x9[2];        /* 4x4 and 8x8 blocks decided by an x9 kernel */
+    int i_x3[4];        /* 4x4, 8x8, 16x16 and chroma decisions that began with an x3 kernel */
+} vbench_iframe_result_t;
+
+typedef struct vbench_iframe_t vbench_iframe_t;
+
+/* A textured frame of i_width x i_height, multiples of 16, in chroma
+ * format i_csp, to code at i_qp, and two reconstructed frames so the
+ * results of two kernel sets can be compared. */
+vbench_iframe_t *vbench_iframe_open( int i_width, int i_height, int i_csp, int i_qp );
+void vbench_iframe_close( vbench_iframe_t *t );
+int  vbench_iframe_mbs( vbench_iframe_t *t );
+
+/* Mode decision of every MB in raster order, as x264's intra analysis:
+ * the 16x16 modes, then the 8x8 and the 4x4 ones block by block, each
+ * block predicted from the reconstruction of those before it, then the
+ * chroma modes.  The chosen modes are reconstructed into frame i_rec
+ * through the 4x4 transform and quant.  With b_fast, the x3 and x9 kernels
+ * cover the modes they can, else every mode is predicted and compared on
+ * its own. */
+void vbench_iframe_analyse( vbench_iframe_t *t, vbench_iframe_func_t *f, int b_fast, int i_rec,
+                            vbench_iframe_result_t *res );
+
+/* Returns 0 if both reconstructed frames match, else sets the first
+ * differing plane and row and returns -1. */
+int vbench_iframe_cmp( vbench_iframe_t *t, int *i_plane, int *i_row );
+
+#endif
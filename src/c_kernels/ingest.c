@@ -0,0 +1,457 @@
+/*****************************************************************************
+ * ingest.c: whole-frame raw input conversion
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/ingest.h"
+#include "c_kernels/threadpool.h"
+#include "c_kernels/memory.h"
+
+/* pictures in the ring of --ingest */
+#define INGEST_RING_FRAMES 8
+
+const char * const vbench_ingest_names[INGEST_FORMATS] =
+{
+    "i420:i420", "i420:nv12", "nv12:nv12", "nv12:i420", "bgr:gbrp", "bgra:gbrp", "v210:nv16"
+};
+
+/* Output planes, their horizontal and vertical chroma shifts and the
+ * planes written by a conversion kernel rather than copied */
+static const struct
+{
+    int i_planes;
+    int i_chroma_w, i_chroma_h;
+    int i_converted;
+} ingest_layout[INGEST_FORMATS] =
+{
+    [INGEST_I420_I420] = { 3, 1, 1, 0 },
+    [INGEST_I420_NV12] = { 2, 0, 1, 2 },
+    [INGEST_NV12_NV12] = { 2, 0, 1, 0 },
+    [INGEST_NV12_I420] = { 3, 1, 1, 6 },
+    [INGEST_BGR_GBRP]  = { 3, 0, 0, 7 },
+    [INGEST_BGRA_GBRP] = { 3, 0, 0, 7 },
+    [INGEST_V210_NV16] = { 2, 0, 0, 3 },
+};
+
+typedef struct
+{
+    int i_y0, i_y1;
+    pixel *tile[3];
+} ingest_band_t;
+
+struct vbench_ingest_t
+{
+    vbench_mc_functions_t *mc;
+    int i_format;
+    int i_width, i_height;
+    int64_t i_frame_size;
+    int i_planes;
+    int i_plane_width[3];
+    int i_plane_shift[3];
+    intptr_t i_stride[3];
+    int i_frames;
+    pixel *(*frame)[3];
+    int i_threads;
+    ingest_band_t band[THREADPOOL_MAX_THREADS];
+    vbench_threadpool_t *pool;
+
+    /* current job */
+    uint8_t *src;
+    pixel **dst;
+    int i_policy;
+};
+
+int vbench_ingest_format( const char *psz_name )
+{
+    for( int i = 0; i < INGEST_FORMATS; i++ )
+        if( !strcmp( psz_name, vbench_ingest_names[i] ) )
+            return i;
+    return -1;
+}
+
+static intptr_t ingest_v210_stride( int i_width )
+{
+    /* 48 pixels in 128 bytes, in 32-bit words */
+    return (i_width + 47) / 48 * 32;
+}
+
+int64_t vbench_ingest_frame_size( int i_format, int i_width, int i_height )
+{
+    int64_t size = (int64_t)i_width * i_height;
+
+    if( (i_width | i_height) & 1 || i_width < 16 || i_height < 2 )
+        return 0;
+    switch( i_format )
+    {
+        case INGEST_I420_I420:
+        case INGEST_I420_NV12:
+        case INGEST_NV12_NV12:
+        case INGEST_NV12_I420:
+            return size * 3 / 2 * sizeof(pixel);
+        case INGEST_BGR_GBRP:
+            return size * 3 * sizeof(pixel);
+        case INGEST_BGRA_GBRP:
+            return size * 4 * sizeof(pixel);
+#if HIGH_BIT_DEPTH
+        case INGEST_V210_NV16:
+            /* the kernel converts 6 pixels per iteration */
+            if( i_width % 6 )
+                return 0;
+            return ingest_v210_stride( i_width ) * sizeof(uint32_t) * i_height;
+#endif
+    }
+    return 0;
+}
+
+/* Source planes at luma row y, strides in pixels (words for v210) */
+static void ingest_src( vbench_ingest_t *t, int y, pixel *src[3], intptr_t i_src[3] )
+{
+    pixel *base = (pixel*)t->src;
+    int w = t->i_width, h = t->i_height;
+
+    switch( t->i_format )
+    {
+        case INGEST_I420_I420:
+        case INGEST_I420_NV12:
+            i_src[0] = w;
+            i_src[1] = i_src[2] = w >> 1;
+            src[0] = base + y * i_src[0];
+            src[1] = base + w * h + (y >> 1) * i_src[1];
+            src[2] = src[1] + (w >> 1) * (h >> 1);
+            break;
+        case INGEST_NV12_NV12:
+        case INGEST_NV12_I420:
+            i_src[0] = i_src[1] = w;
+            src[0] = base + y * i_src[0];
+            src[1] = base + w * h + (y >> 1) * i_src[1];
+            break;
+        case INGEST_BGR_GBRP:
+        case INGEST_BGRA_GBRP:
+            i_src[0] = w * (t->i_format == INGEST_BGR_GBRP ? 3 : 4);
+            src[0] = base + y * i_src[0];
+            break;
+        case INGEST_V210_NV16:
+            i_src[0] = ingest_v210_stride( w );
+            src[0] = (pixel*)((uint32_t*)t->src + y * i_src[0]);
+            break;
+    }
+}
+
+/* Rows [y,y+h) of the current frame.  Under INGEST_STREAM the kernels
+ * that do more than copy write into the tile, which is then streamed
+ * into the picture; the tile has the picture strides so both passes see
+ * the same row alignment. */
+static void ingest_tile( vbench_ingest_t *t, ingest_band_t *b, int y, int h )
+{
+    vbench_mc_functions_t *mc = t->mc;
+    pixel *src[3] = {0}, *pic[3], *dst[3];
+    intptr_t i_src[3] = {0}, *i_dst = t->i_stride;
+    int w = t->i_width;
+    int b_stream = t->i_policy == INGEST_STREAM;
+
+    ingest_src( t, y, src, i_src );
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        pic[p] = t->dst[p] + (y >> t->i_plane_shift[p]) * t->i_stride[p];
+        dst[p] = b_stream ? b->tile[p] : pic[p];
+    }
+
+    switch( t->i_format )
+    {
+        case INGEST_I420_I420:
+            mc->plane_copy( pic[0], i_dst[0], src[0], i_src[0], w, h );
+            mc->plane_copy( pic[1], i_dst[1], src[1], i_src[1], w >> 1, h >> 1 );
+            mc->plane_copy( pic[2], i_dst[2], src[2], i_src[2], w >> 1, h >> 1 );
+            break;
+        case INGEST_I420_NV12:
+            mc->plane_copy( pic[0], i_dst[0], src[0], i_src[0], w, h );
+            mc->plane_copy_interleave( dst[1], i_dst[1], src[1], i_src[1], src[2], i_src[2], w >> 1, h >> 1 );
+            break;
+        case INGEST_NV12_NV12:
+            mc->plane_copy( pic[0], i_dst[0], src[0], i_src[0], w, h );
+            mc->plane_copy( pic[1], i_dst[1], src[1], i_src[1], w, h >> 1 );
+            break;
+        case INGEST_NV12_I420:
+            mc->plane_copy( pic[0], i_dst[0], src[0], i_src[0], w, h );
+            mc->plane_copy_deinterleave( dst[1], i_dst[1], dst[2], i_dst[2], src[1], i_src[1], w >> 1, h >> 1 );
+            break;
+        case INGEST_BGR_GBRP:
+        case INGEST_BGRA_GBRP:
+            mc->plane_copy_deinterleave_rgb( dst[1], i_dst[1], dst[0], i_dst[0], dst[2], i_dst[2],
+                                             src[0], i_src[0], t->i_format == INGEST_BGR_GBRP ? 3 : 4, w, h );
+            break;
+        case INGEST_V210_NV16:
+            mc->plane_copy_deinterleave_v210( dst[0], i_dst[0], dst[1], i_dst[1], (uint32_t*)src[0], i_src[0], w, h );
+            break;
+    }
+
+    if( b_stream )
+        for( int p = 0; p < t->i_planes; p++ )
+            if( ingest_layout[t->i_format].i_converted & (1 << p) )
+                mc->plane_copy( pic[p], i_dst[p], b->tile[p], i_dst[p],
+                                t->i_plane_width[p], h >> t->i_plane_shift[p] );
+}
+
+static void ingest_band_job( void *arg, int i_thread )
+{
+    vbench_ingest_t *t = arg;
+    ingest_band_t *b = &t->band[i_thread];
+
+    for( int y = b->i_y0; y < b->i_y1; y += INGEST_TILE_ROWS )
+        ingest_tile( t, b, y, MIN( INGEST_TILE_ROWS, b->i_y1 - y ) );
+    vbench_emms();
+}
+
+vbench_ingest_t *vbench_ingest_open( vbench_mc_functions_t *mc, int i_format, int i_width, int i_height,
+                                     int i_frames, int i_threads )
+{
+    vbench_ingest_t *t;
+    int i_tiles = (i_height + INGEST_TILE_ROWS - 1) / INGEST_TILE_ROWS;
+    size_t frame_size = 0, tile_size = 0;
+
+    if( i_format < 0 || i_format >= INGEST_FORMATS || i_frames < 1 ||
+        !vbench_ingest_frame_size( i_format, i_width, i_height ) )
+        return NULL;
+    t = calloc( 1, sizeof(vbench_ingest_t) );
+    if( !t )
+        return NULL;
+    t->mc = mc;
+    t->i_format = i_format;
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_frame_size = vbench_ingest_frame_size( i_format, i_width, i_height );
+    t->i_planes = ingest_layout[i_format].i_planes;
+    t->i_frames = i_frames;
+    i_threads = MIN( i_threads, THREADPOOL_MAX_THREADS );
+    i_threads = MIN( i_threads, i_tiles );
+    t->i_threads = MAX( i_threads, 1 );
+
+    /* The SIMD kernels store whole vectors past the width of a row, up to
+     * 16 pixels for plane_copy_deinterleave, and the non-temporal ones
+     * need aligned rows: pad every row by at least 32 pixels and round it
+     * up to a cache line.  The padding also keeps 1080p strides off a
+     * multiple of 4KiB. */
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        t->i_plane_width[p] = p ? i_width >> ingest_layout[i_format].i_chroma_w : i_width;
+        t->i_plane_shift[p] = p ? ingest_layout[i_format].i_chroma_h : 0;
+        t->i_stride[p] = ALIGN( t->i_plane_width[p] + 32, 64 );
+        frame_size += t->i_stride[p] * (i_height >> t->i_plane_shift[p]);
+        tile_size  += t->i_stride[p] * INGEST_TILE_ROWS;
+    }
+
+    /* The pictures follow the --mem policy.  Touch everything now so
+     * page faults don't end up in the first frames converted. */
+    t->frame = calloc( i_frames, sizeof(*t->frame) );
+    if( !t->frame )
+        goto fail;
+    for( int i = 0; i < i_frames; i++ )
+    {
+        pixel *buf = vbench_malloc( frame_size * sizeof(pixel) );
+        if( !buf )
+            goto fail;
+        memset( buf, 0, frame_size * sizeof(pixel) );
+        for( int p = 0; p < t->i_planes; p++ )
+        {
+            t->frame[i][p] = buf;
+            buf += t->i_stride[p] * (i_height >> t->i_plane_shift[p]);
+        }
+    }
+
+    /* bands are whole tiles, the last one takes the remainder */
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        ingest_band_t *b = &t->band[i];
+        pixel *buf = memalign( 64, tile_size * sizeof(pixel) );
+        if( !buf )
+            goto fail;
+        memset( buf, 0, tile_size * sizeof(pixel) );
+        for( int p = 0; p < t->i_planes; p++ )
+        {
+            b->tile[p] = buf;
+            buf += t->i_stride[p] * INGEST_TILE_ROWS;
+        }
+        b->i_y0 = i_tiles * i / t->i_threads * INGEST_TILE_ROWS;
+        b->i_y1 = i == t->i_threads-1 ? i_height : i_tiles * (i+1) / t->i_threads * INGEST_TILE_ROWS;
+    }
+
+    t->pool = vbench_threadpool_init( t->i_threads );
+    if( !t->pool )
+        goto fail;
+    return t;
+fail:
+    vbench_ingest_close( t );
+    return NULL;
+}
+
+void vbench_ingest_close( vbench_ingest_t *t )
+{
+    if( !t )
+        return;
+    vbench_threadpool_delete( t->pool );
+    for( int i = 0; i < t->i_threads; i++ )
+        free( t->band[i].tile[0] );
+    if( t->frame )
+        for( int i = 0; i < t->i_frames; i++ )
+            vbench_free( t->frame[i][0] );
+    free( t->frame );
+    free( t );
+}
+
+int vbench_ingest_threads( vbench_ingest_t *t )
+{
+    return t->i_threads;
+}
+
+int vbench_ingest_planes( vbench_ingest_t *t )
+{
+    return t->i_planes;
+}
+
+pixel *vbench_ingest_plane( vbench_ingest_t *t, int i_frame, int i_plane,
+                            intptr_t *i_stride, int *i_width, int *i_height )
+{
+    *i_stride = t->i_stride[i_plane];
+    *i_width = t->i_plane_width[i_plane];
+    *i_height = t->i_height >> t->i_plane_shift[i_plane];
+    return t->frame[i_frame % t->i_frames][i_plane];
+}
+
+int64_t vbench_ingest_traffic( vbench_ingest_t *t )
+{
+    int64_t bytes = t->i_frame_size;
+    for( int p = 0; p < t->i_planes; p++ )
+        bytes += (int64_t)t->i_plane_width[p] * (t->i_height >> t->i_plane_shift[p]) * sizeof(pixel);
+    return bytes;
+}
+
+void vbench_ingest_frames( vbench_ingest_t *t, uint8_t *src, int i_frames, int i_policy )
+{
+    t->i_policy = i_policy;
+    for( int i = 0; i < i_frames; i++ )
+    {
+        t->src = src + i * t->i_frame_size;
+        t->dst = t->frame[i % t->i_frames];
+        vbench_threadpool_run( t->pool, ingest_band_job, t );
+    }
+}
+
+/****************************************************************************
+ * raw files
+ ****************************************************************************/
+
+int vbench_ingest_map( vbench_ingest_file_t *f, const char *psz_filename )
+{
+    struct stat st;
+    size_t page = sysconf( _SC_PAGESIZE );
+    int fd = open( psz_filename, O_RDONLY );
+
+    if( fd < 0 || fstat( fd, &st ) || st.st_size <= 0 )
+    {
+        fprintf( stderr, "ingest: unable to open %s\n", psz_filename );
+        if( fd >= 0 )
+            close( fd );
+        return -1;
+    }
+
+    /* Reserve the file size plus a page of zeros and map the file over
+     * the start of it.  MAP_POPULATE takes the page faults here rather
+     * than in the first pass over the frames. */
+    f->i_size = st.st_size;
+    f->i_map = ALIGN( (size_t)st.st_size, page ) + page;
+    f->data = mmap( NULL, f->i_map, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( f->data == MAP_FAILED ||
+        mmap( f->data, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED | MAP_POPULATE, fd, 0 ) == MAP_FAILED )
+    {
+        fprintf( stderr, "ingest: unable to map %s\n", psz_filename );
+        if( f->data != MAP_FAILED )
+            munmap( f->data, f->i_map );
+        f->data = NULL;
+        close( fd );
+        return -1;
+    }
+    madvise( f->data, st.st_size, MADV_SEQUENTIAL );
+    close( fd );
+    return 0;
+}
+
+void vbench_ingest_unmap( vbench_ingest_file_t *f )
+{
+    if( f->data )
+        munmap( f->data, f->i_map );
+    f->data = NULL;
+}
+
+int vbench_ingest_raw( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, const char *psz_format,
+                       int i_width, int i_height, const char *psz_filename, int i_threads )
+{
+    static const char * const policy_names[2] = { "cached", "stream" };
+    vbench_mc_functions_t *mc[2] = { mc_c, mc_a };
+    vbench_ingest_file_t f;
+    int i_format = vbench_ingest_format( psz_format );
+    int64_t i_frame_size = vbench_ingest_frame_size( i_format, i_width, i_height );
+    int i_frames;
+
+    if( !i_frame_size )
+    {
+        fprintf( stderr, "ingest: unsupported format %s at %dx%d\n", psz_format, i_width, i_height );
+        return -1;
+    }
+    if( vbench_ingest_map( &f, psz_filename ) )
+        return -1;
+    i_frames = f.i_size / i_frame_size;
+    if( !i_frames )
+    {
+        fprintf( stderr, "ingest: %s is smaller than one %dx%d frame\n", psz_filename, i_width, i_height );
+        vbench_ingest_unmap( &f );
+        return -1;
+    }
+
+    for( int i = 0; i < 2; i++ )
+    {
+        vbench_ingest_t *t = vbench_ingest_open( mc[i], i_format, i_width, i_height, INGEST_RING_FRAMES, i_threads );
+        if( !t )
+        {
+            fprintf( stderr, "ingest: unable to allocate the engine\n" );
+            vbench_ingest_unmap( &f );
+            return -1;
+        }
+        for( int p = INGEST_CACHED; p <= INGEST_STREAM; p++ )
+        {
+            int64_t time = mdate();
+            vbench_ingest_frames( t, f.data, i_frames, p );
+            time = mdate() - time;
+            printf( "%-10s %-4s %-6s %d frames, %d threads: %8.2f GB/s %9.2f fps\n",
+                    psz_format, i ? "asm" : "C", policy_names[p], i_frames, vbench_ingest_threads( t ),
+                    time > 0 ? (double)vbench_ingest_traffic( t ) * i_frames / (time * 1e3) : 0.0,
+                    time > 0 ? i_frames * 1e6 / time : 0.0 );
+        }
+        vbench_ingest_close( t );
+    }
+    vbench_ingest_unmap( &f );
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*****************************************************************************
+ * ingest.h: whole-frame raw input conversion
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef INGEST_H
+#define INGEST_H
+
+/* Source layout -> picture layout, named "in:out".  Sources are packed
+ * raw frames as read from a file, without any row padding.  The RGB
+ * formats keep the x264 plane order G, B, R; v210 is 10-bit 4:2:2 and
+ * only available with HIGH_BIT_DEPTH. */
+enum
+{
+    INGEST_I420_I420,
+    INGEST_I420_NV12,
+    INGEST_NV12_NV12,
+    INGEST_NV12_I420,
+    INGEST_BGR_GBRP,
+    INGEST_BGRA_GBRP,
+    INGEST_V210_NV16,
+    INGEST_FORMATS
+};
+
+extern const char * const vbench_ingest_names[INGEST_FORMATS];
+
+/* Store policies of the converted planes.  INGEST_CACHED lets every
+ * conversion kernel write straight into the picture with its own stores.
+ * INGEST_STREAM converts a tile of rows into a per-thread buffer that
+ * stays in cache and writes it out with plane_copy, whose SIMD versions
+ * use non-temporal stores.  Plain copies go through plane_copy under
+ * both. */
+#define INGEST_CACHED 0
+#define INGEST_STREAM 1
+
+/* rows per tile, a multiple of 2 for the 4:2:0 chroma */
+#define INGEST_TILE_ROWS 16
+
+typedef struct vbench_ingest_t vbench_ingest_t;
+
+/* Returns the index of psz_name in vbench_ingest_names or -1. */
+int vbench_ingest_format( const char *psz_name );
+
+/* Size in bytes of one source frame, 0 if the format or size is invalid. */
+int64_t vbench_ingest_frame_size( int i_format, int i_width, int i_height );
+
+/* The engine converts into a ring of i_frames pictures, as an encoder
+ * fills its lookahead, so large clips don't keep writing into the same
+ * cache-resident picture.  Each of the i_threads threads converts one
+ * horizontal band of every frame in tiles of INGEST_TILE_ROWS rows. */
+vbench_ingest_t *vbench_ingest_open( vbench_mc_functions_t *mc, int i_format, int i_width, int i_height,
+                                     int i_frames, int i_threads );
+void vbench_ingest_close( vbench_ingest_t *t );
+int  vbench_ingest_threads( vbench_ingest_t *t );
+int  vbench_ingest_planes( vbench_ingest_t *t );
+pixel *vbench_ingest_plane( vbench_ingest_t *t, int i_frame, int i_plane,
+                            intptr_t *i_stride, int *i_width, int *i_height );
+
+/* Bytes read plus bytes written per frame */
+int64_t vbench_ingest_traffic( vbench_ingest_t *t );
+
+/* Convert i_frames consecutive source frames starting at src, frame n
+ * into picture n of the ring modulo its size. */
+void vbench_ingest_frames( vbench_ingest_t *t, uint8_t *src, int i_frames, int i_policy );
+
+/* Read-only mapping of a raw file.  The mapping is followed by at least
+ * one page of readable zeros, since the SIMD kernels may read a few
+ * bytes past the last row of the last frame. */
+typedef struct
+{
+    uint8_t *data;
+    int64_t i_size;
+    size_t i_map;
+} vbench_ingest_file_t;
+
+int  vbench_ingest_map( vbench_ingest_file_t *f, const char *psz_filename );
+void vbench_ingest_unmap( vbench_ingest_file_t *f );
+
+/* Convert every frame of a raw file with the C kernels and with mc_a,
+ * under both store policies, and print GB/s to stdout.  Returns 0 on
+ * success. */
+int vbench_ingest_raw( vbench_mc_functions_t *mc_c, vbench_mc_functions_t *mc_a, const char *psz_format,
+                       int i_width, int i_height, const char *psz_filename, int i_threads );
+
+#endif
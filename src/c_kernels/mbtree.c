@@ -0,0 +1,349 @@
+/*****************************************************************************
+ * mbtree.c: GOP-scale macroblock-tree propagation
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/threadpool.h"
+#include "c_kernels/mbtree.h"
+
+#define MBTREE_PRECISION 0.5f
+/* the SIMD kernels work on whole vectors and may read or write this many
+ * entries past the end of a row */
+#define MBTREE_PAD 32
+
+typedef struct
+{
+    int i_row0, i_row1;
+    int16_t *amount;            /* propagate amounts of the current row */
+    void *buffer2;
+    uint16_t *acc[2];           /* private reference costs, zero between frames */
+} mbtree_band_t;
+
+struct vbench_mbtree_t
+{
+    vbench_mc_functions_t *mc;
+    int i_mb_width, i_mb_height, i_mb_count;
+    int i_frames;
+    int i_threads;
+    vbench_mbtree_frame_t *frames;
+    mbtree_band_t band[THREADPOOL_MAX_THREADS];
+    vbench_threadpool_t *pool;
+
+    /* the frame being propagated */
+    vbench_mbtree_frame_t *cur;
+    uint16_t *ref_costs[2];
+    int bipred_weights[2];
+    int i_lists;
+    float fps_factor;
+};
+
+static void *mbtree_alloc( int i_count, int i_size )
+{
+    void *p = memalign( 32, (i_count + MBTREE_PAD) * i_size );
+    if( p )
+        memset( p, 0, (i_count + MBTREE_PAD) * i_size );
+    return p;
+}
+
+vbench_mbtree_t *vbench_mbtree_open( vbench_mc_functions_t *mc, int i_mb_width, int i_mb_height,
+                                     int i_frames, int i_bframes, int i_threads )
+{
+    vbench_mbtree_t *t;
+    int count = i_mb_width * i_mb_height;
+    int minigop = i_bframes + 1;
+
+    if( i_mb_width < 2 || i_mb_height < 2 || i_frames < 2 || i_bframes < 0 )
+        return NULL;
+    t = calloc( 1, sizeof(vbench_mbtree_t) );
+    if( !t )
+        return NULL;
+    t->mc = mc;
+    t->i_mb_width = i_mb_width;
+    t->i_mb_height = i_mb_height;
+    t->i_mb_count = count;
+    t->i_frames = i_frames;
+    t->i_threads = vbench_clip3( i_threads, 1, MIN( i_mb_height, THREADPOOL_MAX_THREADS ) );
+    t->fps_factor = 1.0f / 256.0f * MBTREE_PRECISION;
+    t->frames = calloc( i_frames, sizeof(vbench_mbtree_frame_t) );
+    if( !t->frames )
+        goto fail;
+
+    for( int i = 0; i < i_frames; i++ )
+    {
+        vbench_mbtree_frame_t *f = &t->frames[i];
+        int p0 = i - 1 - (i - 1) % minigop;
+        f->b_bframe = i && i % minigop && i != i_frames-1;
+        f->i_p0 = i ? p0 : 0;
+        f->i_p1 = f->b_bframe ? MIN( p0 + minigop, i_frames-1 ) : i;
+        f->intra_cost     = mbtree_alloc( count, sizeof(uint16_t) );
+        f->lowres_cost    = mbtree_alloc( count, sizeof(uint16_t) );
+        f->inv_qscale     = mbtree_alloc( count, sizeof(uint16_t) );
+        f->propagate_cost = mbtree_alloc( count, sizeof(uint16_t) );
+        f->qp_offset      = mbtree_alloc( count, sizeof(float) );
+        f->mvs[0]         = mbtree_alloc( count, sizeof(int16_t[2]) );
+        f->mvs[1]         = mbtree_alloc( count, sizeof(int16_t[2]) );
+        if( !f->intra_cost || !f->lowres_cost || !f->inv_qscale || !f->propagate_cost ||
+            !f->qp_offset || !f->mvs[0] || !f->mvs[1] )
+            goto fail;
+    }
+
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        mbtree_band_t *b = &t->band[i];
+        b->i_row0 = i_mb_height * i / t->i_threads;
+        b->i_row1 = i_mb_height * (i+1) / t->i_threads;
+        b->amount = mbtree_alloc( i_mb_width, sizeof(int16_t) );
+        /* 12 bytes per MB for the asm list kernels, 48 words per group
+         * of 8, plus one spare group */
+        b->buffer2 = mbtree_alloc( ALIGN( i_mb_width, 8 ) + 8, 6*sizeof(int16_t) );
+        if( !b->amount || !b->buffer2 )
+            goto fail;
+        if( t->i_threads > 1 )
+            for( int l = 0; l < 2; l++ )
+                if( !(b->acc[l] = mbtree_alloc( count, sizeof(uint16_t) )) )
+                    goto fail;
+    }
+    t->pool = vbench_threadpool_init( t->i_threads );
+    if( !t->pool )
+        goto fail;
+    return t;
+fail:
+    vbench_mbtree_close( t );
+    return NULL;
+}
+
+void vbench_mbtree_close( vbench_mbtree_t *t )
+{
+    if( !t )
+        return;
+    vbench_threadpool_delete( t->pool );
+    for( int i = 0; i < t->i_threads; i++ )
+    {
+        free( t->band[i].amount );
+        free( t->band[i].buffer2 );
+        free( t->band[i].acc[0] );
+        free( t->band[i].acc[1] );
+    }
+    if( t->frames )
+        for( int i = 0; i < t->i_frames; i++ )
+        {
+            vbench_mbtree_frame_t *f = &t->frames[i];
+            free( f->intra_cost );
+            free( f->lowres_cost );
+            free( f->inv_qscale );
+            free( f->propagate_cost );
+            free( f->qp_offset );
+            free( f->mvs[0] );
+            free( f->mvs[1] );
+        }
+    free( t->frames );
+    free( t );
+}
+
+int vbench_mbtree_threads( vbench_mbtree_t *t )
+{
+    return t->i_threads;
+}
+
+vbench_mbtree_frame_t *vbench_mbtree_frame( vbench_mbtree_t *t, int i_frame )
+{
+    return &t->frames[i_frame];
+}
+
+/****************************************************************************
+ * synthetic lowres fields
+ ****************************************************************************/
+
+static uint32_t mbtree_rand( uint32_t *state )
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+void vbench_mbtree_gen( vbench_mbtree_t *t, uint32_t i_seed, int i_coherence )
+{
+    uint32_t rnd = i_seed | 1;
+    int w = t->i_mb_width;
+
+    for( int i = 0; i < t->i_frames; i++ )
+    {
+        vbench_mbtree_frame_t *f = &t->frames[i];
+        /* a slow pan plus a slight zoom, in lowres qpel (32 per MB) per frame */
+        int pan_x = (int)(mbtree_rand( &rnd ) % 97) - 48;
+        int pan_y = (int)(mbtree_rand( &rnd ) % 49) - 24;
+        int zoom = (int)(mbtree_rand( &rnd ) % 9) - 4;
+        int dist[2] = { i - f->i_p0, f->i_p1 - i };
+
+        for( int mb = 0; mb < t->i_mb_count; mb++ )
+        {
+            int x = mb % w - (w >> 1);
+            int y = mb / w - (t->i_mb_height >> 1);
+            int b_coherent = (int)(mbtree_rand( &rnd ) % 100) < i_coherence;
+            int intra = 400 + mbtree_rand( &rnd ) % 3600;
+            int inter = intra * (int)(b_coherent ? 20 + mbtree_rand( &rnd ) % 60 : 50 + mbtree_rand( &rnd ) % 70) / 100;
+            int lists = 0;
+
+            if( i )
+                lists = f->b_bframe ? "\1\2\3\3"[mbtree_rand( &rnd ) & 3] : 1;
+            f->intra_cost[mb] = intra;
+            f->lowres_cost[mb] = (i ? MIN( inter, LOWRES_COST_MASK ) : intra) | lists << LOWRES_COST_SHIFT;
+            f->inv_qscale[mb] = 192 + mbtree_rand( &rnd ) % 128;
+            for( int l = 0; l < 2; l++ )
+            {
+                int sign = l ? -1 : 1;
+                if( !(lists & (1 << l)) )
+                    M32( f->mvs[l][mb] ) = 0;
+                else if( b_coherent )
+                {
+                    f->mvs[l][mb][0] = sign * dist[l] * (pan_x + ((x * zoom) >> 2));
+                    f->mvs[l][mb][1] = sign * dist[l] * (pan_y + ((y * zoom) >> 2));
+                }
+                else
+                {
+                    f->mvs[l][mb][0] = (int)(mbtree_rand( &rnd ) % 257) - 128;
+                    f->mvs[l][mb][1] = (int)(mbtree_rand( &rnd ) % 257) - 128;
+                }
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * propagation
+ ****************************************************************************/
+
+static void mbtree_propagate_rows( vbench_mbtree_t *t, mbtree_band_t *b, uint16_t **ref_costs )
+{
+    vbench_mbtree_frame_t *f = t->cur;
+    int w = t->i_mb_width;
+
+    for( int y = b->i_row0; y < b->i_row1; y++ )
+    {
+        int i = y * w;
+        t->mc->mbtree_propagate_cost( b->amount, f->propagate_cost + i, f->intra_cost + i, f->lowres_cost + i,
+                                      f->inv_qscale + i, &t->fps_factor, w );
+        for( int l = 0; l < t->i_lists; l++ )
+            t->mc->mbtree_propagate_list( ref_costs[l], f->mvs[l] + i, b->amount, f->lowres_cost + i,
+                                          t->bipred_weights[l], y, w, l, w, w, t->i_mb_height, b->buffer2 );
+    }
+}
+
+static void mbtree_scatter_job( void *arg, int i_thread )
+{
+    vbench_mbtree_t *t = arg;
+    mbtree_band_t *b = &t->band[i_thread];
+    mbtree_propagate_rows( t, b, b->acc );
+}
+
+/* Each thread owns a slice of the reference arrays and folds every band
+ * into it, clearing the private copies for the next frame. */
+static void mbtree_reduce_job( void *arg, int i_thread )
+{
+    vbench_mbtree_t *t = arg;
+    int k0 = t->i_mb_count * i_thread / t->i_threads;
+    int k1 = t->i_mb_count * (i_thread+1) / t->i_threads;
+
+    for( int l = 0; l < t->i_lists; l++ )
+    {
+        uint16_t *ref = t->ref_costs[l];
+        for( int k = k0; k < k1; k++ )
+        {
+            int sum = ref[k];
+            for( int i = 0; i < t->i_threads; i++ )
+            {
+                sum += t->band[i].acc[l][k];
+                t->band[i].acc[l][k] = 0;
+            }
+            ref[k] = MIN( sum, 32767 );
+        }
+    }
+}
+
+static void mbtree_propagate( vbench_mbtree_t *t, vbench_mbtree_frame_t *f )
+{
+    int b = f - t->frames;
+    int p0 = f->i_p0, p1 = f->i_p1;
+    int dist_scale_factor = ( ((b-p0) << 8) + ((p1-p0) >> 1) ) / (p1-p0);
+    int bipred_weight = 64 - (dist_scale_factor >> 2);
+
+    t->cur = f;
+    t->ref_costs[0] = t->frames[p0].propagate_cost;
+    t->ref_costs[1] = t->frames[p1].propagate_cost;
+    t->bipred_weights[0] = bipred_weight;
+    t->bipred_weights[1] = 64 - bipred_weight;
+    t->i_lists = f->b_bframe ? 2 : 1;
+
+    if( t->i_threads == 1 )
+        mbtree_propagate_rows( t, &t->band[0], t->ref_costs );
+    else
+    {
+        vbench_threadpool_run( t->pool, mbtree_scatter_job, t );
+        vbench_threadpool_run( t->pool, mbtree_reduce_job, t );
+    }
+}
+
+/* qcompress 0.6 and a constant frame rate, as x264 defaults */
+static void mbtree_finish( vbench_mbtree_t *t, vbench_mbtree_frame_t *f )
+{
+    const float strength = 5.0f * (1.0f - 0.6f);
+    const int fps_factor = 256 / MBTREE_PRECISION;
+
+    for( int mb = 0; mb < t->i_mb_count; mb++ )
+    {
+        int intra_cost = (f->intra_cost[mb] * f->inv_qscale[mb] + 128) >> 8;
+        f->qp_offset[mb] = 0.0f;
+        if( intra_cost )
+        {
+            int propagate_cost = (f->propagate_cost[mb] * fps_factor + 128) >> 8;
+            float log2_ratio = log2f( intra_cost + propagate_cost ) - log2f( intra_cost );
+            f->qp_offset[mb] = -strength * log2_ratio;
+        }
+    }
+}
+
+/* Same order as x264's macroblock_tree without b-pyramid: walking back
+ * one minigop at a time, the B frames propagate into both of their P
+ * frames and then the later P frame into the earlier one.  B frames are
+ * never referenced, so their propagate_cost stays zero. */
+void vbench_mbtree_gop( vbench_mbtree_t *t )
+{
+    int last = t->i_frames - 1;
+
+    for( int i = 0; i < t->i_frames; i++ )
+        memset( t->frames[i].propagate_cost, 0, t->i_mb_count * sizeof(uint16_t) );
+
+    while( last > 0 )
+    {
+        int cur = t->frames[last].i_p0;
+        for( int b = last-1; b > cur; b-- )
+            mbtree_propagate( t, &t->frames[b] );
+        mbtree_propagate( t, &t->frames[last] );
+        last = cur;
+    }
+
+    for( int i = 0; i < t->i_frames; i++ )
+        mbtree_finish( t, &t->frames[i] );
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * mbtree.h: GOP-scale macroblock-tree propagation
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef MBTREE_H
+#define MBTREE_H
+
+/* One lowres frame of the lookahead, laid out as in x264 with
+ * i_mb_stride == i_mb_width.  Frame 0 is the keyframe, every
+ * (i_bframes+1)-th frame and the last one are P frames referencing the
+ * previous P, the others are B frames between two P frames. */
+typedef struct
+{
+    int b_bframe;
+    int i_p0, i_p1;             /* reference frames, i_p1 is the frame itself for P */
+    uint16_t *intra_cost;
+    uint16_t *lowres_cost;      /* inter cost | lists used << LOWRES_COST_SHIFT */
+    uint16_t *inv_qscale;
+    int16_t (*mvs[2])[2];       /* list 0 points into i_p0, list 1 into i_p1 */
+    uint16_t *propagate_cost;   /* amount inherited from the frames referencing this one */
+    float *qp_offset;
+} vbench_mbtree_frame_t;
+
+typedef struct vbench_mbtree_t vbench_mbtree_t;
+
+/* With i_threads > 1 the rows of every frame are split into bands.  Each
+ * band scatters into its own zeroed copy of the reference cost arrays and
+ * a second pass folds the copies into the references, split by index.
+ * All scattered amounts are non-negative, so
+ *     MIN( MIN( a + x, 32767 ) + y, 32767 ) == MIN( a + x + y, 32767 )
+ * and saturating the partial sums of a band does not change the total:
+ * the result is bit-exact against the serial one for any thread count. */
+vbench_mbtree_t *vbench_mbtree_open( vbench_mc_functions_t *mc, int i_mb_width, int i_mb_height,
+                                     int i_frames, int i_bframes, int i_threads );
+void vbench_mbtree_close( vbench_mbtree_t *t );
+int  vbench_mbtree_threads( vbench_mbtree_t *t );
+vbench_mbtree_frame_t *vbench_mbtree_frame( vbench_mbtree_t *t, int i_frame );
+
+/* Fill the costs and motion fields from i_seed.  i_coherence in [0,100]
+ * is the share of every MV taken from a smooth global motion, the rest
+ * is per-MB noise of up to +-4 MBs. */
+void vbench_mbtree_gen( vbench_mbtree_t *t, uint32_t i_seed, int i_coherence );
+
+/* Backward propagation over the whole GOP followed by the qp offsets of
+ * every frame.  Only propagate_cost and qp_offset are written. */
+void vbench_mbtree_gop( vbench_mbtree_t *t );
+
+#endif
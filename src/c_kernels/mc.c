@@ -38,6 +38,12 @@
 #include "common.h"
 #include "bench.h"
 #include "asm/x86/mc.h"
+#include "c_kernels/ccbuild.h"
+#include "c_kernels/mc.h"
+#include "c_kernels/vext.h"
+#if ARCH_AARCH64
+#   include "asm/aarch64/mc.h"
+#endif
 
 
 extern const uint8_t vbench_hpel_ref0[16];
@@ -500,6 +506,33 @@ static void frame_init_lowres_core( pixel *src0, pixel *dst0, pixel *dsth, pixel
     }
 }
 
+/* Horizontal pass of the polyphase scaler: every output sums i_taps
+ * source pixels starting at pos[x] with Q14 weights, the result is kept
+ * with 6 fractional bits for the vertical pass. */
+static void scale_h( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width )
+{
+    for( int x = 0; x < i_width; x++, coef += i_taps )
+    {
+        pixel *s = src + pos[x];
+        int sum = 0;
+        for( int j = 0; j < i_taps; j++ )
+            sum += s[j] * coef[j];
+        dst[x] = (sum + 128) >> 8;
+    }
+}
+
+/* Vertical pass: i_taps rows of Q6 samples with Q12 weights */
+static void scale_v( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width )
+{
+    for( int x = 0; x < i_width; x++ )
+    {
+        int sum = 1 << 17;
+        for( int j = 0; j < i_taps; j++ )
+            sum += src[j][x] * coef[j];
+        dst[x] = vbench_clip_pixel( sum >> 18 );
+    }
+}
+
 /* Estimate the total amount of influence on future quality that could be had if we
  * were to improve the reference samples used to inter predict any given macroblock. */
 static void mbtree_propagate_cost( int16_t *dst, uint16_t *propagate_in, uint16_t *intra_costs,
@@ -588,8 +621,18 @@ static void mbtree_propagate_list( uint16_t *ref_costs, int16_t (*mvs)[2],
     }
 }
 
-void vbench_mc_init( int cpu, vbench_mc_functions_t *pf, int cpu_independent )
+void asm_scale_h_sse2( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width );
+void asm_scale_h_avx2( int16_t *dst, pixel *src, int32_t *pos, int16_t *coef, int i_taps, int i_width );
+void asm_scale_v_sse2( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width );
+void asm_scale_v_avx2( pixel *dst, int16_t **src, int16_t *coef, int i_taps, int i_width );
+
+#if HAVE_X86_INTRIN
+PROPAGATE_LIST(asm, avx2)
+#endif
+
+void vbench_mc_init( uint64_t cpu, vbench_mc_functions_t *pf, int cpu_independent )
 {
+    CCBUILD_INIT( cpu, mc_init, 0, pf, cpu_independent );
     pf->mc_luma   = mc_luma;
     pf->get_ref   = get_ref;
 
@@ -637,6 +680,8 @@ void vbench_mc_init( int cpu, vbench_mc_functions_t *pf, int cpu_independent )
     pf->memcpy_aligned = memcpy;
     pf->memzero_aligned = memzero_aligned;
     pf->frame_init_lowres_core = frame_init_lowres_core;
+    pf->scale_h = scale_h;
+    pf->scale_v = scale_v;
 
     pf->integral_init4h = integral_init4h;
     pf->integral_init8h = integral_init8h;
@@ -649,6 +694,22 @@ void vbench_mc_init( int cpu, vbench_mc_functions_t *pf, int cpu_independent )
 #if HAVE_MMX
     vbench_mc_init_mmx( cpu, pf );
 #endif
+#if HAVE_X86_INTRIN && !HIGH_BIT_DEPTH
+    if( cpu&CPU_SSE2 )
+    {
+        pf->scale_h = asm_scale_h_sse2;
+        pf->scale_v = asm_scale_v_sse2;
+    }
+    if( cpu&CPU_AVX2 )
+    {
+        pf->scale_h = asm_scale_h_avx2;
+        pf->scale_v = asm_scale_v_avx2;
+    }
+#endif
+#if HAVE_X86_INTRIN
+    if( cpu&CPU_AVX2 )
+        pf->mbtree_propagate_list = asm_mbtree_propagate_list_avx2;
+#endif
 #if HAVE_ALTIVEC
     if( cpu&vbench_CPU_ALTIVEC )
         vbench_mc_altivec_init( pf );
@@ -663,6 +724,10 @@ void vbench_mc_init( int cpu, vbench_mc_functions_t *pf, int cpu_independent )
     if( cpu&vbench_CPU_MSA )
         vbench_mc_init_mips( cpu, pf );
 #endif
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+    if( cpu&CPU_VEXT )
+        vbench_mc_init_vext( pf );
+#endif
 
     if( cpu_independent )
     {
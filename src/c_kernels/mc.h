@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * mc.h: motion compensation helpers shared by the asm wrappers
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ * Copyright (C) 2004-2016 x264 project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef C_KERNELS_MC_H
+#define C_KERNELS_MC_H
+
+/* mbtree_propagate_list in two phases.  The internal asm function turns
+ * every group of 8 MBs into 48 words of buffer2:
+ *     [ 0..15]  {mbx, mby} of the top-left target of each MB
+ *     [16..31]  {idx0weight, idx1weight} of each MB
+ *     [32..47]  {idx2weight, idx3weight} of each MB
+ * and the scatter below adds them into ref_costs.
+ *
+ * The scatter is conflict-aware: when the 8 MBs of a group all use the
+ * list, lie inside the frame and target consecutive MBs of one row, as
+ * any locally uniform motion gives, the only conflicts are between
+ * neighbours (the idx1 of MB j is the idx0 of MB j+1).  Those pairs are
+ * summed in registers and each of the two target rows gets a single
+ * 9-wide saturating add, MC_CLIP_ADD_RUN( s, x ):
+ *     s[0] += x[0], s[k] += x[2k] + x[2k-1] for k in 1..7, s[8] += x[15]
+ * The asm wrappers redefine it and MC_CLIP_ADD2 with SIMD versions.
+ * An MB with a zero MV stores {amount, 0, 0, 0}, so it needs no special
+ * case in a run.  Amounts are non-negative and ref_costs never exceed
+ * 32767, so the grouping doesn't change the saturated result. */
+#define MC_CLIP_ADD2(s,x)\
+do\
+{\
+    MC_CLIP_ADD( (s)[0], (x)[0] );\
+    MC_CLIP_ADD( (s)[1], (x)[1] );\
+} while(0)
+
+#define MC_CLIP_ADD_RUN(s,x)\
+do\
+{\
+    MC_CLIP_ADD( (s)[0], (x)[0] );\
+    for( int k = 1; k < 8; k++ )\
+        MC_CLIP_ADD( (s)[k], (x)[2*k] + (x)[2*k-1] );\
+    MC_CLIP_ADD( (s)[8], (x)[15] );\
+} while(0)
+
+#define PROPAGATE_LIST(prefix,cpu)\
+void prefix##_mbtree_propagate_list_internal_##cpu( int16_t (*mvs)[2], int16_t *propagate_amount,\
+                                                    uint16_t *lowres_costs, int16_t *output,\
+                                                    int bipred_weight, int mb_y, int len );\
+\
+static void prefix##_mbtree_propagate_list_##cpu( uint16_t *ref_costs, int16_t (*mvs)[2],\
+        int16_t *propagate_amount, uint16_t *lowres_costs,\
+        int bipred_weight, int mb_y, int len, int list, unsigned stride, unsigned width, unsigned height, void *buffer2 )\
+{\
+    int16_t *current = buffer2;\
+    unsigned list_mask = 1 << (list+LOWRES_COST_SHIFT);\
+\
+    prefix##_mbtree_propagate_list_internal_##cpu( mvs, propagate_amount, lowres_costs,\
+                                                  current, bipred_weight, mb_y, len );\
+\
+    for( unsigned i = 0; i < len; current += 32 )\
+    {\
+        int end = MIN( i+8, len );\
+        if( end == i+8 && current[14] == current[0] + 7 && current[15] == current[1] &&\
+            current[0] >= 0 && current[0] + 8 < (int)width &&\
+            current[1] >= 0 && current[1] + 1 < (int)height )\
+        {\
+            unsigned run = list_mask;\
+            for( int j = 1; j < 7; j++ )\
+                run &= -(current[2*j] == current[0] + j && current[2*j+1] == current[1]);\
+            for( int j = 0; j < 8; j++ )\
+                run &= lowres_costs[i+j];\
+            if( run )\
+            {\
+                unsigned idx0 = current[0] + current[1] * stride;\
+                MC_CLIP_ADD_RUN( ref_costs+idx0, current+16 );\
+                MC_CLIP_ADD_RUN( ref_costs+idx0+stride, current+32 );\
+                i += 8;\
+                current += 16;\
+                continue;\
+            }\
+        }\
+        for( ; i < end; i++, current += 2 )\
+        {\
+            if( !(lowres_costs[i] & list_mask) )\
+                continue;\
+\
+            unsigned mbx = current[0];\
+            unsigned mby = current[1];\
+            unsigned idx0 = mbx + mby * stride;\
+            unsigned idx2 = idx0 + stride;\
+\
+            /* Shortcut for the simple/common case of zero MV */\
+            if( !M32( mvs[i] ) )\
+            {\
+                MC_CLIP_ADD( ref_costs[idx0], current[16] );\
+                continue;\
+            }\
+\
+            if( mbx < width-1 && mby < height-1 )\
+            {\
+                MC_CLIP_ADD2( ref_costs+idx0, current+16 );\
+                MC_CLIP_ADD2( ref_costs+idx2, current+32 );\
+            }\
+            else\
+            {\
+                /* Note: this takes advantage of unsigned representation to\
+                 * catch negative mbx/mby. */\
+                if( mby < height )\
+                {\
+                    if( mbx < width )\
+                        MC_CLIP_ADD( ref_costs[idx0+0], current[16] );\
+                    if( mbx+1 < width )\
+                        MC_CLIP_ADD( ref_costs[idx0+1], current[17] );\
+                }\
+                if( mby+1 < height )\
+                {\
+                    if( mbx < width )\
+                        MC_CLIP_ADD( ref_costs[idx2+0], current[32] );\
+                    if( mbx+1 < width )\
+                        MC_CLIP_ADD( ref_costs[idx2+1], current[33] );\
+                }\
+            }\
+        }\
+    }\
+}
+
+#endif
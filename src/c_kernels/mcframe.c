@@ -0,0 +1,507 @@
+/*****************************************************************************
+ * mcframe.c: whole-frame motion compensation from dense MV fields
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/mcframe.h"
+
+extern const vbench_weight_t vbench_weight_none[3];
+
+/* luma partition sizes, indexed by PIXEL_16x16..PIXEL_4x4, and the
+ * 4:2:0 and 4:2:2 chroma size of each */
+static const uint8_t mcframe_dims[7][2] = { {16,16}, {16,8}, {8,16}, {8,8}, {8,4}, {4,8}, {4,4} };
+static const uint8_t mcframe_chroma_size[2][7] =
+{
+    { PIXEL_8x8,  PIXEL_8x4, PIXEL_4x8,  PIXEL_4x4, PIXEL_4x2, PIXEL_2x4, PIXEL_2x2 },
+    { PIXEL_8x16, PIXEL_8x8, PIXEL_4x16, PIXEL_4x8, PIXEL_4x4, PIXEL_2x8, PIXEL_2x4 },
+};
+
+/* i_list 0 and 1 are uni-pred from that list, 2 is bi-pred */
+typedef struct
+{
+    uint8_t x, y;
+    uint8_t i_size;
+    uint8_t i_list;
+    uint8_t b_opposite[2];      /* field refs of the other parity */
+    int16_t mv[2][2];
+} mcframe_part_t;
+
+struct vbench_mcframe_t
+{
+    int i_width, i_height;
+    int i_mb_width, i_mb_height;
+    int i_csp;
+    int i_planes;               /* planes predicted like luma, 3 in 4:4:4 */
+    int i_shift_v;              /* vertical chroma subsampling */
+
+    vbench_plane_t ref[2][3][4];  /* fullpel, h, v, c of each plane of L0 and L1 */
+    vbench_plane_t ref_c[2];      /* interleaved 4:2:0 or 4:2:2 chroma */
+    vbench_plane_t ref_fld[2][3][4];  /* the same, filtered and padded */
+    vbench_plane_t ref_c_fld[2];      /* as two fields */
+    vbench_plane_t pred[2][3];    /* y, u, v */
+
+    mcframe_part_t (*part)[16];
+    uint8_t *i_parts;
+    int b_field;                /* top field MBs first, then bottom ones */
+    int b_weighted;
+    int i_bipred_weight;
+    vbench_weight_t weight[2][3];
+
+    pixel *fdec;
+    pixel *tmp;
+};
+
+/* vbench_plane_expand_border for interleaved chroma, whose edge pixels
+ * come in pairs, and for planes of two fields, each padded vertically
+ * with its own edge rows */
+static void mcframe_expand( vbench_plane_t *pl, int b_nv12, int b_field )
+{
+    int pad = pl->i_pad;
+    int step = 1 + b_nv12;
+    intptr_t stride = pl->i_stride;
+    pixel *pix = pl->plane;
+
+    for( int y = 0; y < pl->i_height; y++, pix += stride )
+        for( int x = step; x <= pad; x += step )
+            for( int i = 0; i < step; i++ )
+            {
+                pix[-x+i] = pix[i];
+                pix[pl->i_width-step+x+i] = pix[pl->i_width-step+i];
+            }
+    for( int y = 1; y <= pad; y++ )
+    {
+        int top = b_field ? y&1 : 0;
+        int bottom = pl->i_height - 1 - (b_field ? y&1 : 0);
+        memcpy( pl->plane - y*stride - pad, pl->plane + top*stride - pad, (pl->i_width + 2*pad) * sizeof(pixel) );
+        memcpy( pl->plane + (pl->i_height-1+y)*stride - pad, pl->plane + bottom*stride - pad,
+                (pl->i_width + 2*pad) * sizeof(pixel) );
+    }
+}
+
+void vbench_mcframe_close( vbench_mcframe_t *t )
+{
+    if( !t )
+        return;
+    for( int l = 0; l < 2; l++ )
+    {
+        for( int p = 0; p < 3; p++ )
+            for( int i = 0; i < 4; i++ )
+            {
+                vbench_plane_free( &t->ref[l][p][i] );
+                vbench_plane_free( &t->ref_fld[l][p][i] );
+            }
+        vbench_plane_free( &t->ref_c[l] );
+        vbench_plane_free( &t->ref_c_fld[l] );
+        for( int p = 0; p < 3; p++ )
+            vbench_plane_free( &t->pred[l][p] );
+    }
+    free( t->part );
+    free( t->i_parts );
+    free( t->fdec );
+    free( t->tmp );
+    free( t );
+}
+
+vbench_mcframe_t *vbench_mcframe_open( vbench_mc_functions_t *mc, int i_width, int i_height, int i_csp )
+{
+    vbench_mcframe_t *t;
+    int16_t *buf;
+
+    if( i_width <= 0 || i_height <= 0 || (i_width&15) || (i_height&31) ||
+        i_csp < CHROMA_400 || i_csp > CHROMA_444 )
+        return NULL;
+    t = calloc( 1, sizeof(vbench_mcframe_t) );
+    if( !t )
+        return NULL;
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_mb_width = i_width / 16;
+    t->i_mb_height = i_height / 16;
+    t->i_csp = i_csp;
+    t->i_planes = i_csp == CHROMA_444 ? 3 : 1;
+    t->i_shift_v = i_csp == CHROMA_420;
+
+    for( int l = 0; l < 2; l++ )
+    {
+        for( int p = 0; p < t->i_planes; p++ )
+            for( int i = 0; i < 4; i++ )
+                if( vbench_plane_alloc( &t->ref[l][p][i], i_width, i_height, MCFRAME_PAD, NULL ) ||
+                    vbench_plane_alloc( &t->ref_fld[l][p][i], i_width, i_height, MCFRAME_PAD, NULL ) )
+                    goto fail;
+        if( (i_csp == CHROMA_420 || i_csp == CHROMA_422) &&
+            (vbench_plane_alloc( &t->ref_c[l], i_width, i_height >> t->i_shift_v, MCFRAME_PAD, NULL ) ||
+             vbench_plane_alloc( &t->ref_c_fld[l], i_width, i_height >> t->i_shift_v, MCFRAME_PAD, NULL )) )
+            goto fail;
+        for( int p = 0; p < (i_csp ? 3 : 1); p++ )
+        {
+            int b_sub = p && i_csp != CHROMA_444;
+            if( vbench_plane_alloc( &t->pred[l][p], i_width >> b_sub, i_height >> (b_sub && t->i_shift_v), 0, NULL ) )
+                goto fail;
+        }
+    }
+    t->part = malloc( t->i_mb_width * t->i_mb_height * sizeof(*t->part) );
+    t->i_parts = calloc( t->i_mb_width * t->i_mb_height, 1 );
+    /* fdec as in an encoder, the planes of 4:4:4 one under the other, then
+     * two luma and four chroma temporaries of stride 16 for bi-pred */
+    t->fdec = memalign( 64, 48 * FDEC_STRIDE * sizeof(pixel) );
+    t->tmp = memalign( 64, (2*16*16 + 4*16*16) * sizeof(pixel) );
+    buf = memalign( 32, (i_width + 96) * sizeof(int16_t) );
+    if( !t->part || !t->i_parts || !t->fdec || !t->tmp || !buf )
+    {
+        free( buf );
+        goto fail;
+    }
+    memset( t->fdec, 0, 48 * FDEC_STRIDE * sizeof(pixel) );
+
+    /* two textured references, touched here first */
+    for( int l = 0; l < 2; l++ )
+    {
+        for( int p = 0; p < t->i_planes; p++ )
+        {
+            vbench_plane_t *y = &t->ref[l][p][0];
+            for( int i = 0; i < i_height; i++ )
+                for( int j = 0; j < i_width; j++ )
+                    y->plane[i*y->i_stride+j] = !p ? (((j+5*l)*(j+5*l) + 3*i*i) >> 8) + (rand() & 15)
+                                                   : 96 + ((j + 2*i + 9*l + 32*p) & 63) + (rand() & 7);
+            vbench_plane_expand_border( y );
+            mc->hpel_filter( t->ref[l][p][1].plane, t->ref[l][p][2].plane, t->ref[l][p][3].plane, y->plane,
+                             y->i_stride, i_width, i_height, buf );
+            for( int i = 1; i < 4; i++ )
+                vbench_plane_expand_border( &t->ref[l][p][i] );
+
+            /* each field filtered on its own lines, as for field pictures */
+            vbench_plane_t *fld = t->ref_fld[l][p];
+            for( int i = 0; i < i_height; i++ )
+                memcpy( fld[0].plane + i*fld[0].i_stride, y->plane + i*y->i_stride, i_width * sizeof(pixel) );
+            mcframe_expand( &fld[0], 0, 1 );
+            for( int i_parity = 0; i_parity < 2; i_parity++ )
+            {
+                intptr_t offset = i_parity * fld[0].i_stride;
+                mc->hpel_filter( fld[1].plane + offset, fld[2].plane + offset, fld[3].plane + offset,
+                                 fld[0].plane + offset, 2*fld[0].i_stride, i_width, i_height/2, buf );
+            }
+            for( int i = 1; i < 4; i++ )
+                mcframe_expand( &fld[i], 0, 1 );
+        }
+        if( t->ref_c[l].plane )
+        {
+            vbench_plane_t *c = &t->ref_c[l];
+            for( int i = 0; i < c->i_height; i++ )
+                for( int j = 0; j < i_width; j++ )
+                    c->plane[i*c->i_stride+j] = 96 + (((j>>1) + (2*i >> !t->i_shift_v) + 9*l) & 63) + (rand() & 7);
+            mcframe_expand( c, 1, 0 );
+            for( int i = 0; i < c->i_height; i++ )
+                memcpy( t->ref_c_fld[l].plane + i*c->i_stride, c->plane + i*c->i_stride, i_width * sizeof(pixel) );
+            mcframe_expand( &t->ref_c_fld[l], 1, 1 );
+        }
+        for( int p = 0; p < 3; p++ )
+            if( t->pred[l][p].buffer )
+                memset( t->pred[l][p].buffer, 0, t->pred[l][p].i_stride * t->pred[l][p].i_height * sizeof(pixel) );
+    }
+    free( buf );
+
+    /* a fade on L0 and a brightening on L1, chroma offset only */
+    t->weight[0][0] = (vbench_weight_t){ .i_scale = 58, .i_denom = 6, .i_offset = -3 };
+    t->weight[1][0] = (vbench_weight_t){ .i_scale = 36, .i_denom = 5, .i_offset = 4 };
+    for( int p = 1; p < 3; p++ )
+    {
+        t->weight[0][p] = (vbench_weight_t){ .i_scale = 64, .i_denom = 6, .i_offset = 2 };
+        t->weight[1][p] = (vbench_weight_t){ .i_scale = 64, .i_denom = 6, .i_offset = -2 };
+    }
+    return t;
+fail:
+    vbench_mcframe_close( t );
+    return NULL;
+}
+
+int vbench_mcframe_mbs( vbench_mcframe_t *t )
+{
+    return t->i_mb_width * t->i_mb_height;
+}
+
+/****************************************************************************
+ * MV field
+ ****************************************************************************/
+
+static int mcframe_rand( int range )
+{
+    return (rand() % (2*range+1)) - range;
+}
+
+static int mcframe_list( const vbench_mcframe_param_t *param )
+{
+    if( !param->i_bipred )
+        return 0;
+    if( rand()%100 < param->i_bipred )
+        return 2;
+    return rand()&1;
+}
+
+/* follow base with a little jitter or go anywhere in range, then keep the
+ * block within the border */
+static void mcframe_part( vbench_mcframe_t *t, const vbench_mcframe_param_t *param, int mb,
+                          int x, int y, int i_size, int i_list, int16_t base[2][2] )
+{
+    mcframe_part_t *p = &t->part[mb][t->i_parts[mb]++];
+    int b_field = param->b_field;
+    int px = 16*(mb % t->i_mb_width) + x;
+    int py = 16*(mb / t->i_mb_width % (t->i_mb_height >> b_field)) + y;
+    int height = t->i_height >> b_field;
+    int margin = MCFRAME_PAD - 16;
+    int margin_v = (MCFRAME_PAD >> b_field) - 16;
+
+    p->x = x;
+    p->y = y;
+    p->i_size = i_size;
+    p->i_list = i_list;
+    for( int l = 0; l < 2; l++ )
+    {
+        int b_follow = rand()%100 < param->i_coherence;
+        int mvx = b_follow ? base[l][0] + mcframe_rand( 1 ) : mcframe_rand( 4*param->i_range );
+        int mvy = b_follow ? base[l][1] + mcframe_rand( 1 ) : mcframe_rand( 4*param->i_range );
+        p->mv[l][0] = vbench_clip3( mvx, 4*(-margin - px), 4*(t->i_width + margin - mcframe_dims[i_size][0] - px) );
+        p->mv[l][1] = vbench_clip3( mvy, 4*(-margin_v - py), 4*(height + margin_v - mcframe_dims[i_size][1] - py) );
+        p->b_opposite[l] = b_field && (rand()&1);
+    }
+}
+
+void vbench_mcframe_field( vbench_mcframe_t *t, const vbench_mcframe_param_t *param )
+{
+    int16_t global[2][2];
+    int i_mbs = vbench_mcframe_mbs( t );
+
+    t->b_field = param->b_field;
+    t->b_weighted = param->b_weighted;
+    t->i_bipred_weight = param->b_weighted ? 24 : 32;
+    /* a pan, seen backwards from L1 */
+    global[0][0] = mcframe_rand( 2*param->i_range );
+    global[0][1] = mcframe_rand( 2*param->i_range );
+    global[1][0] = -global[0][0];
+    global[1][1] = -global[0][1];
+
+    for( int mb = 0; mb < i_mbs; mb++ )
+    {
+        int16_t base[2][2];
+        for( int l = 0; l < 2; l++ )
+            for( int c = 0; c < 2; c++ )
+                base[l][c] = rand()%100 < param->i_coherence ? global[l][c] + mcframe_rand( 2 )
+                                                             : mcframe_rand( 4*param->i_range );
+        t->i_parts[mb] = 0;
+        if( rand()%100 >= param->i_split )
+        {
+            mcframe_part( t, param, mb, 0, 0, PIXEL_16x16, mcframe_list( param ), base );
+            continue;
+        }
+        switch( rand()%3 )
+        {
+            case 0:
+                mcframe_part( t, param, mb, 0, 0, PIXEL_16x8, mcframe_list( param ), base );
+                mcframe_part( t, param, mb, 0, 8, PIXEL_16x8, mcframe_list( param ), base );
+                break;
+            case 1:
+                mcframe_part( t, param, mb, 0, 0, PIXEL_8x16, mcframe_list( param ), base );
+                mcframe_part( t, param, mb, 8, 0, PIXEL_8x16, mcframe_list( param ), base );
+                break;
+            default:
+                /* sub-partitions share the direction of their 8x8 */
+                for( int i8 = 0; i8 < 4; i8++ )
+                {
+                    int x = 8*(i8&1), y = 8*(i8>>1);
+                    int l = mcframe_list( param );
+                    if( rand()%100 >= param->i_split )
+                    {
+                        mcframe_part( t, param, mb, x, y, PIXEL_8x8, l, base );
+                        continue;
+                    }
+                    switch( rand()%3 )
+                    {
+                        case 0:
+                            mcframe_part( t, param, mb, x, y,   PIXEL_8x4, l, base );
+                            mcframe_part( t, param, mb, x, y+4, PIXEL_8x4, l, base );
+                            break;
+                        case 1:
+                            mcframe_part( t, param, mb, x,   y, PIXEL_4x8, l, base );
+                            mcframe_part( t, param, mb, x+4, y, PIXEL_4x8, l, base );
+                            break;
+                        default:
+                            for( int i4 = 0; i4 < 4; i4++ )
+                                mcframe_part( t, param, mb, x+4*(i4&1), y+4*(i4>>1), PIXEL_4x4, l, base );
+                            break;
+                    }
+                }
+                break;
+        }
+    }
+}
+
+/****************************************************************************
+ * prediction
+ ****************************************************************************/
+
+void vbench_mcframe_predict( vbench_mcframe_t *t, vbench_mc_functions_t *mc, int i_pred )
+{
+    vbench_weight_t weight[2][3];
+    const vbench_weight_t *wl[2];
+    pixel *src[2][2][3][4];
+    pixel *src_c[2][2];
+    int b_field = t->b_field;
+    int i_mb_height = t->i_mb_height >> b_field;
+    intptr_t i_stride = t->ref[0][0][0].i_stride << b_field;
+    intptr_t i_stride_c = t->ref_c[0].i_stride << b_field;
+    int b_nv12 = t->i_csp == CHROMA_420 || t->i_csp == CHROMA_422;
+    int v_shift = t->i_shift_v;
+    const uint8_t *chroma_size = mcframe_chroma_size[t->i_csp == CHROMA_422];
+    vbench_plane_t *pred = t->pred[i_pred];
+    pixel *fdec_u = t->fdec + 16*FDEC_STRIDE;
+    pixel *fdec_v = t->fdec + 16*FDEC_STRIDE + 16;
+    pixel *tmp0 = t->tmp;
+    pixel *tmp1 = t->tmp + 16*16;
+    pixel *tmpu[2] = { t->tmp + 2*16*16, t->tmp + 4*16*16 };
+    pixel *tmpv[2] = { t->tmp + 3*16*16, t->tmp + 5*16*16 };
+
+    /* the references of each parity: the frames, or their fields */
+    for( int l = 0; l < 2; l++ )
+    {
+        for( int i_parity = 0; i_parity < 2; i_parity++ )
+        {
+            for( int p = 0; p < t->i_planes; p++ )
+                for( int i = 0; i < 4; i++ )
+                    src[i_parity][l][p][i] = b_field ? t->ref_fld[l][p][i].plane + i_parity*t->ref_fld[l][p][i].i_stride
+                                                     : t->ref[l][p][i].plane;
+            src_c[i_parity][l] = b_field ? t->ref_c_fld[l].plane + i_parity*t->ref_c_fld[l].i_stride : t->ref_c[l].plane;
+        }
+        for( int p = 0; p < 3; p++ )
+        {
+            weight[l][p] = t->weight[l][p];
+            mc->weight_cache( mc, &weight[l][p] );
+        }
+        wl[l] = t->b_weighted ? weight[l] : vbench_weight_none;
+    }
+
+    /* field MBs are those of the top field picture then of the bottom one,
+     * predicted from fields and written back to the lines of their parity */
+    for( int mb_y = 0, mb = 0; mb_y < t->i_mb_height; mb_y++ )
+        for( int mbx = 0; mbx < t->i_mb_width; mbx++, mb++ )
+        {
+            int i_parity = mb_y >= i_mb_height;
+            int mby = mb_y - i_parity*i_mb_height;
+
+            for( int i = 0; i < t->i_parts[mb]; i++ )
+            {
+                mcframe_part_t *p = &t->part[mb][i];
+                int w = mcframe_dims[p->i_size][0];
+                int h = mcframe_dims[p->i_size][1];
+                int px = 16*mbx + p->x;
+                int py = 16*mby + p->y;
+                pixel *dstu = fdec_u + (p->y>>v_shift)*FDEC_STRIDE + (p->x>>1);
+                pixel *dstv = fdec_v + (p->y>>v_shift)*FDEC_STRIDE + (p->x>>1);
+                pixel *(*ref[2])[4];
+                pixel *ref_c[2];
+                int mvy_c[2];
+
+                /* 4:4:4 chroma is predicted as luma is, 4:2:2 chroma MVs
+                 * are doubled vertically to eighths of its full-height
+                 * rows.  4:2:0 chroma sits between the luma lines of its
+                 * field, so a field of the other parity is a quarter of a
+                 * chroma line up or down. */
+                for( int l = 0; l < 2; l++ )
+                {
+                    ref[l] = src[i_parity ^ p->b_opposite[l]][l];
+                    ref_c[l] = src_c[i_parity ^ p->b_opposite[l]][l] + (py>>v_shift)*i_stride_c + px;
+                    mvy_c[l] = p->mv[l][1] * (2 - v_shift);
+                    if( v_shift && p->b_opposite[l] )
+                        mvy_c[l] += i_parity ? 2 : -2;
+                }
+
+                if( p->i_list < 2 )
+                {
+                    int l = p->i_list;
+                    for( int c = 0; c < t->i_planes; c++ )
+                        mc->mc_luma( t->fdec + (16*c + p->y)*FDEC_STRIDE + p->x, FDEC_STRIDE, ref[l][c], i_stride,
+                                     4*px + p->mv[l][0], 4*py + p->mv[l][1], w, h, &wl[l][c] );
+                    if( !b_nv12 )
+                        continue;
+                    mc->mc_chroma( dstu, dstv, FDEC_STRIDE, ref_c[l], i_stride_c,
+                                   p->mv[l][0], mvy_c[l], w>>1, h>>v_shift );
+                    if( t->b_weighted )
+                    {
+                        /* in place, the way an encoder weights chroma;
+                         * any overwrite to the right lands on a block
+                         * that is predicted later */
+                        wl[l][1].weightfn[w>>3]( dstu, FDEC_STRIDE, dstu, FDEC_STRIDE, &wl[l][1], h>>v_shift );
+                        wl[l][2].weightfn[w>>3]( dstv, FDEC_STRIDE, dstv, FDEC_STRIDE, &wl[l][2], h>>v_shift );
+                    }
+                }
+                else
+                {
+                    for( int c = 0; c < t->i_planes; c++ )
+                    {
+                        intptr_t s0 = 16, s1 = 16;
+                        pixel *p0 = mc->get_ref( tmp0, &s0, ref[0][c], i_stride, 4*px + p->mv[0][0], 4*py + p->mv[0][1],
+                                                 w, h, vbench_weight_none );
+                        pixel *p1 = mc->get_ref( tmp1, &s1, ref[1][c], i_stride, 4*px + p->mv[1][0], 4*py + p->mv[1][1],
+                                                 w, h, vbench_weight_none );
+                        mc->avg[p->i_size]( t->fdec + (16*c + p->y)*FDEC_STRIDE + p->x, FDEC_STRIDE,
+                                            p0, s0, p1, s1, t->i_bipred_weight );
+                    }
+                    if( !b_nv12 )
+                        continue;
+                    for( int l = 0; l < 2; l++ )
+                        mc->mc_chroma( tmpu[l], tmpv[l], 16, ref_c[l], i_stride_c,
+                                       p->mv[l][0], mvy_c[l], w>>1, h>>v_shift );
+                    mc->avg[chroma_size[p->i_size]]( dstu, FDEC_STRIDE, tmpu[0], 16, tmpu[1], 16, t->i_bipred_weight );
+                    mc->avg[chroma_size[p->i_size]]( dstv, FDEC_STRIDE, tmpv[0], 16, tmpv[1], 16, t->i_bipred_weight );
+                }
+            }
+            for( int c = 0; c < t->i_planes; c++ )
+                mc->copy[PIXEL_16x16]( pred[c].plane + ((16*mby << b_field) + i_parity)*pred[c].i_stride + 16*mbx,
+                                       pred[c].i_stride << b_field, t->fdec + 16*c*FDEC_STRIDE, FDEC_STRIDE, 16 );
+            if( b_nv12 )
+            {
+                int ch = 16 >> v_shift;
+                mc->copy[PIXEL_8x8]( pred[1].plane + ((ch*mby << b_field) + i_parity)*pred[1].i_stride + 8*mbx,
+                                     pred[1].i_stride << b_field, fdec_u, FDEC_STRIDE, ch );
+                mc->copy[PIXEL_8x8]( pred[2].plane + ((ch*mby << b_field) + i_parity)*pred[2].i_stride + 8*mbx,
+                                     pred[2].i_stride << b_field, fdec_v, FDEC_STRIDE, ch );
+            }
+        }
+}
+
+int vbench_mcframe_cmp( vbench_mcframe_t *t, int *i_plane, int *i_row )
+{
+    for( int p = 0; p < (t->i_csp ? 3 : 1); p++ )
+    {
+        vbench_plane_t *a = &t->pred[0][p];
+        vbench_plane_t *b = &t->pred[1][p];
+        for( int y = 0; y < a->i_height; y++ )
+            if( memcmp( a->plane + y*a->i_stride, b->plane + y*b->i_stride, a->i_width * sizeof(pixel) ) )
+            {
+                *i_plane = p;
+                *i_row = y;
+                return -1;
+            }
+    }
+    return 0;
+}
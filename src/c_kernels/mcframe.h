@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * mcframe.h: whole-frame motion compensation from dense MV fields
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef MCFRAME_H
+#define MCFRAME_H
+
+/* border of the reference planes, MVs are clamped to keep every block
+ * MCFRAME_PAD-16 pixels inside it */
+#define MCFRAME_PAD 64
+
+/* Shape of a synthetic MV field.  i_coherence is the percentage of MBs
+ * that follow the global motion of their list and of partitions that
+ * follow their MB, the rest get random MVs of up to i_range pixels.
+ * i_split is the chance of splitting a 16x16 into 16x8, 8x16 or 8x8 and
+ * then each 8x8 into 8x4, 4x8 or 4x4.  i_bipred is the percentage of
+ * bi-predicted partitions of a B-frame, the others are split between L0
+ * and L1; 0 gives a P-frame predicted from L0 only.  b_weighted applies
+ * explicit weights to uni-pred and implicit ones to bi-pred.  b_field codes
+ * the frame as two field pictures, each partition predicted from the field
+ * of the same or of the other parity of its references. */
+typedef struct
+{
+    int i_coherence;
+    int i_split;
+    int i_bipred;
+    int b_weighted;
+    int i_range;
+    int b_field;
+} vbench_mcframe_param_t;
+
+typedef struct vbench_mcframe_t vbench_mcframe_t;
+
+/* Two reference frames of i_width x i_height, i_width a multiple of 16 and
+ * i_height of 32, in chroma format i_csp (a chroma_format_e), with their
+ * hpel planes built by mc->hpel_filter for the frames and for their fields,
+ * and two prediction frames so the results of two kernel sets can be
+ * compared.  4:2:0 and 4:2:2 chroma is interleaved and goes through
+ * mc_chroma, 4:4:4 chroma through mc_luma like luma. */
+vbench_mcframe_t *vbench_mcframe_open( vbench_mc_functions_t *mc, int i_width, int i_height, int i_csp );
+void vbench_mcframe_close( vbench_mcframe_t *t );
+int  vbench_mcframe_mbs( vbench_mcframe_t *t );
+
+/* Replace the MV field with a new one drawn from rand(). */
+void vbench_mcframe_field( vbench_mcframe_t *t, const vbench_mcframe_param_t *param );
+
+/* Build prediction frame i_pred, luma and chroma, from the field.  Each MB
+ * is predicted into a small buffer as an encoder's fdec and copied out. */
+void vbench_mcframe_predict( vbench_mcframe_t *t, vbench_mc_functions_t *mc, int i_pred );
+
+/* Returns 0 if both prediction frames match, else sets the first
+ * differing plane and row and returns -1. */
+int vbench_mcframe_cmp( vbench_mcframe_t *t, int *i_plane, int *i_row );
+
+#endif
@@ -0,0 +1,273 @@
+/*****************************************************************************
+ * memory.c: page size and NUMA placement of the frame-scale buffers
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include <ctype.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "osdep.h"
+#include "common.h"
+#include "c_kernels/memory.h"
+
+/* from linux/mempolicy.h, which libc doesn't wrap without libnuma */
+#define MEM_MPOL_BIND   2
+#define MEM_MPOL_F_NODE (1<<0)
+#define MEM_MPOL_F_ADDR (1<<1)
+#define MEM_MAX_NODES   1024
+
+/* the mapping is described in front of the returned pointer */
+#define MEM_HEADER 64
+
+typedef struct
+{
+    void *base;
+    size_t i_map;
+} mem_header_t;
+
+vbench_mem_policy_t vbench_mem_policy = { MEM_PAGES_4K, MEM_NODE_LOCAL };
+
+static const char * const mem_pages_names[] = { "4k", "thp", "hugetlb" };
+
+int vbench_mem_parse( vbench_mem_policy_t *p, const char *psz )
+{
+    vbench_mem_policy_t r = { -1, MEM_NODE_LOCAL };
+    const char *node = strchr( psz, ',' );
+    int len = node ? node - psz : strlen( psz );
+
+    for( int i = 0; i < 3; i++ )
+        if( len == (int)strlen( mem_pages_names[i] ) && !strncmp( psz, mem_pages_names[i], len ) )
+            r.i_pages = i;
+    if( r.i_pages < 0 )
+        return -1;
+    if( node )
+    {
+        node++;
+        if( !strcmp( node, "remote" ) )
+            r.i_node = MEM_NODE_REMOTE;
+        else if( !strncmp( node, "node=", 5 ) && isdigit( node[5] ) )
+            r.i_node = atoi( node+5 );
+        else if( strcmp( node, "local" ) )
+            return -1;
+    }
+    *p = r;
+    return 0;
+}
+
+void vbench_mem_name( const vbench_mem_policy_t *p, char *psz, int i_size )
+{
+    if( p->i_node >= 0 )
+        snprintf( psz, i_size, "%s_node%d", mem_pages_names[p->i_pages], p->i_node );
+    else
+        snprintf( psz, i_size, "%s_%s", mem_pages_names[p->i_pages], p->i_node == MEM_NODE_REMOTE ? "remote" : "local" );
+}
+
+int vbench_mem_nodes( void )
+{
+    static int nodes;
+    DIR *dir;
+    struct dirent *d;
+
+    if( nodes )
+        return nodes;
+    dir = opendir( "/sys/devices/system/node" );
+    if( dir )
+    {
+        while( (d = readdir( dir )) )
+            if( !strncmp( d->d_name, "node", 4 ) && isdigit( d->d_name[4] ) )
+                nodes = MAX( nodes, atoi( d->d_name+4 ) + 1 );
+        closedir( dir );
+    }
+    nodes = vbench_clip3( nodes, 1, MEM_MAX_NODES );
+    return nodes;
+}
+
+int vbench_mem_local_node( void )
+{
+    unsigned cpu, node;
+    if( syscall( SYS_getcpu, &cpu, &node, NULL ) )
+        return 0;
+    return node;
+}
+
+int vbench_mem_node_of( void *p )
+{
+    int node = -1;
+    if( syscall( SYS_get_mempolicy, &node, NULL, 0, p, MEM_MPOL_F_NODE | MEM_MPOL_F_ADDR ) )
+        return -1;
+    return node;
+}
+
+int64_t vbench_mem_thp_bytes( void *p )
+{
+    FILE *fh = fopen( "/proc/self/smaps", "r" );
+    char line[256];
+    int b_found = 0;
+    int64_t bytes = -1;
+
+    if( !fh )
+        return -1;
+    while( fgets( line, sizeof(line), fh ) )
+    {
+        unsigned long start, end, kb;
+        /* mapping lines start with the range, field lines with a name */
+        if( sscanf( line, "%lx-%lx ", &start, &end ) == 2 )
+            b_found = (uintptr_t)p >= start && (uintptr_t)p < end;
+        else if( b_found && sscanf( line, "AnonHugePages: %lu kB", &kb ) == 1 )
+        {
+            bytes = (int64_t)kb * 1024;
+            break;
+        }
+    }
+    fclose( fh );
+    return bytes;
+}
+
+static int mem_bind( void *base, size_t i_map, int i_node )
+{
+    unsigned long mask[MEM_MAX_NODES / (8*sizeof(unsigned long))] = {0};
+    int nodes = vbench_mem_nodes();
+
+    if( i_node == MEM_NODE_LOCAL )
+        return 0;
+    if( i_node == MEM_NODE_REMOTE )
+    {
+        if( nodes < 2 )
+            return -1;
+        i_node = (vbench_mem_local_node() + 1) % nodes;
+    }
+    if( i_node >= nodes )
+        return -1;
+    mask[i_node / (8*sizeof(unsigned long))] = 1UL << (i_node % (8*sizeof(unsigned long)));
+    return syscall( SYS_mbind, base, i_map, MEM_MPOL_BIND, mask, MEM_MAX_NODES, 0 ) ? -1 : 0;
+}
+
+void *vbench_malloc_policy( size_t i_size, const vbench_mem_policy_t *p )
+{
+    size_t page = sysconf( _SC_PAGESIZE );
+    size_t i_map = ALIGN( i_size + MEM_HEADER, p->i_pages == MEM_PAGES_4K ? page : MEM_HUGE_PAGE_SIZE );
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    uint8_t *base;
+    mem_header_t *h;
+
+    if( p->i_pages == MEM_PAGES_HUGETLB )
+    {
+#ifdef MAP_HUGETLB
+        flags |= MAP_HUGETLB;
+#else
+        return NULL;
+#endif
+    }
+    if( p->i_pages == MEM_PAGES_THP )
+    {
+        /* over-map by one huge page and trim to get a 2MB aligned range */
+        uint8_t *raw = mmap( NULL, i_map + MEM_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0 );
+        if( raw == MAP_FAILED )
+            return NULL;
+        base = (uint8_t*)ALIGN( (uintptr_t)raw, MEM_HUGE_PAGE_SIZE );
+        if( base > raw )
+            munmap( raw, base - raw );
+        munmap( base + i_map, raw + MEM_HUGE_PAGE_SIZE - base );
+    }
+    else
+    {
+        base = mmap( NULL, i_map, PROT_READ | PROT_WRITE, flags, -1, 0 );
+        if( base == MAP_FAILED )
+            return NULL;
+    }
+
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+    if( p->i_pages == MEM_PAGES_THP )
+        madvise( base, i_map, MADV_HUGEPAGE );
+    else if( p->i_pages == MEM_PAGES_4K )
+        madvise( base, i_map, MADV_NOHUGEPAGE );
+#endif
+    if( mem_bind( base, i_map, p->i_node ) )
+    {
+        munmap( base, i_map );
+        return NULL;
+    }
+
+    h = (mem_header_t*)base;
+    h->base = base;
+    h->i_map = i_map;
+    return base + MEM_HEADER;
+}
+
+void *vbench_malloc( size_t i_size )
+{
+    return vbench_malloc_policy( i_size, &vbench_mem_policy );
+}
+
+void vbench_free( void *p )
+{
+    if( p )
+    {
+        mem_header_t *h = (mem_header_t*)((uint8_t*)p - MEM_HEADER);
+        munmap( h->base, h->i_map );
+    }
+}
+
+/****************************************************************************
+ * padded planes
+ ****************************************************************************/
+
+int vbench_plane_alloc( vbench_plane_t *pl, int i_width, int i_height, int i_pad, const vbench_mem_policy_t *p )
+{
+    /* a border of whole 32-pixel units keeps the picture rows aligned */
+    i_pad = ALIGN( i_pad, 32 );
+    pl->i_width = i_width;
+    pl->i_height = i_height;
+    pl->i_pad = i_pad;
+    pl->i_stride = ALIGN( i_width + 2*i_pad, 64 );
+    pl->buffer = vbench_malloc_policy( pl->i_stride * (i_height + 2*i_pad) * sizeof(pixel), p ? p : &vbench_mem_policy );
+    if( !pl->buffer )
+        return -1;
+    pl->plane = pl->buffer + i_pad * pl->i_stride + i_pad;
+    return 0;
+}
+
+void vbench_plane_free( vbench_plane_t *pl )
+{
+    vbench_free( pl->buffer );
+    pl->buffer = pl->plane = NULL;
+}
+
+void vbench_plane_expand_border( vbench_plane_t *pl )
+{
+    int pad = pl->i_pad;
+    intptr_t stride = pl->i_stride;
+    pixel *pix = pl->plane;
+
+    for( int y = 0; y < pl->i_height; y++, pix += stride )
+        for( int x = 1; x <= pad; x++ )
+        {
+            pix[-x] = pix[0];
+            pix[pl->i_width-1+x] = pix[pl->i_width-1];
+        }
+    for( int y = 1; y <= pad; y++ )
+    {
+        memcpy( pl->plane - y*stride - pad, pl->plane - pad, (pl->i_width + 2*pad) * sizeof(pixel) );
+        memcpy( pl->plane + (pl->i_height-1+y)*stride - pad, pl->plane + (pl->i_height-1)*stride - pad,
+                (pl->i_width + 2*pad) * sizeof(pixel) );
+    }
+}
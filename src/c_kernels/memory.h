@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * memory.h: page size and NUMA placement of the frame-scale buffers
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#define MEM_HUGE_PAGE_SIZE (2*1024*1024)
+
+/* MEM_PAGES_4K forces base pages even when THP is set to "always",
+ * MEM_PAGES_THP asks for transparent huge pages on 2MB aligned memory and
+ * MEM_PAGES_HUGETLB takes them from the reserved pool, failing if it is
+ * empty rather than quietly falling back. */
+enum
+{
+    MEM_PAGES_4K,
+    MEM_PAGES_THP,
+    MEM_PAGES_HUGETLB,
+};
+
+/* i_node >= 0 binds the memory to that node with mbind().  MEM_NODE_LOCAL
+ * leaves the pages to the first thread that touches them, MEM_NODE_REMOTE
+ * binds them to the node after the one the caller runs on. */
+#define MEM_NODE_LOCAL  -1
+#define MEM_NODE_REMOTE -2
+
+typedef struct
+{
+    int i_pages;
+    int i_node;
+} vbench_mem_policy_t;
+
+/* The policy of vbench_malloc, MEM_PAGES_4K and MEM_NODE_LOCAL unless
+ * changed with --mem. */
+extern vbench_mem_policy_t vbench_mem_policy;
+
+/* Parse "4k|thp|hugetlb[,local|remote|node=N]" into p; returns 0 on
+ * success. */
+int vbench_mem_parse( vbench_mem_policy_t *p, const char *psz );
+void vbench_mem_name( const vbench_mem_policy_t *p, char *psz, int i_size );
+
+/* 64-byte aligned memory straight from mmap, untouched, so the first
+ * writer places it under MEM_NODE_LOCAL.  Returns NULL if the policy
+ * can't be honoured. */
+void *vbench_malloc_policy( size_t i_size, const vbench_mem_policy_t *p );
+void *vbench_malloc( size_t i_size );
+void  vbench_free( void *p );
+
+int vbench_mem_nodes( void );
+int vbench_mem_local_node( void );
+/* node of the page holding p, -1 if unknown */
+int vbench_mem_node_of( void *p );
+/* bytes of the mapping holding p backed by transparent huge pages,
+ * -1 if unknown */
+int64_t vbench_mem_thp_bytes( void *p );
+
+/* A plane with i_pad pixels of border on every side, as an encoder's
+ * reference frames.  plane points to the top-left pixel of the picture;
+ * the stride is rounded up to 64 pixels. */
+typedef struct
+{
+    int i_width, i_height, i_pad;
+    intptr_t i_stride;
+    pixel *plane;
+    pixel *buffer;
+} vbench_plane_t;
+
+int  vbench_plane_alloc( vbench_plane_t *pl, int i_width, int i_height, int i_pad, const vbench_mem_policy_t *p );
+void vbench_plane_free( vbench_plane_t *pl );
+/* replicate the edge pixels into the border */
+void vbench_plane_expand_border( vbench_plane_t *pl );
+
+#endif
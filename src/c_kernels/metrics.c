@@ -0,0 +1,401 @@
+/*****************************************************************************
+ * metrics.c: frame-level PSNR/SSIM
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ * Copyright (C) 2003-2016 x264 project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/pixel.h"
+#include "c_kernels/metrics.h"
+#include "c_kernels/threadpool.h"
+#include "c_kernels/memory.h"
+
+typedef struct
+{
+    /* SSIM block rows [ssim_y0,ssim_y1) and pixel rows [ssd_y0,ssd_y1) */
+    int i_ssim_y0, i_ssim_y1;
+    int i_ssd_y0, i_ssd_y1;
+    int (*sums)[4];
+    uint64_t ssd[3];
+    double ssim;
+} metrics_band_t;
+
+struct vbench_metrics_t
+{
+    vbench_pixel_function_t *pf;
+    int i_width, i_height;
+    int i_threads;
+    metrics_band_t band[METRICS_MAX_THREADS];
+    int (*sums)[4];
+    vbench_threadpool_t *pool;
+    vbench_picture_t *ref, *dist;
+};
+
+static double metrics_psnr( double sqe, double size )
+{
+    double mse = sqe / (PIXEL_MAX*PIXEL_MAX * size);
+    if( mse <= 0.0000000001 ) /* max 100dB */
+        return 100;
+    return -10.0 * log10( mse );
+}
+
+static void metrics_finish( vbench_metrics_result_t *res, int i_width, int i_height, double ssim, int cnt )
+{
+    double size = (double)i_width * i_height;
+    res->psnr[0] = metrics_psnr( res->ssd[0], size );
+    res->psnr[1] = metrics_psnr( res->ssd[1], size / 4 );
+    res->psnr[2] = metrics_psnr( res->ssd[2], size / 4 );
+    res->psnr_avg = metrics_psnr( res->ssd[0] + res->ssd[1] + res->ssd[2], size * 3 / 2 );
+    res->ssim = cnt > 0 ? ssim / cnt : 1.0;
+}
+
+int vbench_picture_alloc( vbench_picture_t *pic, int i_width, int i_height )
+{
+    /* 8 pixels of slack after every row for the paired ssim blocks */
+    intptr_t stride_y = ALIGN( i_width + 8, 32 );
+    intptr_t stride_c = ALIGN( (i_width >> 1) + 8, 32 );
+    size_t size = stride_y * i_height + 2 * stride_c * (i_height >> 1);
+
+    if( (i_width | i_height) & 1 || i_width <= 0 || i_height <= 0 )
+        return -1;
+    pic->buffer = vbench_malloc( size * sizeof(pixel) );
+    if( !pic->buffer )
+        return -1;
+    memset( pic->buffer, 0, size * sizeof(pixel) );
+    pic->i_width = i_width;
+    pic->i_height = i_height;
+    pic->i_stride[0] = stride_y;
+    pic->i_stride[1] = pic->i_stride[2] = stride_c;
+    pic->plane[0] = pic->buffer;
+    pic->plane[1] = pic->plane[0] + stride_y * i_height;
+    pic->plane[2] = pic->plane[1] + stride_c * (i_height >> 1);
+    return 0;
+}
+
+void vbench_picture_free( vbench_picture_t *pic )
+{
+    vbench_free( pic->buffer );
+    pic->buffer = NULL;
+}
+
+/****************************************************************************
+ * banded engine
+ ****************************************************************************/
+
+/* Same loop as vbench_pixel_ssim_wxh restricted to the block rows of one
+ * band.  The two rows of sums are swapped rather than recomputed, so each
+ * band only computes its first row of sums twice: once as the bottom of
+ * the band above and once as the top of its own. */
+static void metrics_band( vbench_metrics_t *m, metrics_band_t *b )
+{
+    vbench_pixel_function_t *pf = m->pf;
+    vbench_picture_t *ref = m->ref, *dist = m->dist;
+    pixel *pix1 = ref->plane[0], *pix2 = dist->plane[0];
+    intptr_t stride1 = ref->i_stride[0], stride2 = dist->i_stride[0];
+    int (*sum0)[4] = b->sums;
+    int (*sum1)[4] = sum0 + (m->i_width >> 2) + 3;
+    int width = m->i_width >> 2;
+    double ssim = 0.0;
+
+    for( int p = 0; p < 3; p++ )
+    {
+        int y0 = b->i_ssd_y0 >> !!p;
+        int y1 = b->i_ssd_y1 >> !!p;
+        b->ssd[p] = pixel_ssd_wxh( pf, ref->plane[p] + y0*ref->i_stride[p], ref->i_stride[p],
+                                   dist->plane[p] + y0*dist->i_stride[p], dist->i_stride[p],
+                                   m->i_width >> !!p, y1 - y0 );
+    }
+
+    for( int y = b->i_ssim_y0, z = y-1; y < b->i_ssim_y1; y++ )
+    {
+        float row = 0.0;
+        for( ; z <= y; z++ )
+        {
+            XCHG( void*, sum0, sum1 );
+            for( int x = 0; x < width; x+=2 )
+                pf->ssim_4x4x2_core( &pix1[4*(x+z*stride1)], stride1, &pix2[4*(x+z*stride2)], stride2, &sum0[x] );
+        }
+        for( int x = 0; x < width-1; x += 4 )
+            row += pf->ssim_end4( sum0+x, sum1+x, MIN(4,width-x-1) );
+        ssim += row;
+    }
+    vbench_emms();
+    b->ssim = ssim;
+}
+
+static void metrics_band_job( void *arg, int i_thread )
+{
+    vbench_metrics_t *m = arg;
+    metrics_band( m, &m->band[i_thread] );
+}
+
+vbench_metrics_t *vbench_metrics_open( vbench_pixel_function_t *pf, int i_width, int i_height, int i_threads )
+{
+    vbench_metrics_t *m;
+    int h4 = i_height >> 2;
+    int h16 = i_height >> 4;
+    int sums_size = 2 * ((i_width >> 2) + 3);
+
+    if( (i_width | i_height) & 1 || i_width < 8 || i_height < 8 )
+        return NULL;
+    m = calloc( 1, sizeof(vbench_metrics_t) );
+    if( !m )
+        return NULL;
+    i_threads = MIN( i_threads, METRICS_MAX_THREADS );
+    i_threads = MIN( i_threads, h4-1 );
+    i_threads = MAX( i_threads, 1 );
+    m->pf = pf;
+    m->i_width = i_width;
+    m->i_height = i_height;
+    m->i_threads = i_threads;
+    m->sums = memalign( 16, i_threads * sums_size * sizeof(*m->sums) );
+    if( !m->sums )
+        goto fail;
+
+    /* SSD bands are whole 16-row stripes so the pixf->ssd blocks stay
+     * aligned; the last band takes the remainder. */
+    for( int t = 0; t < i_threads; t++ )
+    {
+        metrics_band_t *b = &m->band[t];
+        b->sums = m->sums + t * sums_size;
+        b->i_ssim_y0 = 1 + (h4-1) * t / i_threads;
+        b->i_ssim_y1 = 1 + (h4-1) * (t+1) / i_threads;
+        b->i_ssd_y0 = h16 * t / i_threads * 16;
+        b->i_ssd_y1 = t == i_threads-1 ? i_height : h16 * (t+1) / i_threads * 16;
+    }
+
+    m->pool = vbench_threadpool_init( i_threads );
+    if( !m->pool )
+        goto fail;
+    return m;
+fail:
+    vbench_metrics_close( m );
+    return NULL;
+}
+
+void vbench_metrics_frame( vbench_metrics_t *m, vbench_picture_t *ref, vbench_picture_t *dist,
+                           vbench_metrics_result_t *res )
+{
+    int h4 = m->i_height >> 2;
+    int w4 = m->i_width >> 2;
+    double ssim = 0.0;
+
+    m->ref = ref;
+    m->dist = dist;
+    vbench_threadpool_run( m->pool, metrics_band_job, m );
+
+    /* reduce in band order so the result doesn't depend on scheduling */
+    memset( res->ssd, 0, sizeof(res->ssd) );
+    for( int t = 0; t < m->i_threads; t++ )
+    {
+        for( int p = 0; p < 3; p++ )
+            res->ssd[p] += m->band[t].ssd[p];
+        ssim += m->band[t].ssim;
+    }
+    metrics_finish( res, m->i_width, m->i_height, ssim, (h4-1) * (w4-1) );
+}
+
+void vbench_metrics_close( vbench_metrics_t *m )
+{
+    if( !m )
+        return;
+    vbench_threadpool_delete( m->pool );
+    free( m->sums );
+    free( m );
+}
+
+void vbench_metrics_frame_ref( vbench_pixel_function_t *pf, vbench_picture_t *ref, vbench_picture_t *dist,
+                               vbench_metrics_result_t *res )
+{
+    int i_width = ref->i_width, i_height = ref->i_height;
+    int cnt = 0;
+    float ssim = 0.0;
+    void *buf = malloc( 2 * ((i_width >> 2) + 3) * sizeof(int[4]) );
+
+    for( int p = 0; p < 3; p++ )
+        res->ssd[p] = pixel_ssd_wxh( pf, ref->plane[p], ref->i_stride[p], dist->plane[p], dist->i_stride[p],
+                                     i_width >> !!p, i_height >> !!p );
+    if( buf )
+        ssim = vbench_pixel_ssim_wxh( pf, ref->plane[0], ref->i_stride[0], dist->plane[0], dist->i_stride[0],
+                                      i_width, i_height, buf, &cnt );
+    vbench_emms();
+    free( buf );
+    metrics_finish( res, i_width, i_height, ssim, cnt );
+}
+
+/****************************************************************************
+ * y4m input
+ ****************************************************************************/
+
+int vbench_y4m_open( vbench_y4m_t *y4m, const char *psz_filename )
+{
+    char header[1024];
+    static const char *colorspaces[] = { "420", "420jpeg", "420paldv", "420mpeg2", NULL };
+
+    memset( y4m, 0, sizeof(*y4m) );
+    y4m->fh = fopen( psz_filename, "rb" );
+    if( !y4m->fh )
+    {
+        fprintf( stderr, "y4m: cannot open %s\n", psz_filename );
+        return -1;
+    }
+    if( !fgets( header, sizeof(header), y4m->fh ) || strncmp( header, "YUV4MPEG2 ", 10 ) ||
+        !strchr( header, '\n' ) )
+    {
+        fprintf( stderr, "y4m: %s: bad header\n", psz_filename );
+        goto fail;
+    }
+    for( char *tok = strtok( header+10, " \n" ); tok; tok = strtok( NULL, " \n" ) )
+    {
+        if( *tok == 'W' )
+            y4m->i_width = strtol( tok+1, NULL, 10 );
+        else if( *tok == 'H' )
+            y4m->i_height = strtol( tok+1, NULL, 10 );
+        else if( *tok == 'C' )
+        {
+            int i = 0;
+            while( colorspaces[i] && strcmp( tok+1, colorspaces[i] ) )
+                i++;
+            if( !colorspaces[i] )
+            {
+                fprintf( stderr, "y4m: %s: colorspace %s not supported, only 8-bit 4:2:0\n", psz_filename, tok+1 );
+                goto fail;
+            }
+        }
+    }
+    if( y4m->i_width <= 0 || y4m->i_height <= 0 || (y4m->i_width | y4m->i_height) & 1 )
+    {
+        fprintf( stderr, "y4m: %s: invalid resolution %dx%d\n", psz_filename, y4m->i_width, y4m->i_height );
+        goto fail;
+    }
+    return 0;
+fail:
+    fclose( y4m->fh );
+    y4m->fh = NULL;
+    return -1;
+}
+
+/* Returns 0 when a frame was read, -1 at end of file or on error. */
+int vbench_y4m_read( vbench_y4m_t *y4m, vbench_picture_t *pic )
+{
+    char header[256];
+
+    if( !fgets( header, sizeof(header), y4m->fh ) )
+        return -1;
+    if( strncmp( header, "FRAME", 5 ) || !strchr( header, '\n' ) )
+    {
+        fprintf( stderr, "y4m: bad frame header at frame %d\n", y4m->i_frame );
+        return -1;
+    }
+    for( int p = 0; p < 3; p++ )
+    {
+        int w = pic->i_width >> !!p;
+        int h = pic->i_height >> !!p;
+        for( int y = 0; y < h; y++ )
+            if( fread( pic->plane[p] + y*pic->i_stride[p], 1, w, y4m->fh ) != w )
+            {
+                fprintf( stderr, "y4m: truncated frame %d\n", y4m->i_frame );
+                return -1;
+            }
+    }
+    y4m->i_frame++;
+    return 0;
+}
+
+void vbench_y4m_close( vbench_y4m_t *y4m )
+{
+    if( y4m->fh )
+        fclose( y4m->fh );
+    y4m->fh = NULL;
+}
+
+int vbench_metrics_y4m( vbench_pixel_function_t *pf, const char *psz_ref, const char *psz_dist, int i_threads )
+{
+    vbench_y4m_t in[2];
+    vbench_picture_t pic[2] = {{0}};
+    vbench_metrics_t *m = NULL;
+    vbench_metrics_result_t res;
+    double psnr_sum[4] = {0}, ssim_sum = 0.0;
+    uint64_t ssd_sum[3] = {0};
+    int i_frames = 0, ret = -1;
+    int64_t t;
+
+    if( vbench_y4m_open( &in[0], psz_ref ) )
+        return -1;
+    if( vbench_y4m_open( &in[1], psz_dist ) )
+        goto end;
+    if( in[0].i_width != in[1].i_width || in[0].i_height != in[1].i_height )
+    {
+        fprintf( stderr, "y4m: resolution mismatch %dx%d vs %dx%d\n",
+                 in[0].i_width, in[0].i_height, in[1].i_width, in[1].i_height );
+        goto end;
+    }
+    if( vbench_picture_alloc( &pic[0], in[0].i_width, in[0].i_height ) ||
+        vbench_picture_alloc( &pic[1], in[0].i_width, in[0].i_height ) )
+        goto end;
+    m = vbench_metrics_open( pf, in[0].i_width, in[0].i_height, i_threads );
+    if( !m )
+        goto end;
+
+    t = mdate();
+    while( !vbench_y4m_read( &in[0], &pic[0] ) && !vbench_y4m_read( &in[1], &pic[1] ) )
+    {
+        vbench_metrics_frame( m, &pic[0], &pic[1], &res );
+        printf( "frame %5d  PSNR Y:%6.3f U:%6.3f V:%6.3f Avg:%6.3f  SSIM Y:%.7f (%6.3fdB)\n",
+                i_frames, res.psnr[0], res.psnr[1], res.psnr[2], res.psnr_avg,
+                res.ssim, -10.0 * log10( MAX( 1 - res.ssim, 1e-10 ) ) );
+        for( int p = 0; p < 3; p++ )
+        {
+            psnr_sum[p] += res.psnr[p];
+            ssd_sum[p] += res.ssd[p];
+        }
+        psnr_sum[3] += res.psnr_avg;
+        ssim_sum += res.ssim;
+        i_frames++;
+    }
+    t = mdate() - t;
+
+    if( i_frames )
+    {
+        double size = (double)in[0].i_width * in[0].i_height * i_frames;
+        double ssim = ssim_sum / i_frames;
+        printf( "PSNR Mean Y:%6.3f U:%6.3f V:%6.3f Avg:%6.3f Global:%6.3f\n",
+                psnr_sum[0] / i_frames, psnr_sum[1] / i_frames, psnr_sum[2] / i_frames, psnr_sum[3] / i_frames,
+                metrics_psnr( ssd_sum[0] + ssd_sum[1] + ssd_sum[2], size * 3 / 2 ) );
+        printf( "SSIM Mean Y:%.7f (%6.3fdB)\n", ssim, -10.0 * log10( MAX( 1 - ssim, 1e-10 ) ) );
+        fprintf( stderr, "%d frames, %d threads, %.2f fps\n",
+                 i_frames, vbench_metrics_threads( m ), t > 0 ? i_frames * 1e6 / t : 0.0 );
+    }
+    ret = 0;
+end:
+    vbench_metrics_close( m );
+    vbench_picture_free( &pic[0] );
+    vbench_picture_free( &pic[1] );
+    vbench_y4m_close( &in[0] );
+    vbench_y4m_close( &in[1] );
+    return ret;
+}
+
+int vbench_metrics_threads( vbench_metrics_t *m )
+{
+    return m->i_threads;
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * metrics.h: frame-level PSNR/SSIM
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ * Copyright (C) 2003-2016 x264 project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#define METRICS_MAX_THREADS 64
+
+/* Planar 4:2:0 picture.  Planes must be readable for 8 pixels past the
+ * width: ssim_4x4x2_core always works on pairs of 4x4 blocks. */
+typedef struct
+{
+    int i_width, i_height;
+    intptr_t i_stride[3];
+    pixel *plane[3];
+    pixel *buffer;
+} vbench_picture_t;
+
+typedef struct
+{
+    uint64_t ssd[3];
+    double psnr[3];
+    double psnr_avg;
+    double ssim;        /* luma, mean over the overlapping 8x8 windows */
+} vbench_metrics_result_t;
+
+typedef struct vbench_metrics_t vbench_metrics_t;
+
+int  vbench_picture_alloc( vbench_picture_t *pic, int i_width, int i_height );
+void vbench_picture_free( vbench_picture_t *pic );
+
+/* The engine splits every frame into i_threads horizontal bands; the
+ * calling thread computes the first band and i_threads-1 persistent
+ * workers the others.  All scratch memory, including the two-row SSIM
+ * sums buffer of each band, is allocated here once. */
+vbench_metrics_t *vbench_metrics_open( vbench_pixel_function_t *pf, int i_width, int i_height, int i_threads );
+void vbench_metrics_frame( vbench_metrics_t *m, vbench_picture_t *ref, vbench_picture_t *dist,
+                           vbench_metrics_result_t *res );
+void vbench_metrics_close( vbench_metrics_t *m );
+int  vbench_metrics_threads( vbench_metrics_t *m );
+
+/* The per-call path: one pixel_ssd_wxh per plane plus one
+ * vbench_pixel_ssim_wxh over the luma plane, with the sums buffer
+ * allocated per frame. */
+void vbench_metrics_frame_ref( vbench_pixel_function_t *pf, vbench_picture_t *ref, vbench_picture_t *dist,
+                               vbench_metrics_result_t *res );
+
+/* YUV4MPEG2 reader, 8-bit 4:2:0 only */
+typedef struct
+{
+    FILE *fh;
+    int i_width, i_height;
+    int i_frame;
+} vbench_y4m_t;
+
+int  vbench_y4m_open( vbench_y4m_t *y4m, const char *psz_filename );
+int  vbench_y4m_read( vbench_y4m_t *y4m, vbench_picture_t *pic );
+void vbench_y4m_close( vbench_y4m_t *y4m );
+
+/* Compare two Y4M files frame by frame, print one line per frame and the
+ * averages to stdout.  Returns 0 on success. */
+int vbench_metrics_y4m( vbench_pixel_function_t *pf, const char *psz_ref, const char *psz_dist, int i_threads );
+
+#endif
@@ -45,7 +45,14 @@
 
 #include "common.h"
 #include "osdep.h"
+#include "bench.h"
 #include "pixel.h"
+#include "c_kernels/ccbuild.h"
+#include "c_kernels/vext.h"
+#if ARCH_AARCH64
+#   include "asm/aarch64/pixel.h"
+#   include "asm/aarch64/predict.h"
+#endif
 
 
 /****************************************************************************
@@ -224,7 +231,7 @@ PIXEL_SSD_C_10B( pixel_ssd_4x4_10b,    4,  4 )
 
 
 
-uint64_t pixel_ssd_wxh( pixel *pix1, intptr_t i_pix1,
+uint64_t pixel_ssd_wxh( vbench_pixel_function_t *pf, pixel *pix1, intptr_t i_pix1,
                              pixel *pix2, intptr_t i_pix2, int i_width, int i_height )
 {
     uint64_t i_ssd = 0;
@@ -236,18 +243,18 @@ uint64_t pixel_ssd_wxh( pixel *pix1, intptr_t i_pix1,
         int x = 0;
         if( align ){
             for( ; x < i_width-15; x += 16 ){
-                i_ssd += pixel_ssd_16x16( pix1 + y*i_pix1 + x, i_pix1, \
+                i_ssd += pf->ssd[PIXEL_16x16]( pix1 + y*i_pix1 + x, i_pix1, \
                                                pix2 + y*i_pix2 + x, i_pix2 );
             }
         }
         for( ; x < i_width-7; x += 8 ){
-            i_ssd += pixel_ssd_8x16( pix1 + y*i_pix1 + x, i_pix1, \
+            i_ssd += pf->ssd[PIXEL_8x16]( pix1 + y*i_pix1 + x, i_pix1, \
                                           pix2 + y*i_pix2 + x, i_pix2 );
         }
     }
     if( y < i_height-7 ){
         for( int x = 0; x < i_width-7; x += 8 ){
-            i_ssd += pixel_ssd_8x8( pix1 + y*i_pix1 + x, i_pix1, \
+            i_ssd += pf->ssd[PIXEL_8x8]( pix1 + y*i_pix1 + x, i_pix1, \
                                          pix2 + y*i_pix2 + x, i_pix2 );
         }
     }
@@ -702,6 +709,9 @@ SATD_X_DECL7( _avx, asm_ )
 SATD_X_DECL7( _xop, asm_ )
 #endif // !HIGH_BIT_DEPTH
 #endif
+#if !HIGH_BIT_DEPTH && ARCH_AARCH64
+SATD_X_DECL7( _neon, asm_ )
+#endif
 
 
 
@@ -1023,8 +1033,8 @@ INTRA_MBCMP_8x8( sad, _mmx2,  _c, asm_)
 INTRA_MBCMP_8x8(sa8d, _sse2,  _sse2, asm_)
 #endif
 #if !HIGH_BIT_DEPTH && (HAVE_ARMV6 || ARCH_AARCH64)
-INTRA_MBCMP_8x8( sad, _neon, _neon )
-INTRA_MBCMP_8x8(sa8d, _neon, _neon )
+INTRA_MBCMP_8x8( sad, _neon, _neon, asm_ )
+INTRA_MBCMP_8x8(sa8d, _neon, _neon, asm_ )
 #endif
 
 #define INTRA_MBCMP_C( mbcmp, size, pred1, pred2, pred3, chroma, cpu, cpu2, prefix )\
@@ -1260,7 +1270,7 @@ float ssim_end4_10b( int sum0[5][4], int sum1[5][4], int width )
     return ssim;
 }
 
-float vbench_pixel_ssim_wxh( 
+float vbench_pixel_ssim_wxh( vbench_pixel_function_t *pf,
                            pixel *pix1, intptr_t stride1,
                            pixel *pix2, intptr_t stride2,
                            int width, int height, void *buf, int *cnt )
@@ -1277,10 +1287,10 @@ float vbench_pixel_ssim_wxh(
         {
             XCHG( void*, sum0, sum1 );
             for( int x = 0; x < width; x+=2 )
-                ssim_4x4x2_core( &pix1[4*(x+z*stride1)], stride1, &pix2[4*(x+z*stride2)], stride2, &sum0[x] );
+                pf->ssim_4x4x2_core( &pix1[4*(x+z*stride1)], stride1, &pix2[4*(x+z*stride2)], stride2, &sum0[x] );
         }
         for( int x = 0; x < width-1; x += 4 )
-            ssim += ssim_end4( sum0+x, sum1+x, MIN(4,width-x-1) );
+            ssim += pf->ssim_end4( sum0+x, sum1+x, MIN(4,width-x-1) );
     }
     *cnt = (height-1) * (width-1);
     return ssim;
@@ -1398,7 +1408,762 @@ int pixel_ads1( int enc_dc[1], uint16_t *sums, int delta,
     return nmv;
 }
 
+/****************************************************************************
+ * vbench_pixel_init:
+ ****************************************************************************/
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf )
+{
+    CCBUILD_INIT( cpu, pixel_init, 0, pixf );
+    memset( pixf, 0, sizeof(*pixf) );
+
+#define INIT2_NAME( name1, name2, cpu, prefix ) \
+    pixf->name1[PIXEL_16x16] = prefix##pixel_##name2##_16x16##cpu;\
+    pixf->name1[PIXEL_16x8]  = prefix##pixel_##name2##_16x8##cpu;
+#define INIT4_NAME( name1, name2, cpu, prefix  ) \
+    INIT2_NAME( name1, name2, cpu, prefix  ) \
+    pixf->name1[PIXEL_8x16]  = prefix##pixel_##name2##_8x16##cpu;\
+    pixf->name1[PIXEL_8x8]   = prefix##pixel_##name2##_8x8##cpu;
+
+#define INIT5_NAME( name1, name2, cpu, prefix  ) \
+    INIT4_NAME( name1, name2, cpu, prefix ) \
+    pixf->name1[PIXEL_8x4]   = prefix##pixel_##name2##_8x4##cpu;
+
+#define INIT6_NAME( name1, name2, cpu, prefix  ) \
+    INIT5_NAME( name1, name2, cpu, prefix  ) \
+    pixf->name1[PIXEL_4x8]   = prefix##pixel_##name2##_4x8##cpu;
+
+#define INIT7_NAME( name1, name2, cpu, prefix  ) \
+    INIT6_NAME( name1, name2, cpu, prefix  ) \
+    pixf->name1[PIXEL_4x4]   = prefix##pixel_##name2##_4x4##cpu;
+
+#define INIT8_NAME( name1, name2, cpu, prefix  ) \
+    INIT7_NAME( name1, name2, cpu, prefix ) \
+    pixf->name1[PIXEL_4x16]  = prefix##pixel_##name2##_4x16##cpu;
+
+#define INIT2( name, cpu, prefix ) INIT2_NAME( name, name, cpu, prefix )
+#define INIT4( name, cpu, prefix ) INIT4_NAME( name, name, cpu, prefix )
+#define INIT5( name, cpu, prefix ) INIT5_NAME( name, name, cpu, prefix )
+#define INIT6( name, cpu, prefix ) INIT6_NAME( name, name, cpu, prefix )
+#define INIT7( name, cpu, prefix ) INIT7_NAME( name, name, cpu, prefix )
+#define INIT8( name, cpu, prefix ) INIT8_NAME( name, name, cpu, prefix )
+
+#define INIT_ADS( cpu, prefix ) \
+    pixf->ads[PIXEL_16x16] = prefix##pixel_ads4##cpu;\
+    pixf->ads[PIXEL_16x8] = prefix##pixel_ads2##cpu;\
+    pixf->ads[PIXEL_8x8] = prefix##pixel_ads1##cpu;
+
+    INIT8( sad, , );
+    INIT8_NAME( sad_aligned, sad, , );
+    INIT7( sad_x3, , );
+    INIT7( sad_x4, , );
+    INIT8( ssd, , );
+    INIT8( satd, , );
+    INIT7( satd_x3, , );
+    INIT7( satd_x4, , );
+    INIT4( hadamard_ac, , );
+    INIT_ADS( , );
+
+    pixf->sa8d[PIXEL_16x16] = pixel_sa8d_16x16;
+    pixf->sa8d[PIXEL_8x8]   = pixel_sa8d_8x8;
+    pixf->var[PIXEL_16x16] = pixel_var_16x16;
+    pixf->var[PIXEL_8x16]  = pixel_var_8x16;
+    pixf->var[PIXEL_8x8]   = pixel_var_8x8;
+    pixf->var2[PIXEL_8x16]  = pixel_var2_8x16;
+    pixf->var2[PIXEL_8x8]   = pixel_var2_8x8;
+
+    pixf->ssd_nv12_core = pixel_ssd_nv12_core;
+    pixf->ssim_4x4x2_core = ssim_4x4x2_core;
+    pixf->ssim_end4 = ssim_end4;
+    pixf->vsad = pixel_vsad;
+    pixf->asd8 = pixel_asd8;
+
+    pixf->intra_sad_x3_4x4    = intra_sad_x3_4x4;
+    pixf->intra_satd_x3_4x4   = intra_satd_x3_4x4;
+    pixf->intra_sad_x3_8x8    = intra_sad_x3_8x8;
+    pixf->intra_sa8d_x3_8x8   = intra_sa8d_x3_8x8;
+    pixf->intra_sad_x3_8x8c   = intra_sad_x3_8x8c;
+    pixf->intra_satd_x3_8x8c  = intra_satd_x3_8x8c;
+    pixf->intra_sad_x3_8x16c  = intra_sad_x3_8x16c;
+    pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c;
+    pixf->intra_sad_x3_16x16  = intra_sad_x3_16x16;
+    pixf->intra_satd_x3_16x16 = intra_satd_x3_16x16;
+
+#if HIGH_BIT_DEPTH
+#if HAVE_MMX
+    if( cpu&CPU_MMX2 )
+    {
+        INIT7( sad, _mmx2, asm_ );
+        INIT7_NAME( sad_aligned, sad, _mmx2, asm_  );
+        INIT7( sad_x3, _mmx2, asm_  );
+        INIT7( sad_x4, _mmx2, asm_  );
+        INIT8( satd, _mmx2, asm_  );
+        INIT7( satd_x3, _mmx2, asm_  );
+        INIT7( satd_x4, _mmx2, asm_  );
+        INIT4( hadamard_ac, _mmx2, asm_  );
+        INIT8( ssd, _mmx2, asm_  );
+        INIT_ADS( _mmx2, asm_  );
+
+        pixf->ssd_nv12_core = pixel_ssd_nv12_core_mmx2;
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_mmx2;
+        pixf->var[PIXEL_8x8]   = pixel_var_8x8_mmx2;
+#if ARCH_X86
+        pixf->var2[PIXEL_8x8]  = pixel_var2_8x8_mmx2;
+        pixf->var2[PIXEL_8x16] = pixel_var2_8x16_mmx2;
+#endif
+
+        pixf->intra_sad_x3_4x4    = intra_sad_x3_4x4_mmx2;
+        pixf->intra_satd_x3_4x4   = intra_satd_x3_4x4_mmx2;
+        pixf->intra_sad_x3_8x8    = intra_sad_x3_8x8_mmx2;
+        pixf->intra_sad_x3_8x8c   = intra_sad_x3_8x8c_mmx2;
+        pixf->intra_satd_x3_8x8c  = intra_satd_x3_8x8c_mmx2;
+        pixf->intra_sad_x3_8x16c  = intra_sad_x3_8x16c_mmx2;
+        pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c_mmx2;
+        pixf->intra_sad_x3_16x16  = intra_sad_x3_16x16_mmx2;
+        pixf->intra_satd_x3_16x16 = intra_satd_x3_16x16_mmx2;
+    }
+    if( cpu&CPU_SSE2 )
+    {
+        INIT4_NAME( sad_aligned, sad, _sse2_aligned );
+        INIT5( ssd, _sse2 );
+        INIT6( satd, _sse2 );
+        pixf->satd[PIXEL_4x16] = pixel_satd_4x16_sse2;
+
+        pixf->sa8d[PIXEL_16x16] = pixel_sa8d_16x16_sse2;
+        pixf->sa8d[PIXEL_8x8]   = pixel_sa8d_8x8_sse2;
+#if ARCH_X86_64
+        pixf->intra_sa8d_x3_8x8 = intra_sa8d_x3_8x8_sse2;
+        pixf->sa8d_satd[PIXEL_16x16] = pixel_sa8d_satd_16x16_sse2;
+#endif
+        pixf->intra_sad_x3_4x4  = intra_sad_x3_4x4_sse2;
+        pixf->ssd_nv12_core = pixel_ssd_nv12_core_sse2;
+        pixf->ssim_4x4x2_core  = pixel_ssim_4x4x2_core_sse2;
+        pixf->ssim_end4        = pixel_ssim_end4_sse2;
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_sse2;
+        pixf->var[PIXEL_8x8]   = pixel_var_8x8_sse2;
+        pixf->var2[PIXEL_8x8]  = pixel_var2_8x8_sse2;
+        pixf->var2[PIXEL_8x16] = pixel_var2_8x16_sse2;
+        pixf->intra_sad_x3_8x8 = intra_sad_x3_8x8_sse2;
+    }
+    if( (cpu&CPU_SSE2) && !(cpu&CPU_SSE2_IS_SLOW) )
+    {
+        INIT5( sad, _sse2 );
+        INIT2( sad_x3, _sse2 );
+        INIT2( sad_x4, _sse2 );
+        INIT_ADS( _sse2 );
+
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            INIT4( hadamard_ac, _sse2 );
+        }
+        pixf->vsad = pixel_vsad_sse2;
+        pixf->asd8 = pixel_asd8_sse2;
+        pixf->intra_sad_x3_8x8    = intra_sad_x3_8x8_sse2;
+        pixf->intra_sad_x3_8x8c   = intra_sad_x3_8x8c_sse2;
+        pixf->intra_sad_x3_8x16c  = intra_sad_x3_8x16c_sse2;
+        pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c_sse2;
+        pixf->intra_sad_x3_16x16  = intra_sad_x3_16x16_sse2;
+    }
+    if( cpu&CPU_SSE2_IS_FAST )
+    {
+        pixf->sad[PIXEL_8x16] = pixel_sad_8x16_sse2;
+        pixf->sad_x3[PIXEL_8x16] = pixel_sad_x3_8x16_sse2;
+        pixf->sad_x3[PIXEL_8x8]  = pixel_sad_x3_8x8_sse2;
+        pixf->sad_x3[PIXEL_8x4]  = pixel_sad_x3_8x4_sse2;
+        pixf->sad_x4[PIXEL_8x16] = pixel_sad_x4_8x16_sse2;
+        pixf->sad_x4[PIXEL_8x8]  = pixel_sad_x4_8x8_sse2;
+        pixf->sad_x4[PIXEL_8x4]  = pixel_sad_x4_8x4_sse2;
+    }
+    if( cpu&CPU_SSSE3 )
+    {
+        INIT4_NAME( sad_aligned, sad, _ssse3_aligned );
+        pixf->sad_aligned[PIXEL_4x4] = pixel_sad_4x4_ssse3;
+        pixf->sad_aligned[PIXEL_4x8] = pixel_sad_4x8_ssse3;
+        INIT7( sad, _ssse3 );
+        INIT7( sad_x3, _ssse3 );
+        INIT7( sad_x4, _ssse3 );
+        INIT_ADS( _ssse3 );
+        INIT6( satd, _ssse3 );
+        pixf->satd[PIXEL_4x16] = pixel_satd_4x16_ssse3;
+
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            INIT4( hadamard_ac, _ssse3 );
+        }
+        pixf->vsad = pixel_vsad_ssse3;
+        pixf->asd8 = pixel_asd8_ssse3;
+        pixf->intra_sad_x3_4x4  = intra_sad_x3_4x4_ssse3;
+        pixf->sa8d[PIXEL_16x16]= pixel_sa8d_16x16_ssse3;
+        pixf->sa8d[PIXEL_8x8]  = pixel_sa8d_8x8_ssse3;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = pixel_sa8d_satd_16x16_ssse3;
+#endif
+        pixf->intra_sad_x3_4x4    = intra_sad_x3_4x4_ssse3;
+        pixf->intra_sad_x3_8x8    = intra_sad_x3_8x8_ssse3;
+        pixf->intra_sad_x3_8x8c   = intra_sad_x3_8x8c_ssse3;
+        pixf->intra_sad_x3_8x16c  = intra_sad_x3_8x16c_ssse3;
+        pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c_ssse3;
+        pixf->intra_sad_x3_16x16  = intra_sad_x3_16x16_ssse3;
+    }
+    if( cpu&CPU_SSE4 )
+    {
+        INIT6( satd, _sse4 );
+        pixf->satd[PIXEL_4x16] = pixel_satd_4x16_sse4;
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            INIT4( hadamard_ac, _sse4 );
+        }
+        pixf->sa8d[PIXEL_16x16]= pixel_sa8d_16x16_sse4;
+        pixf->sa8d[PIXEL_8x8]  = pixel_sa8d_8x8_sse4;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = pixel_sa8d_satd_16x16_sse4;
+#endif
+        pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c_sse4;
+    }
+    if( cpu&CPU_AVX )
+    {
+        INIT5_NAME( sad_aligned, sad, _ssse3 ); /* AVX-capable CPUs doesn't benefit from an aligned version */
+        INIT_ADS( _avx );
+        INIT6( satd, _avx );
+        pixf->satd[PIXEL_4x16] = pixel_satd_4x16_avx;
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            INIT4( hadamard_ac, _avx );
+        }
+        pixf->intra_sad_x3_4x4    = intra_sad_x3_4x4_avx;
+        pixf->sa8d[PIXEL_16x16]= pixel_sa8d_16x16_avx;
+        pixf->sa8d[PIXEL_8x8]  = pixel_sa8d_8x8_avx;
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_avx;
+        pixf->var[PIXEL_8x8]   = pixel_var_8x8_avx;
+        pixf->ssd_nv12_core    = pixel_ssd_nv12_core_avx;
+        pixf->ssim_4x4x2_core  = pixel_ssim_4x4x2_core_avx;
+        pixf->ssim_end4        = pixel_ssim_end4_avx;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = pixel_sa8d_satd_16x16_avx;
+#endif
+        pixf->intra_satd_x3_8x16c = intra_satd_x3_8x16c_avx;
+    }
+    if( cpu&CPU_XOP )
+    {
+        INIT5( sad_x3, _xop );
+        INIT5( sad_x4, _xop );
+        pixf->ssd_nv12_core    = pixel_ssd_nv12_core_xop;
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_xop;
+        pixf->var[PIXEL_8x8]   = pixel_var_8x8_xop;
+        pixf->vsad = pixel_vsad_xop;
+        pixf->asd8 = pixel_asd8_xop;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = pixel_sa8d_satd_16x16_xop;
+#endif
+    }
+    if( cpu&CPU_AVX2 )
+    {
+        INIT2( ssd, _avx2 );
+        INIT2( sad, _avx2 );
+        INIT2_NAME( sad_aligned, sad, _avx2 );
+        INIT2( sad_x3, _avx2 );
+        INIT2( sad_x4, _avx2 );
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_avx2;
+        pixf->vsad = pixel_vsad_avx2;
+        pixf->ssd_nv12_core = pixel_ssd_nv12_core_avx2;
+        pixf->intra_sad_x3_8x8 = intra_sad_x3_8x8_avx2;
+    }
+#endif // HAVE_MMX
+#else // !HIGH_BIT_DEPTH
+#if HAVE_MMX
+    if( cpu&CPU_MMX )
+    {
+        INIT8( ssd, _mmx, asm_ );
+    }
+
+    if( cpu&CPU_MMX2 )
+    {
+        INIT8( sad, _mmx2, asm_ );
+        INIT8_NAME( sad_aligned, sad, _mmx2, asm_ );
+        INIT7( sad_x3, _mmx2, asm_ );
+        INIT7( sad_x4, _mmx2, asm_ );
+        INIT8( satd, _mmx2, asm_ );
+        INIT7( satd_x3, _mmx2, asm_ );
+        INIT7( satd_x4, _mmx2, asm_ );
+        INIT4( hadamard_ac, _mmx2, asm_ );
+        INIT_ADS( _mmx2, asm_ );
+        pixf->var[PIXEL_16x16] = asm_pixel_var_16x16_mmx2;
+        pixf->var[PIXEL_8x16]  = asm_pixel_var_8x16_mmx2;
+        pixf->var[PIXEL_8x8]   = asm_pixel_var_8x8_mmx2;
+        pixf->ssd_nv12_core    = asm_pixel_ssd_nv12_core_mmx2;
+#if ARCH_X86
+        pixf->sa8d[PIXEL_16x16] = asm_pixel_sa8d_16x16_mmx2;
+        pixf->sa8d[PIXEL_8x8]   = asm_pixel_sa8d_8x8_mmx2;
+        pixf->intra_sa8d_x3_8x8 = asm_intra_sa8d_x3_8x8_mmx2;
+        pixf->ssim_4x4x2_core = asm_pixel_ssim_4x4x2_core_mmx2;
+        pixf->var2[PIXEL_8x8] = asm_pixel_var2_8x8_mmx2;
+        pixf->var2[PIXEL_8x16] = asm_pixel_var2_8x16_mmx2;
+        pixf->vsad = asm_pixel_vsad_mmx2;
+
+        if( cpu&CPU_CACHELINE_32 )
+        {
+            INIT5( sad, _cache32_mmx2 );
+            INIT4( sad_x3, _cache32_mmx2 );
+            INIT4( sad_x4, _cache32_mmx2 );
+        }
+        else if( cpu&CPU_CACHELINE_64 && !(cpu&CPU_SLOW_ATOM) )
+        {
+            INIT5( sad, _cache64_mmx2 );
+            INIT4( sad_x3, _cache64_mmx2 );
+            INIT4( sad_x4, _cache64_mmx2 );
+        }
+#else
+        if( cpu&CPU_CACHELINE_64 && !(cpu&CPU_SLOW_ATOM) )
+        {
+            pixf->sad[PIXEL_8x16] = asm_pixel_sad_8x16_cache64_mmx2;
+            pixf->sad[PIXEL_8x8]  = asm_pixel_sad_8x8_cache64_mmx2;
+            pixf->sad[PIXEL_8x4]  = asm_pixel_sad_8x4_cache64_mmx2;
+            pixf->sad_x3[PIXEL_8x16] = asm_pixel_sad_x3_8x16_cache64_mmx2;
+            pixf->sad_x3[PIXEL_8x8]  = asm_pixel_sad_x3_8x8_cache64_mmx2;
+            pixf->sad_x4[PIXEL_8x16] = asm_pixel_sad_x4_8x16_cache64_mmx2;
+            pixf->sad_x4[PIXEL_8x8]  = asm_pixel_sad_x4_8x8_cache64_mmx2;
+        }
+#endif
+        pixf->intra_satd_x3_16x16 = asm_intra_satd_x3_16x16_mmx2;
+        pixf->intra_sad_x3_16x16  = asm_intra_sad_x3_16x16_mmx2;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_mmx2;
+        pixf->intra_sad_x3_8x16c  = asm_intra_sad_x3_8x16c_mmx2;
+        pixf->intra_satd_x3_8x8c  = asm_intra_satd_x3_8x8c_mmx2;
+        pixf->intra_sad_x3_8x8c   = asm_intra_sad_x3_8x8c_mmx2;
+        pixf->intra_sad_x3_8x8    = asm_intra_sad_x3_8x8_mmx2;
+        pixf->intra_satd_x3_4x4   = asm_intra_satd_x3_4x4_mmx2;
+        pixf->intra_sad_x3_4x4    = asm_intra_sad_x3_4x4_mmx2;
+    }
+
+    if( cpu&CPU_SSE2 )
+    {
+        INIT5( ssd, _sse2slow, asm_ );
+        INIT2_NAME( sad_aligned, sad, _sse2_aligned, asm_ );
+        pixf->var[PIXEL_16x16] = asm_pixel_var_16x16_sse2;
+        pixf->ssd_nv12_core    = asm_pixel_ssd_nv12_core_sse2;
+        pixf->ssim_4x4x2_core  = asm_pixel_ssim_4x4x2_core_sse2;
+        pixf->ssim_end4        = asm_pixel_ssim_end4_sse2;
+        pixf->sa8d[PIXEL_16x16] = asm_pixel_sa8d_16x16_sse2;
+        pixf->sa8d[PIXEL_8x8]   = asm_pixel_sa8d_8x8_sse2;
+#if ARCH_X86_64
+        pixf->intra_sa8d_x3_8x8 = asm_intra_sa8d_x3_8x8_sse2;
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_sse2;
+#endif
+        pixf->var2[PIXEL_8x8]   = asm_pixel_var2_8x8_sse2;
+        pixf->var2[PIXEL_8x16]  = asm_pixel_var2_8x16_sse2;
+        pixf->vsad = asm_pixel_vsad_sse2;
+        pixf->asd8 = asm_pixel_asd8_sse2;
+    }
+
+    if( (cpu&CPU_SSE2) && !(cpu&CPU_SSE2_IS_SLOW) )
+    {
+        INIT2( sad, _sse2, asm_ );
+        INIT2( sad_x3, _sse2, asm_  );
+        INIT2( sad_x4, _sse2, asm_  );
+        INIT6( satd, _sse2, asm_  );
+        pixf->satd[PIXEL_4x16]   = asm_pixel_satd_4x16_sse2;
+        INIT6( satd_x3, _sse2, asm_  );
+        INIT6( satd_x4, _sse2, asm_  );
+        INIT4( hadamard_ac, _sse2, asm_  );
+        INIT_ADS( _sse2, asm_  );
+        pixf->var[PIXEL_8x8] = asm_pixel_var_8x8_sse2;
+        pixf->var[PIXEL_8x16] = asm_pixel_var_8x16_sse2;
+        pixf->intra_sad_x3_16x16 = asm_intra_sad_x3_16x16_sse2;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_sse2;
+        pixf->intra_sad_x3_8x16c  = asm_intra_sad_x3_8x16c_sse2;
+        if( cpu&CPU_CACHELINE_64 )
+        {
+            INIT2( ssd, _sse2, asm_); /* faster for width 16 on p4 */
+#if ARCH_X86
+            INIT2( sad, _cache64_sse2, asm_ );
+            INIT2( sad_x3, _cache64_sse2, asm_ );
+            INIT2( sad_x4, _cache64_sse2, asm_ );
+#endif
+           if( cpu&CPU_SSE2_IS_FAST )
+           {
+               pixf->sad_x3[PIXEL_8x16] = asm_pixel_sad_x3_8x16_cache64_sse2;
+               pixf->sad_x4[PIXEL_8x16] = asm_pixel_sad_x4_8x16_cache64_sse2;
+           }
+        }
+    }
+
+    if( cpu&CPU_SSE2_IS_FAST && !(cpu&CPU_CACHELINE_64) )
+    {
+        pixf->sad_aligned[PIXEL_8x16] = asm_pixel_sad_8x16_sse2;
+        pixf->sad[PIXEL_8x16] = asm_pixel_sad_8x16_sse2;
+        pixf->sad_x3[PIXEL_8x16] = asm_pixel_sad_x3_8x16_sse2;
+        pixf->sad_x3[PIXEL_8x8] = asm_pixel_sad_x3_8x8_sse2;
+        pixf->sad_x3[PIXEL_8x4] = asm_pixel_sad_x3_8x4_sse2;
+        pixf->sad_x4[PIXEL_8x16] = asm_pixel_sad_x4_8x16_sse2;
+        pixf->sad_x4[PIXEL_8x8] = asm_pixel_sad_x4_8x8_sse2;
+        pixf->sad_x4[PIXEL_8x4] = asm_pixel_sad_x4_8x4_sse2;
+    }
+
+    if( (cpu&CPU_SSE3) && (cpu&CPU_CACHELINE_64) )
+    {
+        INIT2( sad, _sse3, asm_ );
+        INIT2( sad_x3, _sse3, asm_ );
+        INIT2( sad_x4, _sse3, asm_ );
+    }
+
+    if( cpu&CPU_SSSE3 )
+    {
+        INIT4( hadamard_ac, _ssse3, asm_ );
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            pixf->intra_sad_x9_4x4  = asm_intra_sad_x9_4x4_ssse3;
+            pixf->intra_satd_x9_4x4 = asm_intra_satd_x9_4x4_ssse3;
+            pixf->intra_sad_x9_8x8  = asm_intra_sad_x9_8x8_ssse3;
+#if ARCH_X86_64
+            pixf->intra_sa8d_x9_8x8 = asm_intra_sa8d_x9_8x8_ssse3;
+#endif
+        }
+        INIT_ADS( _ssse3, asm_ );
+        if( cpu&CPU_SLOW_ATOM )
+        {
+            pixf->sa8d[PIXEL_16x16]= asm_pixel_sa8d_16x16_ssse3_atom;
+            pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_ssse3_atom;
+            INIT6( satd, _ssse3_atom, asm_ );
+            pixf->satd[PIXEL_4x16]  = asm_pixel_satd_4x16_ssse3_atom;
+            INIT6( satd_x3, _ssse3_atom, asm_ );
+            INIT6( satd_x4, _ssse3_atom, asm_ );
+            INIT4( hadamard_ac, _ssse3_atom, asm_ );
+#if ARCH_X86_64
+            pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_ssse3_atom;
+#endif
+        }
+        else
+        {
+            INIT8( ssd, _ssse3, asm_ );
+            pixf->sa8d[PIXEL_16x16]= asm_pixel_sa8d_16x16_ssse3;
+            pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_ssse3;
+            INIT8( satd, _ssse3, asm_ );
+            INIT7( satd_x3, _ssse3, asm_ );
+            INIT7( satd_x4, _ssse3, asm_ );
+#if ARCH_X86_64
+            pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_ssse3;
+#endif
+        }
+        pixf->intra_satd_x3_16x16 = asm_intra_satd_x3_16x16_ssse3;
+        if( !(cpu&CPU_SLOW_PSHUFB) )
+            pixf->intra_sad_x3_16x16  = asm_intra_sad_x3_16x16_ssse3;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_ssse3;
+        pixf->intra_satd_x3_8x8c  = asm_intra_satd_x3_8x8c_ssse3;
+        pixf->intra_sad_x3_8x8c   = asm_intra_sad_x3_8x8c_ssse3;
+        pixf->var2[PIXEL_8x8] = asm_pixel_var2_8x8_ssse3;
+        pixf->var2[PIXEL_8x16] = asm_pixel_var2_8x16_ssse3;
+        pixf->asd8 = asm_pixel_asd8_ssse3;
+        if( cpu&CPU_CACHELINE_64 )
+        {
+            INIT2( sad, _cache64_ssse3, asm_ );
+            INIT2( sad_x3, _cache64_ssse3, asm_ );
+            INIT2( sad_x4, _cache64_ssse3, asm_ );
+        }
+        else
+        {
+            INIT2( sad_x3, _ssse3, asm_ );
+            INIT5( sad_x4, _ssse3, asm_ );
+        }
+        if( (cpu&CPU_SLOW_ATOM) || (cpu&CPU_SLOW_SHUFFLE) )
+        {
+            INIT5( ssd, _sse2, asm_ ); /* on conroe, sse2 is faster for width8/16 */
+        }
+    }
 
+    if( cpu&CPU_SSE4 )
+    {
+        INIT8( satd, _sse4, asm_ );
+        INIT7( satd_x3, _sse4, asm_ );
+        INIT7( satd_x4, _sse4, asm_ );
+        INIT4( hadamard_ac, _sse4, asm_ );
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            pixf->intra_sad_x9_4x4  = asm_intra_sad_x9_4x4_sse4;
+            pixf->intra_satd_x9_4x4 = asm_intra_satd_x9_4x4_sse4;
+            pixf->intra_sad_x9_8x8  = asm_intra_sad_x9_8x8_sse4;
+#if ARCH_X86_64
+            pixf->intra_sa8d_x9_8x8 = asm_intra_sa8d_x9_8x8_sse4;
+#endif
+        }
+        pixf->sa8d[PIXEL_16x16]= asm_pixel_sa8d_16x16_sse4;
+        pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_sse4;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_sse4;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_sse4;
+#endif
+    }
+
+    if( cpu&CPU_AVX )
+    {
+        INIT2_NAME( sad_aligned, sad, _sse2, asm_ ); /* AVX-capable CPUs doesn't benefit from an aligned version */
+        INIT2( sad_x3, _avx, asm_ );
+        INIT2( sad_x4, _avx, asm_ );
+        INIT8( satd, _avx, asm_ );
+        INIT7( satd_x3, _avx, asm_ );
+        INIT7( satd_x4, _avx, asm_ );
+        INIT_ADS( _avx, asm_ );
+        INIT4( hadamard_ac, _avx, asm_ );
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            pixf->intra_sad_x9_4x4  = asm_intra_sad_x9_4x4_avx;
+            pixf->intra_satd_x9_4x4 = asm_intra_satd_x9_4x4_avx;
+            pixf->intra_sad_x9_8x8  = asm_intra_sad_x9_8x8_avx;
+#if ARCH_X86_64
+            pixf->intra_sa8d_x9_8x8 = asm_intra_sa8d_x9_8x8_avx;
+#endif
+        }
+        INIT5( ssd, _avx, asm_ );
+        pixf->sa8d[PIXEL_16x16]= asm_pixel_sa8d_16x16_avx;
+        pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_avx;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_avx;
+        pixf->ssd_nv12_core    = asm_pixel_ssd_nv12_core_avx;
+        pixf->var[PIXEL_16x16] = asm_pixel_var_16x16_avx;
+        pixf->var[PIXEL_8x16]  = asm_pixel_var_8x16_avx;
+        pixf->var[PIXEL_8x8]   = asm_pixel_var_8x8_avx;
+        pixf->ssim_4x4x2_core  = asm_pixel_ssim_4x4x2_core_avx;
+        pixf->ssim_end4        = asm_pixel_ssim_end4_avx;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_avx;
+#endif
+    }
 
+    if( cpu&CPU_XOP )
+    {
+        INIT7( satd, _xop, asm_ );
+        INIT7( satd_x3, _xop, asm_ );
+        INIT7( satd_x4, _xop, asm_ );
+        INIT4( hadamard_ac, _xop, asm_ );
+        if( !(cpu&CPU_STACK_MOD4) )
+        {
+            pixf->intra_satd_x9_4x4 = asm_intra_satd_x9_4x4_xop;
+        }
+        INIT5( ssd, _xop, asm_ );
+        pixf->sa8d[PIXEL_16x16]= asm_pixel_sa8d_16x16_xop;
+        pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_xop;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_xop;
+        pixf->ssd_nv12_core    = asm_pixel_ssd_nv12_core_xop;
+        pixf->var[PIXEL_16x16] = asm_pixel_var_16x16_xop;
+        pixf->var[PIXEL_8x16]  = asm_pixel_var_8x16_xop;
+        pixf->var[PIXEL_8x8]   = asm_pixel_var_8x8_xop;
+        pixf->var2[PIXEL_8x8] = asm_pixel_var2_8x8_xop;
+        pixf->var2[PIXEL_8x16] = asm_pixel_var2_8x16_xop;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_xop;
+#endif
+    }
 
+    if( cpu&CPU_AVX2 )
+    {
+        INIT2( ssd, _avx2, asm_ );
+        INIT2( sad_x3, _avx2, asm_ );
+        INIT2( sad_x4, _avx2, asm_ );
+        INIT4( satd, _avx2, asm_ );
+        INIT2( hadamard_ac, _avx2, asm_ );
+        INIT_ADS( _avx2, asm_ );
+        pixf->sa8d[PIXEL_8x8]  = asm_pixel_sa8d_8x8_avx2;
+        pixf->var[PIXEL_16x16] = asm_pixel_var_16x16_avx2;
+        pixf->var2[PIXEL_8x16]  = asm_pixel_var2_8x16_avx2;
+        pixf->var2[PIXEL_8x8]   = asm_pixel_var2_8x8_avx2;
+        pixf->intra_sad_x3_16x16 = asm_intra_sad_x3_16x16_avx2;
+        pixf->intra_sad_x9_8x8  = asm_intra_sad_x9_8x8_avx2;
+        pixf->intra_sad_x3_8x8c = asm_intra_sad_x3_8x8c_avx2;
+        pixf->ssd_nv12_core = asm_pixel_ssd_nv12_core_avx2;
+#if ARCH_X86_64
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_avx2;
+#endif
+    }
+
+#if ARCH_X86_64
+    if( cpu&CPU_AVX512 )
+    {
+        INIT4( sad_x4, _avx512, asm_ );
+        INIT4( satd, _avx512, asm_ );
+        pixf->sa8d[PIXEL_16x16] = asm_pixel_sa8d_16x16_avx512;
+        pixf->sa8d[PIXEL_8x8]   = asm_pixel_sa8d_8x8_avx512;
+    }
+#endif
+#endif //HAVE_MMX
+
+#if HAVE_ARMV6
+    if( cpu&CPU_ARMV6 )
+    {
+        pixf->sad[PIXEL_4x8] = asm_pixel_sad_4x8_armv6;
+        pixf->sad[PIXEL_4x4] = asm_pixel_sad_4x4_armv6;
+        pixf->sad_aligned[PIXEL_4x8] = asm_pixel_sad_4x8_armv6;
+        pixf->sad_aligned[PIXEL_4x4] = asm_pixel_sad_4x4_armv6;
+    }
+    if( cpu&CPU_NEON )
+    {
+        INIT5( sad, _neon, asm_ );
+        INIT5( sad_aligned, _neon, asm_ );
+        INIT7( sad_x3, _neon, asm_ );
+        INIT7( sad_x4, _neon, asm_ );
+        INIT7( ssd, _neon, asm_ );
+        INIT7( satd, _neon, asm_ );
+        INIT7( satd_x3, _neon, asm_ );
+        INIT7( satd_x4, _neon, asm_ );
+        INIT4( hadamard_ac, _neon, asm_ );
+        pixf->sa8d[PIXEL_8x8]   = asm_pixel_sa8d_8x8_neon;
+        pixf->sa8d[PIXEL_16x16] = asm_pixel_sa8d_16x16_neon;
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_neon;
+        pixf->var[PIXEL_8x8]    = asm_pixel_var_8x8_neon;
+        pixf->var[PIXEL_8x16]   = asm_pixel_var_8x16_neon;
+        pixf->var[PIXEL_16x16]  = asm_pixel_var_16x16_neon;
+        pixf->var2[PIXEL_8x8]   = asm_pixel_var2_8x8_neon;
+        pixf->var2[PIXEL_8x16]  = asm_pixel_var2_8x16_neon;
+        pixf->vsad = pixel_vsad_neon;
+        pixf->asd8 = pixel_asd8_neon;
+
+        pixf->intra_sad_x3_4x4    = asm_intra_sad_x3_4x4_neon;
+        pixf->intra_satd_x3_4x4   = asm_intra_satd_x3_4x4_neon;
+        pixf->intra_sad_x3_8x8    = asm_intra_sad_x3_8x8_neon;
+        pixf->intra_sa8d_x3_8x8   = asm_intra_sa8d_x3_8x8_neon;
+        pixf->intra_sad_x3_8x8c   = asm_intra_sad_x3_8x8c_neon;
+        pixf->intra_satd_x3_8x8c  = asm_intra_satd_x3_8x8c_neon;
+        pixf->intra_sad_x3_8x16c  = asm_intra_sad_x3_8x16c_neon;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_neon;
+        pixf->intra_sad_x3_16x16  = asm_intra_sad_x3_16x16_neon;
+        pixf->intra_satd_x3_16x16 = asm_intra_satd_x3_16x16_neon;
+
+        pixf->ssd_nv12_core     = asm_pixel_ssd_nv12_core_neon;
+        pixf->ssim_4x4x2_core   = asm_pixel_ssim_4x4x2_core_neon;
+        pixf->ssim_end4         = asm_pixel_ssim_end4_neon;
+
+        if( cpu&CPU_FAST_NEON_MRC )
+        {
+            pixf->sad[PIXEL_4x8] = asm_pixel_sad_4x8_neon;
+            pixf->sad[PIXEL_4x4] = asm_pixel_sad_4x4_neon;
+            pixf->sad_aligned[PIXEL_4x8] = asm_pixel_sad_aligned_4x8_neon;
+            pixf->sad_aligned[PIXEL_4x4] = asm_pixel_sad_aligned_4x4_neon;
+        }
+        else    // really just scheduled for dual issue / A8
+        {
+            INIT5( sad_aligned, _neon_dual );
+        }
+    }
+#endif
+
+#if ARCH_AARCH64
+    if( cpu&CPU_NEON )
+    {
+        INIT8( sad, _neon, asm_ );
+        // AArch64 has no distinct instructions for aligned load/store
+        INIT8_NAME( sad_aligned, sad, _neon, asm_ );
+        INIT7( sad_x3, _neon, asm_ );
+        INIT7( sad_x4, _neon, asm_ );
+        INIT8( ssd, _neon, asm_ );
+        INIT8( satd, _neon, asm_ );
+        INIT7( satd_x3, _neon, asm_ );
+        INIT7( satd_x4, _neon, asm_ );
+        INIT4( hadamard_ac, _neon, asm_ );
+
+        pixf->sa8d[PIXEL_8x8]   = asm_pixel_sa8d_8x8_neon;
+        pixf->sa8d[PIXEL_16x16] = asm_pixel_sa8d_16x16_neon;
+        pixf->sa8d_satd[PIXEL_16x16] = asm_pixel_sa8d_satd_16x16_neon;
+
+        pixf->var[PIXEL_8x8]    = asm_pixel_var_8x8_neon;
+        pixf->var[PIXEL_8x16]   = asm_pixel_var_8x16_neon;
+        pixf->var[PIXEL_16x16]  = asm_pixel_var_16x16_neon;
+        pixf->var2[PIXEL_8x8]   = asm_pixel_var2_8x8_neon;
+        pixf->var2[PIXEL_8x16]  = asm_pixel_var2_8x16_neon;
+        pixf->vsad = asm_pixel_vsad_neon;
+        pixf->asd8 = asm_pixel_asd8_neon;
+
+        pixf->intra_sad_x3_4x4    = asm_intra_sad_x3_4x4_neon;
+        pixf->intra_satd_x3_4x4   = asm_intra_satd_x3_4x4_neon;
+        pixf->intra_sad_x3_8x8    = intra_sad_x3_8x8_neon;
+        pixf->intra_sa8d_x3_8x8   = intra_sa8d_x3_8x8_neon;
+        pixf->intra_sad_x3_8x8c   = asm_intra_sad_x3_8x8c_neon;
+        pixf->intra_satd_x3_8x8c  = asm_intra_satd_x3_8x8c_neon;
+        pixf->intra_sad_x3_8x16c  = asm_intra_sad_x3_8x16c_neon;
+        pixf->intra_satd_x3_8x16c = asm_intra_satd_x3_8x16c_neon;
+        pixf->intra_sad_x3_16x16  = asm_intra_sad_x3_16x16_neon;
+        pixf->intra_satd_x3_16x16 = asm_intra_satd_x3_16x16_neon;
+
+        pixf->ssd_nv12_core     = asm_pixel_ssd_nv12_core_neon;
+        pixf->ssim_4x4x2_core   = asm_pixel_ssim_4x4x2_core_neon;
+        pixf->ssim_end4         = asm_pixel_ssim_end4_neon;
+    }
+#endif // ARCH_AARCH64
+
+#if HAVE_MSA
+    if( cpu&CPU_MSA )
+    {
+        INIT8( sad, _msa, asm_ );
+        INIT8_NAME( sad_aligned, sad, _msa, asm_ );
+        INIT8( ssd, _msa, asm_ );
+        INIT7( sad_x3, _msa, asm_ );
+        INIT7( sad_x4, _msa, asm_ );
+        INIT8( satd, _msa, asm_ );
+        INIT4( hadamard_ac, _msa, asm_ );
+
+        pixf->intra_sad_x3_4x4   = intra_sad_x3_4x4_msa;
+        pixf->intra_sad_x3_8x8   = intra_sad_x3_8x8_msa;
+        pixf->intra_sad_x3_8x8c  = intra_sad_x3_8x8c_msa;
+        pixf->intra_sad_x3_16x16 = intra_sad_x3_16x16_msa;
+        pixf->intra_satd_x3_4x4   = intra_satd_x3_4x4_msa;
+        pixf->intra_satd_x3_16x16 = intra_satd_x3_16x16_msa;
+        pixf->intra_satd_x3_8x8c  = intra_satd_x3_8x8c_msa;
+        pixf->intra_sa8d_x3_8x8   = intra_sa8d_x3_8x8_msa;
+
+        pixf->ssim_4x4x2_core = ssim_4x4x2_core_msa;
+
+        pixf->var[PIXEL_16x16] = pixel_var_16x16_msa;
+        pixf->var[PIXEL_8x16]  = pixel_var_8x16_msa;
+        pixf->var[PIXEL_8x8]   = pixel_var_8x8_msa;
+        pixf->var2[PIXEL_8x16]  = pixel_var2_8x16_msa;
+        pixf->var2[PIXEL_8x8]   = pixel_var2_8x8_msa;
+        pixf->sa8d[PIXEL_16x16] = pixel_sa8d_16x16;
+        pixf->sa8d[PIXEL_8x8]   = pixel_sa8d_8x8;
+    }
+#endif // HAVE_MSA
+
+#endif // HIGH_BIT_DEPTH
+#if HAVE_ALTIVEC
+    if( cpu&CPU_ALTIVEC )
+    {
+        pixel_altivec_init( pixf );
+    }
+#endif
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+    if( cpu&CPU_VEXT )
+        vbench_pixel_init_vext( pixf );
+#endif
+
+    pixf->ads[PIXEL_8x16] =
+    pixf->ads[PIXEL_8x4] =
+    pixf->ads[PIXEL_4x8] = pixf->ads[PIXEL_16x8];
+    pixf->ads[PIXEL_4x4] = pixf->ads[PIXEL_8x8];
+}
+
+
+/****************************************************************************
+ * static dispatch: the kernels above called by name, n times in a loop the
+ * compiler sees whole, against the calls through vbench_pixel_function_t.
+ * The empty asm hides that the blocks are the same every time round, or
+ * the kernel would be computed once for all n.
+ ****************************************************************************/
+#define PIXEL_STATIC( name, size ) \
+int vbench_static_##name##_##size( int n, pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )\
+{\
+    int sum = 0;\
+    for( int i = 0; i < n; i++ )\
+    {\
+        asm volatile( "" : "+r"(pix1), "+r"(pix2) );\
+        sum += pixel_##name##_##size( pix1, i_pix1, pix2, i_pix2 );\
+    }\
+    return sum;\
+}
 
+#define PIXEL_STATIC_SIZES( name ) \
+PIXEL_STATIC( name, 16x16 )\
+PIXEL_STATIC( name, 16x8 )\
+PIXEL_STATIC( name, 8x16 )\
+PIXEL_STATIC( name, 8x8 )\
+PIXEL_STATIC( name, 8x4 )\
+PIXEL_STATIC( name, 4x8 )\
+PIXEL_STATIC( name, 4x4 )\
+PIXEL_STATIC( name, 4x16 )
+
+PIXEL_STATIC_SIZES( sad )
+PIXEL_STATIC_SIZES( ssd )
+PIXEL_STATIC_SIZES( satd )
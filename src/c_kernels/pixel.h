@@ -149,6 +149,9 @@ SATD_XD_DECL7( _sse4, asm_ )
 SATD_XD_DECL7( _avx, asm_ )
 SATD_XD_DECL7( _xop, asm_ )
 #endif
+#if ARCH_AARCH64
+SATD_XD_DECL7( _neon, asm_ )
+#endif
 
 
 #define HADAMARD_ACD(w,h) \
@@ -279,6 +282,7 @@ SATD_X_DECL7_10BD()
     DECL_X4( sad, xop, asm_ )
     DECL_X4( sad, avx, asm_ )
     DECL_X4( sad, avx2, asm_ )
+    DECL_X4( sad, avx512, asm_ )
     DECL_X1( ssd, mmx, asm_ )
     DECL_X1( ssd, mmx2, asm_ )
     DECL_X1( ssd, sse2slow, asm_ )
@@ -295,6 +299,7 @@ SATD_X_DECL7_10BD()
     DECL_X1( satd, avx, asm_ )
     DECL_X1( satd, xop, asm_ )
     DECL_X1( satd, avx2, asm_ )
+    DECL_X1( satd, avx512, asm_ )
     DECL_X1( sa8d, mmx2, asm_ )
     DECL_X1( sa8d, sse2, asm_ )
     DECL_X1( sa8d, ssse3, asm_ )
@@ -303,6 +308,7 @@ SATD_X_DECL7_10BD()
     DECL_X1( sa8d, avx, asm_ )
     DECL_X1( sa8d, xop, asm_ )
     DECL_X1( sa8d, avx2, asm_ )
+    DECL_X1( sa8d, avx512, asm_ )
     DECL_X1( sad, cache32_mmx2, asm_ );
     DECL_X1( sad, cache64_mmx2, asm_ );
     DECL_X1( sad, cache64_sse2, asm_ );
@@ -412,6 +418,14 @@ void pixel_ssd_nv12( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2,
 void pixel_ssd_nv12_10b( pixel_10b *pix1, intptr_t i_pix1, pixel_10b *pix2, intptr_t i_pix2,
                               int i_width, int i_height, uint64_t *ssd_u, uint64_t *ssd_v );
 
+/* Whole-plane metrics built on the pixf kernels, one call per plane. */
+uint64_t pixel_ssd_wxh( vbench_pixel_function_t *pf, pixel *pix1, intptr_t i_pix1,
+                        pixel *pix2, intptr_t i_pix2, int i_width, int i_height );
+float vbench_pixel_ssim_wxh( vbench_pixel_function_t *pf,
+                             pixel *pix1, intptr_t stride1,
+                             pixel *pix2, intptr_t stride2,
+                             int width, int height, void *buf, int *cnt );
+
 
 void asm_pixel_ssd_nv12_core_mmx2( pixel *pixuv1, intptr_t stride1,
             pixel *pixuv2, intptr_t stride2, int width,
@@ -505,5 +519,24 @@ int pixel_vsad_10b( pixel *src, intptr_t stride, int height );
 #undef DECL_X4
 #undef DECL_ADS
 
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf );
+
+/* static dispatch drivers: n runs of the C kernel of one size, inlined */
+#define PIXEL_STATIC_D( name, size ) \
+int vbench_static_##name##_##size( int n, pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 );
+
+#define PIXEL_STATIC_SIZES_D( name ) \
+PIXEL_STATIC_D( name, 16x16 )\
+PIXEL_STATIC_D( name, 16x8 )\
+PIXEL_STATIC_D( name, 8x16 )\
+PIXEL_STATIC_D( name, 8x8 )\
+PIXEL_STATIC_D( name, 8x4 )\
+PIXEL_STATIC_D( name, 4x8 )\
+PIXEL_STATIC_D( name, 4x4 )\
+PIXEL_STATIC_D( name, 4x16 )
+
+PIXEL_STATIC_SIZES_D( sad )
+PIXEL_STATIC_SIZES_D( ssd )
+PIXEL_STATIC_SIZES_D( satd )
 
 #endif /* PIXEL_H */
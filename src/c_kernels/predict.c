@@ -34,6 +34,10 @@
 #include "bench.h"
 #include "predict.h"
 #include "macroblock.h"
+#include "c_kernels/ccbuild.h"
+#if ARCH_AARCH64
+#   include "asm/aarch64/predict.h"
+#endif
 
 
 
@@ -909,8 +913,9 @@ static void vbench_predict_8x8_hu_c( pixel *src, pixel edge[36] )
  * Exported functions:
  ****************************************************************************/
 
-void vbench_predict_16x16_init( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_16x16_init( uint64_t cpu, vbench_predict_t pf[7] )
 {
+    CCBUILD_INIT( cpu, predict_16x16_init, 0, pf );
     pf[I_PRED_16x16_V ]     = vbench_predict_16x16_v_c;
     pf[I_PRED_16x16_H ]     = vbench_predict_16x16_h_c;
     pf[I_PRED_16x16_DC]     = vbench_predict_16x16_dc_c;
@@ -952,8 +957,9 @@ void vbench_predict_16x16_init( int cpu, vbench_predict_t pf[7] )
 #endif
 }
 
-void vbench_predict_8x8c_init( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_8x8c_init( uint64_t cpu, vbench_predict_t pf[7] )
 {
+    CCBUILD_INIT( cpu, predict_8x8c_init, 0, pf );
     pf[I_PRED_CHROMA_V ]     = vbench_predict_8x8c_v_c;
     pf[I_PRED_CHROMA_H ]     = vbench_predict_8x8c_h_c;
     pf[I_PRED_CHROMA_DC]     = vbench_predict_8x8c_dc_c;
@@ -989,8 +995,9 @@ void vbench_predict_8x8c_init( int cpu, vbench_predict_t pf[7] )
 #endif
 }
 
-void vbench_predict_8x16c_init( int cpu, vbench_predict_t pf[7] )
+void vbench_predict_8x16c_init( uint64_t cpu, vbench_predict_t pf[7] )
 {
+    CCBUILD_INIT( cpu, predict_8x16c_init, 0, pf );
     pf[I_PRED_CHROMA_V ]     = vbench_predict_8x16c_v_c;
     pf[I_PRED_CHROMA_H ]     = vbench_predict_8x16c_h_c;
     pf[I_PRED_CHROMA_DC]     = vbench_predict_8x16c_dc_c;
@@ -1012,8 +1019,9 @@ void vbench_predict_8x16c_init( int cpu, vbench_predict_t pf[7] )
 #endif
 }
 
-void vbench_predict_8x8_init( int cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter )
+void vbench_predict_8x8_init( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter )
 {
+    CCBUILD_INIT( cpu, predict_8x8_init, 0, pf, predict_filter );
     pf[I_PRED_8x8_V]      = vbench_predict_8x8_v_c;
     pf[I_PRED_8x8_H]      = vbench_predict_8x8_h_c;
     pf[I_PRED_8x8_DC]     = vbench_predict_8x8_dc_c;
@@ -1050,8 +1058,9 @@ void vbench_predict_8x8_init( int cpu, vbench_predict8x8_t pf[12], vbench_predic
 #endif
 }
 
-void vbench_predict_4x4_init( int cpu, vbench_predict_t pf[12] )
+void vbench_predict_4x4_init( uint64_t cpu, vbench_predict_t pf[12] )
 {
+    CCBUILD_INIT( cpu, predict_4x4_init, 0, pf );
     pf[I_PRED_4x4_V]      = vbench_predict_4x4_v_c;
     pf[I_PRED_4x4_H]      = vbench_predict_4x4_h_c;
     pf[I_PRED_4x4_DC]     = vbench_predict_4x4_dc_c;
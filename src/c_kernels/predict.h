@@ -128,19 +128,19 @@ void vbench_predict_8x16c_h_c ( pixel *src );
 void vbench_predict_8x16c_v_c ( pixel *src );
 void vbench_predict_8x16c_p_c ( pixel *src );
 
-void vbench_predict_16x16_init ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_8x8c_init  ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_8x16c_init ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_4x4_init   ( int cpu, vbench_predict_t pf[12] );
-void vbench_predict_8x8_init   ( int cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter );
+void vbench_predict_16x16_init ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x8c_init  ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x16c_init ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_4x4_init   ( uint64_t cpu, vbench_predict_t pf[12] );
+void vbench_predict_8x8_init   ( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_filter );
 
 
 #if HAVE_MMX
-void vbench_predict_16x16_init_mmx ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_8x16c_init_mmx  ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_8x8c_init_mmx  ( int cpu, vbench_predict_t pf[7] );
-void vbench_predict_4x4_init_mmx   ( int cpu, vbench_predict_t pf[12] );
-void vbench_predict_8x8_init_mmx   ( int cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_8x8_filter );
+void vbench_predict_16x16_init_mmx ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x16c_init_mmx  ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_8x8c_init_mmx  ( uint64_t cpu, vbench_predict_t pf[7] );
+void vbench_predict_4x4_init_mmx   ( uint64_t cpu, vbench_predict_t pf[12] );
+void vbench_predict_8x8_init_mmx   ( uint64_t cpu, vbench_predict8x8_t pf[12], vbench_predict_8x8_filter_t *predict_8x8_filter );
 
 void asm_predict_16x16_v_mmx2( pixel *src );
 void asm_predict_16x16_v_sse ( pixel *src );
@@ -31,6 +31,8 @@
 #include "common.h"
 #include "bench.h"
 #include "macroblock.h"
+#include "c_kernels/ccbuild.h"
+#include "c_kernels/vext.h"
 
 #if HAVE_MMX
 #include "asm/x86/quant.h"
@@ -42,7 +44,7 @@
 #   include "arm/quant.h"
 #endif
 #if ARCH_AARCH64
-#   include "aarch64/quant.h"
+#   include "asm/aarch64/quant.h"
 #endif
 #if ARCH_MIPS
 #   include "mips/quant.h"
@@ -436,8 +438,9 @@ level_run(16)
 #define INIT_TRELLIS(...)
 #endif
 
-void vbench_quant_init(int i_cqm_preset, int cpu, vbench_quant_function_t *pf )
+void vbench_quant_init(int i_cqm_preset, uint64_t cpu, vbench_quant_function_t *pf )
 {
+    CCBUILD_INIT( cpu, quant_init, i_cqm_preset, 0, pf );
     pf->quant_8x8 = quant_8x8;
     pf->quant_4x4 = quant_4x4;
     pf->quant_4x4x4 = quant_4x4x4;
@@ -732,6 +735,11 @@ void vbench_quant_init(int i_cqm_preset, int cpu, vbench_quant_function_t *pf )
             pf->coeff_level_run[DCT_LUMA_4x4] = asm_coeff_level_run16_avx2_lzcnt;
         }
     }
+
+#if ARCH_X86_64
+    if( cpu&CPU_AVX512 )
+        pf->quant_4x4x4 = asm_quant_4x4x4_avx512;
+#endif
 #endif // HAVE_MMX
 
 #if HAVE_ALTIVEC
@@ -804,6 +812,10 @@ void vbench_quant_init(int i_cqm_preset, int cpu, vbench_quant_function_t *pf )
     }
 #endif
 #endif // HIGH_BIT_DEPTH
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+    if( cpu&CPU_VEXT )
+        vbench_quant_init_vext( pf );
+#endif
     pf->coeff_last[DCT_LUMA_DC]     = pf->coeff_last[DCT_CHROMAU_DC]  = pf->coeff_last[DCT_CHROMAV_DC] =
     pf->coeff_last[DCT_CHROMAU_4x4] = pf->coeff_last[DCT_CHROMAV_4x4] = pf->coeff_last[DCT_LUMA_4x4];
     pf->coeff_last[DCT_CHROMA_AC]   = pf->coeff_last[DCT_CHROMAU_AC]  =
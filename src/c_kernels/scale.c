@@ -0,0 +1,254 @@
+/*****************************************************************************
+ * scale.c: polyphase picture scaler
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/scale.h"
+
+typedef struct
+{
+    int i_width, i_height;
+    vbench_scale_filter_t h[2];     /* luma, chroma */
+    vbench_scale_filter_t v[2];
+    int16_t *ring;                  /* the last v[].i_taps rows out of scale_h */
+    intptr_t i_ring_stride;
+} scale_output_t;
+
+struct vbench_scaler_t
+{
+    vbench_mc_functions_t *mc;
+    int i_width, i_height;
+    int i_outputs;
+    scale_output_t out[SCALE_MAX_OUTPUTS];
+    int16_t **rows;
+};
+
+static const double scale_support[3] = { 1.0, 2.0, 3.0 };
+
+static double scale_kernel( int i_method, double t )
+{
+    t = fabs( t );
+    if( i_method == SCALE_BILINEAR )
+        return t < 1 ? 1 - t : 0;
+    if( i_method == SCALE_BICUBIC )
+    {
+        if( t < 1 )
+            return (1.5*t - 2.5)*t*t + 1;
+        if( t < 2 )
+            return ((-0.5*t + 2.5)*t - 4)*t + 2;
+        return 0;
+    }
+    if( t < 1e-8 )
+        return 1;
+    if( t >= 3 )
+        return 0;
+    return 3 * sin( M_PI*t ) * sin( M_PI*t/3 ) / (M_PI*M_PI*t*t);
+}
+
+/* The kernel is stretched by the ratio when downscaling so it low-passes
+ * the source.  Weights are normalized and quantized to i_bits with error
+ * diffusion, the rounding remainder goes to the largest tap so every
+ * output sums to exactly 1 << i_bits. */
+int vbench_scale_filter_init( vbench_scale_filter_t *f, int i_src, int i_dst, int i_method,
+                              int i_tap_align, int i_bits )
+{
+    double ratio = (double)i_src / i_dst;
+    double stretch = MAX( ratio, 1.0 );
+    double support = scale_support[i_method] * stretch;
+    int taps = ALIGN( (int)ceil( 2*support ), i_tap_align );
+    int n = ALIGN( i_dst, 16 );
+    int one = 1 << i_bits;
+    double *w;
+
+    memset( f, 0, sizeof(*f) );
+    if( i_dst <= 0 || i_src < i_tap_align )
+        return -1;
+    taps = MIN( taps, i_src & ~(i_tap_align-1) );
+    f->i_src = i_src;
+    f->i_dst = i_dst;
+    f->i_taps = taps;
+    f->pos = malloc( n * sizeof(int32_t) );
+    f->coef = calloc( n * taps, sizeof(int16_t) );
+    w = malloc( taps * sizeof(double) );
+    if( !f->pos || !f->coef || !w )
+    {
+        free( w );
+        vbench_scale_filter_free( f );
+        return -1;
+    }
+
+    for( int i = 0; i < i_dst; i++ )
+    {
+        double center = (i + 0.5) * ratio - 0.5;
+        int first = floor( center - support ) + 1;
+        int last = ceil( center + support ) - 1;
+        int start = vbench_clip3( first, 0, i_src - taps );
+        int16_t *coef = f->coef + i*taps;
+        double sum = 0, err = 0;
+        int isum = 0, jmax = 0;
+
+        for( int j = 0; j < taps; j++ )
+            w[j] = 0;
+        for( int k = first; k <= last; k++ )
+        {
+            int j = vbench_clip3( k, 0, i_src-1 ) - start;
+            w[vbench_clip3( j, 0, taps-1 )] += scale_kernel( i_method, (k - center) / stretch );
+        }
+        for( int j = 0; j < taps; j++ )
+            sum += w[j];
+        for( int j = 0; j < taps; j++ )
+        {
+            double v = w[j] / sum * one + err;
+            coef[j] = lrint( v );
+            err = v - coef[j];
+            isum += coef[j];
+            if( fabs( w[j] ) > fabs( w[jmax] ) )
+                jmax = j;
+        }
+        coef[jmax] += one - isum;
+        f->pos[i] = start;
+    }
+    for( int i = i_dst; i < n; i++ )
+        f->pos[i] = f->pos[i_dst-1];
+    free( w );
+    return 0;
+}
+
+void vbench_scale_filter_free( vbench_scale_filter_t *f )
+{
+    free( f->pos );
+    free( f->coef );
+    f->pos = NULL;
+    f->coef = NULL;
+}
+
+vbench_scaler_t *vbench_scaler_open( vbench_mc_functions_t *mc, int i_width, int i_height,
+                                     int i_outputs, const int (*dims)[2], int i_method )
+{
+    vbench_scaler_t *s;
+    int max_taps = 0;
+
+    if( i_outputs <= 0 || i_outputs > SCALE_MAX_OUTPUTS || (i_width | i_height) & 1 ||
+        i_method < SCALE_BILINEAR || i_method > SCALE_LANCZOS )
+        return NULL;
+    s = calloc( 1, sizeof(vbench_scaler_t) );
+    if( !s )
+        return NULL;
+    s->mc = mc;
+    s->i_width = i_width;
+    s->i_height = i_height;
+    s->i_outputs = i_outputs;
+    for( int o = 0; o < i_outputs; o++ )
+    {
+        scale_output_t *out = &s->out[o];
+        int taps;
+        out->i_width = dims[o][0];
+        out->i_height = dims[o][1];
+        if( (out->i_width | out->i_height) & 1 )
+            goto fail;
+        for( int c = 0; c < 2; c++ )
+            if( vbench_scale_filter_init( &out->h[c], i_width >> c, out->i_width >> c, i_method, 4, 14 ) ||
+                vbench_scale_filter_init( &out->v[c], i_height >> c, out->i_height >> c, i_method, 2, 12 ) )
+                goto fail;
+        taps = MAX( out->v[0].i_taps, out->v[1].i_taps );
+        max_taps = MAX( max_taps, taps );
+        out->i_ring_stride = ALIGN( out->i_width, 16 );
+        out->ring = memalign( 32, taps * out->i_ring_stride * sizeof(int16_t) );
+        if( !out->ring )
+            goto fail;
+        memset( out->ring, 0, taps * out->i_ring_stride * sizeof(int16_t) );
+    }
+    s->rows = malloc( max_taps * sizeof(int16_t*) );
+    if( !s->rows )
+        goto fail;
+    return s;
+fail:
+    vbench_scaler_close( s );
+    return NULL;
+}
+
+void vbench_scaler_close( vbench_scaler_t *s )
+{
+    if( !s )
+        return;
+    for( int o = 0; o < s->i_outputs; o++ )
+    {
+        for( int c = 0; c < 2; c++ )
+        {
+            vbench_scale_filter_free( &s->out[o].h[c] );
+            vbench_scale_filter_free( &s->out[o].v[c] );
+        }
+        free( s->out[o].ring );
+    }
+    free( s->rows );
+    free( s );
+}
+
+/* Source rows are visited once, in order.  Each output runs scale_h on
+ * the rows its remaining vertical windows need and emits every output row
+ * whose window ends on the current row, so one source row is filtered
+ * for all renditions while it is still in cache. */
+static void scaler_plane( vbench_scaler_t *s, int c, pixel *src, intptr_t i_src,
+                          pixel **dst, intptr_t *i_dst )
+{
+    int i_height = s->i_height >> c;
+    int next[SCALE_MAX_OUTPUTS] = {0};
+
+    for( int y = 0; y < i_height; y++ )
+        for( int o = 0; o < s->i_outputs; o++ )
+        {
+            scale_output_t *out = &s->out[o];
+            vbench_scale_filter_t *fh = &out->h[c];
+            vbench_scale_filter_t *fv = &out->v[c];
+            int oy = next[o];
+
+            if( oy == fv->i_dst || y < fv->pos[oy] )
+                continue;
+            s->mc->scale_h( out->ring + (y % fv->i_taps) * out->i_ring_stride, src + y*i_src,
+                            fh->pos, fh->coef, fh->i_taps, fh->i_dst );
+            for( ; oy < fv->i_dst && fv->pos[oy] + fv->i_taps - 1 == y; oy++ )
+            {
+                for( int j = 0; j < fv->i_taps; j++ )
+                    s->rows[j] = out->ring + ((fv->pos[oy] + j) % fv->i_taps) * out->i_ring_stride;
+                s->mc->scale_v( dst[o] + oy*i_dst[o], s->rows, fv->coef + oy*fv->i_taps, fv->i_taps, fh->i_dst );
+            }
+            next[o] = oy;
+        }
+}
+
+void vbench_scaler_frame( vbench_scaler_t *s, pixel *src[3], intptr_t i_src[3],
+                          pixel *dst[][3], intptr_t i_dst[][3] )
+{
+    pixel *plane[SCALE_MAX_OUTPUTS];
+    intptr_t stride[SCALE_MAX_OUTPUTS];
+
+    for( int p = 0; p < 3; p++ )
+    {
+        for( int o = 0; o < s->i_outputs; o++ )
+        {
+            plane[o] = dst[o][p];
+            stride[o] = i_dst[o][p];
+        }
+        scaler_plane( s, !!p, src[p], i_src[p], plane, stride );
+    }
+}
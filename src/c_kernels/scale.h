@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * scale.h: polyphase picture scaler
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef SCALE_H
+#define SCALE_H
+
+#define SCALE_MAX_OUTPUTS 8
+
+enum scale_method_e
+{
+    SCALE_BILINEAR = 0,
+    SCALE_BICUBIC  = 1,     /* Catmull-Rom */
+    SCALE_LANCZOS  = 2,     /* 3 lobes */
+};
+
+/* One axis of a separable filter.  Output i reads the i_taps source
+ * samples starting at pos[i] with weights coef[i*i_taps ...].  Windows
+ * are shifted to lie inside the source and weights that fall outside are
+ * folded onto the edge sample.  pos and coef are padded to a multiple of
+ * 16 outputs with zero weights so the SIMD passes can run past i_dst. */
+typedef struct
+{
+    int i_src, i_dst;
+    int i_taps;
+    int32_t *pos;
+    int16_t *coef;
+} vbench_scale_filter_t;
+
+int  vbench_scale_filter_init( vbench_scale_filter_t *f, int i_src, int i_dst, int i_method,
+                               int i_tap_align, int i_bits );
+void vbench_scale_filter_free( vbench_scale_filter_t *f );
+
+/* A ladder of 4:2:0 renditions of the same source.  vbench_scaler_frame
+ * reads every source row once and feeds it to all outputs that need it,
+ * each output keeping only a ring of horizontally scaled rows.  Output
+ * planes may be written up to 15 pixels past their width. */
+typedef struct vbench_scaler_t vbench_scaler_t;
+
+vbench_scaler_t *vbench_scaler_open( vbench_mc_functions_t *mc, int i_width, int i_height,
+                                     int i_outputs, const int (*dims)[2], int i_method );
+void vbench_scaler_frame( vbench_scaler_t *s, pixel *src[3], intptr_t i_src[3],
+                          pixel *dst[][3], intptr_t i_dst[][3] );
+void vbench_scaler_close( vbench_scaler_t *s );
+
+#endif
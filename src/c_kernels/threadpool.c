@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * threadpool.c: fork-join pool for the frame-level engines
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "osdep.h"
+#include "common.h"
+#include "c_kernels/threadpool.h"
+
+typedef struct
+{
+    vbench_threadpool_t *pool;
+    int i_thread;
+} threadpool_worker_t;
+
+struct vbench_threadpool_t
+{
+    int i_threads;
+    pthread_t thread[THREADPOOL_MAX_THREADS];
+    threadpool_worker_t worker[THREADPOOL_MAX_THREADS];
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cv_start;
+    pthread_cond_t cv_done;
+    int i_job;          /* generation, bumped by every run */
+    int i_pending;
+    int b_exit;
+    void (*func)( void *, int );
+    void *arg;
+};
+
+static void *threadpool_worker( void *arg )
+{
+    threadpool_worker_t *w = arg;
+    vbench_threadpool_t *pool = w->pool;
+    int i_job = 0;
+
+    for( ;; )
+    {
+        pthread_mutex_lock( &pool->mutex );
+        while( pool->i_job == i_job && !pool->b_exit )
+            pthread_cond_wait( &pool->cv_start, &pool->mutex );
+        if( pool->b_exit )
+        {
+            pthread_mutex_unlock( &pool->mutex );
+            break;
+        }
+        i_job = pool->i_job;
+        pthread_mutex_unlock( &pool->mutex );
+
+        pool->func( pool->arg, w->i_thread );
+
+        pthread_mutex_lock( &pool->mutex );
+        if( !--pool->i_pending )
+            pthread_cond_signal( &pool->cv_done );
+        pthread_mutex_unlock( &pool->mutex );
+    }
+    return NULL;
+}
+
+vbench_threadpool_t *vbench_threadpool_init( int i_threads )
+{
+    vbench_threadpool_t *pool = calloc( 1, sizeof(vbench_threadpool_t) );
+    if( !pool )
+        return NULL;
+    pool->i_threads = vbench_clip3( i_threads, 1, THREADPOOL_MAX_THREADS );
+    pthread_mutex_init( &pool->mutex, NULL );
+    pthread_cond_init( &pool->cv_start, NULL );
+    pthread_cond_init( &pool->cv_done, NULL );
+    for( int t = 1; t < pool->i_threads; t++ )
+    {
+        pool->worker[t].pool = pool;
+        pool->worker[t].i_thread = t;
+        if( pthread_create( &pool->thread[t], NULL, threadpool_worker, &pool->worker[t] ) )
+        {
+            pool->i_threads = t;
+            vbench_threadpool_delete( pool );
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+int vbench_threadpool_threads( vbench_threadpool_t *pool )
+{
+    return pool->i_threads;
+}
+
+void vbench_threadpool_run( vbench_threadpool_t *pool, void (*func)( void *arg, int i_thread ), void *arg )
+{
+    if( pool->i_threads > 1 )
+    {
+        pthread_mutex_lock( &pool->mutex );
+        pool->func = func;
+        pool->arg = arg;
+        pool->i_pending = pool->i_threads - 1;
+        pool->i_job++;
+        pthread_cond_broadcast( &pool->cv_start );
+        pthread_mutex_unlock( &pool->mutex );
+    }
+
+    func( arg, 0 );
+
+    if( pool->i_threads > 1 )
+    {
+        pthread_mutex_lock( &pool->mutex );
+        while( pool->i_pending )
+            pthread_cond_wait( &pool->cv_done, &pool->mutex );
+        pthread_mutex_unlock( &pool->mutex );
+    }
+}
+
+void vbench_threadpool_delete( vbench_threadpool_t *pool )
+{
+    if( !pool )
+        return;
+    pthread_mutex_lock( &pool->mutex );
+    pool->b_exit = 1;
+    pthread_cond_broadcast( &pool->cv_start );
+    pthread_mutex_unlock( &pool->mutex );
+    for( int t = 1; t < pool->i_threads; t++ )
+        pthread_join( pool->thread[t], NULL );
+    pthread_mutex_destroy( &pool->mutex );
+    pthread_cond_destroy( &pool->cv_start );
+    pthread_cond_destroy( &pool->cv_done );
+    free( pool );
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * threadpool.h: fork-join pool for the frame-level engines
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#define THREADPOOL_MAX_THREADS 64
+
+typedef struct vbench_threadpool_t vbench_threadpool_t;
+
+/* i_threads-1 persistent workers are created; the thread calling
+ * vbench_threadpool_run is the remaining one. */
+vbench_threadpool_t *vbench_threadpool_init( int i_threads );
+int  vbench_threadpool_threads( vbench_threadpool_t *pool );
+
+/* Run func( arg, t ) for every t in [0,i_threads) and return once all of
+ * them are done.  t = 0 runs on the calling thread. */
+void vbench_threadpool_run( vbench_threadpool_t *pool, void (*func)( void *arg, int i_thread ), void *arg );
+void vbench_threadpool_delete( vbench_threadpool_t *pool );
+
+#endif
@@ -0,0 +1,680 @@
+/*****************************************************************************
+ * vext.c: kernels written with generic vector extensions
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "c_kernels/vext.h"
+
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+
+typedef uint8_t  v8u8   __attribute__((vector_size(8)));
+typedef uint8_t  v16u8  __attribute__((vector_size(16)));
+typedef uint16_t v8u16  __attribute__((vector_size(16)));
+typedef int16_t  v8i16  __attribute__((vector_size(16)));
+typedef int16_t  v16i16 __attribute__((vector_size(32)));
+typedef int32_t  v4i32  __attribute__((vector_size(16)));
+typedef int32_t  v8i32  __attribute__((vector_size(32)));
+typedef int32_t  v16i32 __attribute__((vector_size(64)));
+
+/* Loads and stores go through memcpy: none of the pointers the kernels
+ * get are guaranteed to be aligned to the vector size. */
+static ALWAYS_INLINE v8i16 load8( const pixel *p )
+{
+    v8u8 v;
+    memcpy( &v, p, sizeof(v) );
+    return __builtin_convertvector( v, v8i16 );
+}
+
+static ALWAYS_INLINE v16i16 load16( const pixel *p )
+{
+    v16u8 v;
+    memcpy( &v, p, sizeof(v) );
+    return __builtin_convertvector( v, v16i16 );
+}
+
+/* Operators only, so these work on any signed vector type.  Comparisons
+ * give 0 or -1 per lane. */
+#define VABS( v )       (((v) ^ ((v) >> (8*sizeof((v)[0])-1))) - ((v) >> (8*sizeof((v)[0])-1)))
+#define VMIN( a, b )    ((a) ^ (((a) ^ (b)) & ((b) < (a))))
+#define VMAX( a, b )    ((a) ^ (((a) ^ (b)) & ((a) < (b))))
+#define VSEL( m, a, b ) (((a) & (m)) | ((b) & ~(m)))
+#define VCLIP3( v, lo, hi ) VMIN( VMAX( v, lo ), hi )
+
+#define VHADAMARD4( d0, d1, d2, d3, s0, s1, s2, s3 ) {\
+    __typeof__(s0) t0 = s0 + s1;\
+    __typeof__(s0) t1 = s0 - s1;\
+    __typeof__(s0) t2 = s2 + s3;\
+    __typeof__(s0) t3 = s2 - s3;\
+    d0 = t0 + t2;\
+    d2 = t0 - t2;\
+    d1 = t1 + t3;\
+    d3 = t1 - t3;\
+}
+
+/* Horizontal sums by halving, the compilers don't turn a loop over the
+ * lanes into this. */
+static ALWAYS_INLINE int hsum_v8i32( v8i32 v )
+{
+    v4i32 s = __builtin_shufflevector( v, v, 0, 1, 2, 3 ) + __builtin_shufflevector( v, v, 4, 5, 6, 7 );
+    s += __builtin_shufflevector( s, s, 2, 3, 0, 1 );
+    s += __builtin_shufflevector( s, s, 1, 0, 3, 2 );
+    return s[0];
+}
+
+static ALWAYS_INLINE int hsum8( v8i16 v )
+{
+    return hsum_v8i32( __builtin_convertvector( v, v8i32 ) );
+}
+
+static ALWAYS_INLINE int hsum16( v16i16 v )
+{
+    return hsum_v8i32( __builtin_convertvector( __builtin_shufflevector( v, v, 0, 1, 2, 3, 4, 5, 6, 7 ), v8i32 ) +
+                       __builtin_convertvector( __builtin_shufflevector( v, v, 8, 9, 10, 11, 12, 13, 14, 15 ), v8i32 ) );
+}
+
+static ALWAYS_INLINE int hsum32( v16i32 v )
+{
+    return hsum_v8i32( __builtin_shufflevector( v, v, 0, 1, 2, 3, 4, 5, 6, 7 ) +
+                       __builtin_shufflevector( v, v, 8, 9, 10, 11, 12, 13, 14, 15 ) );
+}
+
+static ALWAYS_INLINE v16u8 clip_pixel16( v16i16 v )
+{
+    const v16i16 zero = {0};
+    v = VCLIP3( v, zero, zero + PIXEL_MAX );
+    return __builtin_convertvector( v, v16u8 );
+}
+
+static ALWAYS_INLINE v8u8 clip_pixel8( v8i32 v )
+{
+    const v8i32 zero = {0};
+    v = VCLIP3( v, zero, zero + PIXEL_MAX );
+    return __builtin_convertvector( v, v8u8 );
+}
+
+/****************************************************************************
+ * pixel
+ ****************************************************************************/
+
+/* |a-b| of 16 pixels, and the sums of its pairs in 16 bits */
+static ALWAYS_INLINE v8u16 sad_pairs( v16u8 a, v16u8 b )
+{
+    v16u8 m = (v16u8)(a > b);
+    v8u16 d = (v8u16)(((a - b) & m) | ((b - a) & ~m));
+    return (d & 0xff) + (d >> 8);
+}
+
+/* 16 pixels of a 16 wide block, or 2 rows of an 8 wide one */
+static ALWAYS_INLINE v16u8 load16x1( const pixel *p, intptr_t stride )
+{
+    v16u8 v;
+    memcpy( &v, p, sizeof(v) );
+    return v;
+}
+
+static ALWAYS_INLINE v16u8 load8x2( const pixel *p, intptr_t stride )
+{
+    v16u8 v;
+    memcpy( &v, p, 8 );
+    memcpy( (uint8_t*)&v + 8, p+stride, 8 );
+    return v;
+}
+
+#define PIXEL_SAD_VEXT( w, h ) \
+static int pixel_sad_##w##x##h##_vext( pixel *pix1, intptr_t i_stride_pix1,\
+                                      pixel *pix2, intptr_t i_stride_pix2 )\
+{\
+    v8u16 sum = {0};\
+    for( int y = 0; y < h; y += 16/w )\
+    {\
+        if( w == 16 )\
+            sum += sad_pairs( load16x1( pix1, i_stride_pix1 ), load16x1( pix2, i_stride_pix2 ) );\
+        else\
+            sum += sad_pairs( load8x2( pix1, i_stride_pix1 ), load8x2( pix2, i_stride_pix2 ) );\
+        pix1 += (16/w) * i_stride_pix1;\
+        pix2 += (16/w) * i_stride_pix2;\
+    }\
+    return hsum_v8i32( __builtin_convertvector( sum, v8i32 ) );\
+}
+
+PIXEL_SAD_VEXT( 16, 16 )
+PIXEL_SAD_VEXT( 16, 8 )
+PIXEL_SAD_VEXT( 8, 16 )
+PIXEL_SAD_VEXT( 8, 8 )
+PIXEL_SAD_VEXT( 8, 4 )
+
+/* the squares don't fit in 16 bits */
+#define PIXEL_SSD_VEXT( w, h ) \
+static int pixel_ssd_##w##x##h##_vext( pixel *pix1, intptr_t i_stride_pix1,\
+                                      pixel *pix2, intptr_t i_stride_pix2 )\
+{\
+    v16i32 sum = {0};\
+    for( int y = 0; y < h; y += 16/w )\
+    {\
+        v16i16 d;\
+        if( w == 16 )\
+            d = load16( pix1 ) - load16( pix2 );\
+        else\
+            d = __builtin_shufflevector( load8( pix1 ) - load8( pix2 ),\
+                                         load8( pix1+i_stride_pix1 ) - load8( pix2+i_stride_pix2 ),\
+                                         0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );\
+        v16i32 d32 = __builtin_convertvector( d, v16i32 );\
+        sum += d32 * d32;\
+        pix1 += (16/w) * i_stride_pix1;\
+        pix2 += (16/w) * i_stride_pix2;\
+    }\
+    return hsum32( sum );\
+}
+
+PIXEL_SSD_VEXT( 16, 16 )
+PIXEL_SSD_VEXT( 16, 8 )
+PIXEL_SSD_VEXT( 8, 16 )
+PIXEL_SSD_VEXT( 8, 8 )
+PIXEL_SSD_VEXT( 8, 4 )
+
+/* One stage of a horizontal Hadamard: lanes i and i^s become their sum
+ * and difference. */
+static ALWAYS_INLINE v16i16 hbutterfly1( v16i16 v )
+{
+    v16i16 x = __builtin_shufflevector( v, v, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 );
+    return __builtin_shufflevector( v + x, x - v, 0, 17, 2, 19, 4, 21, 6, 23, 8, 25, 10, 27, 12, 29, 14, 31 );
+}
+
+static ALWAYS_INLINE v16i16 hbutterfly2( v16i16 v )
+{
+    v16i16 x = __builtin_shufflevector( v, v, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 );
+    return __builtin_shufflevector( v + x, x - v, 0, 1, 18, 19, 4, 5, 22, 23, 8, 9, 26, 27, 12, 13, 30, 31 );
+}
+
+static ALWAYS_INLINE v16i16 hbutterfly4( v16i16 v )
+{
+    v16i16 x = __builtin_shufflevector( v, v, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11 );
+    return __builtin_shufflevector( v + x, x - v, 0, 1, 2, 3, 20, 21, 22, 23, 8, 9, 10, 11, 28, 29, 30, 31 );
+}
+
+static ALWAYS_INLINE v16i16 hbutterfly8( v16i16 v )
+{
+    v16i16 x = __builtin_shufflevector( v, v, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7 );
+    return __builtin_shufflevector( v + x, x - v, 0, 1, 2, 3, 4, 5, 6, 7, 24, 25, 26, 27, 28, 29, 30, 31 );
+}
+
+/* two rows of an 8 wide block side by side */
+static ALWAYS_INLINE v16i16 diff8x2( pixel *pix1, pixel *pix2, intptr_t i_pix1, intptr_t i_pix2 )
+{
+    return __builtin_shufflevector( load8( pix1 ) - load8( pix2 ),
+                                    load8( pix1+i_pix1 ) - load8( pix2+i_pix2 ),
+                                    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+}
+
+/* The 4x4 Hadamards of four rows of 16 differences, as the sum per lane of
+ * the absolute coefficients.  Every coefficient is at most 16*PIXEL_MAX. */
+static ALWAYS_INLINE v16i32 satd_4rows( v16i16 d0, v16i16 d1, v16i16 d2, v16i16 d3 )
+{
+    v16i16 a0, a1, a2, a3;
+    VHADAMARD4( a0, a1, a2, a3, d0, d1, d2, d3 );
+    a0 = hbutterfly2( hbutterfly1( a0 ) );
+    a1 = hbutterfly2( hbutterfly1( a1 ) );
+    a2 = hbutterfly2( hbutterfly1( a2 ) );
+    a3 = hbutterfly2( hbutterfly1( a3 ) );
+    return __builtin_convertvector( VABS( a0 ) + VABS( a1 ) + VABS( a2 ) + VABS( a3 ), v16i32 );
+}
+
+/* The coefficients of a 4x4 Hadamard all have the parity of the sum of
+ * the block, so halving the total is the same as halving each 4x4. */
+static int pixel_satd_8x4_vext( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    v16i16 d[4];
+    for( int y = 0; y < 4; y++ )
+        d[y] = __builtin_shufflevector( load8( pix1+y*i_pix1 ) - load8( pix2+y*i_pix2 ), (v8i16){0},
+                                        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+    return hsum32( satd_4rows( d[0], d[1], d[2], d[3] ) ) >> 1;
+}
+
+#define PIXEL_SATD_VEXT( w, h ) \
+static int pixel_satd_##w##x##h##_vext( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )\
+{\
+    v16i32 sum = {0};\
+    if( w == 16 )\
+        for( int y = 0; y < h; y += 4 )\
+            sum += satd_4rows( load16( pix1+(y+0)*i_pix1 ) - load16( pix2+(y+0)*i_pix2 ),\
+                               load16( pix1+(y+1)*i_pix1 ) - load16( pix2+(y+1)*i_pix2 ),\
+                               load16( pix1+(y+2)*i_pix1 ) - load16( pix2+(y+2)*i_pix2 ),\
+                               load16( pix1+(y+3)*i_pix1 ) - load16( pix2+(y+3)*i_pix2 ) );\
+    else\
+        for( int y = 0; y < h; y += 8 )\
+            sum += satd_4rows( diff8x2( pix1+(y+0)*i_pix1, pix2+(y+0)*i_pix2, 4*i_pix1, 4*i_pix2 ),\
+                               diff8x2( pix1+(y+1)*i_pix1, pix2+(y+1)*i_pix2, 4*i_pix1, 4*i_pix2 ),\
+                               diff8x2( pix1+(y+2)*i_pix1, pix2+(y+2)*i_pix2, 4*i_pix1, 4*i_pix2 ),\
+                               diff8x2( pix1+(y+3)*i_pix1, pix2+(y+3)*i_pix2, 4*i_pix1, 4*i_pix2 ) );\
+    return hsum32( sum ) >> 1;\
+}
+
+PIXEL_SATD_VEXT( 16, 16 )
+PIXEL_SATD_VEXT( 16, 8 )
+PIXEL_SATD_VEXT( 8, 16 )
+PIXEL_SATD_VEXT( 8, 8 )
+
+/* Rows k and k+4 of the 8x8 share a vector: the vertical transform is a
+ * 4-point Hadamard across the vectors and a butterfly between the halves.
+ * The coefficients are at most 64*PIXEL_MAX, their sum needs 32 bits. */
+static ALWAYS_INLINE int sa8d_8x8_vext( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    v16i16 d0 = diff8x2( pix1+0*i_pix1, pix2+0*i_pix2, 4*i_pix1, 4*i_pix2 );
+    v16i16 d1 = diff8x2( pix1+1*i_pix1, pix2+1*i_pix2, 4*i_pix1, 4*i_pix2 );
+    v16i16 d2 = diff8x2( pix1+2*i_pix1, pix2+2*i_pix2, 4*i_pix1, 4*i_pix2 );
+    v16i16 d3 = diff8x2( pix1+3*i_pix1, pix2+3*i_pix2, 4*i_pix1, 4*i_pix2 );
+    v16i16 a[4];
+    VHADAMARD4( a[0], a[1], a[2], a[3], d0, d1, d2, d3 );
+    v16i32 sum = {0};
+    for( int i = 0; i < 4; i++ )
+    {
+        v16i16 v = hbutterfly4( hbutterfly2( hbutterfly1( hbutterfly8( a[i] ) ) ) );
+        sum += __builtin_convertvector( VABS( v ), v16i32 );
+    }
+    return hsum32( sum );
+}
+
+static int pixel_sa8d_8x8_vext( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    int sum = sa8d_8x8_vext( pix1, i_pix1, pix2, i_pix2 );
+    return (sum+2)>>2;
+}
+
+static int pixel_sa8d_16x16_vext( pixel *pix1, intptr_t i_pix1, pixel *pix2, intptr_t i_pix2 )
+{
+    int sum = sa8d_8x8_vext( pix1, i_pix1, pix2, i_pix2 )
+            + sa8d_8x8_vext( pix1+8, i_pix1, pix2+8, i_pix2 )
+            + sa8d_8x8_vext( pix1+8*i_pix1, i_pix1, pix2+8*i_pix2, i_pix2 )
+            + sa8d_8x8_vext( pix1+8+8*i_pix1, i_pix1, pix2+8+8*i_pix2, i_pix2 );
+    return (sum+2)>>2;
+}
+
+void vbench_pixel_init_vext( vbench_pixel_function_t *pixf )
+{
+#define INIT5_VEXT( name ) \
+    pixf->name[PIXEL_16x16] = pixel_##name##_16x16_vext;\
+    pixf->name[PIXEL_16x8]  = pixel_##name##_16x8_vext;\
+    pixf->name[PIXEL_8x16]  = pixel_##name##_8x16_vext;\
+    pixf->name[PIXEL_8x8]   = pixel_##name##_8x8_vext;\
+    pixf->name[PIXEL_8x4]   = pixel_##name##_8x4_vext;
+
+    INIT5_VEXT( sad );
+    INIT5_VEXT( ssd );
+    INIT5_VEXT( satd );
+    pixf->sa8d[PIXEL_16x16] = pixel_sa8d_16x16_vext;
+    pixf->sa8d[PIXEL_8x8]   = pixel_sa8d_8x8_vext;
+}
+
+/****************************************************************************
+ * dct
+ ****************************************************************************/
+
+/* Two 4x4 blocks side by side, one per half of each row vector: transpose
+ * both at once. */
+#define TRANSPOSE2x4x4( d0, d1, d2, d3, s0, s1, s2, s3 ) {\
+    __typeof__(s0) p01 = __builtin_shufflevector( s0, s1, 0, 8, 1, 9, 4, 12, 5, 13 );\
+    __typeof__(s0) q01 = __builtin_shufflevector( s0, s1, 2, 10, 3, 11, 6, 14, 7, 15 );\
+    __typeof__(s0) p23 = __builtin_shufflevector( s2, s3, 0, 8, 1, 9, 4, 12, 5, 13 );\
+    __typeof__(s0) q23 = __builtin_shufflevector( s2, s3, 2, 10, 3, 11, 6, 14, 7, 15 );\
+    d0 = __builtin_shufflevector( p01, p23, 0, 1, 8, 9, 4, 5, 12, 13 );\
+    d1 = __builtin_shufflevector( p01, p23, 2, 3, 10, 11, 6, 7, 14, 15 );\
+    d2 = __builtin_shufflevector( q01, q23, 0, 1, 8, 9, 4, 5, 12, 13 );\
+    d3 = __builtin_shufflevector( q01, q23, 2, 3, 10, 11, 6, 7, 14, 15 );\
+}
+
+#define DCT4_1D( d0, d1, d2, d3, s0, s1, s2, s3 ) {\
+    __typeof__(s0) s03 = s0 + s3;\
+    __typeof__(s0) s12 = s1 + s2;\
+    __typeof__(s0) d03 = s0 - s3;\
+    __typeof__(s0) d12 = s1 - s2;\
+    d0 =   s03 +   s12;\
+    d1 = 2*d03 +   d12;\
+    d2 =   s03 -   s12;\
+    d3 =   d03 - 2*d12;\
+}
+
+#define IDCT4_1D( d0, d1, d2, d3, s0, s1, s2, s3 ) {\
+    __typeof__(s0) s02 =  s0     +  s2;\
+    __typeof__(s0) d02 =  s0     -  s2;\
+    __typeof__(s0) s13 =  s1     + (s3>>1);\
+    __typeof__(s0) d13 = (s1>>1) -  s3;\
+    d0 = s02 + s13;\
+    d1 = d02 + d13;\
+    d2 = d02 - d13;\
+    d3 = s02 - s13;\
+}
+
+/* The transform has no rounding, so the vertical pass can go first: one
+ * transpose instead of two. */
+static void sub8x8_dct_vext( dctcoef dct[4][16], pixel *pix1, pixel *pix2 )
+{
+    for( int i = 0; i < 2; i++, pix1 += 4*FENC_STRIDE, pix2 += 4*FDEC_STRIDE )
+    {
+        v8i16 r0 = load8( pix1+0*FENC_STRIDE ) - load8( pix2+0*FDEC_STRIDE );
+        v8i16 r1 = load8( pix1+1*FENC_STRIDE ) - load8( pix2+1*FDEC_STRIDE );
+        v8i16 r2 = load8( pix1+2*FENC_STRIDE ) - load8( pix2+2*FDEC_STRIDE );
+        v8i16 r3 = load8( pix1+3*FENC_STRIDE ) - load8( pix2+3*FDEC_STRIDE );
+        v8i16 a0, a1, a2, a3, b0, b1, b2, b3;
+        DCT4_1D( a0, a1, a2, a3, r0, r1, r2, r3 );
+        TRANSPOSE2x4x4( b0, b1, b2, b3, a0, a1, a2, a3 );
+        DCT4_1D( a0, a1, a2, a3, b0, b1, b2, b3 );
+        /* a[h] holds coefficients h*4..h*4+3 of the left block, then of the right */
+        v8i16 l01 = __builtin_shufflevector( a0, a1, 0, 1, 2, 3, 8, 9, 10, 11 );
+        v8i16 l23 = __builtin_shufflevector( a2, a3, 0, 1, 2, 3, 8, 9, 10, 11 );
+        v8i16 r01 = __builtin_shufflevector( a0, a1, 4, 5, 6, 7, 12, 13, 14, 15 );
+        v8i16 r23 = __builtin_shufflevector( a2, a3, 4, 5, 6, 7, 12, 13, 14, 15 );
+        memcpy( &dct[2*i+0][0], &l01, sizeof(l01) );
+        memcpy( &dct[2*i+0][8], &l23, sizeof(l23) );
+        memcpy( &dct[2*i+1][0], &r01, sizeof(r01) );
+        memcpy( &dct[2*i+1][8], &r23, sizeof(r23) );
+    }
+}
+
+static void sub16x16_dct_vext( dctcoef dct[16][16], pixel *pix1, pixel *pix2 )
+{
+    sub8x8_dct_vext( &dct[ 0], &pix1[0], &pix2[0] );
+    sub8x8_dct_vext( &dct[ 4], &pix1[8], &pix2[8] );
+    sub8x8_dct_vext( &dct[ 8], &pix1[8*FENC_STRIDE+0], &pix2[8*FDEC_STRIDE+0] );
+    sub8x8_dct_vext( &dct[12], &pix1[8*FENC_STRIDE+8], &pix2[8*FDEC_STRIDE+8] );
+}
+
+/* The >>1 make the order of the passes matter: same order as the C, first
+ * pass in 16 bits like its tmp[], second in 32 like its locals. */
+static void add8x8_idct_vext( pixel *p_dst, dctcoef dct[4][16] )
+{
+    for( int i = 0; i < 2; i++ )
+    {
+        v8i16 l01, l23, r01, r23;
+        memcpy( &l01, &dct[2*i+0][0], sizeof(l01) );
+        memcpy( &l23, &dct[2*i+0][8], sizeof(l23) );
+        memcpy( &r01, &dct[2*i+1][0], sizeof(r01) );
+        memcpy( &r23, &dct[2*i+1][8], sizeof(r23) );
+        v8i16 s0 = __builtin_shufflevector( l01, r01, 0, 1, 2, 3, 8, 9, 10, 11 );
+        v8i16 s1 = __builtin_shufflevector( l01, r01, 4, 5, 6, 7, 12, 13, 14, 15 );
+        v8i16 s2 = __builtin_shufflevector( l23, r23, 0, 1, 2, 3, 8, 9, 10, 11 );
+        v8i16 s3 = __builtin_shufflevector( l23, r23, 4, 5, 6, 7, 12, 13, 14, 15 );
+        v8i16 a0, a1, a2, a3, b0, b1, b2, b3;
+        IDCT4_1D( a0, a1, a2, a3, s0, s1, s2, s3 );
+        TRANSPOSE2x4x4( b0, b1, b2, b3, a0, a1, a2, a3 );
+        v8i32 c[4];
+        IDCT4_1D( c[0], c[1], c[2], c[3],
+                  __builtin_convertvector( b0, v8i32 ), __builtin_convertvector( b1, v8i32 ),
+                  __builtin_convertvector( b2, v8i32 ), __builtin_convertvector( b3, v8i32 ) );
+        for( int y = 0; y < 4; y++, p_dst += FDEC_STRIDE )
+        {
+            v8i32 p = __builtin_convertvector( load8( p_dst ), v8i32 ) + ((c[y] + 32) >> 6);
+            v8u8 out = clip_pixel8( p );
+            memcpy( p_dst, &out, sizeof(out) );
+        }
+    }
+}
+
+static void add16x16_idct_vext( pixel *p_dst, dctcoef dct[16][16] )
+{
+    add8x8_idct_vext( &p_dst[0],               &dct[0] );
+    add8x8_idct_vext( &p_dst[8],               &dct[4] );
+    add8x8_idct_vext( &p_dst[8*FDEC_STRIDE+0], &dct[8] );
+    add8x8_idct_vext( &p_dst[8*FDEC_STRIDE+8], &dct[12] );
+}
+
+void vbench_dct_init_vext( vbench_dct_function_t *dctf )
+{
+    dctf->sub8x8_dct    = sub8x8_dct_vext;
+    dctf->sub16x16_dct  = sub16x16_dct_vext;
+    dctf->add8x8_idct   = add8x8_idct_vext;
+    dctf->add16x16_idct = add16x16_idct_vext;
+}
+
+/****************************************************************************
+ * quant
+ ****************************************************************************/
+
+/* QUANT_ONE of 8 coefficients in 32 bits, returning the coefficients as
+ * stored, so the nonzero flag is computed from the same values as the C. */
+static ALWAYS_INLINE v8i16 quant8_vext( dctcoef *dct, udctcoef *mf, udctcoef *bias )
+{
+    v8i16 c16;
+    v8u16 m16, f16;
+    memcpy( &c16, dct, sizeof(c16) );
+    memcpy( &m16, mf, sizeof(m16) );
+    memcpy( &f16, bias, sizeof(f16) );
+    v8i32 c = __builtin_convertvector( c16, v8i32 );
+    v8i32 neg = c <= 0;
+    v8i32 q = ((__builtin_convertvector( f16, v8i32 ) + VABS( c )) * __builtin_convertvector( m16, v8i32 )) >> 16;
+    c16 = __builtin_convertvector( (q ^ neg) - neg, v8i16 );
+    memcpy( dct, &c16, sizeof(c16) );
+    return c16;
+}
+
+static int quant_8x8_vext( dctcoef dct[64], udctcoef mf[64], udctcoef bias[64] )
+{
+    v8i16 nz = {0};
+    for( int i = 0; i < 64; i += 8 )
+        nz |= quant8_vext( dct+i, mf+i, bias+i );
+    return hsum8( nz != 0 ) != 0;
+}
+
+static int quant_4x4_vext( dctcoef dct[16], udctcoef mf[16], udctcoef bias[16] )
+{
+    v8i16 nz = quant8_vext( dct, mf, bias ) | quant8_vext( dct+8, mf+8, bias+8 );
+    return hsum8( nz != 0 ) != 0;
+}
+
+static int quant_4x4x4_vext( dctcoef dct[4][16], udctcoef mf[16], udctcoef bias[16] )
+{
+    int nza = 0;
+    for( int j = 0; j < 4; j++ )
+    {
+        v8i16 nz = quant8_vext( dct[j], mf, bias ) | quant8_vext( dct[j]+8, mf+8, bias+8 );
+        nza |= (hsum8( nz != 0 ) != 0)<<j;
+    }
+    return nza;
+}
+
+void vbench_quant_init_vext( vbench_quant_function_t *pf )
+{
+    pf->quant_8x8   = quant_8x8_vext;
+    pf->quant_4x4   = quant_4x4_vext;
+    pf->quant_4x4x4 = quant_4x4x4_vext;
+}
+
+/****************************************************************************
+ * mc
+ ****************************************************************************/
+
+#define TAPFILTER_VEXT( a, b, c, d, e, f ) ((a) + (f) - 5*((b) + (e)) + 20*((c) + (d)))
+
+/* 16 pixels at a time, the remainder of each pass in C.  The vertical and
+ * horizontal filters fit in 16 bits, the centre one, filtering the
+ * vertical output again, doesn't. */
+static void hpel_filter_vext( pixel *dsth, pixel *dstv, pixel *dstc, pixel *src,
+                              intptr_t stride, int width, int height, int16_t *buf )
+{
+    for( int y = 0; y < height; y++ )
+    {
+        int x = -2;
+        for( ; x + 16 <= width+3; x += 16 )
+        {
+            v16i16 v = TAPFILTER_VEXT( load16( src+x-2*stride ), load16( src+x-stride ), load16( src+x ),
+                                       load16( src+x+stride ), load16( src+x+2*stride ), load16( src+x+3*stride ) );
+            v16u8 out = clip_pixel16( (v + 16) >> 5 );
+            memcpy( dstv+x, &out, sizeof(out) );
+            memcpy( buf+x+2, &v, sizeof(v) );
+        }
+        for( ; x < width+3; x++ )
+        {
+            int v = TAPFILTER_VEXT( src[x-2*stride], src[x-stride], src[x],
+                                    src[x+stride], src[x+2*stride], src[x+3*stride] );
+            dstv[x] = vbench_clip_pixel( (v + 16) >> 5 );
+            buf[x+2] = v;
+        }
+        for( x = 0; x + 16 <= width; x += 16 )
+        {
+            v16i32 b[6];
+            for( int i = 0; i < 6; i++ )
+            {
+                v16i16 t;
+                memcpy( &t, buf+x+i, sizeof(t) );
+                b[i] = __builtin_convertvector( t, v16i32 );
+            }
+            v16i32 c = (TAPFILTER_VEXT( b[0], b[1], b[2], b[3], b[4], b[5] ) + 512) >> 10;
+            c = VCLIP3( c, (v16i32){0}, (v16i32){0} + PIXEL_MAX );
+            v16u8 out = __builtin_convertvector( c, v16u8 );
+            memcpy( dstc+x, &out, sizeof(out) );
+
+            v16i16 h = TAPFILTER_VEXT( load16( src+x-2 ), load16( src+x-1 ), load16( src+x ),
+                                       load16( src+x+1 ), load16( src+x+2 ), load16( src+x+3 ) );
+            out = clip_pixel16( (h + 16) >> 5 );
+            memcpy( dsth+x, &out, sizeof(out) );
+        }
+        for( ; x < width; x++ )
+        {
+            int c = TAPFILTER_VEXT( buf[x], buf[x+1], buf[x+2], buf[x+3], buf[x+4], buf[x+5] );
+            int h = TAPFILTER_VEXT( src[x-2], src[x-1], src[x], src[x+1], src[x+2], src[x+3] );
+            dstc[x] = vbench_clip_pixel( (c + 512) >> 10 );
+            dsth[x] = vbench_clip_pixel( (h + 16) >> 5 );
+        }
+        dsth += stride;
+        dstv += stride;
+        dstc += stride;
+        src += stride;
+    }
+}
+
+void vbench_mc_init_vext( vbench_mc_functions_t *pf )
+{
+    pf->hpel_filter = hpel_filter_vext;
+}
+
+/****************************************************************************
+ * deblock
+ ****************************************************************************/
+
+/* deblock_edge_luma_c on the 16 pixels of an edge, lane i using
+ * tc0[i>>2].  A negative tc0 leaves its 4 lanes alone. */
+static ALWAYS_INLINE void deblock_luma_vext( v16i16 *pp1, v16i16 *pp0, v16i16 *pq0, v16i16 *pq1,
+                                             v16i16 p2, v16i16 q2, int alpha, int beta, int8_t *tc0 )
+{
+    const v16i16 zero = {0};
+    v16i16 p1 = *pp1, p0 = *pp0, q0 = *pq0, q1 = *pq1;
+    v16i16 tc = { tc0[0], tc0[0], tc0[0], tc0[0], tc0[1], tc0[1], tc0[1], tc0[1],
+                  tc0[2], tc0[2], tc0[2], tc0[2], tc0[3], tc0[3], tc0[3], tc0[3] };
+    v16i16 vbeta = zero + (int16_t)beta;
+    v16i16 m = (tc >= 0) & (VABS( p0 - q0 ) < zero + (int16_t)alpha) & (VABS( p1 - p0 ) < vbeta) & (VABS( q1 - q0 ) < vbeta);
+    v16i16 ap = m & (VABS( p2 - p0 ) < vbeta);
+    v16i16 aq = m & (VABS( q2 - q0 ) < vbeta);
+    v16i16 avg = (p0 + q0 + 1) >> 1;
+    v16i16 np1 = p1 + VCLIP3( ((p2 + avg) >> 1) - p1, -tc, tc );
+    v16i16 nq1 = q1 + VCLIP3( ((q2 + avg) >> 1) - q1, -tc, tc );
+    tc = tc - ap - aq;
+    v16i16 delta = VCLIP3( (((q0 - p0) << 2) + (p1 - q1) + 4) >> 3, -tc, tc );
+    v16i16 maxv = zero + PIXEL_MAX;
+    *pp1 = VSEL( ap, np1, p1 );
+    *pq1 = VSEL( aq, nq1, q1 );
+    *pp0 = VSEL( m, VCLIP3( p0 + delta, zero, maxv ), p0 );
+    *pq0 = VSEL( m, VCLIP3( q0 - delta, zero, maxv ), q0 );
+}
+
+static void deblock_v_luma_vext( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 )
+{
+    v16i16 p1 = load16( pix-2*stride );
+    v16i16 p0 = load16( pix-1*stride );
+    v16i16 q0 = load16( pix );
+    v16i16 q1 = load16( pix+1*stride );
+    deblock_luma_vext( &p1, &p0, &q0, &q1, load16( pix-3*stride ), load16( pix+2*stride ), alpha, beta, tc0 );
+    v16u8 out;
+    out = __builtin_convertvector( p1, v16u8 ); memcpy( pix-2*stride, &out, sizeof(out) );
+    out = __builtin_convertvector( p0, v16u8 ); memcpy( pix-1*stride, &out, sizeof(out) );
+    out = __builtin_convertvector( q0, v16u8 ); memcpy( pix,          &out, sizeof(out) );
+    out = __builtin_convertvector( q1, v16u8 ); memcpy( pix+1*stride, &out, sizeof(out) );
+}
+
+/* The 8 pixels pix[-4..3] of 16 rows as 8 columns: interleave rows in
+ * pairs, then pairs of pairs and so on. */
+static ALWAYS_INLINE void transpose_16x8( v16u8 col[8], pixel *pix, intptr_t stride )
+{
+    v16u8 a[8], b[8], c[8];
+    for( int k = 0; k < 8; k++ )
+    {
+        v8u8 r0, r1;
+        memcpy( &r0, pix+(2*k+0)*stride-4, sizeof(r0) );
+        memcpy( &r1, pix+(2*k+1)*stride-4, sizeof(r1) );
+        a[k] = __builtin_shufflevector( r0, r1, 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15 );
+    }
+    /* b[2k], b[2k+1]: columns 0-3 and 4-7 of rows 4k..4k+3 */
+    for( int k = 0; k < 4; k++ )
+    {
+        b[2*k+0] = __builtin_shufflevector( a[2*k], a[2*k+1], 0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23 );
+        b[2*k+1] = __builtin_shufflevector( a[2*k], a[2*k+1], 8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31 );
+    }
+    /* c[4k+2h], c[4k+2h+1]: columns 4h, 4h+1 and 4h+2, 4h+3 of rows 8k..8k+7 */
+    for( int k = 0; k < 2; k++ )
+        for( int h = 0; h < 2; h++ )
+        {
+            c[4*k+2*h+0] = __builtin_shufflevector( b[4*k+h], b[4*k+2+h], 0, 1, 2, 3, 16, 17, 18, 19, 4, 5, 6, 7, 20, 21, 22, 23 );
+            c[4*k+2*h+1] = __builtin_shufflevector( b[4*k+h], b[4*k+2+h], 8, 9, 10, 11, 24, 25, 26, 27, 12, 13, 14, 15, 28, 29, 30, 31 );
+        }
+    for( int j = 0; j < 8; j += 2 )
+    {
+        col[j+0] = __builtin_shufflevector( c[j>>1], c[4+(j>>1)], 0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23 );
+        col[j+1] = __builtin_shufflevector( c[j>>1], c[4+(j>>1)], 8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31 );
+    }
+}
+
+/* and back, the 4 columns the filter changes into pix[-2..1] */
+static ALWAYS_INLINE void transpose_4x16( pixel *pix, intptr_t stride, v16u8 p1, v16u8 p0, v16u8 q0, v16u8 q1 )
+{
+    v16u8 e0 = __builtin_shufflevector( p1, p0, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23 );
+    v16u8 e1 = __builtin_shufflevector( p1, p0, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31 );
+    v16u8 f0 = __builtin_shufflevector( q0, q1, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23 );
+    v16u8 f1 = __builtin_shufflevector( q0, q1, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31 );
+    v16u8 g[4];
+    g[0] = __builtin_shufflevector( e0, f0, 0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23 );
+    g[1] = __builtin_shufflevector( e0, f0, 8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31 );
+    g[2] = __builtin_shufflevector( e1, f1, 0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23 );
+    g[3] = __builtin_shufflevector( e1, f1, 8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31 );
+    for( int y = 0; y < 16; y++ )
+        memcpy( pix+y*stride-2, (uint8_t*)&g[y>>2] + 4*(y&3), 4 );
+}
+
+static void deblock_h_luma_vext( pixel *pix, intptr_t stride, int alpha, int beta, int8_t *tc0 )
+{
+    v16u8 col[8];
+    transpose_16x8( col, pix, stride );
+    v16i16 p1 = __builtin_convertvector( col[2], v16i16 );
+    v16i16 p0 = __builtin_convertvector( col[3], v16i16 );
+    v16i16 q0 = __builtin_convertvector( col[4], v16i16 );
+    v16i16 q1 = __builtin_convertvector( col[5], v16i16 );
+    deblock_luma_vext( &p1, &p0, &q0, &q1, __builtin_convertvector( col[1], v16i16 ),
+                       __builtin_convertvector( col[6], v16i16 ), alpha, beta, tc0 );
+    transpose_4x16( pix, stride, __builtin_convertvector( p1, v16u8 ), __builtin_convertvector( p0, v16u8 ),
+                    __builtin_convertvector( q0, v16u8 ), __builtin_convertvector( q1, v16u8 ) );
+}
+
+void vbench_deblock_init_vext( vbench_deblock_function_t *pf )
+{
+    pf->deblock_luma[1] = deblock_v_luma_vext;
+    pf->deblock_luma[0] = deblock_h_luma_vext;
+}
+
+#endif // HAVE_VEXT && !HIGH_BIT_DEPTH
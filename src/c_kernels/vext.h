@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * vext.h: kernels written with generic vector extensions
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef VEXT_H
+#define VEXT_H
+
+/* One source for every architecture: the kernels use only the vector
+ * types, operators and __builtin_shufflevector / __builtin_convertvector
+ * of gcc and clang, and the compiler picks the instructions for the
+ * target (SSE2 or AVX2 on x86, NEON on AArch64).  They sit between the C
+ * and the asm, under CPU_VEXT, and give the same results as the C.
+ * 8-bit only. */
+#if HAVE_VEXT && !HIGH_BIT_DEPTH
+void vbench_pixel_init_vext( vbench_pixel_function_t *pixf );
+void vbench_dct_init_vext( vbench_dct_function_t *dctf );
+void vbench_quant_init_vext( vbench_quant_function_t *pf );
+void vbench_mc_init_vext( vbench_mc_functions_t *pf );
+void vbench_deblock_init_vext( vbench_deblock_function_t *pf );
+#endif
+
+#endif
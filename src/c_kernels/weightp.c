@@ -0,0 +1,345 @@
+/*****************************************************************************
+ * weightp.c: explicit weighted prediction analysis
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ * Copyright (C) 2004-2016 x264 project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include "osdep.h"
+#include "common.h"
+#include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/weightp.h"
+
+struct vbench_weightp_t
+{
+    vbench_pixel_function_t *pf;
+    vbench_mc_functions_t *mc;
+    int i_width, i_height;
+    int i_planes;                   /* 1 in 4:0:0, else 3 */
+
+    vbench_plane_t plane[2][3];
+    vbench_plane_t lowres[2][4];    /* fullpel, h, v, c */
+    vbench_plane_t out[3];
+    vbench_weightp_stats_t stats[2];
+
+    pixel *buf;                     /* 8x8 block weighted by the search */
+};
+
+void vbench_weightp_close( vbench_weightp_t *t )
+{
+    if( !t )
+        return;
+    for( int i = 0; i < 2; i++ )
+    {
+        for( int p = 0; p < 3; p++ )
+            vbench_plane_free( &t->plane[i][p] );
+        for( int p = 0; p < 4; p++ )
+            vbench_plane_free( &t->lowres[i][p] );
+    }
+    for( int p = 0; p < 3; p++ )
+        vbench_plane_free( &t->out[p] );
+    free( t->buf );
+    free( t );
+}
+
+vbench_weightp_t *vbench_weightp_open( vbench_pixel_function_t *pf, vbench_mc_functions_t *mc,
+                                       int i_width, int i_height, int i_csp )
+{
+    vbench_weightp_t *t;
+    int h_shift = i_csp == CHROMA_420 || i_csp == CHROMA_422;
+    int v_shift = i_csp == CHROMA_420;
+
+    if( i_width <= 0 || i_height <= 0 || (i_width&15) || (i_height&31) ||
+        i_csp < CHROMA_400 || i_csp > CHROMA_444 )
+        return NULL;
+    t = calloc( 1, sizeof(vbench_weightp_t) );
+    if( !t )
+        return NULL;
+    t->pf = pf;
+    t->mc = mc;
+    t->i_width = i_width;
+    t->i_height = i_height;
+    t->i_planes = i_csp ? 3 : 1;
+
+    /* frame_init_lowres_core reads one row and column past the picture,
+     * the SIMD versions a little more */
+    for( int i = 0; i < 2; i++ )
+    {
+        for( int p = 0; p < t->i_planes; p++ )
+            if( vbench_plane_alloc( &t->plane[i][p], i_width >> (p ? h_shift : 0), i_height >> (p ? v_shift : 0), 32, NULL ) )
+                goto fail;
+        for( int p = 0; p < 4; p++ )
+            if( vbench_plane_alloc( &t->lowres[i][p], i_width/2, i_height/2, 32, NULL ) )
+                goto fail;
+    }
+    for( int p = 0; p < t->i_planes; p++ )
+        if( vbench_plane_alloc( &t->out[p], i_width >> (p ? h_shift : 0), i_height >> (p ? v_shift : 0), 0, NULL ) )
+            goto fail;
+    t->buf = memalign( 64, 8*8 * sizeof(pixel) );
+    if( !t->buf )
+        goto fail;
+
+    for( int i = 0; i < 2; i++ )
+        for( int p = 0; p < t->i_planes; p++ )
+            memset( t->plane[i][p].buffer, 0, t->plane[i][p].i_stride * (t->plane[i][p].i_height + 64) * sizeof(pixel) );
+    return t;
+fail:
+    vbench_weightp_close( t );
+    return NULL;
+}
+
+pixel *vbench_weightp_plane( vbench_weightp_t *t, int i_frame, int i_plane, intptr_t *i_stride )
+{
+    *i_stride = t->plane[i_frame][i_plane].i_stride;
+    return t->plane[i_frame][i_plane].plane;
+}
+
+const vbench_weightp_stats_t *vbench_weightp_stats( vbench_weightp_t *t, int i_frame )
+{
+    return &t->stats[i_frame];
+}
+
+/****************************************************************************
+ * statistics
+ ****************************************************************************/
+
+/* pixel_var returns the sum in the low and the sum of squares in the high
+ * 32 bits; the AC energy of a block is what's left without its mean */
+static void weightp_plane_stats( vbench_pixel_function_t *pf, vbench_plane_t *pl, int i_size,
+                                 float *f_mean, float *f_var )
+{
+    int bs = i_size == PIXEL_16x16 ? 16 : 8;
+    int shift = i_size == PIXEL_16x16 ? 8 : 6;
+    uint64_t sum = 0, ac = 0;
+
+    for( int y = 0; y < pl->i_height; y += bs )
+        for( int x = 0; x < pl->i_width; x += bs )
+        {
+            uint64_t v = pf->var[i_size]( pl->plane + y*pl->i_stride + x, pl->i_stride );
+            uint32_t s = (uint32_t)v;
+            sum += s;
+            ac += (v >> 32) - (((uint64_t)s * s) >> shift);
+        }
+    *f_mean = (float)sum / (pl->i_width * pl->i_height);
+    *f_var = (float)ac / (pl->i_width * pl->i_height);
+}
+
+void vbench_weightp_analyse( vbench_weightp_t *t, int i_frame )
+{
+    vbench_plane_t *y = &t->plane[i_frame][0];
+    vbench_plane_t *lowres = t->lowres[i_frame];
+    vbench_weightp_stats_t *s = &t->stats[i_frame];
+
+    vbench_plane_expand_border( y );
+    t->mc->frame_init_lowres_core( y->plane, lowres[0].plane, lowres[1].plane, lowres[2].plane, lowres[3].plane,
+                                   y->i_stride, lowres[0].i_stride, lowres[0].i_width, lowres[0].i_height );
+    for( int p = 0; p < t->i_planes; p++ )
+        weightp_plane_stats( t->pf, &t->plane[i_frame][p], p ? PIXEL_8x8 : PIXEL_16x16, &s->f_mean[p], &s->f_var[p] );
+    weightp_plane_stats( t->pf, &lowres[0], PIXEL_8x8, &s->f_lowres_mean, &s->f_lowres_var );
+}
+
+/****************************************************************************
+ * search
+ ****************************************************************************/
+
+static void weightp_get_h264( int weight_nonh264, int offset, vbench_weight_t *w )
+{
+    w->i_offset = offset;
+    w->i_denom = 7;
+    w->i_scale = weight_nonh264;
+    while( w->i_denom > 0 && (w->i_scale > 127) )
+    {
+        w->i_denom--;
+        w->i_scale >>= 1;
+    }
+    w->i_scale = MIN( w->i_scale, 127 );
+}
+
+static int weightp_cost_luma( vbench_weightp_t *t, vbench_weight_t *w )
+{
+    vbench_plane_t *ref = &t->lowres[1][0];
+    vbench_plane_t *fenc = &t->lowres[0][0];
+    intptr_t stride = ref->i_stride;
+    int cost = 0;
+
+    for( int y = 0; y < ref->i_height; y += 8 )
+        for( int x = 0; x < ref->i_width; x += 8 )
+        {
+            intptr_t pixoff = y*stride + x;
+            if( w )
+            {
+                w->weightfn[8>>2]( t->buf, 8, ref->plane + pixoff, stride, w, 8 );
+                cost += t->pf->sad[PIXEL_8x8]( t->buf, 8, fenc->plane + pixoff, stride );
+            }
+            else
+                cost += t->pf->sad[PIXEL_8x8]( ref->plane + pixoff, stride, fenc->plane + pixoff, stride );
+        }
+    return cost;
+}
+
+/* asd8 only compares the DC of each block, which is all a chroma weight
+ * can fix */
+static int weightp_cost_chroma( vbench_weightp_t *t, int i_plane, vbench_weight_t *w )
+{
+    vbench_plane_t *ref = &t->plane[1][i_plane];
+    vbench_plane_t *fenc = &t->plane[0][i_plane];
+    intptr_t stride = ref->i_stride;
+    int cost = 0;
+
+    for( int y = 0; y < ref->i_height; y += 8 )
+        for( int x = 0; x < ref->i_width; x += 8 )
+        {
+            intptr_t pixoff = y*stride + x;
+            if( w )
+            {
+                w->weightfn[8>>2]( t->buf, 8, ref->plane + pixoff, stride, w, 8 );
+                cost += t->pf->asd8( t->buf, 8, fenc->plane + pixoff, stride, 8 );
+            }
+            else
+                cost += t->pf->asd8( ref->plane + pixoff, stride, fenc->plane + pixoff, stride, 8 );
+        }
+    return cost;
+}
+
+static int weightp_cost( vbench_weightp_t *t, int i_plane, vbench_weight_t *w )
+{
+    return i_plane ? weightp_cost_chroma( t, i_plane, w ) : weightp_cost_luma( t, w );
+}
+
+static void weightp_search( vbench_weightp_t *t, int i_plane, vbench_weightp_result_t *res )
+{
+    vbench_weightp_stats_t *fenc = &t->stats[0];
+    vbench_weightp_stats_t *ref = &t->stats[1];
+    vbench_weight_t *w = &res->weight[i_plane];
+    float fenc_mean = i_plane ? fenc->f_mean[i_plane] : fenc->f_lowres_mean;
+    float ref_mean  = i_plane ? ref->f_mean[i_plane]  : ref->f_lowres_mean;
+    float fenc_var  = i_plane ? fenc->f_var[i_plane]  : fenc->f_lowres_var;
+    float ref_var   = i_plane ? ref->f_var[i_plane]   : ref->f_lowres_var;
+    /* a flat reference can only be fixed with an offset */
+    float guess_scale = ref_var > 0 ? sqrtf( fenc_var / ref_var ) : 1.0f;
+    int origscore = weightp_cost( t, i_plane, NULL );
+    int minscore = origscore;
+    int mindenom, minscale, minoff = 0;
+    int found = 0;
+
+    weightp_get_h264( (int)(guess_scale * 128 + 0.5f), 0, w );
+    mindenom = w->i_denom;
+    minscale = w->i_scale;
+
+    int start_scale = vbench_clip3( minscale - WEIGHTP_SCALE_DIST, 0, 127 );
+    int end_scale   = vbench_clip3( minscale + WEIGHTP_SCALE_DIST, 0, 127 );
+    for( int i_scale = start_scale; i_scale <= end_scale; i_scale++ )
+    {
+        int cur_offset = (int)floorf( fenc_mean - ref_mean * i_scale / (1 << mindenom) + 0.5f );
+        int start_offset = vbench_clip3( cur_offset - WEIGHTP_OFFSET_DIST, -128, 127 );
+        int end_offset   = vbench_clip3( cur_offset + WEIGHTP_OFFSET_DIST, -128, 127 );
+        for( int i_off = start_offset; i_off <= end_offset; i_off++ )
+        {
+            int s;
+            w->i_scale = i_scale;
+            w->i_denom = mindenom;
+            w->i_offset = i_off;
+            t->mc->weight_cache( t->mc, w );
+            s = weightp_cost( t, i_plane, w );
+            if( s < minscore )
+            {
+                minscore = s;
+                minscale = i_scale;
+                minoff = i_off;
+                found = 1;
+            }
+        }
+    }
+
+    /* simplify the denominator as the bitstream would */
+    while( mindenom > 0 && !(minscale&1) )
+    {
+        mindenom--;
+        minscale >>= 1;
+    }
+
+    res->i_cost_none[i_plane] = origscore;
+    res->i_ssd[i_plane] = 0;
+    if( !found || (minscale == 1 << mindenom && minoff == 0) || (float)minscore / origscore > 0.998f )
+    {
+        res->b_weighted[i_plane] = 0;
+        res->i_cost[i_plane] = origscore;
+        *w = (vbench_weight_t){ .i_scale = 1 << mindenom, .i_denom = mindenom };
+        return;
+    }
+    res->b_weighted[i_plane] = 1;
+    res->i_cost[i_plane] = minscore;
+    w->i_scale = minscale;
+    w->i_denom = mindenom;
+    w->i_offset = minoff;
+    t->mc->weight_cache( t->mc, w );
+}
+
+/****************************************************************************
+ * weighted reference
+ ****************************************************************************/
+
+/* Horizontal strips of 16 rows as x264_weight_scale_plane, each measured
+ * against the current frame while it's still in cache. */
+static uint64_t weightp_scale_plane( vbench_weightp_t *t, vbench_plane_t *dst, vbench_plane_t *src,
+                                     vbench_plane_t *fenc, vbench_weight_t *w )
+{
+    pixel *d = dst->plane, *s = src->plane, *f = fenc->plane;
+    uint64_t ssd = 0;
+
+    for( int y = 0; y < src->i_height; y += 16 )
+    {
+        int x;
+        for( x = 0; x < src->i_width-8; x += 16 )
+        {
+            w->weightfn[16>>2]( d+x, dst->i_stride, s+x, src->i_stride, w, 16 );
+            ssd += t->pf->ssd[PIXEL_16x16]( f+x, fenc->i_stride, d+x, dst->i_stride );
+        }
+        if( x < src->i_width )
+        {
+            w->weightfn[8>>2]( d+x, dst->i_stride, s+x, src->i_stride, w, 16 );
+            ssd += t->pf->ssd[PIXEL_8x16]( f+x, fenc->i_stride, d+x, dst->i_stride );
+        }
+        d += 16 * dst->i_stride;
+        s += 16 * src->i_stride;
+        f += 16 * fenc->i_stride;
+    }
+    return ssd;
+}
+
+void vbench_weightp_frame( vbench_weightp_t *t, vbench_weightp_result_t *res )
+{
+    vbench_weightp_analyse( t, 0 );
+    for( int p = 0; p < t->i_planes; p++ )
+    {
+        weightp_search( t, p, res );
+        if( res->b_weighted[p] )
+            res->i_ssd[p] = weightp_scale_plane( t, &t->out[p], &t->plane[1][p], &t->plane[0][p], &res->weight[p] );
+    }
+}
+
+pixel *vbench_weightp_weighted( vbench_weightp_t *t, vbench_weightp_result_t *res, int i_plane, intptr_t *i_stride )
+{
+    vbench_plane_t *pl = res->b_weighted[i_plane] ? &t->out[i_plane] : &t->plane[1][i_plane];
+    *i_stride = pl->i_stride;
+    return pl->plane;
+}
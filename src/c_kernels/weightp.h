@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * weightp.h: explicit weighted prediction analysis
+ *****************************************************************************
+ *
+ * Copyright (C) 2016 Michail Alvanos
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ *
+ *****************************************************************************/
+
+#ifndef WEIGHTP_H
+#define WEIGHTP_H
+
+/* candidates tried on each side of the initial guess */
+#define WEIGHTP_SCALE_DIST  2
+#define WEIGHTP_OFFSET_DIST 2
+
+/* Mean and variance (per pixel, of the AC part of each 16x16 luma or 8x8
+ * chroma block) of the three planes, and of the 8x8 blocks of the lowres
+ * luma the luma search runs on. */
+typedef struct
+{
+    float f_mean[3];
+    float f_var[3];
+    float f_lowres_mean;
+    float f_lowres_var;
+} vbench_weightp_stats_t;
+
+typedef struct
+{
+    vbench_weight_t weight[3];
+    int b_weighted[3];
+    int i_cost[3];       /* search cost of the chosen weight */
+    int i_cost_none[3];  /* and of the unweighted reference */
+    uint64_t i_ssd[3];   /* full-res SSD of the weighted planes */
+} vbench_weightp_result_t;
+
+typedef struct vbench_weightp_t vbench_weightp_t;
+
+/* Two frames in chroma format i_csp (a chroma_format_e), the current one
+ * (0) and its reference (1), of i_width x i_height with i_width a multiple
+ * of 16 and i_height of 32.  A 4:0:0 frame has only its luma plane. */
+vbench_weightp_t *vbench_weightp_open( vbench_pixel_function_t *pf, vbench_mc_functions_t *mc,
+                                       int i_width, int i_height, int i_csp );
+void vbench_weightp_close( vbench_weightp_t *t );
+pixel *vbench_weightp_plane( vbench_weightp_t *t, int i_frame, int i_plane, intptr_t *i_stride );
+
+/* Lowres planes and statistics of a frame whose planes were written, done
+ * for every frame once as it enters the lookahead. */
+void vbench_weightp_analyse( vbench_weightp_t *t, int i_frame );
+const vbench_weightp_stats_t *vbench_weightp_stats( vbench_weightp_t *t, int i_frame );
+
+/* The per-frame work: analyse frame 0, search weights for each plane
+ * against frame 1 as x264's weights_analyse does, luma with SAD on the
+ * lowres planes and chroma with asd8 at full resolution, then write the
+ * weighted reference with the weight_fn_t tables in strips of 16 rows. */
+void vbench_weightp_frame( vbench_weightp_t *t, vbench_weightp_result_t *res );
+
+/* the weighted reference plane, or the reference itself if the plane
+ * isn't weighted */
+pixel *vbench_weightp_weighted( vbench_weightp_t *t, vbench_weightp_result_t *res, int i_plane, intptr_t *i_stride );
+
+#endif
@@ -0,0 +1,225 @@
+#!/bin/sh
+#
+# Code size and instruction mix report.
+#
+# Finds the symbol of every implementation listed by ./bench --code
+# --bench, takes its size from the symbol table (for the asm, which yasm
+# gives no size, up to the next symbol) and sorts the instructions of its
+# body into classes: scalar, MMX, 128, 256 and 512-bit vector, shuffles,
+# gathers and scatters, branches and calls.  Then, for every kernel with
+# both, the C against its fastest asm: how many times the size for how
+# many times the cycles.
+#
+# usage: ./codereport.sh binary bench_output
+#        make codereport BENCH_LOG=...
+#
+# The classes go by the mnemonics and AT&T operands objdump gives for
+# x86.  A vector instruction counts in the widest register class it
+# names, scalar float on xmm (addss, cvtsi2sd, ...) as scalar.
+#
+# Output, tab separated, in the order of the first table of bench_output:
+#   bench  column  cycles  bytes  insns  scalar  mmx  xmm  ymm  zmm
+#   shuffle  gather  branch  call  symbol
+# then ranked by the size of the C over that of the asm:
+#   size  cycles  bench  C bytes  asm bytes  C cycles  asm cycles  asm
+#
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 binary bench_output" >&2
+    exit 1
+fi
+BIN=$1
+BENCH_LOG=$2
+
+if ! grep -q '^code	' "$BENCH_LOG"; then
+    echo "$0: no code table in $BENCH_LOG, run ./bench --code --bench" >&2
+    exit 1
+fi
+
+TMP=${TMPDIR:-/tmp}/codereport.$$
+trap 'rm -f $TMP.*' EXIT
+
+HEX='
+function hex( s,    i, n )
+{
+    n = 0
+    s = tolower( s )
+    sub( /^0x/, "", s )
+    for( i = 1; i <= length( s ); i++ )
+        n = n * 16 + index( "0123456789abcdef", substr( s, i, 1 ) ) - 1
+    return n
+}'
+
+# Text symbols: start, end, name.  A symbol without a size ends at the
+# next one that is not one of its own local labels (name.label).
+nm -S --defined-only "$BIN" | awk "$HEX"'
+NF == 4 && $3 ~ /^[tTwW]$/ { print hex( $1 ) "\t" hex( $2 ) "\t" $4 }
+NF == 3 && $2 ~ /^[tTwW]$/ { print hex( $1 ) "\t0\t" $3 }
+' | sort -t'	' -k1,1n -k2,2nr | awk -F'\t' -v OFS='\t' '
+{
+    start[NR] = $1; size[NR] = $2; name[NR] = $3
+}
+END {
+    for( i = 1; i <= NR; i++ )
+    {
+        if( index( name[i], "." ) && substr( name[i], 1, index( name[i], "." ) - 1 ) == parent )
+            continue
+        parent = name[i]
+        end = start[i] + size[i]
+        if( !size[i] )
+        {
+            end = 0
+            for( j = i + 1; j <= NR && !end; j++ )
+                if( start[j] > start[i] && index( name[j] ".", name[i] "." ) != 1 )
+                    end = start[j]
+            if( !end )
+                end = start[i]
+        }
+        printf "%.0f\t%.0f\t%s\n", start[i], end, name[i]
+    }
+}
+' > $TMP.syms
+
+# The implementations: bench, column, cycles from the first table, and
+# the address --code gave, moved by where main is in the binary.
+MAIN=$(awk -F'\t' '$3 == "main" { print $1; exit }' $TMP.syms)
+awk -F'\t' -v OFS='\t' -v main="$MAIN" "$HEX"'
+/\tC\tMMX\t/ && !/^(throughput|cold)/ && !ncol {
+    for( i = 2; i <= NF; i++ )
+        col[i] = $i
+    ncol = NF
+    table = 1
+    next
+}
+table && !/ : / { table = 0 }
+table {
+    k = $1
+    sub( /^ */, "", k )
+    sub( / *: *$/, "", k )
+    for( i = 2; i <= NF && i <= ncol; i++ )
+        cycles[k, col[i]] = $i
+    next
+}
+/^code\t/ {
+    delta = hex( $2 ) - main
+    code = 1
+    next
+}
+code && NF == 3 {
+    printf "%s\t%s\t%s\t%.0f\n", $1, $2, (($1, $2) in cycles) ? cycles[$1, $2] : "-", hex( $3 ) - delta
+}
+' "$BENCH_LOG" > $TMP.impls
+
+awk -F'\t' -v OFS='\t' '
+FILENAME == ARGV[1] { n++; s[n] = $1; e[n] = $2; sym[n] = $3; next }
+{
+    found = ""
+    for( i = 1; i <= n; i++ )
+        if( s[i] <= $4 && $4 < e[i] )
+        {
+            found = sym[i]; lo = s[i]; hi = e[i]
+            break
+        }
+    if( found == "" )
+        print "-\t-\t" $0
+    else
+        printf "%.0f\t%.0f\t%s\t%s\n", lo, hi, $0, found
+}
+' $TMP.syms $TMP.impls > $TMP.resolved
+
+# One pass over the disassembly, counting for the symbols wanted.
+objdump -d --no-show-raw-insn "$BIN" | awk -F'\t' -v OFS='\t' "$HEX"'
+FILENAME == ARGV[1] {
+    if( $1 != "-" )
+        want[$1] = 1
+    next
+}
+/^[0-9a-f]+ <.*>:$/ {
+    label = $0
+    sub( /^[0-9a-f]+ </, "", label )
+    sub( />:$/, "", label )
+    a = sprintf( "%.0f", hex( substr( $0, 1, index( $0, " " ) - 1 ) ) )
+    # a local label of the function being counted continues it
+    if( a in want )
+    {
+        cur = a
+        curname = label
+    }
+    else if( index( label, curname "." ) != 1 )
+        cur = ""
+    next
+}
+cur != "" && /^ *[0-9a-f]+:\t/ {
+    insn = $2
+    sub( /^(rep[a-z]* |lock |notrack |bnd |data16 |cs |ds )+/, "", insn )
+    m = insn
+    sub( / .*/, "", m )
+    ops = insn
+    sub( /^[^ ]* */, "", ops )
+    n[cur]++
+    if( ops ~ /%zmm/ )
+        w = "zmm"
+    else if( ops ~ /%ymm/ )
+        w = "ymm"
+    else if( ops ~ /%xmm/ )
+        w = (m ~ /s[sd]$/ && m !~ /^v?p/ && m !~ /broadcast/) ? "scalar" : "xmm"
+    else if( ops ~ /%mm[0-7]/ )
+        w = "mmx"
+    else
+        w = "scalar"
+    cnt[cur, w]++
+    if( w != "scalar" && m ~ /shuf|unpck|perm|align|pack|ins|ext|broadcast|movhl|movlh|dup|expand|compress|dq$|pmov[sz]x/ )
+        cnt[cur, "shuffle"]++
+    if( m ~ /gather|scatter/ )
+        cnt[cur, "gather"]++
+    if( m ~ /^j/ )
+        cnt[cur, "branch"]++
+    if( m ~ /^call/ )
+        cnt[cur, "call"]++
+}
+END {
+    for( a in n )
+    {
+        printf "%s\t%d", a, n[a]
+        split( "scalar mmx xmm ymm zmm shuffle gather branch call", cls, " " )
+        for( i = 1; i <= 9; i++ )
+            printf "\t%d", cnt[a, cls[i]]
+        printf "\n"
+    }
+}
+' $TMP.resolved - > $TMP.mix
+
+awk -F'\t' -v OFS='\t' '
+FILENAME == ARGV[1] { mix[$1] = $0; next }
+{
+    bytes = $1 == "-" ? "-" : $2 - $1
+    if( $1 in mix )
+    {
+        split( mix[$1], f, "\t" )
+        m = f[2]
+        for( i = 3; i <= 11; i++ )
+            m = m OFS f[i]
+    }
+    else
+        m = "-\t-\t-\t-\t-\t-\t-\t-\t-\t-"
+    print $3, $4, $5, bytes, m, ($7 != "" ? $7 : "?")
+}
+' $TMP.mix $TMP.resolved > $TMP.report
+
+printf "bench\tcolumn\tcycles\tbytes\tinsns\tscalar\tmmx\txmm\tymm\tzmm\tshuffle\tgather\tbranch\tcall\tsymbol\n"
+cat $TMP.report
+echo
+
+# the C against the fastest asm of the same kernel
+printf "size\tcycles\tbench\tC bytes\tasm bytes\tC cycles\tasm cycles\tasm\n"
+awk -F'\t' -v OFS='\t' '
+BEGIN { split( "MMX SSE SSE2 SSE3 SSSE3 SSE4 SSE42 AVX XOP FMA4 FMA3 AVX2 AVX512", l, " " ); for( i in l ) asm[l[i]] = 1 }
+$4 == "-" || !($3 > 0) { next }
+$2 == "C" { cb[$1] = $4; cc[$1] = $3 }
+($2 in asm) && (!($1 in ac) || $3 < ac[$1]) { ab[$1] = $4; ac[$1] = $3; an[$1] = $2 }
+END {
+    for( k in cb )
+        if( (k in ab) && ab[k] > 0 )
+            printf "%.2f\t%.2f\t%s\t%d\t%d\t%d\t%d\t%s\n", cb[k] / ab[k], cc[k] / ac[k], k, cb[k], ab[k], cc[k], ac[k], an[k]
+}
+' $TMP.report | sort -t'	' -k1,1gr -k3,3
@@ -72,11 +72,18 @@ typedef uint16_t udctcoef;
 #define MC_CLIP_ADD(s,x) (s) = MIN((s)+(x),(1<<15)-1)
 
 
-#define CHROMA_SIZE(s) ((s)>>(CHROMA_H_SHIFT+CHROMA_V_SHIFT))
-#define FRAME_SIZE(s) ((s)+2*CHROMA_SIZE(s))
+/* Chroma format the benchmarks run the chroma paths of, one of the
+ * chroma_format_e values, set with --chroma= and 4:2:0 by default. */
+extern int vbench_chroma_format;
+extern const char * const vbench_chroma_names[4];
 
-#define CHROMA_FORMAT CHROMA_420
+#define CHROMA_FORMAT vbench_chroma_format
 #define CHROMA444 (CHROMA_FORMAT == CHROMA_444)
+#define CHROMA_H_SHIFT (CHROMA_FORMAT == CHROMA_420 || CHROMA_FORMAT == CHROMA_422)
+#define CHROMA_V_SHIFT (CHROMA_FORMAT == CHROMA_420)
+
+#define CHROMA_SIZE(s) (CHROMA_FORMAT ? (s)>>(CHROMA_H_SHIFT+CHROMA_V_SHIFT) : 0)
+#define FRAME_SIZE(s) ((s)+2*CHROMA_SIZE(s))
 
 /* Unions for type-punning.
  *  * Mn: load or store n bits, aligned, native-endian
@@ -225,9 +232,11 @@ enum slice_type_e
 
 
 #define BENCH_RUNS 100  // tradeoff between accuracy and speed
+#define RATE_RUNS 4     // calls per sample for throughput (GB/s, fps) benchmarks
 #define BENCH_ALIGNS 32 // number of stack+heap data alignments (another accuracy vs speed tradeoff)
 #define MAX_FUNCS 8192  // just has to be big enough to hold all the existing functions
 #define MAX_CPUS 64     // number of different combinations of cpu flags
+#define COLD_DATA_SIZE (8<<20) // bytes swept before a --cold sample, past the L2 of anything we run on
 
 
 
@@ -269,6 +278,9 @@ enum slice_type_e
                                              * new SLOW flags. */
 #define VSIMD_CPU_SLOW_PSHUFB     0x2000000  /* such as on the Intel Atom */
 #define VSIMD_CPU_SLOW_PALIGNR    0x4000000  /* such as on the AMD Bobcat */
+#define VSIMD_CPU_AVX512          0x8000000  /* AVX-512 {F, CD, BW, DQ, VL}, requires OS support */
+#define VSIMD_CPU_AVX512VBMI      0x10000000 /* AVX-512 VBMI: vpermb, vpermi2b, vpmultishiftqb */
+#define VSIMD_CPU_AVX512VNNI      0x20000000 /* AVX-512 VNNI: vpdpbusd, vpdpwssd */
 
 /* PowerPC */
 #define VSIMD_CPU_ALTIVEC         0x0000001
@@ -282,6 +294,20 @@ enum slice_type_e
 /* MIPS */
 #define VSIMD_CPU_MSA             0x0000001  /* MIPS MSA */
 
+/* The cpu the checks and inits take is 64-bit: the low word is the cpu
+ * features above, as cpu_detect returns them, the high one what else the
+ * harness can put in place of the asm. */
+
+/* Not a cpu feature: the index, from 1, of one of the side-by-side C
+ * builds linked into the binary (see c_kernels/ccbuild.h) */
+#define VSIMD_CPU_CCBUILD_SHIFT   32
+#define VSIMD_CPU_CCBUILD_MASK    (UINT64_C(7) << VSIMD_CPU_CCBUILD_SHIFT)
+#define VSIMD_CPU_CCBUILD( i )    ((uint64_t)(i) << VSIMD_CPU_CCBUILD_SHIFT)
+
+/* Not a cpu feature either: the kernels written with the compiler's
+ * generic vector extensions (c_kernels/vext.c) */
+#define VSIMD_CPU_VEXT            (UINT64_C(1) << 35)
+
 
 
 
@@ -332,6 +358,9 @@ extern const cpu_name_t cpu_names[];
 
 #define CPU_SLOW_PSHUFB     0x2000000  /* such as on the Intel Atom */
 #define CPU_SLOW_PALIGNR    0x4000000  /* such as on the AMD Bobcat */
+#define CPU_AVX512          0x8000000  /* AVX-512 {F, CD, BW, DQ, VL}, requires OS support */
+#define CPU_AVX512VBMI      0x10000000 /* AVX-512 VBMI */
+#define CPU_AVX512VNNI      0x20000000 /* AVX-512 VNNI */
 
 /* PowerPC */
 #define CPU_ALTIVEC         0x0000001
@@ -345,6 +374,9 @@ extern const cpu_name_t cpu_names[];
 /* MIPS */
 #define CPU_MSA             0x0000001  /* MIPS MSA */
 
+/* any arch */
+#define CPU_VEXT            VSIMD_CPU_VEXT /* generic vector extensions, not in the cpu_detect word */
+
 
 
 uint32_t cpu_detect( void );
@@ -367,7 +399,15 @@ intptr_t benchmark_call( intptr_t (*func)(), int *ok, ... );
 
 
 /* Calls for the benchmarks */
-int check_pixel( int cpu_ref, int cpu_new );
+int check_pixel( uint64_t cpu_ref, uint64_t cpu_new );
+int check_dct( uint64_t cpu_ref, uint64_t cpu_new );
+int check_mc( uint64_t cpu_ref, uint64_t cpu_new );
+int check_intra( uint64_t cpu_ref, uint64_t cpu_new );
+int check_deblock( uint64_t cpu_ref, uint64_t cpu_new );
+int check_quant( uint64_t cpu_ref, uint64_t cpu_new );
+int check_cabac( uint64_t cpu_ref, uint64_t cpu_new );
+int check_bitstream( uint64_t cpu_ref, uint64_t cpu_new );
+int check_metrics( uint64_t cpu_ref, uint64_t cpu_new );
 
 
 
@@ -55,7 +55,7 @@
 
 const cpu_name_t cpu_names[] =
 {
-#if HAVE_MMX
+#if HAVE_MMX || HAVE_X86_INTRIN
 //  {"MMX",         CPU_MMX},  // we don't support asm on mmx1 cpus anymore
 //  {"CMOV",        CPU_CMOV}, // we require this unconditionally, so don't print it
 #define MMX2 CPU_MMX|CPU_MMX2|CPU_CMOV
@@ -77,6 +77,9 @@ const cpu_name_t cpu_names[] =
     {"FMA4",        AVX|CPU_FMA4},
     {"FMA3",        AVX|CPU_FMA3},
     {"AVX2",        AVX|CPU_FMA3|CPU_AVX2},
+    {"AVX512",      AVX|CPU_FMA3|CPU_AVX2|CPU_AVX512},
+    {"AVX512VBMI",  AVX|CPU_FMA3|CPU_AVX2|CPU_AVX512|CPU_AVX512VBMI},
+    {"AVX512VNNI",  AVX|CPU_FMA3|CPU_AVX2|CPU_AVX512|CPU_AVX512VNNI},
 #undef AVX
 #undef SSE2
 #undef MMX2
@@ -125,11 +128,26 @@ static void sigill_handler( int sig )
 }
 #endif
 
+#if HAVE_MMX || HAVE_X86_INTRIN
 #if HAVE_MMX
 int pu_cpuid_test( void );
 void asm_cpu_cpuid( uint32_t op, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx );
 void asm_cpu_xgetbv( uint32_t op, uint32_t *eax, uint32_t *edx );
 int asm_cpu_cpuid_test();
+#else
+/* The generic build on x86_64 has the intrinsics but not cpu-a.asm: the
+ * same two instructions, from C. */
+#include <cpuid.h>
+static void asm_cpu_cpuid( uint32_t op, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx )
+{
+    __cpuid_count( op, 0, *eax, *ebx, *ecx, *edx );
+}
+
+static void asm_cpu_xgetbv( uint32_t op, uint32_t *eax, uint32_t *edx )
+{
+    asm volatile( "xgetbv" : "=a"(*eax), "=d"(*edx) : "c"(op) );
+}
+#endif
 
 uint32_t cpu_detect( void )
 {
@@ -137,9 +155,10 @@ uint32_t cpu_detect( void )
     uint32_t eax, ebx, ecx, edx;
     uint32_t vendor[4] = {0};
     uint32_t max_extended_cap, max_basic_cap;
+    uint32_t xcr0 = 0;
     int cache;
 
-#if !ARCH_X86_64
+#if HAVE_MMX && !ARCH_X86_64
     if( !asm_cpu_cpuid_test() )
         return 0;
 #endif
@@ -175,7 +194,8 @@ uint32_t cpu_detect( void )
     {
         /* Check for OS support */
         asm_cpu_xgetbv( 0, &eax, &edx );
-        if( (eax&0x6) == 0x6 )
+        xcr0 = eax;
+        if( (xcr0&0x6) == 0x6 )
         {
             cpu |= CPU_AVX;
             if( ecx&0x00001000 )
@@ -189,6 +209,16 @@ uint32_t cpu_detect( void )
         /* AVX2 requires OS support, but BMI1/2 don't. */
         if( (cpu&CPU_AVX) && (ebx&0x00000020) )
             cpu |= CPU_AVX2;
+        /* AVX-512 F, DQ, CD, BW and VL, with the opmask and ZMM state
+         * enabled by the OS */
+        if( (cpu&CPU_AVX2) && (xcr0&0xE0) == 0xE0 && (ebx&0xD0030000) == 0xD0030000 )
+        {
+            cpu |= CPU_AVX512;
+            if( ecx&0x00000002 )
+                cpu |= CPU_AVX512VBMI;
+            if( ecx&0x00000800 )
+                cpu |= CPU_AVX512VNNI;
+        }
         if( ebx&0x00000008 )
         {
             cpu |= CPU_BMI1;
@@ -38,10 +38,19 @@
 
 
 #include <ctype.h>
+#include <unistd.h>
 
 #include "common.h"
 #include "osdep.h"
 #include "bench.h"
+#include "macroblock.h"
+#include "c_kernels/metrics.h"
+#include "c_kernels/ingest.h"
+#include "c_kernels/memory.h"
+#include "c_kernels/ccbuild.h"
+
+void vbench_pixel_init( uint64_t cpu, vbench_pixel_function_t *pixf );
+void vbench_mc_init( uint64_t cpu, vbench_mc_functions_t *pf, int cpu_independent );
 
 
 
@@ -72,6 +81,31 @@ pixel *pbuf3, *pbuf4;
 int bench_pattern_len = 0;
 const char *bench_pattern = "";
 bench_func_t benchs[MAX_FUNCS];
+bench_rate_func_t bench_rates[MAX_FUNCS];
+
+int vbench_chroma_format = CHROMA_420;
+const char * const vbench_chroma_names[4] = { "400", "420", "422", "444" };
+
+/* what the Makefile compiled in: which build of the benchmark ran */
+#ifndef VBENCH_BUILD_NAME
+#define VBENCH_BUILD_NAME "unknown"
+#define VBENCH_BUILD_ARCH "unknown"
+#define VBENCH_BUILD_CC "unknown"
+#define VBENCH_BUILD_CFLAGS ""
+#define VBENCH_BUILD_LDFLAGS ""
+#define VBENCH_BUILD_REV "unknown"
+#endif
+#ifndef __VERSION__
+#define __VERSION__ "unknown version"
+#endif
+
+static void print_build(void)
+{
+    printf( "build: %s, %s, rev %s\n", VBENCH_BUILD_NAME, VBENCH_BUILD_ARCH, VBENCH_BUILD_REV );
+    printf( "cc: %s %s\n", VBENCH_BUILD_CC, __VERSION__ );
+    printf( "cflags: %s\n", VBENCH_BUILD_CFLAGS );
+    printf( "ldflags: %s\n", VBENCH_BUILD_LDFLAGS );
+}
 
 
 
@@ -128,7 +162,10 @@ static void print_bench_native(void)
             if( k < j )
                 continue;
             printf( "    %s%s: %ld", 
-#if HAVE_MMX
+                    b->cpu&VSIMD_CPU_CCBUILD_MASK ? vbench_ccbuild_name( b->cpu ) :
+                    b->cpu&VSIMD_CPU_VEXT ? "vec" :
+#if HAVE_MMX || HAVE_X86_INTRIN
+                    b->cpu&VSIMD_CPU_AVX512 ? "avx512" :
                     b->cpu&VSIMD_CPU_AVX2 ? "avx2" :
                     b->cpu&VSIMD_CPU_FMA3 ? "fma3" :
                     b->cpu&VSIMD_CPU_FMA4 ? "fma4" :
@@ -155,7 +192,7 @@ static void print_bench_native(void)
                     b->cpu&VSIMD_CPU_MSA ? "msa" :
 #endif
                     "c",
-#if HAVE_MMX
+#if HAVE_MMX || HAVE_X86_INTRIN
                     b->cpu&VSIMD_CPU_CACHELINE_32 ? "_c32" :
                     b->cpu&VSIMD_CPU_SLOW_ATOM && b->cpu&VSIMD_CPU_CACHELINE_64 ? "_c64_atom" :
                     b->cpu&VSIMD_CPU_CACHELINE_64 ? "_c64" :
@@ -175,10 +212,25 @@ static void print_bench_native(void)
     }
 }
 
-static void print_bench(void)
+/* one extra column per side-by-side C build, after AVX512 and VEC */
+static void print_ccbuild_header(void)
+{
+    for( int i = 1; i <= CCBUILD_MAX; i++ )
+        if( vbench_ccbuild_name( VSIMD_CPU_CCBUILD( i ) ) )
+            printf( "\t%s", vbench_ccbuild_name( VSIMD_CPU_CCBUILD( i ) ) );
+    printf( "\n" );
+}
+
+static int print_column( int j )
+{
+    return j < 15 || vbench_ccbuild_name( VSIMD_CPU_CCBUILD( j-14 ) );
+}
+
+/* ten times the cycles of an empty read_time() pair */
+static int bench_nop_time(void)
 {
     uint16_t nops[10000];
-    int nfuncs, nop_time=0;
+    int nop_time=0;
 
     for( int i = 0; i < 10000; i++ )
     {
@@ -188,7 +240,12 @@ static void print_bench(void)
     qsort( nops, 10000, sizeof(uint16_t), cmp_nop );
     for( int i = 500; i < 9500; i++ )
         nop_time += nops[i];
-    nop_time /= 900;
+    return nop_time / 900;
+}
+
+static void print_bench(void)
+{
+    int nfuncs, nop_time = bench_nop_time();
     printf( "nop: %d\n", nop_time );
 
     for( nfuncs = 0; nfuncs < MAX_FUNCS && benchs[nfuncs].name; nfuncs++ );
@@ -197,7 +254,8 @@ static void print_bench(void)
 
     int64_t results[32] = {0};
 
-    printf( "                                 \tC\tMMX\tSSE\tSSE2\tSSE3\tSSSE3\tSSE4\tSSE42\tAVX\tXOP\tFMA4\tFMA3\tAVX2\n")  ;
+    printf( "                                 \tC\tMMX\tSSE\tSSE2\tSSE3\tSSSE3\tSSE4\tSSE42\tAVX\tXOP\tFMA4\tFMA3\tAVX2\tAVX512\tVEC" );
+    print_ccbuild_header();
     for( int i = 0; i < nfuncs; i++ ){
         printf( "%30s : \t", benchs[i].name);
 
@@ -209,7 +267,10 @@ static void print_bench(void)
             if( k < j )
                 continue;
 
-            if (b->cpu&VSIMD_CPU_AVX2) results[12] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
+            if (b->cpu&VSIMD_CPU_CCBUILD_MASK) results[14+((b->cpu&VSIMD_CPU_CCBUILD_MASK)>>VSIMD_CPU_CCBUILD_SHIFT)] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
+            else if (b->cpu&VSIMD_CPU_VEXT) results[14] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
+            else if (b->cpu&VSIMD_CPU_AVX512) results[13] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
+            else if (b->cpu&VSIMD_CPU_AVX2) results[12] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
             else if (b->cpu&VSIMD_CPU_FMA3) results[11] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
             else if (b->cpu&VSIMD_CPU_FMA4) results[10] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
             else if (b->cpu&VSIMD_CPU_XOP) results[9] = (int64_t)(10*b->cycles/b->den - nop_time)/4; 
@@ -226,9 +287,10 @@ static void print_bench(void)
         }
 
 
-        for( int j = 0; j < 13; j++ )
+        for( int j = 0; j < 15+CCBUILD_MAX; j++ )
         {
-            printf("%ld\t", results[j] );
+            if( print_column( j ) )
+                printf("%ld\t", results[j] );
         }
         memset(results, 0, 32*sizeof(int64_t));
         printf("\n");
@@ -237,6 +299,141 @@ static void print_bench(void)
 
 
 
+bench_rate_t *get_bench_rate( const char *name, const char *unit, double scale, uint64_t cpu )
+{
+    int i, j;
+    for( i = 0; bench_rates[i].name && strcmp(name, bench_rates[i].name); i++ )
+        assert( i < MAX_FUNCS );
+    if( !bench_rates[i].name )
+    {
+        bench_rates[i].name = strdup( name );
+        bench_rates[i].unit = unit;
+        bench_rates[i].scale = scale;
+    }
+    if( !cpu )
+        return &bench_rates[i].vers[0];
+    for( j = 1; bench_rates[i].vers[j].cpu && bench_rates[i].vers[j].cpu != cpu; j++ )
+        assert( j < MAX_CPUS );
+    bench_rates[i].vers[j].cpu = cpu;
+    return &bench_rates[i].vers[j];
+}
+
+static int cmp_bench_rate( const void *a, const void *b )
+{
+    return strcmp( ((bench_rate_func_t*)a)->name, ((bench_rate_func_t*)b)->name );
+}
+
+/* same column layout as print_bench */
+static int bench_column( uint64_t cpu )
+{
+    if( cpu&VSIMD_CPU_CCBUILD_MASK )
+        return 14 + ((cpu&VSIMD_CPU_CCBUILD_MASK) >> VSIMD_CPU_CCBUILD_SHIFT);
+    if( cpu&VSIMD_CPU_VEXT )
+        return 14;
+    static const uint32_t flags[] = { VSIMD_CPU_AVX512, VSIMD_CPU_AVX2, VSIMD_CPU_FMA3, VSIMD_CPU_FMA4, VSIMD_CPU_XOP,
+                                      VSIMD_CPU_AVX, VSIMD_CPU_SSE42, VSIMD_CPU_SSE4, VSIMD_CPU_SSSE3,
+                                      VSIMD_CPU_SSE3, VSIMD_CPU_SSE2, VSIMD_CPU_SSE, VSIMD_CPU_MMX };
+    for( int i = 0; i < 13; i++ )
+        if( cpu&flags[i] )
+            return 13-i;
+    return 0;
+}
+
+static const char *column_name( int j )
+{
+    static const char *names[15] = { "C", "MMX", "SSE", "SSE2", "SSE3", "SSSE3", "SSE4", "SSE42",
+                                     "AVX", "XOP", "FMA4", "FMA3", "AVX2", "AVX512", "VEC" };
+    return j < 15 ? names[j] : vbench_ccbuild_name( VSIMD_CPU_CCBUILD( j-14 ) );
+}
+
+/* --code: where every implementation of the first table is, for
+ * codereport.sh to find its symbol.  main is there to relocate by. */
+static int bench_code = 0;
+int main( int argc, char *argv[] );
+
+static void print_bench_code(void)
+{
+    printf( "\ncode\t%p\n", (void*)main );
+    for( int i = 0; i < MAX_FUNCS && benchs[i].name; i++ )
+        for( int j = 0; j < MAX_CPUS && (!j || benchs[i].vers[j].cpu); j++ )
+        {
+            int k;
+            bench_t *b = &benchs[i].vers[j];
+            for( k = 0; k < j && benchs[i].vers[k].pointer != b->pointer; k++ );
+            if( k < j || !b->pointer )
+                continue;
+            printf( "%s\t%s\t%p\n", benchs[i].name, column_name( bench_column( b->cpu ) ), b->pointer );
+        }
+}
+
+/* --cold: steady/first call for every cell of the first table, in its
+ * order, both in the same units */
+static void print_bench_cold(void)
+{
+    int nop_time = bench_nop_time();
+
+    printf( "\ncold                             \tC\tMMX\tSSE\tSSE2\tSSE3\tSSSE3\tSSE4\tSSE42\tAVX\tXOP\tFMA4\tFMA3\tAVX2\tAVX512\tVEC" );
+    print_ccbuild_header();
+    for( int i = 0; i < MAX_FUNCS && benchs[i].name; i++ )
+    {
+        char cells[15+CCBUILD_MAX][48] = {{0}};
+        for( int j = 0; j < MAX_CPUS && (!j || benchs[i].vers[j].cpu); j++ )
+        {
+            int k;
+            bench_t *b = &benchs[i].vers[j];
+            for( k = 0; k < j && benchs[i].vers[k].pointer != b->pointer; k++ );
+            if( k < j || !b->den )
+                continue;
+            int64_t warm = (int64_t)(10*b->cycles/b->den - nop_time)/4;
+            if( b->cold_den )
+                snprintf( cells[bench_column( b->cpu )], 48, "%ld/%ld", warm,
+                          (int64_t)(10*b->cold_cycles/b->cold_den - nop_time) );
+            else
+                snprintf( cells[bench_column( b->cpu )], 48, "%ld/-", warm );
+        }
+        printf( "%30s : \t", benchs[i].name );
+        for( int j = 0; j < 15+CCBUILD_MAX; j++ )
+            if( print_column( j ) )
+                printf( "%s\t", cells[j][0] ? cells[j] : "0" );
+        printf( "\n" );
+    }
+}
+
+static void print_bench_rates(void)
+{
+    int nfuncs;
+    for( nfuncs = 0; nfuncs < MAX_FUNCS && bench_rates[nfuncs].name; nfuncs++ );
+    if( !nfuncs )
+        return;
+
+    qsort( bench_rates, nfuncs, sizeof(bench_rate_func_t), cmp_bench_rate );
+
+    printf( "\nthroughput                     \tC\tMMX\tSSE\tSSE2\tSSE3\tSSSE3\tSSE4\tSSE42\tAVX\tXOP\tFMA4\tFMA3\tAVX2\tAVX512\tVEC" );
+    print_ccbuild_header();
+    for( int i = 0; i < nfuncs; i++ )
+    {
+        double results[15+CCBUILD_MAX] = {0};
+        bench_rate_func_t *f = &bench_rates[i];
+        for( int j = 0; j < MAX_CPUS && (!j || f->vers[j].cpu); j++ )
+        {
+            int k;
+            bench_rate_t *r = &f->vers[j];
+            for( k = 0; r->pointer && k < j && f->vers[k].pointer != r->pointer; k++ );
+            if( (r->pointer && k < j) || !(f->scale ? r->usecs : r->cycles) )
+                continue;
+            if( f->scale )
+                results[bench_column( r->cpu )] = r->work / f->scale / (r->usecs * 1e-6);
+            else
+                results[bench_column( r->cpu )] = r->work / r->cycles;
+        }
+        printf( "%23s %6s : \t", f->name, f->unit );
+        for( int j = 0; j < 15+CCBUILD_MAX; j++ )
+            if( print_column( j ) )
+                printf( "%.2f\t", results[j] );
+        printf( "\n" );
+    }
+}
+
 int64_t mdate( void )
 {
 #if SYS_WINDOWS
@@ -256,6 +453,79 @@ int main(int argc, char *argv[])
 {
     int ret = 0;
 
+    /* --mem=4k|thp|hugetlb[,local|remote|node=N]: pages and placement of
+     * the frame-scale buffers, may precede any of the modes below */
+    if( argc > 1 && !strncmp( argv[1], "--mem=", 6 ) )
+    {
+        char name[32];
+        if( vbench_mem_parse( &vbench_mem_policy, argv[1]+6 ) )
+        {
+            fprintf( stderr, "unknown memory policy %s\n", argv[1]+6 );
+            return 1;
+        }
+        vbench_mem_name( &vbench_mem_policy, name, sizeof(name) );
+        fprintf( stderr, "VideoBench: frame buffers use %s memory\n", name );
+        argc--;
+        argv++;
+    }
+
+    /* --chroma=400|420|422|444: chroma format whose chroma paths are
+     * checked and benchmarked, may precede any of the modes below */
+    if( argc > 1 && !strncmp( argv[1], "--chroma=", 9 ) )
+    {
+        int i;
+        for( i = 0; i < 4 && strcmp( argv[1]+9, vbench_chroma_names[i] ); i++ );
+        if( i == 4 )
+        {
+            fprintf( stderr, "unknown chroma format %s\n", argv[1]+9 );
+            return 1;
+        }
+        vbench_chroma_format = i;
+        fprintf( stderr, "VideoBench: chroma format %s\n", vbench_chroma_names[i] );
+        argc--;
+        argv++;
+    }
+
+    /* --metrics ref.y4m dist.y4m [threads]: per-frame PSNR/SSIM of a pair */
+    if( argc > 3 && !strcmp( argv[1], "--metrics" ) )
+    {
+        vbench_pixel_function_t pixf;
+        int threads = argc > 4 ? atoi( argv[4] ) : sysconf( _SC_NPROCESSORS_ONLN );
+        vbench_pixel_init( cpu_detect(), &pixf );
+        return !!vbench_metrics_y4m( &pixf, argv[2], argv[3], threads );
+    }
+
+    /* --ingest in:out WxH file.raw [threads]: convert a raw clip, see
+     * vbench_ingest_names for the formats */
+    if( argc > 4 && !strcmp( argv[1], "--ingest" ) )
+    {
+        vbench_mc_functions_t mc_c, mc_a;
+        int width, height;
+        int threads = argc > 5 ? atoi( argv[5] ) : sysconf( _SC_NPROCESSORS_ONLN );
+        if( sscanf( argv[3], "%dx%d", &width, &height ) != 2 )
+        {
+            fprintf( stderr, "ingest: bad resolution %s\n", argv[3] );
+            return 1;
+        }
+        vbench_mc_init( 0, &mc_c, 0 );
+        vbench_mc_init( cpu_detect(), &mc_a, 0 );
+        return !!vbench_ingest_raw( &mc_c, &mc_a, argv[2], width, height, argv[4], threads );
+    }
+
+    if( argc > 1 && !strcmp( argv[1], "--cold" ) )
+    {
+        bench_cold = 1;
+        argc--;
+        argv++;
+    }
+
+    if( argc > 1 && !strcmp( argv[1], "--code" ) )
+    {
+        bench_code = 1;
+        argc--;
+        argv++;
+    }
+
     if( argc > 1 && !strncmp( argv[1], "--bench", 7 ) )
     {
 #if !ARCH_X86 && !ARCH_X86_64 && !ARCH_PPC && !ARCH_ARM && !ARCH_AARCH64 && !ARCH_MIPS
@@ -271,6 +541,8 @@ int main(int argc, char *argv[])
         argv++;
     }
 
+    print_build();
+
     int seed = ( argc > 1 ) ? atoi(argv[1]) : mdate();
     fprintf( stderr, "VideoBench: using random seed %u\n", seed );
     srand( seed );
@@ -314,6 +586,11 @@ int main(int argc, char *argv[])
     }else
         fprintf( stderr, "VideoBench: All tests passed Yeah :)\n" );
     print_bench();
+    if( bench_cold )
+        print_bench_cold();
+    print_bench_rates();
+    if( bench_code )
+        print_bench_code();
     return 0;
 }
 
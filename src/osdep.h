@@ -118,6 +118,17 @@
 #define x264_nonconstant_p(x) 0
 #endif
 
+/* Generic vector extensions with shuffles and conversions between vector
+ * types: clang, and gcc from 12 on. */
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_shufflevector) && __has_builtin(__builtin_convertvector)
+#define HAVE_VEXT 1
+#endif
+#endif
+#ifndef HAVE_VEXT
+#define HAVE_VEXT 0
+#endif
+
 
 
 // GCC doesn't align stack variables on ARM, so use .bss
@@ -0,0 +1,88 @@
+#!/bin/sh
+#
+# Build variant report.
+#
+# Puts the first table of the ./bench output of several builds (make
+# variants) side by side: per kernel the cycles of the C in every build
+# and its change against the first build given, then the geometric mean
+# of those changes.  The fastest asm of every kernel gets the same as a
+# control: its code is the same in every build, so what moves there is the
+# call into it, the harness around it and noise.
+#
+# usage: ./variantreport.sh bench_output ...
+#        make variantreport REPORT_VARIANTS="O3 O3-lto O3-pgo O3-pgo-lto"
+#
+# Output, tab separated, only kernels with cycles in every build:
+#   bench  cycles of the first  then per build: cycles  change in %
+#
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 bench_output bench_output ..." >&2
+    exit 1
+fi
+
+awk -F'\t' -v OFS='\t' '
+FNR == 1 {
+    n++
+    name[n] = FILENAME
+    table = 0
+}
+/^build: / {
+    b = $0
+    sub( /^build: */, "", b )
+    sub( /,.*/, "", b )
+    name[n] = b
+    next
+}
+/\tC\tMMX\t/ && !/^(throughput|cold)/ { table = 1; next }
+table && !/ : / { table = 0 }
+table {
+    k = $1
+    sub( /^ */, "", k )
+    sub( / *: *$/, "", k )
+    if( n == 1 )
+        order[++nk] = k
+    best = 0
+    for( i = 3; i <= NF; i++ )
+        if( $i > 0 && (!best || $i < best) )
+            best = $i
+    c[n, k] = $2
+    a[n, k] = best
+}
+function side( title, v,    i, j, k, row, ok, sum, cnt )
+{
+    row = title
+    for( j = 1; j <= n; j++ )
+        row = row OFS name[j] (j > 1 ? OFS "%" : "")
+    print row
+    for( i = 1; i <= nk; i++ )
+    {
+        k = order[i]
+        ok = 1
+        for( j = 1; j <= n; j++ )
+            if( !(((j, k) in v) && v[j, k] > 0) )
+                ok = 0
+        if( !ok )
+            continue
+        row = k OFS v[1, k]
+        for( j = 2; j <= n; j++ )
+        {
+            row = row OFS v[j, k] OFS sprintf( "%+.1f", 100 * (v[j, k] - v[1, k]) / v[1, k] )
+            sum[j] += log( v[j, k] / v[1, k] )
+        }
+        cnt++
+        print row
+    }
+    if( !cnt )
+        return
+    row = "geomean" OFS "-"
+    for( j = 2; j <= n; j++ )
+        row = row OFS "-" OFS sprintf( "%+.1f", 100 * (exp( sum[j] / cnt ) - 1) )
+    print row
+}
+END {
+    side( "C", c )
+    print ""
+    side( "asm", a )
+}
+' "$@"
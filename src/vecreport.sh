@@ -0,0 +1,222 @@
+#!/bin/sh
+#
+# Vectorization report.
+#
+# Compiles the C kernels with the vectorizer remarks of the compiler on
+# (gcc -fopt-info-vec, clang -Rpass=loop-vectorize), attributes every loop
+# to the kernel function it is written in and, given the output of ./bench,
+# ranks the loops left scalar by how far the C of their kernel is behind
+# the fastest asm of the same kernel.
+#
+# usage: ./vecreport.sh [-b bench_output] source.c ...
+#        CC and CFLAGS as for the build (make vecreport BENCH_LOG=...)
+#
+# Output, tab separated and ranked by the C/asm cycle ratio:
+#   ratio  C  asm  bench  function  file:line  reason
+# then the missed loops of kernels without a benchmark, then per file
+# counts of vectorized and missed loops.
+#
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O3 -march=core-avx2 -ftree-vectorize --std=gnu99 -DARCH_X86_64=1 -DHAVE_MMX -I./}
+BENCH_LOG=
+
+if [ "$1" = "-b" ]; then
+    BENCH_LOG=$2
+    shift 2
+fi
+if [ $# -eq 0 ]; then
+    echo "usage: $0 [-b bench_output] source.c ..." >&2
+    exit 1
+fi
+
+if $CC --version 2>/dev/null | grep -qi clang; then
+    REMARKS="-Rpass=loop-vectorize -Rpass-missed=loop-vectorize -Rpass-analysis=loop-vectorize -fno-color-diagnostics"
+elif $CC --version 2>/dev/null | grep -qi "gcc\|free software"; then
+    REMARKS="-fopt-info-vec-optimized -fopt-info-vec-missed"
+else
+    echo "$0: no vectorizer remarks known for $CC" >&2
+    exit 1
+fi
+
+TMP=${TMPDIR:-/tmp}/vecreport.$$
+trap 'rm -f $TMP.*' EXIT
+
+for src in "$@"; do
+    $CC $CFLAGS -c -w $REMARKS $src -o /dev/null 2>&1
+done > $TMP.remarks
+
+# One record per loop: file, line, vectorized or missed, reason.  gcc
+# gives the reason of a missed loop in the next remark, clang in the one
+# before at the same place.
+awk '
+function flush() {
+    if( open != "" )
+        print open "\tmissed\t" (reason != "" ? reason : "not vectorized")
+    open = ""; reason = ""
+}
+{
+    if( !match( $0, /^[^:]+:[0-9]+:/ ) )
+        next
+    split( $0, loc, ":" )
+    sub( /^\.\//, "", loc[1] )
+    where = loc[1] ":" loc[2]
+    text = $0
+    sub( /^[^:]+:[0-9]+:[0-9]*:? */, "", text )
+    sub( / *\[-R[^]]*\]$/, "", text )
+}
+/ optimized: .*loop vectorized| remark: vectorized loop/ {
+    flush()
+    print where "\tvectorized\t"
+    next
+}
+/ missed: couldn.t vectorize loop/ {
+    flush()
+    open = where
+    next
+}
+/ missed: not vectorized| missed: .*alias| missed: .*complicated/ {
+    sub( /^missed: */, "", text )
+    if( open != "" && reason == "" )
+    {
+        reason = text
+        flush()
+    }
+    else if( open == "" )
+        print where "\tmissed\t" text
+    next
+}
+/ remark: loop not vectorized:/ {
+    sub( /^remark: loop not vectorized: */, "", text )
+    flush()
+    open = where; reason = text
+    next
+}
+/ remark: loop not vectorized/ {
+    if( open != where )
+    {
+        flush()
+        open = where
+    }
+    next
+}
+END { flush() }
+' $TMP.remarks | sort -u > $TMP.loops
+
+# The function each line is in: the last definition at column 0 above it,
+# or for the kernels a macro stamps out, FOO( name, ... ), the name.  The
+# headers the remarks point into are scanned as well.
+awk -v OFS='\t' '
+FNR == 1 { file = FILENAME }
+/^[A-Z_0-9]+\( *[a-z_][a-z_0-9]* *,/ {
+    name = $0
+    sub( /^[A-Z_0-9]+\( */, "", name )
+    sub( / *,.*/, "", name )
+    print file, FNR, name
+    next
+}
+/^[a-zA-Z_].*[a-z_0-9] *\(/ && !/;[ \t]*$/ && !/^(typedef|return|if|for|while|switch|else)[ (]/ {
+    name = $0
+    sub( / *\(.*/, "", name )
+    sub( /.*[ *]/, "", name )
+    print file, FNR, name
+}
+' $(cut -f1 $TMP.loops | cut -d: -f1 | sort -u) > $TMP.funcs
+
+awk -F'\t' -v OFS='\t' '
+FILENAME == ARGV[1] {
+    func_at[$1 ":" $2] = $3
+    next
+}
+FILENAME == ARGV[2] {
+    split( $1, loc, ":" )
+    name = "?"
+    for( l = loc[2]; l > 0; l-- )
+        if( (loc[1] ":" l) in func_at )
+        {
+            name = func_at[loc[1] ":" l]
+            break
+        }
+    print $1, $2, name, $3
+}
+' $TMP.funcs $TMP.loops > $TMP.attributed
+
+# cycles per kernel from the first table of ./bench: C in the first column,
+# the asm in the next thirteen
+if [ -n "$BENCH_LOG" ]; then
+    awk -F'\t' -v OFS='\t' '
+    /\tC\tMMX\t/ && !/^(throughput|cold)/ { table = 1; next }
+    table && !/ : / { exit }
+    table {
+        name = $1
+        sub( /^ */, "", name )
+        sub( / *: *$/, "", name )
+        best = 0
+        for( i = 3; i <= 15 && i <= NF; i++ )
+            if( $i > 0 && (!best || $i < best) )
+                best = $i
+        if( $2 > 0 && best > 0 )
+            print name, $2, best
+    }
+    ' "$BENCH_LOG" > $TMP.bench
+else
+    : > $TMP.bench
+fi
+
+# the benchmark of a function: the one named after it, with or without a
+# pixel_/x264_ style prefix; of several, the one furthest behind the asm
+awk -F'\t' -v OFS='\t' '
+FILENAME == ARGV[1] {
+    n++
+    bname[n] = $1; bc[n] = $2; basm[n] = $3
+    next
+}
+{
+    if( $2 == "vectorized" )
+    {
+        vec[$1] = 1
+        split( $1, loc, ":" )
+        nvec[loc[1]]++
+        next
+    }
+    miss[$1] = $0
+}
+END {
+    for( w in miss )
+    {
+        if( w in vec )
+            continue
+        split( miss[w], m, "\t" )
+        split( w, loc, ":" )
+        nmiss[loc[1]]++
+        best = 0
+        for( i = 1; i <= n; i++ )
+        {
+            f = m[3]
+            b = bname[i]
+            if( f != b && substr( f, length( f ) - length( b ) ) != "_" b )
+                continue
+            r = bc[i] / basm[i]
+            if( r > best )
+            {
+                best = r; bi = i
+            }
+        }
+        if( best )
+            printf "%.2f\t%d\t%d\t%s\t%s\t%s\t%s\n", best, bc[bi], basm[bi], bname[bi], m[3], w, m[4] > "/dev/stdout"
+        else
+            printf "-\t-\t-\t-\t%s\t%s\t%s\n", m[3], w, m[4] > "/dev/stderr"
+    }
+    for( file in nvec )
+        if( !(file in nmiss) )
+            nmiss[file] = 0
+    for( file in nmiss )
+        printf "%s\t%d vectorized\t%d missed\n", file, nvec[file], nmiss[file] > "'$TMP.summary'"
+}
+' $TMP.bench $TMP.attributed > $TMP.ranked 2> $TMP.unranked
+
+printf "ratio\tC\tasm\tbench\tfunction\twhere\treason\n"
+sort -t'	' -k1,1gr -k6,6 $TMP.ranked
+sort -t'	' -k5,5 -k6,6 $TMP.unranked
+echo
+sort $TMP.summary